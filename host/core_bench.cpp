@@ -0,0 +1,145 @@
+/**
+ * @file core_bench.cpp
+ * @brief Google Benchmark micro-benchmarks of the portable cores
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <benchmark/benchmark.h>
+
+extern "C" {
+#include <dht11_frame.h>
+#include <event_queue.h>
+#include <hal_host.h>
+#include <key_fsm.h>
+}
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+static const dht11_data_t reading = {45, 0, 23, 4, 72};
+
+static const key_fsm_timing_t timing = {1000, 300, 500, 200};
+
+static uint32_t handled;
+
+/*******************************************************************************
+ * Function Definitions
+ ******************************************************************************/
+
+static void count_handler(const event_t *evt) { handled += evt->len; }
+
+static void BM_DecodeBits(benchmark::State &state) {
+  const uint8_t bytes[] = {reading.rh_high, reading.rh_low, reading.t_high,
+                           reading.t_low, reading.parity};
+  uint8_t bits[DHT11_NUM_DATA_BITS];
+  dht11_data_t data;
+
+  for (uint8_t bit = 0; bit < DHT11_NUM_DATA_BITS; bit++) {
+    bits[bit] = (bytes[bit / 8] >> (7 - bit % 8)) & 1;
+  }
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(dht11_frame_decode_bits(bits, &data));
+    benchmark::DoNotOptimize(data);
+  }
+}
+BENCHMARK(BM_DecodeBits);
+
+static void BM_DecodePulses(benchmark::State &state) {
+  const uint8_t bytes[] = {reading.rh_high, reading.rh_low, reading.t_high,
+                           reading.t_low, reading.parity};
+  uint8_t widths[DHT11_NUM_PULSES];
+  dht11_data_t data;
+
+  widths[0] = 80;
+  for (uint8_t bit = 0; bit < DHT11_NUM_DATA_BITS; bit++) {
+    widths[bit + 1] = (bytes[bit / 8] >> (7 - bit % 8)) & 1 ? 70 : 26;
+  }
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(dht11_frame_decode_pulses(widths, 50, 70, &data));
+    benchmark::DoNotOptimize(data);
+  }
+}
+BENCHMARK(BM_DecodePulses);
+
+// CPU cost of a polled frame against the simulated line, about 20000 reads
+static void BM_FramePoll(benchmark::State &state) {
+  uint8_t bits[DHT11_NUM_DATA_BITS];
+  hal_host_replay_t replay;
+  const hal_line_t line = {&replay};
+
+  for (auto _ : state) {
+    hal_host_line_frame(&line, &reading);
+    benchmark::DoNotOptimize(dht11_frame_poll(&line, bits));
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(BM_FramePoll);
+
+// Short press, double click and a long press with two repeats
+static void BM_KeyGestures(benchmark::State &state) {
+  key_fsm_t fsm;
+  key_fsm_out_t out;
+
+  key_fsm_init(&fsm);
+
+  for (auto _ : state) {
+    key_fsm_sample(&fsm, &timing, true, &out);
+    key_fsm_sample(&fsm, &timing, false, &out);
+    key_fsm_expired(&fsm, &timing, &out);
+
+    key_fsm_sample(&fsm, &timing, true, &out);
+    key_fsm_sample(&fsm, &timing, false, &out);
+    key_fsm_sample(&fsm, &timing, true, &out);
+    key_fsm_sample(&fsm, &timing, false, &out);
+
+    key_fsm_sample(&fsm, &timing, true, &out);
+    key_fsm_expired(&fsm, &timing, &out);
+    key_fsm_expired(&fsm, &timing, &out);
+    key_fsm_expired(&fsm, &timing, &out);
+    key_fsm_sample(&fsm, &timing, false, &out);
+    benchmark::DoNotOptimize(out);
+  }
+}
+BENCHMARK(BM_KeyGestures);
+
+// Post and dispatch a burst of mixed priority events to four subscribers
+static void BM_EventRoute(benchmark::State &state) {
+  static const event_type_t types[] = {EVENT_BUTTON_GESTURE,
+                                       EVENT_BUTTON_PRESSED,
+                                       EVENT_BUTTON_RELEASED, EVENT_BUTTON_1S};
+  static const struct event_subscriber subs[] = {
+      {EVENT_BUTTON_1S, count_handler},
+      {EVENT_BUTTON_PRESSED, count_handler},
+      {EVENT_BUTTON_RELEASED, count_handler},
+      {EVENT_BUTTON_GESTURE, count_handler},
+  };
+  const size_t burst = state.range(0);
+  event_node_t nodes[64];
+  event_queue_t queue;
+  uint32_t payload = 0;
+
+  event_queue_init(&queue);
+
+  for (auto _ : state) {
+    for (size_t idx = 0; idx < burst; idx++) {
+      event_queue_fill(&nodes[idx], types[idx % 4], &payload, sizeof(payload),
+                       idx);
+      event_queue_push(&queue, &nodes[idx]);
+    }
+
+    while (event_node_t *node = event_queue_pop(&queue)) {
+      event_queue_route(&node->evt, subs, 4);
+    }
+  }
+
+  benchmark::DoNotOptimize(handled);
+  state.SetItemsProcessed(state.iterations() * burst);
+}
+BENCHMARK(BM_EventRoute)->RangeMultiplier(4)->Range(1, 64);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,311 @@
+/**
+ * @file core_check.c
+ * @brief Checks of the portable cores, run under ASan and UBSan by ctest
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <derived.h>
+#include <dht11_frame.h>
+#include <dht11_model.h>
+#include <event_queue.h>
+#include <hal_host.h>
+#include <key_fsm.h>
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/** Fail the current check with the failing expression */
+#define CHECK(cond)                                                            \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      printf("%s:%d: %s\n", __FILE__, __LINE__, #cond);                        \
+      return 1;                                                                \
+    }                                                                          \
+  } while (0)
+
+/** Largest errors of the derived metrics against the double reference */
+#define DEW_POINT_TOL 0.1
+#define ABS_HUMIDITY_TOL 0.05
+#define HEAT_INDEX_TOL 0.2
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+static const dht11_data_t reading = {
+    .rh_high = 45, .rh_low = 0, .t_high = 23, .t_low = 4, .parity = 72};
+
+static const key_fsm_timing_t timing = {
+    .long_press_ms = 1000,
+    .double_click_ms = 300,
+    .repeat_delay_ms = 500,
+    .repeat_interval_ms = 200,
+};
+
+/** Types seen by the event handlers, in order */
+static event_type_t routed[8];
+static uint32_t num_routed;
+
+/*******************************************************************************
+ * Function Definitions
+ ******************************************************************************/
+
+/** Heat index of the NWS in C, the reference of derived.c */
+static double heat_index_ref(double t_c, double rh) {
+  double t = t_c * 9 / 5 + 32;
+  double hi = 0.5 * (t + 61.0 + (t - 68.0) * 1.2 + rh * 0.094);
+
+  if ((hi + t) / 2 < 80) {
+    return (hi - 32) * 5 / 9;
+  }
+
+  hi = -42.379 + 2.04901523 * t + 10.14333127 * rh - 0.22475541 * t * rh -
+       6.83783e-3 * t * t - 5.481717e-2 * rh * rh + 1.22874e-3 * t * t * rh +
+       8.5282e-4 * t * rh * rh - 1.99e-6 * t * t * rh * rh;
+  if (rh < 13 && t >= 80 && t <= 112) {
+    hi -= (13 - rh) / 4 * sqrt((17 - fabs(t - 95)) / 17);
+  } else if (rh > 85 && t >= 80 && t <= 87) {
+    hi += (rh - 85) / 10 * (87 - t) / 5;
+  }
+
+  return (hi - 32) * 5 / 9;
+}
+
+static void record_handler(const event_t *evt) {
+  routed[num_routed++ % 8] = evt->type;
+}
+
+static int check_decode(void) {
+  uint8_t bits[DHT11_NUM_DATA_BITS];
+  uint8_t widths[DHT11_NUM_PULSES];
+  const uint8_t bytes[] = {reading.rh_high, reading.rh_low, reading.t_high,
+                           reading.t_low, reading.parity};
+  dht11_data_t data;
+
+  widths[0] = 80;
+  for (uint8_t bit = 0; bit < DHT11_NUM_DATA_BITS; bit++) {
+    bits[bit] = (bytes[bit / 8] >> (7 - bit % 8)) & 1;
+    widths[bit + 1] = bits[bit] ? 70 : 26;
+  }
+
+  CHECK(dht11_frame_decode_bits(bits, &data) == DHT11_ERROR_NONE);
+  CHECK(memcmp(&data, &reading, sizeof(data)) == 0);
+
+  CHECK(dht11_frame_decode_pulses(widths, 50, 70, &data) == DHT11_ERROR_NONE);
+  CHECK(memcmp(&data, &reading, sizeof(data)) == 0);
+
+  CHECK(dht11_frame_decode_pulses(widths, 50, 90, &data) ==
+        DHT11_ERROR_SETUP_FAILED);
+
+  bits[DHT11_NUM_DATA_BITS - 1] ^= 1;
+  CHECK(dht11_frame_decode_bits(bits, &data) ==
+        DHT11_ERROR_PARITY_CHECK_FAILED);
+
+  return 0;
+}
+
+static int check_models(void) {
+  // 0.5 C below zero, sign in bit 7 of the tenths byte
+  const dht11_data_t dht11_cold = {.rh_high = 80, .t_high = 0, .t_low = 0x85};
+  // 100.0 %, 40.0 C below zero, the ends of the DHT22 range
+  const dht11_data_t dht22_ends = {.rh_high = 0x03, .rh_low = 0xE8,
+                                   .t_high = 0x81, .t_low = 0x90};
+  dht11_data_t dht22_past = dht22_ends;
+  const dht11_data_t zero = {0};
+  dht11_sample_t sample;
+
+  CHECK(dht11_model_sample(&dht11_model_dht11, &reading, &sample) ==
+        DHT11_ERROR_NONE);
+  CHECK(sample.rh_x10 == 450 && sample.t_x10 == 234);
+
+  CHECK(dht11_model_sample(&dht11_model_dht11, &dht11_cold, &sample) ==
+        DHT11_ERROR_NONE);
+  CHECK(sample.rh_x10 == 800 && sample.t_x10 == -5);
+
+  CHECK(dht11_model_sample(&dht11_model_dht22, &dht22_ends, &sample) ==
+        DHT11_ERROR_NONE);
+  CHECK(sample.rh_x10 == 1000 && sample.t_x10 == -400);
+
+  dht22_past.t_low++;
+  CHECK(dht11_model_sample(&dht11_model_dht22, &dht22_past, &sample) ==
+        DHT11_ERROR_OUT_OF_RANGE);
+  CHECK(dht11_model_sample(&dht11_model_dht11, &dht22_ends, &sample) ==
+        DHT11_ERROR_OUT_OF_RANGE);
+  CHECK(dht11_model_sample(&dht11_model_dht22, &zero, &sample) ==
+        DHT11_ERROR_OUT_OF_RANGE);
+
+  return 0;
+}
+
+static int check_derived(void) {
+  derived_cache_t cache = {0};
+  derived_metrics_t metrics;
+  dht11_sample_t sample;
+
+  // Every sample either model can send
+  for (int16_t t_x10 = -400; t_x10 <= 800; t_x10++) {
+    for (int16_t rh_x10 = 1; rh_x10 <= 1000; rh_x10++) {
+      double t = t_x10 / 10.0;
+      double rh = rh_x10 / 10.0;
+      double magnus = 17.62 * t / (243.12 + t);
+      double gamma = log(rh / 100) + magnus;
+      double ah = 216.7 * rh / 100 * 6.112 * exp(magnus) / (273.15 + t);
+
+      sample.rh_x10 = rh_x10;
+      sample.t_x10 = t_x10;
+      CHECK(derived_compute(&sample, &metrics) == 0);
+      CHECK(fabs(metrics.dew_point_x10 / 10.0 - 243.12 * gamma /
+                                                   (17.62 - gamma)) <=
+            DEW_POINT_TOL);
+      CHECK(fabs(metrics.abs_humidity_x100 / 100.0 - ah) <= ABS_HUMIDITY_TOL);
+      if (t_x10 <= 500) {
+        CHECK(fabs(metrics.heat_index_x10 / 10.0 - heat_index_ref(t, rh)) <=
+              HEAT_INDEX_TOL);
+      } else {
+        CHECK(metrics.heat_index_x10 == DERIVED_NONE);
+      }
+    }
+  }
+
+  sample.rh_x10 = 0;
+  CHECK(derived_compute(&sample, &metrics) == -EDOM);
+  sample.rh_x10 = 1001;
+  CHECK(derived_compute(&sample, &metrics) == -ERANGE);
+  sample.rh_x10 = 500;
+  sample.t_x10 = -401;
+  CHECK(derived_compute(&sample, &metrics) == -ERANGE);
+
+  // Computed once per sequence number, whatever the sample passed with it
+  sample.t_x10 = 250;
+  CHECK(derived_cache_get(&cache, 7, &sample, &metrics) == 0);
+  sample.t_x10 = 300;
+  CHECK(derived_cache_get(&cache, 7, &sample, &metrics) == 0);
+  CHECK(cache.computed == 1 && cache.hits == 1);
+  CHECK(derived_cache_get(&cache, 8, &sample, &metrics) == 0);
+  CHECK(cache.computed == 2 && cache.seq == 8);
+
+  return 0;
+}
+
+static int check_poll(void) {
+  uint8_t bits[DHT11_NUM_DATA_BITS];
+  dht11_data_t bad = reading;
+  dht11_data_t data;
+  hal_host_replay_t replay;
+  const hal_line_t line = {.replay = &replay};
+
+  hal_host_line_frame(&line, &reading);
+  CHECK(dht11_frame_poll(&line, bits) == DHT11_ERROR_NONE);
+  CHECK(dht11_frame_decode_bits(bits, &data) == DHT11_ERROR_NONE);
+  CHECK(memcmp(&data, &reading, sizeof(data)) == 0);
+
+  bad.parity++;
+  hal_host_line_frame(&line, &bad);
+  CHECK(dht11_frame_poll(&line, bits) == DHT11_ERROR_NONE);
+  CHECK(dht11_frame_decode_bits(bits, &data) ==
+        DHT11_ERROR_PARITY_CHECK_FAILED);
+
+  hal_host_line_idle(&line);
+  CHECK(dht11_frame_poll(&line, bits) == DHT11_ERROR_HARDWARE_UNAVAILABLE);
+
+  return 0;
+}
+
+static int check_key(void) {
+  key_fsm_t fsm;
+  key_fsm_out_t out;
+
+  key_fsm_init(&fsm);
+
+  // Bounce back to released reports nothing
+  CHECK(!key_fsm_sample(&fsm, &timing, false, &out));
+
+  // Short press, reported once the double click window closes
+  CHECK(key_fsm_sample(&fsm, &timing, true, &out));
+  CHECK(out.press && out.timer_ms == timing.long_press_ms);
+  CHECK(key_fsm_sample(&fsm, &timing, false, &out));
+  CHECK(out.release && out.gesture == BUTTON_GESTURE_MAX);
+  CHECK(out.timer_ms == timing.double_click_ms);
+  key_fsm_expired(&fsm, &timing, &out);
+  CHECK(out.gesture == BUTTON_GESTURE_SHORT && fsm.state == KEY_IDLE);
+
+  // Double click
+  CHECK(key_fsm_sample(&fsm, &timing, true, &out));
+  CHECK(key_fsm_sample(&fsm, &timing, false, &out));
+  CHECK(key_fsm_sample(&fsm, &timing, true, &out));
+  CHECK(out.press && out.gesture == BUTTON_GESTURE_DOUBLE);
+  CHECK(out.timer_ms == KEY_FSM_TIMER_STOP);
+  CHECK(key_fsm_sample(&fsm, &timing, false, &out));
+  CHECK(out.gesture == BUTTON_GESTURE_MAX && fsm.state == KEY_IDLE);
+
+  // Long press with repeats
+  CHECK(key_fsm_sample(&fsm, &timing, true, &out));
+  key_fsm_expired(&fsm, &timing, &out);
+  CHECK(out.hold && out.gesture == BUTTON_GESTURE_LONG);
+  CHECK(out.timer_ms == timing.repeat_delay_ms);
+  key_fsm_expired(&fsm, &timing, &out);
+  CHECK(out.gesture == BUTTON_GESTURE_REPEAT);
+  CHECK(out.timer_ms == timing.repeat_interval_ms);
+  CHECK(key_fsm_sample(&fsm, &timing, false, &out));
+  CHECK(out.release && out.gesture == BUTTON_GESTURE_MAX);
+  CHECK(out.timer_ms == KEY_FSM_TIMER_STOP);
+
+  return 0;
+}
+
+static int check_events(void) {
+  static const struct event_subscriber subs[] = {
+      {.type = EVENT_BUTTON_GESTURE, .handler = record_handler},
+      {.type = EVENT_BUTTON_PRESSED, .handler = record_handler},
+      {.type = EVENT_BUTTON_PRESSED, .handler = record_handler},
+  };
+  event_node_t nodes[3];
+  event_queue_t queue;
+  event_node_t *node;
+  uint32_t payload = 0xC0FFEE;
+
+  CHECK(!event_queue_valid(NO_EVENT, NULL, 0));
+  CHECK(!event_queue_valid(EVENT_MAX, NULL, 0));
+  CHECK(!event_queue_valid(EVENT_BUTTON_1S, &payload, EVENT_PAYLOAD_SIZE + 1));
+  CHECK(!event_queue_valid(EVENT_BUTTON_1S, NULL, sizeof(payload)));
+  CHECK(event_queue_valid(EVENT_BUTTON_1S, &payload, sizeof(payload)));
+
+  event_queue_init(&queue);
+  event_queue_fill(&nodes[0], EVENT_BUTTON_GESTURE, &payload, sizeof(payload),
+                   1);
+  event_queue_fill(&nodes[1], EVENT_BUTTON_PRESSED, NULL, 0, 2);
+  event_queue_fill(&nodes[2], EVENT_BUTTON_RELEASED, NULL, 0, 3);
+  for (uint8_t idx = 0; idx < 3; idx++) {
+    event_queue_push(&queue, &nodes[idx]);
+  }
+
+  // High priority first in posting order, then the gesture
+  num_routed = 0;
+  while ((node = event_queue_pop(&queue))) {
+    event_queue_route(&node->evt, subs, 3);
+  }
+
+  CHECK(num_routed == 3);
+  CHECK(routed[0] == EVENT_BUTTON_PRESSED && routed[1] == EVENT_BUTTON_PRESSED);
+  CHECK(routed[2] == EVENT_BUTTON_GESTURE);
+  CHECK(memcmp(nodes[0].evt.payload, &payload, sizeof(payload)) == 0);
+
+  return 0;
+}
+
+int main(void) {
+  int failed = check_decode() + check_models() + check_derived() +
+               check_poll() + check_key() + check_events();
+
+  printf("%s\n", failed ? "FAIL" : "PASS");
+
+  return failed;
+}
@@ -0,0 +1,91 @@
+/**
+ * @file hal_host.c
+ * @brief Hardware access of the portable cores on the host
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <hal_host.h>
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/** Nominal DHT11 timing in us */
+#define RESPONSE_US 30
+#define ACK_LOW_US 80
+#define ACK_HIGH_US 80
+#define BIT_LOW_US 50
+#define ZERO_US 26
+#define ONE_US 70
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+/** Simulated cycle counter */
+static uint32_t now;
+
+/*******************************************************************************
+ * Function Definitions
+ ******************************************************************************/
+
+// Described in .h
+uint32_t hal_cycles(void) { return now; }
+
+// Described in .h
+uint32_t hal_us_to_cycles(uint32_t us) { return us * HAL_HOST_CYCLES_PER_US; }
+
+// Described in .h
+uint32_t hal_cycles_to_us(uint32_t cycles) {
+  return (cycles + HAL_HOST_CYCLES_PER_US - 1) / HAL_HOST_CYCLES_PER_US;
+}
+
+// Described in .h
+int hal_line_get(const hal_line_t *line) {
+  hal_host_replay_t *replay = line->replay;
+
+  now += HAL_HOST_READ_NS;
+
+  while (replay->idx < replay->count &&
+         now - replay->start >= replay->ends[replay->idx]) {
+    replay->idx++;
+  }
+
+  return replay->idx >= replay->count || !(replay->idx & 1);
+}
+
+// Described in .h
+void hal_host_line_frame(const hal_line_t *line, const dht11_data_t *data) {
+  hal_host_replay_t *replay = line->replay;
+  const uint8_t bytes[] = {data->rh_high, data->rh_low, data->t_high,
+                           data->t_low, data->parity};
+  uint32_t end = 0;
+  uint8_t count = 0;
+
+  replay->ends[count++] = end += hal_us_to_cycles(RESPONSE_US);
+  replay->ends[count++] = end += hal_us_to_cycles(ACK_LOW_US);
+  replay->ends[count++] = end += hal_us_to_cycles(ACK_HIGH_US);
+
+  for (uint8_t bit = 0; bit < DHT11_NUM_DATA_BITS; bit++) {
+    uint8_t one = (bytes[bit / 8] >> (7 - bit % 8)) & 1;
+
+    replay->ends[count++] = end += hal_us_to_cycles(BIT_LOW_US);
+    replay->ends[count++] = end += hal_us_to_cycles(one ? ONE_US : ZERO_US);
+  }
+
+  // Final low before the line is released
+  replay->ends[count++] = end += hal_us_to_cycles(BIT_LOW_US);
+
+  replay->count = count;
+  replay->idx = 0;
+  replay->start = now;
+}
+
+// Described in .h
+void hal_host_line_idle(const hal_line_t *line) {
+  line->replay->count = 0;
+  line->replay->idx = 0;
+  line->replay->start = now;
+}
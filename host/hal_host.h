@@ -0,0 +1,73 @@
+/**
+ * @file hal_host.h
+ * @brief Simulated hardware of the host build
+ *
+ * Time is simulated so the polling capture gives the same result on every
+ * run: the cycle counter counts ns and only moves when a line is read, by
+ * HAL_HOST_READ_NS per read.  A line is a handle on a replay, a list of
+ * levels played from the moment it is loaded that idles high once they run
+ * out, like the DHT11 data line with its pull-up.  Reads advance the replay,
+ * so it stays writable behind the const line the frame core reads.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <dht11_frame.h>
+#include <hal.h>
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/** Simulated cycles per us */
+#define HAL_HOST_CYCLES_PER_US 1000
+
+/** Simulated time taken by a read of a line in ns */
+#define HAL_HOST_READ_NS 250
+
+/** Most levels a line replays, enough for a DHT11 response */
+#define HAL_HOST_MAX_LEVELS (3 + 2 * DHT11_NUM_DATA_BITS + 1)
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+
+/** Levels replayed by a line, alternating starting high */
+typedef struct hal_host_replay_s {
+  uint32_t ends[HAL_HOST_MAX_LEVELS]; ///< End of each level, cycles from start
+  uint8_t count;                      ///< Number of levels
+  uint8_t idx;                        ///< Level at the last read
+  uint32_t start;                     ///< Cycle count when loaded
+} hal_host_replay_t;
+
+/** A simulated line */
+struct hal_line {
+  hal_host_replay_t *replay; ///< Levels the line plays
+};
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Load a line with the response of a DHT11 to a start signal
+ *
+ * Uses the nominal timing of the datasheet: 30 us until the sensor answers,
+ * 80 us low and 80 us high, then per bit 50 us low and a 26 us or 70 us high.
+ *
+ * @param line Line to load
+ * @param data Frame sent, sent as is so a bad parity byte can be sent
+ */
+void hal_host_line_frame(const hal_line_t *line, const dht11_data_t *data);
+
+/**
+ * @brief Load a line that stays high, a missing sensor
+ *
+ * @param line Line to load
+ */
+void hal_host_line_idle(const hal_line_t *line);
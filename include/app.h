@@ -0,0 +1,54 @@
+/**
+ * @file app.h
+ * @brief Runtime controls of the application
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <derived.h>
+#include <sample_ring.h>
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Period of the DHT11 acquisition
+ *
+ * @return Period in ms
+ */
+uint32_t app_dht11_period_get(void);
+
+/**
+ * @brief Change the period of the DHT11 acquisition
+ *
+ * Takes effect when the acquisition in flight, if any, completes.  Not
+ * persisted, a reset restores the default.
+ *
+ * @param period_ms New period in ms, at least the minimum read interval of
+ * the model of every instance
+ *
+ * @return 0 on success
+ * @return -EINVAL if the period is shorter than the sensor allows
+ */
+int app_dht11_period_set(uint32_t period_ms);
+
+/**
+ * @brief Derived metrics of a published sample
+ *
+ * The metrics are computed on the first request for the sample and shared
+ * with every later request for it, see derived.h.  May be called from any
+ * thread, the computation runs with a spinlock held.
+ *
+ * @param sample Sample read from sensor_sample_ring
+ * @param metrics Pointer to store the metrics, only valid on success
+ *
+ * @return As derived_compute()
+ */
+int app_derived_get(const sample_ring_sample_t *sample,
+                    derived_metrics_t *metrics);
@@ -0,0 +1,128 @@
+/**
+ * @file app_trace.h
+ * @brief Cycle counter tracing of the hot paths
+ *
+ * A span is timed with k_cycle_get_32() at its start and end and its length
+ * is counted in a log2 histogram, bucket n holding the lengths from 2^(n-1)
+ * up to 2^n cycles.  Recording takes a handful of atomic operations and is
+ * safe in interrupts and with interrupts locked.  With CONFIG_TRACING every
+ * span is also emitted as a named event, so on native_sim the CTF backend
+ * writes them to the trace file next to the kernel events.
+ *
+ * Without CONFIG_APP_TRACE the macros expand to nothing and the spans cost
+ * no code and no RAM.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/** Histogram buckets, bucket 0 counts zero length spans */
+#define APP_TRACE_BUCKETS 33
+
+#ifdef CONFIG_APP_TRACE
+
+/**
+ * @brief Timestamp the start of a span
+ *
+ * @return Start cycles to pass to APP_TRACE_END()
+ */
+#define APP_TRACE_START() k_cycle_get_32()
+
+/**
+ * @brief Record a span
+ *
+ * @param span Span name without the APP_TRACE_ prefix, e.g. DHT11_DECODE
+ * @param start Value returned by APP_TRACE_START() or any earlier
+ * k_cycle_get_32() taken at the start of the span
+ */
+#define APP_TRACE_END(span, start)                                             \
+  app_trace_record(APP_TRACE_##span, k_cycle_get_32() - (start))
+
+#else
+
+#define APP_TRACE_START() 0U
+#define APP_TRACE_END(span, start) ((void)(start))
+
+#endif
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+
+/** Traced spans */
+typedef enum app_trace_span_e {
+  APP_TRACE_DHT11_IRQ_LOCK = 0, ///< Polling capture with interrupts locked
+  APP_TRACE_DHT11_EDGE_ISR,     ///< DHT11 edge interrupt
+  APP_TRACE_DHT11_DECODE,       ///< Decode of a captured frame
+  APP_TRACE_BUTTON_ISR,         ///< Button edge interrupt
+  APP_TRACE_BUTTON_LATENCY,     ///< First button edge to debounced event
+  APP_TRACE_SPAN_MAX
+} app_trace_span_t;
+
+/** Statistics of one span */
+typedef struct app_trace_stats_s {
+  uint32_t count;                      ///< Spans recorded
+  uint32_t max_cycles;                 ///< Longest span
+  uint32_t buckets[APP_TRACE_BUCKETS]; ///< log2 histogram of the lengths
+} app_trace_stats_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Record a span of a given length, see APP_TRACE_END()
+ *
+ * @param span Traced span
+ * @param cycles Length of the span in cycles
+ */
+void app_trace_record(app_trace_span_t span, uint32_t cycles);
+
+/**
+ * @brief Retrieve the statistics of a span
+ *
+ * Lock free.  A span recorded meanwhile may be counted in some fields and not
+ * yet in others.
+ *
+ * @param span Traced span
+ * @param stats Pointer to struct to store the statistics
+ *
+ * @return 0 on success, -EINVAL if the span does not exist
+ */
+int app_trace_get(app_trace_span_t span, app_trace_stats_t *stats);
+
+/**
+ * @brief Name of a span as used for its trace event
+ *
+ * @param span Traced span
+ * @return Name, "?" if the span does not exist
+ */
+const char *app_trace_name(app_trace_span_t span);
+
+/**
+ * @brief Longest time interrupts were held off by a traced span
+ *
+ * The maximum over the spans that mask interrupts, the locked polling capture
+ * and the interrupt handlers themselves.
+ *
+ * @param span Pointer to store the span that held them off longest, may be
+ * NULL
+ * @return Length in cycles, 0 if none was recorded
+ */
+uint32_t app_trace_blackout(app_trace_span_t *span);
+
+/**
+ * @brief Clear the statistics of every span
+ */
+void app_trace_reset(void);
@@ -1,15 +1,23 @@
 /**
  * @file common.h
  * @brief Common utilities used here.
- * 
- * 
+ *
+ * The COMMON_LOG_* macros work with both text and dictionary logging.  In
+ * dictionary mode (see dictionary.conf) the device only emits a format ID and
+ * the raw arguments, the format strings, colors included, are kept in the
+ * dictionary database and expanded by scripts/log_decode.py on the host.
  */
 
 #pragma once
 
+#include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
 
+#include <stdbool.h>
+#include <stdint.h>
+
 // ANSI Coloring for logging
+#ifdef CONFIG_APP_LOG_COLOR
 #define ANSI_COLOR_RED     "\033[1;31m"
 #define ANSI_COLOR_GREEN   "\033[1;32m"
 #define ANSI_COLOR_YELLOW  "\033[1;33m"
@@ -17,7 +25,20 @@
 #define ANSI_COLOR_MAGENTA "\033[1;35m"
 #define ANSI_COLOR_CYAN    "\033[1;36m"
 #define ANSI_COLOR_RESET   "\033[0m"
+#else
+#define ANSI_COLOR_RED     ""
+#define ANSI_COLOR_GREEN   ""
+#define ANSI_COLOR_YELLOW  ""
+#define ANSI_COLOR_BLUE    ""
+#define ANSI_COLOR_MAGENTA ""
+#define ANSI_COLOR_CYAN    ""
+#define ANSI_COLOR_RESET   ""
+#endif
 
+/** Rate limit interval when built without the application Kconfig */
+#ifndef CONFIG_APP_LOG_RATELIMIT_MS
+#define CONFIG_APP_LOG_RATELIMIT_MS 10000
+#endif
 
 #define COMMON_LOG_INF(fmt, ...) \
     LOG_INF(ANSI_COLOR_GREEN fmt ANSI_COLOR_RESET, ##__VA_ARGS__)
@@ -29,4 +50,56 @@
     LOG_DBG(ANSI_COLOR_BLUE fmt ANSI_COLOR_RESET, ##__VA_ARGS__)
 
 #define COMMON_LOG_WRN(fmt, ...) \
-    LOG_DBG(ANSI_COLOR_YELLOW fmt ANSI_COLOR_RESET, ##__VA_ARGS__)
+    LOG_WRN(ANSI_COLOR_YELLOW fmt ANSI_COLOR_RESET, ##__VA_ARGS__)
+
+/**
+ * @brief Rate limited COMMON_LOG_ERR
+ *
+ * Each call site logs at most once per CONFIG_APP_LOG_RATELIMIT_MS.  The
+ * first message after a burst reports how many were suppressed.
+ */
+#define COMMON_LOG_ERR_RATELIMIT(fmt, ...)                                     \
+  do {                                                                         \
+    static common_ratelimit_t _common_rl;                                      \
+    uint32_t _common_suppressed;                                               \
+                                                                               \
+    if (common_ratelimit(&_common_rl, &_common_suppressed)) {                  \
+      if (_common_suppressed) {                                                \
+        COMMON_LOG_ERR("%u similar messages suppressed", _common_suppressed);  \
+      }                                                                        \
+      COMMON_LOG_ERR(fmt, ##__VA_ARGS__);                                      \
+    }                                                                          \
+  } while (0)
+
+/** State of a rate limited call site */
+typedef struct common_ratelimit_s {
+  int64_t last_ms;     ///< Uptime of the last message let through
+  uint32_t suppressed; ///< Messages dropped since then
+  bool active;         ///< False until the first message
+} common_ratelimit_t;
+
+/**
+ * @brief Decide whether a rate limited message may be logged
+ *
+ * @param rl State of the call site
+ * @param suppressed Set to the number of messages dropped since the last one
+ * let through, only when returning true
+ *
+ * @return True if the message should be logged
+ */
+static inline bool common_ratelimit(common_ratelimit_t *rl,
+                                    uint32_t *suppressed) {
+  int64_t now_ms = k_uptime_get();
+
+  if (rl->active && now_ms - rl->last_ms < CONFIG_APP_LOG_RATELIMIT_MS) {
+    rl->suppressed++;
+    return false;
+  }
+
+  *suppressed = rl->suppressed;
+  rl->suppressed = 0;
+  rl->last_ms = now_ms;
+  rl->active = true;
+
+  return true;
+}
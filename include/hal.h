@@ -0,0 +1,60 @@
+/**
+ * @file hal.h
+ * @brief Hardware access of the portable cores
+ *
+ * The DHT11 frame core (dht11_frame.c) reads the data line and the cycle
+ * counter through these functions only, so it builds for the host as well as
+ * for the target.  The key and event cores (key_fsm.c, event_queue.c) get
+ * their samples and time stamps as arguments and need none of them.
+ * src/hal_zephyr.c implements the interface on Zephyr, host/hal_host.c on a
+ * workstation, see the Host Build section of the README.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+
+/** A digital input line, defined by hal_zephyr.h and host/hal_host.h */
+typedef struct hal_line hal_line_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Free running cycle counter
+ *
+ * @return Current count, wraps at 32 bits
+ */
+uint32_t hal_cycles(void);
+
+/**
+ * @brief Convert a duration to cycles, rounding up
+ *
+ * @param us Duration in us
+ * @return Duration in cycles
+ */
+uint32_t hal_us_to_cycles(uint32_t us);
+
+/**
+ * @brief Convert a duration to us, rounding up
+ *
+ * @param cycles Duration in cycles
+ * @return Duration in us
+ */
+uint32_t hal_cycles_to_us(uint32_t cycles);
+
+/**
+ * @brief Read a line
+ *
+ * @param line Line to read
+ * @return Logical level of the line, 0 or 1
+ */
+int hal_line_get(const hal_line_t *line);
@@ -0,0 +1,22 @@
+/**
+ * @file hal_zephyr.h
+ * @brief Hardware access of the portable cores on Zephyr
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <zephyr/drivers/gpio.h>
+
+#include <hal.h>
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+
+/** A GPIO line described in the device tree */
+struct hal_line {
+  struct gpio_dt_spec spec; ///< Pin read by hal_line_get()
+};
@@ -0,0 +1,41 @@
+/**
+ * @file history.h
+ * @brief Flash history of the published DHT11 samples
+ *
+ * Drains sensor_sample_ring into the time series store (ts_store.h) on the
+ * history_partition flash partition.  Writing a batch may erase a flash
+ * sector first, which takes up to seconds on the STM32F7, so the store runs
+ * on the storage work queue (storage_workq.h) instead of the system work
+ * queue.  The RAM batch of the store is also written once its oldest sample
+ * is CONFIG_APP_HISTORY_FLUSH_MIN minutes old, so a reset loses at most that
+ * long plus one drain period of samples.  Samples are timestamped in seconds
+ * since the first boot that stored one: each boot continues one second after
+ * the newest stored sample, there being no real time clock.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Mount the store and start draining the sample ring
+ *
+ * @return 0 on success
+ * @return Negative errno if the store cannot be mounted, nothing is recorded
+ */
+int history_init(void);
+
+/**
+ * @brief Store timestamp of an uptime
+ *
+ * @param uptime_ms Uptime in ms, e.g. sample_ring_sample_t::timestamp_ms
+ * @return Timestamp in s as stored in the history
+ */
+uint32_t history_time_s(int64_t uptime_ms);
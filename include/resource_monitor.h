@@ -0,0 +1,86 @@
+/**
+ * @file resource_monitor.h
+ * @brief Periodic stack and CPU usage of every thread
+ *
+ * Every CONFIG_APP_RESOURCE_MONITOR_PERIOD_S the monitor walks the thread
+ * list from the system work queue and records the stack high-water mark of
+ * each thread and its share of the CPU over the last period.  A thread whose
+ * stack peak reaches CONFIG_APP_RESOURCE_MONITOR_STACK_PCT of its size is
+ * logged once, a thread other than idle whose share rises above
+ * CONFIG_APP_RESOURCE_MONITOR_CPU_PCT each time it does.  The last sample is
+ * read with resource_monitor_get() and sent as a RESOURCES telemetry record.
+ *
+ * The event slab is the only memory pool of the application, its peak use is
+ * in event_stats_t.  There is no heap.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/** Longest thread name kept, including the terminator */
+#define RESOURCE_MONITOR_NAME_LEN 12
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+
+/** Usage of a thread at the last sample */
+typedef struct resource_monitor_thread_s {
+  char name[RESOURCE_MONITOR_NAME_LEN]; ///< Truncated name, "?" if unnamed
+  uint32_t stack_size;                  ///< Stack size in bytes
+  uint32_t stack_peak;                  ///< Stack high-water mark in bytes
+  uint16_t cpu_permille;                ///< Share of the last period in 0.1 %
+  bool stack_warn;                      ///< Peak at or over the threshold
+  bool cpu_warn;                        ///< Share over the threshold
+} resource_monitor_thread_t;
+
+/** Monitor statistics */
+typedef struct resource_monitor_stats_s {
+  uint32_t samples;        ///< Samples taken
+  uint32_t stack_warnings; ///< Threads whose stack crossed the threshold
+  uint32_t cpu_warnings;   ///< Periods a thread went over the CPU threshold
+  uint32_t untracked;      ///< Threads of the last sample beyond the table
+} resource_monitor_stats_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Take a first sample and start the periodic sampling
+ */
+void resource_monitor_init(void);
+
+/**
+ * @brief Take a sample now
+ *
+ * Called by the periodic work item, or directly by a test without
+ * resource_monitor_init().  Not reentrant.
+ */
+void resource_monitor_sample(void);
+
+/**
+ * @brief Copy the last sample
+ *
+ * @param threads Array to store the usage of each thread
+ * @param max Length of threads
+ * @return Number of threads stored
+ */
+size_t resource_monitor_get(resource_monitor_thread_t *threads, size_t max);
+
+/**
+ * @brief Retrieve the monitor statistics
+ *
+ * @param stats Pointer to struct to store the statistics
+ */
+void resource_monitor_get_stats(resource_monitor_stats_t *stats);
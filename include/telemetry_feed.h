@@ -0,0 +1,72 @@
+/**
+ * @file telemetry_feed.h
+ * @brief Feed of the application data into the telemetry stream
+ *
+ * Sends the published DHT11 samples, the button events and periodic counters
+ * over the UART chosen as app,telemetry-uart, in the frames of telemetry.h.
+ * With CONFIG_APP_RESOURCE_MONITOR the last resource_monitor.h sample goes
+ * with the counters.  The samples are drained from sensor_sample_ring and the
+ * open frame is flushed every CONFIG_APP_TELEMETRY_FLUSH_MS from the system
+ * work queue, so a sample reaches the host within one flush period.  With
+ * CONFIG_APP_TELEMETRY_DERIVED each sample is followed by its derived metrics.
+ * The records are decoded by scripts/telemetry_decode.py.
+ *
+ * Record payloads, all little endian:
+ *
+ * | Type      | Payload                                                     |
+ * | --------- | ----------------------------------------------------------- |
+ * | SAMPLE    | Uptime in ms (4), instance (1), humidity and temperature in |
+ * |           | 0.1 units (2 + 2, signed)                                   |
+ * | EVENT     | event_type_t (1), event payload as posted, button_event_t   |
+ * |           | for the button events                                       |
+ * | COUNTERS  | telemetry_feed_counter_t values of 4 B each, in that order  |
+ * | RESOURCES | Per thread: stack size and peak in B (2 + 2), CPU share of  |
+ * |           | the last period in 0.1 % (2), name (12, zero padded)        |
+ * | DERIVED   | Uptime in ms (4), instance (1), dew point in 0.1 C (2,      |
+ * |           | signed), absolute humidity in 0.01 g/m3 (2), heat index in  |
+ * |           | 0.1 C (2, signed, -32768 above 50 C)                        |
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+
+/** Record types */
+typedef enum telemetry_feed_record_e {
+  TELEMETRY_FEED_SAMPLE = 1, ///< A published DHT11 sample
+  TELEMETRY_FEED_EVENT,      ///< A dispatched event
+  TELEMETRY_FEED_COUNTERS,   ///< Every CONFIG_APP_TELEMETRY_COUNTERS_S
+  TELEMETRY_FEED_RESOURCES,  ///< With the counters
+  TELEMETRY_FEED_DERIVED,    ///< After each sample, see derived.h
+} telemetry_feed_record_t;
+
+/** Fields of a COUNTERS record */
+typedef enum telemetry_feed_counter_e {
+  TELEMETRY_FEED_FRAMES = 0,      ///< Telemetry frames closed
+  TELEMETRY_FEED_FRAMES_DROPPED,  ///< Telemetry frames dropped
+  TELEMETRY_FEED_EVENTS_POSTED,   ///< Events accepted by the dispatcher
+  TELEMETRY_FEED_EVENTS_DROPPED,  ///< Events dropped by the dispatcher
+  TELEMETRY_FEED_DHT11_REQUESTS,  ///< DHT11 requests completed
+  TELEMETRY_FEED_DHT11_PUBLISHED, ///< DHT11 requests with a valid sample
+  TELEMETRY_FEED_DHT11_RETRIES,   ///< DHT11 attempts beyond the first
+  TELEMETRY_FEED_SAMPLES_OVERRUN, ///< Samples lost by the feed's ring reader
+  TELEMETRY_FEED_EVENT_POOL_PEAK, ///< Most event slab blocks used at once
+  TELEMETRY_FEED_COUNTER_MAX
+} telemetry_feed_counter_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Attach the stream to its UART and start the feed
+ *
+ * @return 0 on success
+ * @return Negative errno if the UART is unavailable, nothing is sent
+ */
+int telemetry_feed_init(void);
@@ -0,0 +1,28 @@
+# scripts/derived_tables.cmake
+#
+# Generation of derived_tables.h, the fixed-point tables of
+# src/components/derived.c, at build time.  Needs PYTHON_EXECUTABLE, which
+# Zephyr sets.
+
+set(DERIVED_TABLES_SCRIPT ${CMAKE_CURRENT_LIST_DIR}/derived_tables.py)
+
+# Make the tables available to the sources of each target given.  The header
+# is generated once per directory, however many targets use it.
+function(derived_tables_generate)
+  set(out_dir ${CMAKE_CURRENT_BINARY_DIR}/derived_tables)
+  set(out ${out_dir}/derived_tables.h)
+
+  if(NOT TARGET derived_tables)
+    add_custom_command(OUTPUT ${out}
+      COMMAND ${CMAKE_COMMAND} -E make_directory ${out_dir}
+      COMMAND ${PYTHON_EXECUTABLE} ${DERIVED_TABLES_SCRIPT} ${out}
+      DEPENDS ${DERIVED_TABLES_SCRIPT}
+      COMMENT "Generating derived_tables.h")
+    add_custom_target(derived_tables DEPENDS ${out})
+  endif()
+
+  foreach(target ${ARGN})
+    add_dependencies(${target} derived_tables)
+    target_include_directories(${target} PRIVATE ${out_dir})
+  endforeach()
+endfunction()
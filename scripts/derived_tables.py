@@ -0,0 +1,152 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: Apache-2.0
+"""Generate the fixed-point tables of the derived metrics.
+
+Writes the header included by src/components/derived.c.  The tables are
+sampled from the double-precision formulas below, which are also the
+reference the tests compare against, and are interpolated linearly at run
+time.  Run from the build through scripts/derived_tables.cmake:
+
+    scripts/derived_tables.py <build dir>/derived_tables.h
+"""
+
+import argparse
+import math
+
+# Magnus coefficients over water, Sonntag 1990
+MAGNUS_A_HPA = 6.112
+MAGNUS_B = 17.62
+MAGNUS_C = 243.12
+
+# Absolute humidity in g/m3 of a vapour pressure in hPa at a temperature in K,
+# 100 / R_w with R_w = 461.5 J/(kg K)
+AH_PER_HPA_K = 216.7
+KELVIN = 273.15
+
+# Whole degrees C covered by the tables sampled per degree, the range of every
+# model of dht11_model.h.  One node past the end so the last value
+# interpolates without a special case.
+T_MIN_C = -40
+T_MAX_C = 80
+
+# log() of the mantissa of the relative humidity, [0.5, 1) in LN_SEGMENTS
+LN_SEGMENTS = 32
+
+# Heat index regression grid, from below the lowest temperature at which the
+# regression is used to where it stops describing anything physical
+HI_T_MIN_C = 26
+HI_T_MAX_C = 50
+HI_RH_STEP = 5
+
+Q16 = 1 << 16
+Q15 = 1 << 15
+
+
+def saturation_hpa(t_c):
+    return MAGNUS_A_HPA * math.exp(MAGNUS_B * t_c / (MAGNUS_C + t_c))
+
+
+def magnus(t_c):
+    return MAGNUS_B * t_c / (MAGNUS_C + t_c)
+
+
+def saturation_ah(t_c):
+    """Absolute humidity at saturation in g/m3."""
+    return AH_PER_HPA_K * saturation_hpa(t_c) / (KELVIN + t_c)
+
+
+def rothfusz_f(t_f, rh):
+    """Heat index regression of the NWS in F, without its adjustments."""
+    return (-42.379 + 2.04901523 * t_f + 10.14333127 * rh
+            - 0.22475541 * t_f * rh - 6.83783e-3 * t_f * t_f
+            - 5.481717e-2 * rh * rh + 1.22874e-3 * t_f * t_f * rh
+            + 8.5282e-4 * t_f * rh * rh - 1.99e-6 * t_f * t_f * rh * rh)
+
+
+def dry_adjust(t_f):
+    """Square root factor of the NWS low humidity adjustment, 80 to 112 F."""
+    return math.sqrt((17 - abs(t_f - 95)) / 17)
+
+
+def c_to_f(t_c):
+    return t_c * 9 / 5 + 32
+
+
+def table(name, ctype, values, comment, per_line=8):
+    lines = [f'/** {comment} */', f'static const {ctype} {name}[] = {{']
+    for idx in range(0, len(values), per_line):
+        chunk = ', '.join(str(v) for v in values[idx:idx + per_line])
+        lines.append(f'    {chunk},')
+    lines.append('};')
+    return '\n'.join(lines)
+
+
+def generate():
+    # The regression takes over once the mean of the simple formula and the
+    # temperature reaches 80 F, which needs at least 78.9 F at 100 %
+    assert c_to_f(HI_T_MIN_C) < (170.3 - 0.047 * 100) / 2.1
+
+    t_nodes = range(T_MIN_C, T_MAX_C + 2)
+    ln = [round(math.log(0.5 + idx / (2 * LN_SEGMENTS)) * Q16)
+          for idx in range(LN_SEGMENTS + 1)]
+    magnus_q16 = [round(magnus(t) * Q16) for t in t_nodes]
+    ahs_mg = [round(saturation_ah(t) * 1000) for t in t_nodes]
+    hi_t = range(HI_T_MIN_C, HI_T_MAX_C + 2)
+    hi_rh = range(0, 100 + 2 * HI_RH_STEP, HI_RH_STEP)
+    hi_f_x10 = [round(rothfusz_f(c_to_f(t), rh) * 10)
+                for rh in hi_rh for t in hi_t]
+    dry_q15 = [round(dry_adjust(t_f) * Q15) for t_f in range(80, 113)]
+
+    out = [
+        '/* Generated by scripts/derived_tables.py, do not edit */',
+        '',
+        '#pragma once',
+        '',
+        '#include <stdint.h>',
+        '',
+        f'#define DERIVED_T_MIN_C ({T_MIN_C})',
+        f'#define DERIVED_T_MAX_C {T_MAX_C}',
+        f'#define DERIVED_LN_SEGMENTS {LN_SEGMENTS}',
+        f'#define DERIVED_LN2_Q16 {round(math.log(2) * Q16)}',
+        f'#define DERIVED_LN_1024_1000_Q16 {round(math.log(1.024) * Q16)}',
+        f'#define DERIVED_MAGNUS_B_Q16 {round(MAGNUS_B * Q16)}',
+        f'#define DERIVED_MAGNUS_C_X100 {round(MAGNUS_C * 100)}',
+        f'#define DERIVED_HI_T_MIN_C {HI_T_MIN_C}',
+        f'#define DERIVED_HI_T_MAX_C {HI_T_MAX_C}',
+        f'#define DERIVED_HI_T_NODES {len(hi_t)}',
+        f'#define DERIVED_HI_RH_STEP {HI_RH_STEP}',
+        '',
+        table('derived_ln_q16', 'int32_t', ln,
+              'log() of 0.5 to 1 in Q16, DERIVED_LN_SEGMENTS steps'),
+        '',
+        table('derived_magnus_q16', 'int32_t', magnus_q16,
+              'b T / (c + T) in Q16 per degree from DERIVED_T_MIN_C'),
+        '',
+        table('derived_ahs_mg', 'int32_t', ahs_mg,
+              'Absolute humidity at saturation in mg/m3 per degree from '
+              'DERIVED_T_MIN_C'),
+        '',
+        table('derived_hi_f_x10', 'int16_t', hi_f_x10,
+              'Heat index regression in 0.1 F, DERIVED_HI_T_NODES degrees '
+              'from\n * DERIVED_HI_T_MIN_C per DERIVED_HI_RH_STEP % of '
+              'humidity', per_line=len(hi_t) // 2),
+        '',
+        table('derived_dry_q15', 'uint16_t', dry_q15,
+              'Low humidity adjustment factor in Q15 per F from 80 F to '
+              '112 F'),
+        '',
+    ]
+    return '\n'.join(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('output', help='Header to write')
+    args = parser.parse_args()
+
+    with open(args.output, 'w', encoding='utf-8') as out:
+        out.write(generate())
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: Apache-2.0
+"""Decode dictionary log output from the application.
+
+Captures the binary log stream from a serial port, or reads a capture file,
+and expands it with the dictionary database of the build using Zephyr's
+dictionary log parser.  The COMMON_LOG_* colors are part of the format
+strings in the database, so they are restored as they would have been printed
+by the device.
+
+    scripts/log_decode.py build/zephyr/log_dictionary.json --serial /dev/ttyACM0
+    scripts/log_decode.py build/zephyr/log_dictionary.json capture.bin
+"""
+
+import argparse
+import os
+import subprocess
+import sys
+import tempfile
+import time
+
+
+def parser_path():
+    zephyr_base = os.environ.get('ZEPHYR_BASE')
+    if not zephyr_base:
+        sys.exit('ZEPHYR_BASE is not set')
+    return os.path.join(zephyr_base, 'scripts', 'logging', 'dictionary',
+                        'log_parser.py')
+
+
+def capture(port, baud, duration, path):
+    """Copy duration seconds of the serial stream to path."""
+    import serial
+
+    with serial.Serial(port, baud, timeout=0.1) as ser, open(path, 'wb') as f:
+        end = time.monotonic() + duration
+        while time.monotonic() < end:
+            f.write(ser.read(4096))
+
+
+def decode(database, path, hex_input):
+    cmd = [sys.executable, parser_path(), database, path]
+    if hex_input:
+        cmd.insert(2, '--hex')
+    return subprocess.call(cmd)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('database', help='log_dictionary.json of the build')
+    parser.add_argument('capture', nargs='?', help='captured log data')
+    parser.add_argument('--serial', help='serial port to capture from')
+    parser.add_argument('--baud', type=int, default=115200)
+    parser.add_argument('--duration', type=float, default=10.0,
+                        help='seconds to capture from the serial port')
+    parser.add_argument('--hex', action='store_true',
+                        help='input is hex encoded (..._DICTIONARY_HEX)')
+    args = parser.parse_args()
+
+    if bool(args.capture) == bool(args.serial):
+        parser.error('give either a capture file or --serial')
+
+    if args.capture:
+        return decode(args.database, args.capture, args.hex)
+
+    with tempfile.TemporaryDirectory() as tmp:
+        path = os.path.join(tmp, 'capture.bin')
+        capture(args.serial, args.baud, args.duration, path)
+        return decode(args.database, path, args.hex)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,103 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: Apache-2.0
+"""Compare the RAM or flash used by two builds of the application.
+
+Reports the size of every allocated section of the region and of the largest
+symbols in it for each ELF, followed by the difference.  For RAM the thread
+stacks are listed separately.  Flash covers code and read-only data, the load
+image of initialised data is not included.  Used by the ram_compare and
+flash_compare build targets:
+
+    west build -t ram_compare -- -DBASELINE_ELF=<baseline zephyr.elf>
+"""
+
+import argparse
+import sys
+
+from elftools.elf.constants import SH_FLAGS
+from elftools.elf.elffile import ELFFile
+from elftools.elf.sections import SymbolTableSection
+
+
+def region_sections(elf, flash):
+    """Allocated sections of the region, writable ones are RAM, by name."""
+    sections = {}
+    for section in elf.iter_sections():
+        flags = section['sh_flags']
+        if flags & SH_FLAGS.SHF_ALLOC and \
+                bool(flags & SH_FLAGS.SHF_WRITE) != flash:
+            sections[section.name] = section['sh_size']
+    return sections
+
+
+def region_symbols(elf, sections, flash):
+    """Sizes of the objects (and for flash functions) in sections."""
+    index = {elf.get_section(i).name: i for i in range(elf.num_sections())}
+    region_idx = {index[name] for name in sections}
+    types = ('STT_OBJECT', 'STT_FUNC') if flash else ('STT_OBJECT',)
+    symbols = {}
+    for section in elf.iter_sections():
+        if not isinstance(section, SymbolTableSection):
+            continue
+        for sym in section.iter_symbols():
+            if (sym['st_info']['type'] in types and sym['st_size']
+                    and sym['st_shndx'] in region_idx):
+                symbols[sym.name] = sym['st_size']
+    return symbols
+
+
+def load(path, flash):
+    with open(path, 'rb') as f:
+        elf = ELFFile(f)
+        sections = region_sections(elf, flash)
+        return sections, region_symbols(elf, sections, flash)
+
+
+def is_stack(name):
+    return 'stack' in name and 'stack_info' not in name
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('baseline', help='ELF of the baseline build')
+    parser.add_argument('current', help='ELF of the current build')
+    parser.add_argument('--top', type=int, default=20,
+                        help='number of symbol changes to list')
+    parser.add_argument('--flash', action='store_true',
+                        help='compare flash instead of RAM')
+    args = parser.parse_args()
+
+    base_sec, base_sym = load(args.baseline, args.flash)
+    cur_sec, cur_sym = load(args.current, args.flash)
+
+    print(f"{'Section':<32}{'Baseline':>10}{'Current':>10}{'Delta':>10}")
+    for name in sorted(set(base_sec) | set(cur_sec)):
+        old, new = base_sec.get(name, 0), cur_sec.get(name, 0)
+        print(f'{name:<32}{old:>10}{new:>10}{new - old:>+10}')
+    old, new = sum(base_sec.values()), sum(cur_sec.values())
+    print(f"{'Total':<32}{old:>10}{new:>10}{new - old:>+10}\n")
+
+    if not args.flash:
+        old = sum(v for k, v in base_sym.items() if is_stack(k))
+        new = sum(v for k, v in cur_sym.items() if is_stack(k))
+        print(f"{'Thread stacks':<32}{old:>10}{new:>10}{new - old:>+10}")
+        for name in sorted(k for k in set(base_sym) | set(cur_sym)
+                           if is_stack(k)):
+            old, new = base_sym.get(name, 0), cur_sym.get(name, 0)
+            print(f'  {name:<30}{old:>10}{new:>10}{new - old:>+10}')
+        print()
+
+    changes = [(cur_sym.get(k, 0) - base_sym.get(k, 0), k)
+               for k in set(base_sym) | set(cur_sym)]
+    changes = sorted((c for c in changes if c[0]), key=lambda c: abs(c[0]),
+                     reverse=True)
+    print('Largest symbol changes')
+    for delta, name in changes[:args.top]:
+        old, new = base_sym.get(name, 0), cur_sym.get(name, 0)
+        print(f'  {name:<30}{old:>10}{new:>10}{delta:>+10}')
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,219 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: Apache-2.0
+"""Decode the binary telemetry stream of the application.
+
+Reads the frames sent over the app,telemetry-uart UART from a serial port, a
+native_sim pty or a capture file.  Each frame is COBS decoded, checked
+against its CRC16 and split into records, see src/components/include/
+telemetry.h and include/telemetry_feed.h.  Frames lost on the way show up as
+gaps in the sequence numbers.
+
+    scripts/telemetry_decode.py --serial /dev/ttyUSB0 --baud 921600
+    scripts/telemetry_decode.py --serial /dev/pts/5 --stats
+    scripts/telemetry_decode.py capture.bin
+"""
+
+import argparse
+import struct
+import sys
+import time
+
+TELEMETRY_VERSION = 1
+HEADER = struct.Struct('<BHI')
+CRC_SEED = 0xFFFF
+
+REC_SAMPLE = 1
+REC_EVENT = 2
+REC_COUNTERS = 3
+REC_RESOURCES = 4
+REC_DERIVED = 5
+
+EVENT_NAMES = {1: 'button_1s', 2: 'button_pressed', 3: 'button_released',
+               4: 'button_gesture'}
+GESTURE_NAMES = ['short', 'long', 'double', 'repeat']
+COUNTER_NAMES = ['frames', 'frames_dropped', 'events_posted',
+                 'events_dropped', 'dht11_requests', 'dht11_published',
+                 'dht11_retries', 'samples_overrun', 'event_pool_peak']
+RESOURCE = struct.Struct('<HHH12s')
+
+
+def crc16_ccitt(data, crc=CRC_SEED):
+    """Zephyr's crc16_ccitt(), reflected polynomial 0x8408, no final xor."""
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = (crc >> 1) ^ 0x8408 if crc & 1 else crc >> 1
+    return crc
+
+
+def cobs_decode(data):
+    out = bytearray()
+    idx = 0
+    while idx < len(data):
+        code = data[idx]
+        idx += 1
+        if code == 0 or idx + code - 1 > len(data):
+            raise ValueError('bad COBS code')
+        out += data[idx:idx + code - 1]
+        idx += code - 1
+        if code != 0xFF and idx < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def parse_frame(encoded):
+    """Return (seq, uptime_ms, records) of a frame, raise ValueError if bad."""
+    frame = cobs_decode(encoded)
+    if len(frame) < HEADER.size + 2:
+        raise ValueError('short frame')
+    if crc16_ccitt(frame[:-2]) != struct.unpack_from('<H', frame, len(frame) - 2)[0]:
+        raise ValueError('CRC mismatch')
+    version, seq, uptime_ms = HEADER.unpack_from(frame)
+    if version != TELEMETRY_VERSION:
+        raise ValueError(f'unknown version {version}')
+
+    records = []
+    pos = HEADER.size
+    end = len(frame) - 2
+    while pos < end:
+        if pos + 2 > end or pos + 2 + frame[pos + 1] > end:
+            raise ValueError('truncated record')
+        rtype, rlen = frame[pos], frame[pos + 1]
+        records.append((rtype, frame[pos + 2:pos + 2 + rlen]))
+        pos += 2 + rlen
+    return seq, uptime_ms, records
+
+
+def format_record(rtype, payload):
+    if rtype == REC_SAMPLE and len(payload) == 9:
+        ts, inst, rh, temp = struct.unpack('<IBhh', payload)
+        return f'sample {ts} ms dht11_{inst} RH={rh / 10:.1f} % T={temp / 10:.1f} C'
+    if rtype == REC_DERIVED and len(payload) == 11:
+        ts, inst, dew, ah, hi = struct.unpack('<IBhHh', payload)
+        text = (f'derived {ts} ms dht11_{inst} dew point={dew / 10:.1f} C '
+                f'AH={ah / 100:.2f} g/m3')
+        return text + (f' HI={hi / 10:.1f} C' if hi != -32768 else '')
+    if rtype == REC_EVENT and payload:
+        name = EVENT_NAMES.get(payload[0], f'event {payload[0]}')
+        if len(payload) >= 7:
+            hold_ms, key, gesture = struct.unpack_from('<IBB', payload, 1)
+            text = f'{name} key {key} hold {hold_ms} ms'
+            if name == 'button_gesture' and gesture < len(GESTURE_NAMES):
+                text += f' {GESTURE_NAMES[gesture]}'
+            return text
+        return name
+    if rtype == REC_COUNTERS:
+        values = struct.unpack(f'<{len(payload) // 4}I', payload)
+        return 'counters ' + ' '.join(
+            f'{COUNTER_NAMES[i] if i < len(COUNTER_NAMES) else i}={v}'
+            for i, v in enumerate(values))
+    if rtype == REC_RESOURCES and len(payload) % RESOURCE.size == 0:
+        threads = []
+        for size, peak, cpu, name in RESOURCE.iter_unpack(payload):
+            name = name.rstrip(b'\0').decode(errors='replace')
+            threads.append(f'{name} stack {peak}/{size} B cpu {cpu / 10:.1f} %')
+        return 'resources ' + ', '.join(threads)
+    return f'record {rtype} {payload.hex()}'
+
+
+class Decoder:
+    """Splits a byte stream on zero delimiters and keeps stream statistics."""
+
+    def __init__(self, print_records):
+        self.print_records = print_records
+        self.buf = bytearray()
+        self.frames = 0
+        self.bytes = 0
+        self.errors = 0
+        self.lost = 0
+        self.next_seq = None
+
+    def feed(self, data):
+        self.buf += data
+        self.bytes += len(data)
+        while True:
+            end = self.buf.find(0)
+            if end < 0:
+                break
+            encoded = bytes(self.buf[:end])
+            del self.buf[:end + 1]
+            if encoded:
+                self.frame(encoded)
+
+    def frame(self, encoded):
+        try:
+            seq, uptime_ms, records = parse_frame(encoded)
+        except ValueError as err:
+            self.errors += 1
+            if self.print_records:
+                print(f'bad frame: {err}', file=sys.stderr)
+            return
+
+        # The first frame seen only sets the expected sequence number, and a
+        # jump backwards is a device reset rather than 64k lost frames
+        if self.next_seq is not None:
+            gap = (seq - self.next_seq) & 0xFFFF
+            if gap < 0x8000:
+                self.lost += gap
+        self.next_seq = (seq + 1) & 0xFFFF
+        self.frames += 1
+
+        if self.print_records:
+            for rtype, payload in records:
+                print(f'[{uptime_ms:10d}] #{seq:5d} {format_record(rtype, payload)}')
+
+
+def open_stream(args):
+    if args.capture:
+        return open(args.capture, 'rb')
+
+    import serial
+
+    return serial.Serial(args.serial, args.baud, timeout=0.1)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('capture', nargs='?', help='captured stream')
+    parser.add_argument('--serial', help='serial port or pty to read from')
+    parser.add_argument('--baud', type=int, default=921600)
+    parser.add_argument('--duration', type=float,
+                        help='seconds to read from the serial port')
+    parser.add_argument('--stats', action='store_true',
+                        help='print frames per second instead of records')
+    args = parser.parse_args()
+
+    if bool(args.capture) == bool(args.serial):
+        parser.error('give either a capture file or --serial')
+
+    decoder = Decoder(not args.stats)
+    start = last = time.monotonic()
+    last_frames = 0
+
+    with open_stream(args) as stream:
+        try:
+            while True:
+                data = stream.read(4096)
+                if not data and args.capture:
+                    break
+                decoder.feed(data)
+
+                now = time.monotonic()
+                if args.stats and now - last >= 1.0:
+                    print(f'{(decoder.frames - last_frames) / (now - last):8.1f} frames/s '
+                          f'{decoder.frames} frames {decoder.lost} lost '
+                          f'{decoder.errors} bad')
+                    last, last_frames = now, decoder.frames
+                if args.duration and now - start >= args.duration:
+                    break
+        except KeyboardInterrupt:
+            pass
+
+    elapsed = time.monotonic() - start
+    print(f'{decoder.frames} frames, {decoder.lost} lost, {decoder.errors} bad, '
+          f'{decoder.bytes} B in {elapsed:.1f} s', file=sys.stderr)
+    return 1 if decoder.errors else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
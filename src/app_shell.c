@@ -0,0 +1,284 @@
+/**
+ * @file app_shell.c
+ * @brief `app` shell commands
+ *
+ * Event and button counters are read without a lock.  The thread listings
+ * walk the thread list with k_thread_foreach_unlocked(), so the scheduler is
+ * only locked by the kernel for the individual runtime queries.
+ *
+ * Thread runtimes need CONFIG_THREAD_RUNTIME_STATS, stack high-water marks
+ * CONFIG_INIT_STACKS and CONFIG_THREAD_STACK_INFO, the hot path spans
+ * CONFIG_APP_TRACE.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+
+#include <string.h>
+
+#include <app_trace.h>
+#include <button_module.h>
+#include <event_module.h>
+#ifdef CONFIG_APP_TELEMETRY
+#include <telemetry.h>
+#endif
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+
+/** Context of a runtime listing */
+typedef struct runtime_walk_s {
+  const struct shell *sh;
+  uint64_t total_cycles; ///< Execution cycles of all threads
+} runtime_walk_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+/**
+ * @brief Print the runtime of one thread
+ *
+ * @param thread Thread to print
+ * @param user_data runtime_walk_t of the listing
+ */
+static void print_thread_runtime(const struct k_thread *thread,
+                                 void *user_data);
+#endif
+
+#if defined(CONFIG_INIT_STACKS) && defined(CONFIG_THREAD_STACK_INFO)
+/**
+ * @brief Print the stack usage of one thread
+ *
+ * @param thread Thread to print
+ * @param user_data Shell to print to
+ */
+static void print_thread_stack(const struct k_thread *thread,
+                               void *user_data);
+#endif
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+static const char *const event_names[EVENT_MAX] = {
+    [NO_EVENT] = "none",
+    [EVENT_BUTTON_1S] = "button_1s",
+    [EVENT_BUTTON_PRESSED] = "button_pressed",
+    [EVENT_BUTTON_RELEASED] = "button_released",
+    [EVENT_BUTTON_GESTURE] = "button_gesture",
+};
+
+static const char *const gesture_names[BUTTON_GESTURE_MAX] = {
+    [BUTTON_GESTURE_SHORT] = "short",
+    [BUTTON_GESTURE_LONG] = "long",
+    [BUTTON_GESTURE_DOUBLE] = "double",
+    [BUTTON_GESTURE_REPEAT] = "repeat",
+};
+
+/*******************************************************************************
+ * Function Definitions
+ ******************************************************************************/
+
+/** `app events`, dispatcher counters */
+static int cmd_app_events(const struct shell *sh, size_t argc, char **argv) {
+  event_stats_t stats;
+
+  event_module_get_stats(&stats);
+
+  shell_print(sh, "posted %u dropped %u dispatched %u", stats.posted,
+              stats.dropped, stats.dispatched);
+  shell_print(sh, "worst latency %u us",
+              k_cyc_to_us_ceil32(stats.max_latency_cycles));
+  shell_print(sh, "pool peak %u of %u", stats.pool_peak, EVENT_POOL_SIZE);
+
+  for (uint8_t type = NO_EVENT + 1; type < EVENT_MAX; type++) {
+    shell_print(sh, "  %-16s %u", event_names[type], stats.count[type]);
+  }
+
+  return 0;
+}
+
+/** `app buttons`, key counters and latencies */
+static int cmd_app_buttons(const struct shell *sh, size_t argc, char **argv) {
+  button_stats_t stats;
+
+  button_module_get_stats(&stats);
+
+  shell_print(sh, "%u key(s): edges %u presses %u releases %u holds %u",
+              button_module_key_count(), stats.edges, stats.presses,
+              stats.releases, stats.holds);
+  shell_print(sh, "edge to event latency: last %u us, worst %u us",
+              stats.last_latency_us, stats.max_latency_us);
+
+  for (uint8_t gesture = 0; gesture < BUTTON_GESTURE_MAX; gesture++) {
+    shell_print(sh, "  %-8s %u", gesture_names[gesture],
+                stats.gestures[gesture]);
+  }
+
+  return 0;
+}
+
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+// Described above
+static void print_thread_runtime(const struct k_thread *thread,
+                                 void *user_data) {
+  const runtime_walk_t *walk = user_data;
+  const char *name = k_thread_name_get((k_tid_t)thread);
+  k_thread_runtime_stats_t stats;
+
+  if (k_thread_runtime_stats_get((k_tid_t)thread, &stats)) {
+    return;
+  }
+
+  // Share in per mille to print one decimal without floating point
+  uint32_t permille =
+      walk->total_cycles
+          ? (uint32_t)(stats.execution_cycles * 1000 / walk->total_cycles)
+          : 0;
+
+  shell_print(walk->sh, "%-20s %3d %12llu us %3u.%u %%", name ? name : "?",
+              thread->base.prio,
+              k_cyc_to_us_floor64(stats.execution_cycles),
+              permille / 10, permille % 10);
+}
+#endif
+
+/** `app threads`, runtime of every thread since boot */
+static int cmd_app_threads(const struct shell *sh, size_t argc, char **argv) {
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+  runtime_walk_t walk = {.sh = sh};
+  k_thread_runtime_stats_t all;
+
+  if (k_thread_runtime_stats_all_get(&all)) {
+    return -EIO;
+  }
+  walk.total_cycles = all.execution_cycles;
+
+  shell_print(sh, "%-20s %3s %15s %7s", "thread", "pri", "runtime", "cpu");
+  k_thread_foreach_unlocked(print_thread_runtime, &walk);
+
+  return 0;
+#else
+  shell_error(sh, "Needs CONFIG_THREAD_RUNTIME_STATS");
+
+  return -ENOTSUP;
+#endif
+}
+
+#if defined(CONFIG_INIT_STACKS) && defined(CONFIG_THREAD_STACK_INFO)
+// Described above
+static void print_thread_stack(const struct k_thread *thread,
+                               void *user_data) {
+  const struct shell *sh = user_data;
+  const char *name = k_thread_name_get((k_tid_t)thread);
+  size_t size = thread->stack_info.size;
+  size_t unused;
+
+  if (k_thread_stack_space_get(thread, &unused)) {
+    return;
+  }
+
+  shell_print(sh, "%-20s %6zu %6zu %3zu %%", name ? name : "?", size,
+              size - unused, size ? (size - unused) * 100 / size : 0);
+}
+#endif
+
+/** `app stacks`, stack high-water mark of every thread */
+static int cmd_app_stacks(const struct shell *sh, size_t argc, char **argv) {
+#if defined(CONFIG_INIT_STACKS) && defined(CONFIG_THREAD_STACK_INFO)
+  shell_print(sh, "%-20s %6s %6s %5s", "thread", "size", "peak", "used");
+  k_thread_foreach_unlocked(print_thread_stack, (void *)sh);
+
+  return 0;
+#else
+  shell_error(sh, "Needs CONFIG_INIT_STACKS and CONFIG_THREAD_STACK_INFO");
+
+  return -ENOTSUP;
+#endif
+}
+
+/** `app trace [reset]`, hot path spans and the worst interrupt blackout */
+static int cmd_app_trace(const struct shell *sh, size_t argc, char **argv) {
+#ifdef CONFIG_APP_TRACE
+  app_trace_stats_t stats;
+  app_trace_span_t worst;
+
+  if (argc > 1) {
+    if (strcmp(argv[1], "reset")) {
+      shell_error(sh, "Unknown argument %s", argv[1]);
+      return -EINVAL;
+    }
+
+    app_trace_reset();
+    return 0;
+  }
+
+  for (uint8_t span = 0; span < APP_TRACE_SPAN_MAX; span++) {
+    app_trace_get(span, &stats);
+
+    shell_print(sh, "%s: %u spans, longest %u cycles (%u us)",
+                app_trace_name(span), stats.count, stats.max_cycles,
+                k_cyc_to_us_ceil32(stats.max_cycles));
+
+    // Bucket n holds the spans shorter than 2^n cycles not in bucket n - 1
+    for (uint8_t idx = 0; idx < APP_TRACE_BUCKETS; idx++) {
+      if (stats.buckets[idx]) {
+        shell_print(sh, "  < %10llu cycles %8u", BIT64(idx),
+                    stats.buckets[idx]);
+      }
+    }
+  }
+
+  uint32_t blackout = app_trace_blackout(&worst);
+
+  shell_print(sh, "worst interrupt blackout %u us, %s",
+              k_cyc_to_us_ceil32(blackout), app_trace_name(worst));
+
+  return 0;
+#else
+  shell_error(sh, "Needs CONFIG_APP_TRACE, see trace.conf");
+
+  return -ENOTSUP;
+#endif
+}
+
+/** `app telemetry`, telemetry stream counters */
+static int cmd_app_telemetry(const struct shell *sh, size_t argc,
+                             char **argv) {
+#ifdef CONFIG_APP_TELEMETRY
+  telemetry_stats_t stats;
+
+  telemetry_get_stats(&stats);
+
+  shell_print(sh, "records %u frames %u sent %u dropped %u", stats.records,
+              stats.frames, stats.frames_sent, stats.frames_dropped);
+  shell_print(sh, "bytes sent %u tx errors %u", stats.bytes_sent,
+              stats.tx_errors);
+
+  return 0;
+#else
+  shell_error(sh, "Needs CONFIG_APP_TELEMETRY, see telemetry.conf");
+
+  return -ENOTSUP;
+#endif
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(
+    sub_app,
+    SHELL_CMD(events, NULL, "Event dispatcher counters", cmd_app_events),
+    SHELL_CMD(buttons, NULL, "Button counters and latency", cmd_app_buttons),
+    SHELL_CMD(threads, NULL, "Thread runtimes", cmd_app_threads),
+    SHELL_CMD(stacks, NULL, "Stack high-water marks", cmd_app_stacks),
+    SHELL_CMD_ARG(trace, NULL, "Hot path span histograms [reset]",
+                  cmd_app_trace, 1, 1),
+    SHELL_CMD(telemetry, NULL, "Telemetry stream counters",
+              cmd_app_telemetry),
+    SHELL_SUBCMD_SET_END);
+
+SHELL_CMD_REGISTER(app, &sub_app, "Application diagnostics", NULL);
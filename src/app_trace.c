@@ -0,0 +1,132 @@
+/**
+ * @file app_trace.c
+ * @brief Cycle counter tracing of the hot paths
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <zephyr/kernel.h>
+#ifdef CONFIG_TRACING
+#include <zephyr/tracing/tracing.h>
+#endif
+
+#include <errno.h>
+
+#include <app_trace.h>
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+
+/** Record of one span, atomic so it can be updated from any context */
+typedef struct trace_record_s {
+  atomic_t count;
+  atomic_t max_cycles;
+  atomic_t buckets[APP_TRACE_BUCKETS];
+} trace_record_t;
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+/** Span names, at most 20 characters to fit a CTF named event */
+static const char *const span_names[APP_TRACE_SPAN_MAX] = {
+    [APP_TRACE_DHT11_IRQ_LOCK] = "dht11_irq_lock",
+    [APP_TRACE_DHT11_EDGE_ISR] = "dht11_edge_isr",
+    [APP_TRACE_DHT11_DECODE] = "dht11_decode",
+    [APP_TRACE_BUTTON_ISR] = "button_isr",
+    [APP_TRACE_BUTTON_LATENCY] = "button_latency",
+};
+
+/** Spans during which interrupts are held off */
+static const app_trace_span_t blackout_spans[] = {
+    APP_TRACE_DHT11_IRQ_LOCK,
+    APP_TRACE_DHT11_EDGE_ISR,
+    APP_TRACE_BUTTON_ISR,
+};
+
+static trace_record_t records[APP_TRACE_SPAN_MAX];
+
+/*******************************************************************************
+ * Function Definitions
+ ******************************************************************************/
+
+// Described in .h
+void app_trace_record(app_trace_span_t span, uint32_t cycles) {
+  trace_record_t *record = &records[span];
+  atomic_val_t max;
+
+  // Bucket n holds [2^(n-1), 2^n)
+  atomic_inc(&record->buckets[cycles ? 32 - __builtin_clz(cycles) : 0]);
+  atomic_inc(&record->count);
+
+  // Spans end in interrupts as well as threads, so the maximum needs a CAS
+  do {
+    max = atomic_get(&record->max_cycles);
+    if (cycles <= (uint32_t)max) {
+      break;
+    }
+  } while (!atomic_cas(&record->max_cycles, max, (atomic_val_t)cycles));
+
+#ifdef CONFIG_TRACING
+  sys_trace_named_event(span_names[span], cycles,
+                        k_cyc_to_us_floor32(cycles));
+#endif
+}
+
+// Described in .h
+int app_trace_get(app_trace_span_t span, app_trace_stats_t *stats) {
+  if (span >= APP_TRACE_SPAN_MAX) {
+    return -EINVAL;
+  }
+
+  const trace_record_t *record = &records[span];
+
+  stats->count = atomic_get(&record->count);
+  stats->max_cycles = atomic_get(&record->max_cycles);
+  for (uint8_t idx = 0; idx < APP_TRACE_BUCKETS; idx++) {
+    stats->buckets[idx] = atomic_get(&record->buckets[idx]);
+  }
+
+  return 0;
+}
+
+// Described in .h
+const char *app_trace_name(app_trace_span_t span) {
+  return span < APP_TRACE_SPAN_MAX ? span_names[span] : "?";
+}
+
+// Described in .h
+uint32_t app_trace_blackout(app_trace_span_t *span) {
+  app_trace_span_t worst_span = blackout_spans[0];
+  uint32_t worst = 0;
+
+  for (uint8_t idx = 0; idx < ARRAY_SIZE(blackout_spans); idx++) {
+    uint32_t cycles = atomic_get(&records[blackout_spans[idx]].max_cycles);
+
+    if (cycles > worst) {
+      worst = cycles;
+      worst_span = blackout_spans[idx];
+    }
+  }
+
+  if (span) {
+    *span = worst_span;
+  }
+
+  return worst;
+}
+
+// Described in .h
+void app_trace_reset(void) {
+  for (uint8_t span = 0; span < APP_TRACE_SPAN_MAX; span++) {
+    trace_record_t *record = &records[span];
+
+    atomic_clear(&record->count);
+    atomic_clear(&record->max_cycles);
+    for (uint8_t idx = 0; idx < APP_TRACE_BUCKETS; idx++) {
+      atomic_clear(&record->buckets[idx]);
+    }
+  }
+}
@@ -2,65 +2,145 @@
  * @file button_module.c
  * @brief
  *
+ * Each key is debounced without polling.  Every edge interrupt restarts the
+ * key's debounce timeout; once the line has been stable for the key's
+ * debounce time the timeout samples it and feeds it to the gesture state
+ * machine of key_fsm.c.  A second timeout per key tracks the long press,
+ * repeat and double click windows.  Both live in the shared timer wheel, so
+ * the state machines run from the wheel tick and nothing runs while every key
+ * is idle.
+ *
  * @copyright Copyright (c) 2025
  *
  */
 
 #include "include/button_module.h"
+#include <zephyr/devicetree.h>
 #include <zephyr/drivers/gpio.h>
 #include <zephyr/kernel.h>
-#include <zephyr/kernel/thread_stack.h>
 #include <zephyr/logging/log.h>
 
 #include <stdbool.h>
 
+#include <app_trace.h>
+#include <event_module.h>
+#include <timer_wheel.h>
+
 LOG_MODULE_REGISTER(btn_mod, 3);
 
 /*******************************************************************************
  * Definitions
  ******************************************************************************/
 
-/* size of stack area used by each thread */
-#define STACKSIZE 256
+/** Key container node, keys are its children */
+#define KEYS_NODE DT_COMPAT_GET_ANY_STATUS_OKAY(custom_input_keys)
 
-/* scheduling priority used by each thread */
-#define PRIORITY 7
-
-/** User button node ID */
+/** User button node ID, used when there is no key container */
 #define USER_BTN DT_ALIAS(sw0)
 
+/** Timing used for the sw0 fallback, matching the binding defaults */
 #define DEBOUNCE_TIME_MS 20
-
 #define BTN_HOLD_TIME_MS 1000
+#define DOUBLE_CLICK_TIME_MS 300
+#define REPEAT_INTERVAL_MS 200
 
-/* Check to see if the button is available */
-#if !DT_NODE_HAS_STATUS_OKAY(USER_BTN)
-#error "Unsupported board: sw0 devicetree alias is not defined"
+/* Check to see if any key is available */
+#if !DT_NODE_EXISTS(KEYS_NODE) && !DT_NODE_HAS_STATUS_OKAY(USER_BTN)
+#error "Unsupported board: no custom,input-keys node and no sw0 alias"
 #endif
 
-/** Define a memory region for the DHT11 thread stack */
-K_THREAD_STACK_DEFINE(btn_thread_stack, STACKSIZE);
+/** Build the configuration of one key from its devicetree node */
+#define KEY_CFG_INIT(node)                                                     \
+  {                                                                            \
+      .gpio = GPIO_DT_SPEC_GET(node, gpios),                                   \
+      .debounce_ms = DT_PROP(node, debounce_ms),                               \
+      .timing =                                                                \
+          {                                                                    \
+              .long_press_ms = DT_PROP(node, long_press_ms),                   \
+              .double_click_ms = DT_PROP(node, double_click_ms),               \
+              .repeat_delay_ms = DT_PROP(node, repeat_delay_ms),               \
+              .repeat_interval_ms = DT_PROP(node, repeat_interval_ms),         \
+          },                                                                   \
+  },
+
+/** Number of keys */
+#define NUM_KEYS ARRAY_SIZE(key_cfgs)
 
 /*******************************************************************************
  * Type Definitions
  ******************************************************************************/
+
+/** Static configuration of a key */
+typedef struct key_cfg_s {
+  struct gpio_dt_spec gpio;
+  uint16_t debounce_ms;
+  key_fsm_timing_t timing;
+} key_cfg_t;
+
+/** Run time state of a key */
+typedef struct button_key_s {
+  const key_cfg_t *cfg;
+  struct gpio_callback cb;
+  timer_wheel_entry_t debounce; ///< Restarted by every edge
+  timer_wheel_entry_t gesture;  ///< Long press, repeat or double click window
+  key_fsm_t fsm;                ///< Debounced and gesture state
+  bool edge_pending;            ///< True while first_edge_cycles is valid
+  uint32_t first_edge_cycles;   ///< First edge since the last debounced change
+  uint32_t press_cycles;        ///< Cycle count of the last press
+  uint8_t idx;
+} button_key_t;
+
 /*******************************************************************************
  * Function Prototypes
  ******************************************************************************/
 
-/** Function called when the task is launched */
-static void button_task();
+/** Edge ISR for a key, restarts its debounce timeout */
+static void button_isr(const struct device *dev, struct gpio_callback *cb,
+                       uint32_t pins);
+
+/** Samples a key once it has been stable for its debounce time */
+static void debounce_expired(timer_wheel_entry_t *entry);
+
+/** Advances the gesture state machine when its window closes */
+static void gesture_expired(timer_wheel_entry_t *entry);
+
+/** Post the events of a state machine step and rearm the gesture timeout */
+static void apply_output(button_key_t *key, const key_fsm_out_t *out);
+
+/** Post an event carrying a button_event_t for the key */
+static void post_event(button_key_t *key, event_type_t type,
+                       button_gesture_t gesture);
+
+/** Record the latency from the first edge of a change to its event */
+static void record_latency(button_key_t *key);
 
 /*******************************************************************************
  * Variables
  ******************************************************************************/
 
-/** User button spec based on the DT description */
-static const struct gpio_dt_spec button =
-    GPIO_DT_SPEC_GET_OR(USER_BTN, gpios, {0});
+/** Key specs based on the DT description */
+#if DT_NODE_EXISTS(KEYS_NODE)
+static const key_cfg_t key_cfgs[] = {
+    DT_FOREACH_CHILD_STATUS_OKAY(KEYS_NODE, KEY_CFG_INIT)};
+#else
+static const key_cfg_t key_cfgs[] = {{
+    .gpio = GPIO_DT_SPEC_GET(USER_BTN, gpios),
+    .debounce_ms = DEBOUNCE_TIME_MS,
+    .timing =
+        {
+            .long_press_ms = BTN_HOLD_TIME_MS,
+            .double_click_ms = DOUBLE_CLICK_TIME_MS,
+            .repeat_delay_ms = 0,
+            .repeat_interval_ms = REPEAT_INTERVAL_MS,
+        },
+}};
+#endif
+
+BUILD_ASSERT(ARRAY_SIZE(key_cfgs) <= UINT8_MAX, "Too many keys");
+
+static button_key_t keys[NUM_KEYS];
 
-/**  DHT11 thread structure */
-static struct k_thread button_thread;
+static button_stats_t stats;
 
 /*******************************************************************************
  * Function Definitions
@@ -68,76 +148,162 @@ static struct k_thread button_thread;
 
 // Described in .h
 int8_t button_module_init() {
-  if (!gpio_is_ready_dt(&button)) {
-    LOG_ERR("Button is not ready");
-    return -1;
-  }
+  for (uint8_t idx = 0; idx < NUM_KEYS; idx++) {
+    button_key_t *key = &keys[idx];
+    const struct gpio_dt_spec *gpio = &key_cfgs[idx].gpio;
+
+    key->cfg = &key_cfgs[idx];
+    key->idx = idx;
+    key_fsm_init(&key->fsm);
+    timer_wheel_init_entry(&key->debounce, debounce_expired);
+    timer_wheel_init_entry(&key->gesture, gesture_expired);
+
+    if (!gpio_is_ready_dt(gpio)) {
+      LOG_ERR("Key %d is not ready", idx);
+      return -1;
+    }
+
+    if (gpio_pin_configure_dt(gpio, GPIO_INPUT)) {
+      return -1;
+    }
 
-  if (gpio_pin_interrupt_configure_dt(&button, GPIO_INT_EDGE_BOTH)) {
-    return -1;
+    gpio_init_callback(&key->cb, button_isr, BIT(gpio->pin));
+    if (gpio_add_callback_dt(gpio, &key->cb)) {
+      return -1;
+    }
+
+    if (gpio_pin_interrupt_configure_dt(gpio, GPIO_INT_EDGE_BOTH)) {
+      return -1;
+    }
   }
 
-  // Create and start the DHT11 acquisition thread
-  k_tid_t button_thread_id = k_thread_create(
-      &button_thread, btn_thread_stack, K_THREAD_STACK_SIZEOF(btn_thread_stack),
-      button_task, NULL, NULL, NULL, 7, 0, K_NO_WAIT);
+  LOG_INF("%d key(s) configured", (int)NUM_KEYS);
 
   return 0;
 }
 
-static void button_task() {
-  uint8_t current_button_state = 0;
-  uint8_t previous_button_state = 0;
+// Described in .h
+uint8_t button_module_key_count() { return NUM_KEYS; }
+
+// Described in .h
+void button_module_get_stats(button_stats_t *out) {
+  // Every field is a single word, a torn copy can only mix two updates
+  *out = stats;
+}
+
+// Described above
+static void button_isr(const struct device *dev, struct gpio_callback *cb,
+                       uint32_t pins) {
+  uint32_t isr_start = APP_TRACE_START();
+  button_key_t *key = CONTAINER_OF(cb, button_key_t, cb);
+
+  if (!key->edge_pending) {
+    key->first_edge_cycles = k_cycle_get_32();
+    key->edge_pending = true;
+  }
+  stats.edges++;
+
+  // Each bounce pushes the sample point out again
+  timer_wheel_start(&key->debounce, key->cfg->debounce_ms);
 
-  enum BUTTON_STATE {
-    BUTTON_STATE_INACTIVE,
-    BUTTON_STATE_PRESSED,
-    BUTTON_STATE_RELEASED,
-    BUTTON_STATE_MAX,
+  APP_TRACE_END(BUTTON_ISR, isr_start);
+}
+
+// Described above
+static void record_latency(button_key_t *key) {
+  unsigned int lock = irq_lock();
+
+  if (key->edge_pending) {
+    stats.last_latency_us =
+        k_cyc_to_us_ceil32(k_cycle_get_32() - key->first_edge_cycles);
+    stats.max_latency_us = MAX(stats.max_latency_us, stats.last_latency_us);
+    key->edge_pending = false;
+    APP_TRACE_END(BUTTON_LATENCY, key->first_edge_cycles);
+  }
+
+  irq_unlock(lock);
+}
+
+// Described above
+static void post_event(button_key_t *key, event_type_t type,
+                       button_gesture_t gesture) {
+  button_event_t evt = {
+      .hold_ms = 0,
+      .key = key->idx,
+      .gesture = gesture,
   };
 
-  enum BUTTON_STATE btn_state = BUTTON_STATE_INACTIVE;
+  if (type != EVENT_BUTTON_PRESSED) {
+    evt.hold_ms = k_cyc_to_ms_ceil32(k_cycle_get_32() - key->press_cycles);
+  }
 
-  uint32_t cnt_start = 0;
+  if (type == EVENT_BUTTON_GESTURE) {
+    stats.gestures[gesture]++;
+  }
 
-  uint32_t btn_timer_start = 0;
+  event_module_post(type, &evt, sizeof(evt));
+}
 
-  while (1) {
-    current_button_state = gpio_pin_get_dt(&button);
+// Described above
+static void debounce_expired(timer_wheel_entry_t *entry) {
+  button_key_t *key = CONTAINER_OF(entry, button_key_t, debounce);
+  bool pressed = gpio_pin_get_dt(&key->cfg->gpio) > 0;
+  key_fsm_out_t out;
 
-    if (current_button_state != previous_button_state) {
-      if (!cnt_start) {
-        cnt_start = k_cycle_get_32();
-      } else if (k_cyc_to_ms_ceil32(k_cycle_get_32() - cnt_start) >=
-                 DEBOUNCE_TIME_MS) {
-        previous_button_state = current_button_state;
-        cnt_start = 0;
+  // Bounced back to the state we already reported
+  if (!key_fsm_sample(&key->fsm, &key->cfg->timing, pressed, &out)) {
+    // Same lock as record_latency(), the ISR tests and sets the flag
+    unsigned int lock = irq_lock();
 
-        LOG_INF("New button state is %d", current_button_state);
+    key->edge_pending = false;
+    irq_unlock(lock);
+    return;
+  }
 
-        if (current_button_state) // BUTTON PRESSED
-        {
-          // Start the timer on press
-          btn_timer_start = k_cycle_get_32();
-        } else // BUTTON RELEASED
-        {
-          uint32_t stop_time = k_cycle_get_32();
-          if (k_cyc_to_ms_ceil32(stop_time - btn_timer_start) >=
-              BTN_HOLD_TIME_MS) {
-            LOG_INF("Button hold time was exceeded.  Hold time is %d",
-                    k_cyc_to_ms_ceil32(stop_time - btn_timer_start));
-          }
-          btn_timer_start = 0;
-        }
-
-        // Make sure to reset the debounce timer once the event has been
-        // processed
-        cnt_start = 0;
-      }
-    } else {
-      cnt_start = 0;
-    }
+  LOG_DBG("Key %d state is %d", key->idx, pressed);
+
+  if (pressed) {
+    key->press_cycles = k_cycle_get_32();
+    stats.presses++;
+  } else {
+    stats.releases++;
+  }
+
+  apply_output(key, &out);
+  record_latency(key);
+}
+
+// Described above
+static void gesture_expired(timer_wheel_entry_t *entry) {
+  button_key_t *key = CONTAINER_OF(entry, button_key_t, gesture);
+  key_fsm_out_t out;
+
+  key_fsm_expired(&key->fsm, &key->cfg->timing, &out);
+  apply_output(key, &out);
+}
+
+// Described above
+static void apply_output(button_key_t *key, const key_fsm_out_t *out) {
+  if (out->press) {
+    post_event(key, EVENT_BUTTON_PRESSED, BUTTON_GESTURE_MAX);
+  }
+
+  if (out->release) {
+    post_event(key, EVENT_BUTTON_RELEASED, BUTTON_GESTURE_MAX);
+  }
+
+  if (out->hold) {
+    stats.holds++;
+    post_event(key, EVENT_BUTTON_1S, BUTTON_GESTURE_LONG);
+  }
+
+  if (out->gesture != BUTTON_GESTURE_MAX) {
+    post_event(key, EVENT_BUTTON_GESTURE, out->gesture);
+  }
 
-    k_msleep(1);
+  if (out->timer_ms == KEY_FSM_TIMER_STOP) {
+    timer_wheel_stop(&key->gesture);
+  } else if (out->timer_ms != KEY_FSM_TIMER_KEEP) {
+    timer_wheel_start(&key->gesture, out->timer_ms);
   }
 }
@@ -0,0 +1,91 @@
+/**
+ * @file cobs.c
+ * @brief Consistent overhead byte stuffing
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <errno.h>
+
+#include <cobs.h>
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/** Code of a full run of 254 non-zero bytes not followed by a zero */
+#define COBS_RUN_MAX 0xFF
+
+/*******************************************************************************
+ * Function Definitions
+ ******************************************************************************/
+
+// Described in .h
+int cobs_encode(const uint8_t *src, size_t len, uint8_t *dst, size_t size) {
+  size_t code_pos = 0;
+  size_t out = 1;
+  uint8_t code = 1;
+
+  if (size == 0) {
+    return -ENOMEM;
+  }
+
+  for (size_t idx = 0; idx < len; idx++) {
+    if (src[idx] != 0) {
+      if (out >= size) {
+        return -ENOMEM;
+      }
+      dst[out++] = src[idx];
+      code++;
+    }
+
+    // A zero closes the run, and so does a full run with more input to come
+    if (src[idx] == 0 || (code == COBS_RUN_MAX && idx + 1 < len)) {
+      if (out >= size) {
+        return -ENOMEM;
+      }
+      dst[code_pos] = code;
+      code_pos = out++;
+      code = 1;
+    }
+  }
+
+  dst[code_pos] = code;
+
+  return (int)out;
+}
+
+// Described in .h
+int cobs_decode(const uint8_t *src, size_t len, uint8_t *dst, size_t size) {
+  size_t idx = 0;
+  size_t out = 0;
+
+  while (idx < len) {
+    uint8_t code = src[idx++];
+
+    if (code == 0 || idx + code - 1 > len) {
+      return -EINVAL;
+    }
+
+    for (uint8_t run = 1; run < code; run++) {
+      if (src[idx] == 0) {
+        return -EINVAL;
+      }
+      if (out >= size) {
+        return -ENOMEM;
+      }
+      dst[out++] = src[idx++];
+    }
+
+    // Every run but a full one and the last stands for a zero
+    if (code != COBS_RUN_MAX && idx < len) {
+      if (out >= size) {
+        return -ENOMEM;
+      }
+      dst[out++] = 0;
+    }
+  }
+
+  return (int)out;
+}
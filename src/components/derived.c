@@ -0,0 +1,239 @@
+/**
+ * @file derived.c
+ * @brief Dew point, absolute humidity and heat index of a sample
+ *
+ * Temperatures are handled in 0.01 F for the heat index so the conversion
+ * from 0.1 C is exact, every other quantity in the units of its table.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <errno.h>
+
+#include <derived.h>
+#include <derived_tables.h>
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/** Range of the sample accepted, in 0.1 units */
+#define RH_X10_MAX 1000
+#define T_X10_MIN (DERIVED_T_MIN_C * 10)
+#define T_X10_MAX (DERIVED_T_MAX_C * 10)
+
+/** Humidity in 0.1 % is normalised by shifts to [512, 1024) */
+#define LN_MANTISSA_MIN 512
+
+/** Mantissa units per segment of derived_ln_q16 */
+#define LN_SEGMENT (LN_MANTISSA_MIN / DERIVED_LN_SEGMENTS)
+
+/** Humidity in 0.1 % per row of derived_hi_f_x10 */
+#define HI_RH_STEP_X10 (DERIVED_HI_RH_STEP * 10)
+
+/** Mean of the simple formula and the temperature above which the regression
+ * is used, in 0.01 F */
+#define HI_REGRESSION_F_X100 8000
+
+/** Low humidity adjustment, below 13 % from 80 F to 112 F */
+#define HI_DRY_RH_X10 130
+#define HI_DRY_T_MIN_F_X100 8000
+#define HI_DRY_T_MAX_F_X100 11200
+
+/** Segments of derived_dry_q15, one per F */
+#define HI_DRY_SEGMENTS ((HI_DRY_T_MAX_F_X100 - HI_DRY_T_MIN_F_X100) / 100)
+
+/** High humidity adjustment, above 85 % from 80 F to 87 F */
+#define HI_WET_RH_X10 850
+#define HI_WET_T_MIN_F_X100 8000
+#define HI_WET_T_MAX_F_X100 8700
+
+/** One in Q15 */
+#define Q15_ONE (1 << 15)
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Division rounded to the nearest integer
+ *
+ * @param num Numerator
+ * @param den Denominator, positive
+ * @return num / den rounded half away from zero
+ */
+static int32_t div_round(int64_t num, int64_t den);
+
+/**
+ * @brief Linear interpolation of a table sampled per degree from
+ * DERIVED_T_MIN_C
+ *
+ * @param table Table to interpolate
+ * @param t_x10 Temperature in 0.1 C, within the range of the table
+ * @return Interpolated value in the units of the table
+ */
+static int32_t interp_t(const int32_t *table, int16_t t_x10);
+
+/**
+ * @brief Natural logarithm of the relative humidity as a fraction
+ *
+ * @param rh_x10 Relative humidity in 0.1 %, 1 to 1000
+ * @return log(rh_x10 / 1000) in Q16
+ */
+static int32_t ln_rh_q16(int16_t rh_x10);
+
+/**
+ * @brief Heat index
+ *
+ * @param sample Sample within the range of the tables
+ * @return Heat index in 0.1 C or DERIVED_NONE
+ */
+static int16_t heat_index_x10(const dht11_sample_t *sample);
+
+/*******************************************************************************
+ * Function Definitions
+ ******************************************************************************/
+
+// Described above
+static int32_t div_round(int64_t num, int64_t den) {
+  return (int32_t)((num < 0 ? num - den / 2 : num + den / 2) / den);
+}
+
+// Described above
+static int32_t interp_t(const int32_t *table, int16_t t_x10) {
+  int32_t pos = t_x10 - T_X10_MIN;
+  int32_t idx = pos / 10;
+  int32_t frac = pos % 10;
+
+  return table[idx] +
+         div_round((int64_t)(table[idx + 1] - table[idx]) * frac, 10);
+}
+
+// Described above
+static int32_t ln_rh_q16(int16_t rh_x10) {
+  int32_t mantissa = rh_x10;
+  int32_t shifts = 0;
+
+  while (mantissa < LN_MANTISSA_MIN) {
+    mantissa <<= 1;
+    shifts++;
+  }
+
+  int32_t idx = (mantissa - LN_MANTISSA_MIN) / LN_SEGMENT;
+  int32_t frac = (mantissa - LN_MANTISSA_MIN) % LN_SEGMENT;
+  int32_t ln = derived_ln_q16[idx] +
+               div_round((int64_t)(derived_ln_q16[idx + 1] -
+                                   derived_ln_q16[idx]) *
+                             frac,
+                         LN_SEGMENT);
+
+  // rh_x10 / 1000 = mantissa / 1024 * 1024 / 1000 / 2^shifts
+  return ln + DERIVED_LN_1024_1000_Q16 - shifts * DERIVED_LN2_Q16;
+}
+
+// Described above
+static int16_t heat_index_x10(const dht11_sample_t *sample) {
+  int32_t t_f = sample->t_x10 * 18 + 3200;
+  int32_t rh = sample->rh_x10;
+  // 0.5 (T + 61 + 1.2 (T - 68) + 0.094 RH) in 0.0001 F, exact
+  int32_t simple = 50 * t_f + 305000 + 60 * (t_f - 6800) + 47 * rh;
+  int32_t hi = div_round(simple, 100);
+
+  // Compared before rounding, the heat index jumps where the regression
+  // takes over
+  if (simple + 100 * t_f >= 200 * HI_REGRESSION_F_X100) {
+    if (sample->t_x10 > DERIVED_HI_T_MAX_C * 10) {
+      return DERIVED_NONE;
+    }
+
+    // Bilinear interpolation of the regression, rows are humidities
+    int32_t t_pos = sample->t_x10 - DERIVED_HI_T_MIN_C * 10;
+    int32_t ti = t_pos / 10;
+    int32_t tf = t_pos % 10;
+    int32_t ri = rh / HI_RH_STEP_X10;
+    int32_t rf = rh % HI_RH_STEP_X10;
+    const int16_t *row = &derived_hi_f_x10[ri * DERIVED_HI_T_NODES + ti];
+    const int16_t *next = row + DERIVED_HI_T_NODES;
+    int64_t sum = (int64_t)row[0] * (10 - tf) * (HI_RH_STEP_X10 - rf) +
+                  (int64_t)row[1] * tf * (HI_RH_STEP_X10 - rf) +
+                  (int64_t)next[0] * (10 - tf) * rf +
+                  (int64_t)next[1] * tf * rf;
+
+    // Weights add up to 10 * HI_RH_STEP_X10, the table is in 0.1 F
+    hi = div_round(sum * 10, 10 * HI_RH_STEP_X10);
+
+    if (rh < HI_DRY_RH_X10 && t_f >= HI_DRY_T_MIN_F_X100 &&
+        t_f <= HI_DRY_T_MAX_F_X100) {
+      // (13 - RH) / 4 * sqrt((17 - |T - 95|) / 17), the root from the table
+      int32_t pos = t_f - HI_DRY_T_MIN_F_X100;
+      int32_t idx =
+          pos / 100 < HI_DRY_SEGMENTS ? pos / 100 : HI_DRY_SEGMENTS - 1;
+      int32_t frac = pos - idx * 100;
+      int32_t root = derived_dry_q15[idx] +
+                     div_round((int64_t)(derived_dry_q15[idx + 1] -
+                                         derived_dry_q15[idx]) *
+                                   frac,
+                               100);
+
+      hi -= div_round((int64_t)(HI_DRY_RH_X10 - rh) * 5 * root, 2 * Q15_ONE);
+    } else if (rh > HI_WET_RH_X10 && t_f >= HI_WET_T_MIN_F_X100 &&
+               t_f <= HI_WET_T_MAX_F_X100) {
+      // (RH - 85) / 10 * (87 - T) / 5
+      hi += div_round((int64_t)(rh - HI_WET_RH_X10) *
+                          (HI_WET_T_MAX_F_X100 - t_f),
+                      500);
+    }
+  }
+
+  return (int16_t)div_round((int64_t)(hi - 3200) * 5, 90);
+}
+
+// Described in .h
+int derived_compute(const dht11_sample_t *sample, derived_metrics_t *metrics) {
+  if (sample->rh_x10 <= 0) {
+    return -EDOM;
+  }
+
+  if (sample->rh_x10 > RH_X10_MAX || sample->t_x10 < T_X10_MIN ||
+      sample->t_x10 > T_X10_MAX) {
+    return -ERANGE;
+  }
+
+  // Magnus: g = ln(RH) + b T / (c + T), Td = c g / (b - g)
+  int32_t gamma =
+      ln_rh_q16(sample->rh_x10) + interp_t(derived_magnus_q16, sample->t_x10);
+
+  metrics->dew_point_x10 = (int16_t)div_round(
+      (int64_t)DERIVED_MAGNUS_C_X100 * gamma,
+      10 * ((int64_t)DERIVED_MAGNUS_B_Q16 - gamma));
+
+  // Saturation value in mg/m3 times RH in 0.1 %, to 0.01 g/m3
+  metrics->abs_humidity_x100 = (uint16_t)div_round(
+      (int64_t)interp_t(derived_ahs_mg, sample->t_x10) * sample->rh_x10,
+      10000);
+
+  metrics->heat_index_x10 = heat_index_x10(sample);
+
+  return 0;
+}
+
+// Described in .h
+int derived_cache_get(derived_cache_t *cache, uint32_t seq,
+                      const dht11_sample_t *sample,
+                      derived_metrics_t *metrics) {
+  if (cache->valid && cache->seq == seq) {
+    cache->hits++;
+  } else {
+    cache->err = derived_compute(sample, &cache->metrics);
+    cache->seq = seq;
+    cache->valid = true;
+    cache->computed++;
+  }
+
+  if (!cache->err) {
+    *metrics = cache->metrics;
+  }
+
+  return cache->err;
+}
@@ -6,34 +6,128 @@
  *
  */
 
-#include <event_module.h>
+#include <zephyr/kernel.h>
 
-/*******************************************************************************
- * Definitions
- ******************************************************************************/
-
-/*******************************************************************************
- * Type Definitions
- ******************************************************************************/
+#include <event_module.h>
 
 /*******************************************************************************
  * Function Prototypes
  ******************************************************************************/
 
+/**
+ * @brief Deliver every queued event to its subscribers
+ *
+ * @param work Pointer to dispatch_work
+ */
+static void dispatch_work_handler(struct k_work *work);
+
 /*******************************************************************************
  * Variables
  ******************************************************************************/
 
-static struct k_event event_obj;
+K_MEM_SLAB_DEFINE_STATIC(event_slab, sizeof(event_node_t), EVENT_POOL_SIZE, 4);
+
+static K_WORK_DEFINE(dispatch_work, dispatch_work_handler);
+
+/** Subscribers placed by EVENT_HANDLER_DEFINE() */
+STRUCT_SECTION_START_EXTERN(event_subscriber);
+
+/** Protects the pending queues */
+static struct k_spinlock event_lock;
+
+/** Queued events */
+static event_queue_t pending;
+
+/** Dispatcher statistics, atomic so they are read without event_lock */
+static struct {
+  atomic_t posted;
+  atomic_t dropped;
+  atomic_t dispatched;
+  atomic_t count[EVENT_MAX];
+  atomic_t max_latency_cycles;
+  atomic_t pool_peak;
+} stats;
 
 /*******************************************************************************
  * Function Definitions
  ******************************************************************************/
 
-void event_module_init() { k_event_init(&event_obj); }
+// Described in .h
+void event_module_init() {
+  event_queue_init(&pending);
+}
+
+// Described in .h
+int event_module_post(event_type_t type, const void *payload, size_t len) {
+  event_node_t *node;
 
-struct k_event *const event_module_get_event_object() { return &event_obj; }
+  if (!event_queue_valid(type, payload, len)) {
+    return -EINVAL;
+  }
+
+  if (k_mem_slab_alloc(&event_slab, (void **)&node, K_NO_WAIT)) {
+    atomic_inc(&stats.dropped);
+    return -ENOMEM;
+  }
+
+  event_queue_fill(node, type, payload, len, k_cycle_get_32());
+
+  K_SPINLOCK(&event_lock) {
+    uint32_t used = k_mem_slab_num_used_get(&event_slab);
+
+    event_queue_push(&pending, node);
+
+    // Raised under event_lock, no compare and swap needed
+    if (used > (uint32_t)atomic_get(&stats.pool_peak)) {
+      atomic_set(&stats.pool_peak, used);
+    }
+  }
+  atomic_inc(&stats.posted);
+
+  k_work_submit(&dispatch_work);
+
+  return 0;
+}
+
+// Described above
+static void dispatch_work_handler(struct k_work *work) {
+  int num_subs;
+
+  STRUCT_SECTION_COUNT(event_subscriber, &num_subs);
+
+  while (1) {
+    event_node_t *node;
+
+    K_SPINLOCK(&event_lock) { node = event_queue_pop(&pending); }
+
+    if (!node) {
+      return;
+    }
+
+    uint32_t latency = k_cycle_get_32() - node->evt.post_cycles;
+
+    event_queue_route(&node->evt, STRUCT_SECTION_START(event_subscriber),
+                      num_subs);
+
+    // Only the dispatcher writes the maximum, no compare and swap needed
+    atomic_inc(&stats.dispatched);
+    atomic_inc(&stats.count[node->evt.type]);
+    if (latency > (uint32_t)atomic_get(&stats.max_latency_cycles)) {
+      atomic_set(&stats.max_latency_cycles, latency);
+    }
+
+    k_mem_slab_free(&event_slab, node);
+  }
+}
 
-uint32_t event_module_wait_on_event(uint32_t wait_ms) {
-  return k_event_wait(&event_obj, 0xFFF, false, K_MSEC(wait_ms));
+// Described in .h
+void event_module_get_stats(event_stats_t *out) {
+  out->posted = atomic_get(&stats.posted);
+  out->dropped = atomic_get(&stats.dropped);
+  out->dispatched = atomic_get(&stats.dispatched);
+  for (uint8_t type = 0; type < EVENT_MAX; type++) {
+    out->count[type] = atomic_get(&stats.count[type]);
+  }
+  out->max_latency_cycles = atomic_get(&stats.max_latency_cycles);
+  out->pool_peak = atomic_get(&stats.pool_peak);
 }
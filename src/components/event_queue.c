@@ -0,0 +1,101 @@
+/**
+ * @file event_queue.c
+ * @brief
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <string.h>
+
+#include <event_queue.h>
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+/** Priority of each event type */
+static const event_priority_t event_priority[EVENT_MAX] = {
+    [NO_EVENT] = EVENT_PRIORITY_LOW,
+    [EVENT_BUTTON_1S] = EVENT_PRIORITY_HIGH,
+    [EVENT_BUTTON_PRESSED] = EVENT_PRIORITY_HIGH,
+    [EVENT_BUTTON_RELEASED] = EVENT_PRIORITY_HIGH,
+    [EVENT_BUTTON_GESTURE] = EVENT_PRIORITY_NORMAL,
+};
+
+/*******************************************************************************
+ * Function Definitions
+ ******************************************************************************/
+
+// Described in .h
+void event_queue_init(event_queue_t *queue) {
+  for (uint8_t prio = 0; prio < EVENT_PRIORITY_MAX; prio++) {
+    queue->head[prio] = NULL;
+    queue->tail[prio] = NULL;
+  }
+}
+
+// Described in .h
+bool event_queue_valid(event_type_t type, const void *payload, size_t len) {
+  return type > NO_EVENT && type < EVENT_MAX && len <= EVENT_PAYLOAD_SIZE &&
+         (!len || payload);
+}
+
+// Described in .h
+void event_queue_fill(event_node_t *node, event_type_t type,
+                      const void *payload, size_t len, uint32_t post_cycles) {
+  node->evt.type = type;
+  node->evt.len = len;
+  if (len) {
+    memcpy(node->evt.payload, payload, len);
+  }
+  node->evt.post_cycles = post_cycles;
+}
+
+// Described in .h
+void event_queue_push(event_queue_t *queue, event_node_t *node) {
+  event_priority_t prio = event_priority[node->evt.type];
+
+  node->next = NULL;
+  if (queue->tail[prio]) {
+    queue->tail[prio]->next = node;
+  } else {
+    queue->head[prio] = node;
+  }
+  queue->tail[prio] = node;
+}
+
+// Described in .h
+event_node_t *event_queue_pop(event_queue_t *queue) {
+  // Always take the highest priority event first so a burst of low priority
+  // events cannot delay a high priority one by more than a single dispatch
+  for (uint8_t prio = 0; prio < EVENT_PRIORITY_MAX; prio++) {
+    event_node_t *node = queue->head[prio];
+
+    if (node) {
+      queue->head[prio] = node->next;
+      if (!node->next) {
+        queue->tail[prio] = NULL;
+      }
+      return node;
+    }
+  }
+
+  return NULL;
+}
+
+// Described in .h
+uint32_t event_queue_route(const event_t *evt,
+                           const struct event_subscriber *subs,
+                           size_t num_subs) {
+  uint32_t called = 0;
+
+  for (size_t idx = 0; idx < num_subs; idx++) {
+    if (subs[idx].type == evt->type) {
+      subs[idx].handler(evt);
+      called++;
+    }
+  }
+
+  return called;
+}
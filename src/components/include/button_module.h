@@ -2,6 +2,12 @@
  * @file button_module.h
  * @brief
  *
+ * Keys are taken from the children of a "custom,input-keys" devicetree node,
+ * or from the sw0 alias when there is none.  Every key is debounced from its
+ * edge interrupt and run through a gesture state machine.  All debounce and
+ * gesture timeouts share the timer wheel, so no thread or timer is needed per
+ * key.
+ *
  * @copyright Copyright (c) 2025
  *
  */
@@ -10,14 +16,62 @@
 
 #include <stdint.h>
 
+#include <key_fsm.h>
+
 /*******************************************************************************
  * Definitions
  ******************************************************************************/
 /*******************************************************************************
  * Type Definitions
  ******************************************************************************/
+
+/** Payload of every button event */
+typedef struct button_event_s {
+  uint32_t hold_ms; ///< Time since the press, 0 for EVENT_BUTTON_PRESSED
+  uint8_t key;      ///< Index of the key in devicetree order
+  uint8_t gesture;  ///< button_gesture_t, only for EVENT_BUTTON_GESTURE
+} button_event_t;
+
+/** Button statistics, summed over all keys */
+typedef struct button_stats_s {
+  uint32_t edges;    ///< Edge interrupts taken
+  uint32_t presses;  ///< Debounced presses
+  uint32_t releases; ///< Debounced releases
+  uint32_t holds;    ///< Presses held past the long press time
+  /** Gestures reported per type */
+  uint32_t gestures[BUTTON_GESTURE_MAX];
+  uint32_t last_latency_us; ///< First edge to event post of the last change
+  uint32_t max_latency_us;  ///< Worst first edge to event post latency
+} button_stats_t;
+
 /*******************************************************************************
  * Function Prototypes
  ******************************************************************************/
 
-int8_t button_module_init();
\ No newline at end of file
+/**
+ * @brief Configure the keys and their edge interrupts
+ *
+ * Press and release are posted to the event module as EVENT_BUTTON_PRESSED
+ * and EVENT_BUTTON_RELEASED, a long press also as EVENT_BUTTON_1S, and every
+ * gesture as EVENT_BUTTON_GESTURE.  All carry a button_event_t.
+ *
+ * @return 0 on success, -1 on failure
+ */
+int8_t button_module_init();
+
+/**
+ * @brief Number of keys handled by the module
+ *
+ * @return Key count
+ */
+uint8_t button_module_key_count();
+
+/**
+ * @brief Retrieve the button statistics
+ *
+ * Lock free, so reading them never delays an edge interrupt.  An edge taken
+ * meanwhile may be counted in some fields and not yet in others.
+ *
+ * @param stats Pointer to struct to store the statistics
+ */
+void button_module_get_stats(button_stats_t *stats);
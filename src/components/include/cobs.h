@@ -0,0 +1,62 @@
+/**
+ * @file cobs.h
+ * @brief Consistent overhead byte stuffing
+ *
+ * COBS removes every zero byte from a block so a single zero can delimit
+ * frames on a byte stream.  Each run of up to 254 non-zero bytes is prefixed
+ * with a code byte giving the offset of the next zero, which costs one byte
+ * per 254 bytes of input at most.  A receiver that joins mid stream or loses
+ * bytes resynchronises at the next zero.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/**
+ * @brief Largest encoding of a block, without the delimiter
+ *
+ * @param len Length of the block
+ */
+#define COBS_MAX_ENCODED_SIZE(len) ((len) + (len) / 254 + 1)
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Encode a block
+ *
+ * The zero delimiter is not appended.
+ *
+ * @param src Block to encode
+ * @param len Length of the block
+ * @param dst Buffer for the encoding, must not overlap src
+ * @param size Size of dst, COBS_MAX_ENCODED_SIZE(len) is always enough
+ *
+ * @return Length of the encoding
+ * @return -ENOMEM if dst is too small
+ */
+int cobs_encode(const uint8_t *src, size_t len, uint8_t *dst, size_t size);
+
+/**
+ * @brief Decode a block
+ *
+ * @param src Encoding without the delimiter
+ * @param len Length of the encoding
+ * @param dst Buffer for the block, may be src to decode in place
+ * @param size Size of dst, len - 1 is always enough
+ *
+ * @return Length of the block
+ * @return -EINVAL if the encoding holds a zero or a code past its end
+ * @return -ENOMEM if dst is too small
+ */
+int cobs_decode(const uint8_t *src, size_t len, uint8_t *dst, size_t size);
@@ -0,0 +1,96 @@
+/**
+ * @file derived.h
+ * @brief Dew point, absolute humidity and heat index of a sample
+ *
+ * The metrics are computed in fixed point from tables generated at build time
+ * by scripts/derived_tables.py, with linear interpolation in between:
+ *
+ * * Dew point: Magnus formula over water.  log() of the humidity comes from a
+ *   table of the mantissa once the humidity is normalised by shifts, the
+ *   temperature term from a table per degree.  The last step is one integer
+ *   division.
+ * * Absolute humidity: a table of the value at saturation per degree, scaled
+ *   by the relative humidity.
+ * * Heat index: the algorithm of the US National Weather Service.  The
+ *   simple formula is linear and computed directly.  Where the Rothfusz
+ *   regression takes over, it comes from a table per degree and per 5 % of
+ *   humidity, and its two adjustments are added on top.
+ *
+ * Nothing is computed as samples are published.  A subscriber asks for the
+ * metrics of a sample through a derived_cache_t, which computes them the
+ * first time a sample sequence number is asked for and returns the same
+ * result to every later request for it.
+ *
+ * Nothing in here depends on Zephyr, it builds for the host as well.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <dht11_model.h>
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/** derived_metrics_t heat_index_x10 above 50 C, where the regression no
+ * longer describes anything physical */
+#define DERIVED_NONE INT16_MIN
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+
+/** Metrics derived from a sample */
+typedef struct derived_metrics_s {
+  int16_t dew_point_x10;      ///< Dew point in 0.1 C
+  uint16_t abs_humidity_x100; ///< Absolute humidity in 0.01 g/m3
+  int16_t heat_index_x10;     ///< Heat index in 0.1 C or DERIVED_NONE
+} derived_metrics_t;
+
+/** Metrics of the last sample asked for, see derived_cache_get() */
+typedef struct derived_cache_s {
+  bool valid;                ///< False until the first request
+  uint32_t seq;              ///< Sequence number of the cached sample
+  int err;                   ///< Result of derived_compute() for it
+  derived_metrics_t metrics; ///< Metrics of the sample, if err is 0
+  uint32_t computed;         ///< Requests that computed the metrics
+  uint32_t hits;             ///< Requests answered from the cache
+} derived_cache_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Compute the metrics of a sample
+ *
+ * @param sample Converted reading, any model
+ * @param metrics Pointer to store the metrics, only valid on success
+ *
+ * @return 0 on success
+ * @return -EDOM if the humidity is 0 or below, which has no dew point
+ * @return -ERANGE if the humidity is above 100 % or the temperature outside
+ * -40 C to 80 C
+ */
+int derived_compute(const dht11_sample_t *sample, derived_metrics_t *metrics);
+
+/**
+ * @brief Metrics of a sample, computed on the first request for it
+ *
+ * Not thread safe, the caller serialises the requests on a shared cache.
+ *
+ * @param cache Cache shared by the subscribers
+ * @param seq Sequence number of the sample, e.g. sample_ring_sample_t::seq
+ * @param sample Sample numbered seq
+ * @param metrics Pointer to store the metrics, only valid on success
+ *
+ * @return As derived_compute()
+ */
+int derived_cache_get(derived_cache_t *cache, uint32_t seq,
+                      const dht11_sample_t *sample, derived_metrics_t *metrics);
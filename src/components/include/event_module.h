@@ -1,31 +1,93 @@
 /**
  * @file event_module.h
- * @brief
+ * @brief Typed publish/subscribe event dispatcher
+ *
+ * Modules post typed events carrying a small payload.  Handlers subscribe at
+ * link time with EVENT_HANDLER_DEFINE() which places them in an iterable
+ * section, so there is no run time registration.  Posting copies the payload
+ * into a block from a memory slab and queues it by the priority of its type.
+ * Events are dispatched, highest priority first, from the system work queue.
+ * Types, queueing and routing live in event_queue.h.
+ * Posting never blocks and is allowed from ISRs.
  *
  * @copyright Copyright (c) 2025
  *
  */
 
+#pragma once
+
 #include <zephyr/kernel.h>
+#include <zephyr/sys/iterable_sections.h>
 
-#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include <event_queue.h>
 
 /*******************************************************************************
  * Definitions
  ******************************************************************************/
 
-#define NO_EVENT 0x0
-#define EVENT_BUTTON_1S 0x1
+/** Number of events that can be pending at once */
+#define EVENT_POOL_SIZE 16
+
+/**
+ * @brief Subscribe a handler to an event type
+ *
+ * The handler runs on the system work queue and must not block.
+ *
+ * @param name Unique name of the subscription
+ * @param evt_type event_type_t to subscribe to
+ * @param fn Handler of type event_handler_t
+ */
+#define EVENT_HANDLER_DEFINE(name, evt_type, fn)                               \
+  static const STRUCT_SECTION_ITERABLE(event_subscriber, name) = {            \
+      .type = evt_type,                                                        \
+      .handler = fn,                                                           \
+  }
+
 /*******************************************************************************
  * Type Definitions
  ******************************************************************************/
 
+/** Dispatcher statistics */
+typedef struct event_stats_s {
+  uint32_t posted;             ///< Events accepted
+  uint32_t dropped;            ///< Events dropped for lack of a slab block
+  uint32_t dispatched;         ///< Events delivered to their handlers
+  uint32_t count[EVENT_MAX];   ///< Events dispatched per type
+  uint32_t max_latency_cycles; ///< Worst post to dispatch latency
+  uint32_t pool_peak;          ///< Most slab blocks used at once
+} event_stats_t;
+
 /*******************************************************************************
  * Function Prototypes
  ******************************************************************************/
 
+/**
+ * @brief Initialise the pending queues
+ */
 void event_module_init();
 
-struct k_event *const event_module_get_event_object();
+/**
+ * @brief Post an event
+ *
+ * @param type Type of the event
+ * @param payload Data copied into the event, may be NULL if len is 0
+ * @param len Payload length, at most EVENT_PAYLOAD_SIZE
+ *
+ * @return 0 on success
+ * @return -EINVAL on an invalid type or payload
+ * @return -ENOMEM if the event pool is exhausted, the event is dropped
+ */
+int event_module_post(event_type_t type, const void *payload, size_t len);
 
-uint32_t event_module_wait_on_event(uint32_t wait_ms);
\ No newline at end of file
+/**
+ * @brief Retrieve the dispatcher statistics
+ *
+ * Lock free.  An event dispatched meanwhile may be counted in some fields and
+ * not yet in others.
+ *
+ * @param stats Pointer to struct to store the statistics
+ */
+void event_module_get_stats(event_stats_t *stats);
@@ -0,0 +1,138 @@
+/**
+ * @file event_queue.h
+ * @brief Event types, priority queues and routing of the event module
+ *
+ * Queues events in one FIFO per priority and routes a dequeued event to the
+ * subscribers of its type.  Nothing in here allocates, locks or depends on
+ * Zephyr: event_module.c takes the nodes from a memory slab, guards the queue
+ * with a spinlock and routes over the link time subscriber section.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/** Largest payload carried by an event in bytes */
+#define EVENT_PAYLOAD_SIZE 16
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+
+/** Event types */
+typedef enum event_type_e {
+  NO_EVENT = 0,
+  EVENT_BUTTON_1S,       ///< Key held for its long press time (1 s default)
+  EVENT_BUTTON_PRESSED,  ///< Debounced key press
+  EVENT_BUTTON_RELEASED, ///< Debounced key release
+  EVENT_BUTTON_GESTURE,  ///< Short/long press, double click or repeat
+  EVENT_MAX
+} event_type_t;
+
+/** Dispatch priorities, lower values are dispatched first */
+typedef enum event_priority_e {
+  EVENT_PRIORITY_HIGH = 0,
+  EVENT_PRIORITY_NORMAL,
+  EVENT_PRIORITY_LOW,
+  EVENT_PRIORITY_MAX
+} event_priority_t;
+
+/** An event as delivered to handlers */
+typedef struct event_s {
+  event_type_t type;    ///< Type of the event
+  uint32_t post_cycles; ///< k_cycle_get_32() when the event was posted
+  uint8_t len;          ///< Number of valid bytes in payload
+  uint8_t payload[EVENT_PAYLOAD_SIZE]
+      __attribute__((__aligned__(4))); ///< Event specific data
+} event_t;
+
+/** Event handler, the event is only valid for the duration of the call */
+typedef void (*event_handler_t)(const event_t *evt);
+
+/** Link time subscription, see EVENT_HANDLER_DEFINE() */
+struct event_subscriber {
+  event_type_t type;
+  event_handler_t handler;
+};
+
+/** A queued event, owned by the caller while it is not queued */
+typedef struct event_node_s {
+  struct event_node_s *next;
+  event_t evt;
+} event_node_t;
+
+/** Pending events, one FIFO per priority */
+typedef struct event_queue_s {
+  event_node_t *head[EVENT_PRIORITY_MAX];
+  event_node_t *tail[EVENT_PRIORITY_MAX];
+} event_queue_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Empty a queue
+ *
+ * @param queue Queue to initialise
+ */
+void event_queue_init(event_queue_t *queue);
+
+/**
+ * @brief Check the arguments of a post
+ *
+ * @param type Type of the event
+ * @param payload Data of the event, may be NULL if len is 0
+ * @param len Payload length
+ * @return True if the event can be posted
+ */
+bool event_queue_valid(event_type_t type, const void *payload, size_t len);
+
+/**
+ * @brief Fill in a node from valid post arguments
+ *
+ * @param node Node to fill in
+ * @param type Type of the event
+ * @param payload Data copied into the event, may be NULL if len is 0
+ * @param len Payload length, at most EVENT_PAYLOAD_SIZE
+ * @param post_cycles Time stamp of the post
+ */
+void event_queue_fill(event_node_t *node, event_type_t type,
+                      const void *payload, size_t len, uint32_t post_cycles);
+
+/**
+ * @brief Queue an event behind those of the same priority
+ *
+ * @param queue Queue
+ * @param node Filled in node
+ */
+void event_queue_push(event_queue_t *queue, event_node_t *node);
+
+/**
+ * @brief Dequeue the oldest event of the highest priority
+ *
+ * @param queue Queue
+ * @return Dequeued node or NULL if the queue is empty
+ */
+event_node_t *event_queue_pop(event_queue_t *queue);
+
+/**
+ * @brief Deliver an event to the subscribers of its type
+ *
+ * @param evt Event to deliver
+ * @param subs Array of subscribers
+ * @param num_subs Number of subscribers
+ * @return Number of handlers called
+ */
+uint32_t event_queue_route(const event_t *evt,
+                           const struct event_subscriber *subs,
+                           size_t num_subs);
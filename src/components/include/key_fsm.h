@@ -0,0 +1,110 @@
+/**
+ * @file key_fsm.h
+ * @brief Debounce and gesture state machine of a key
+ *
+ * The state machine only sees debounced samples of the key and the expiry of
+ * its gesture timeout.  It tells the caller which events to post and how to
+ * rearm the timeout, so it holds no timers and calls no kernel API.  The
+ * button module drives it from the timer wheel, the host build from a test or
+ * benchmark.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/** key_fsm_out_t timer_ms value leaving the gesture timeout as it is */
+#define KEY_FSM_TIMER_KEEP (-1)
+
+/** key_fsm_out_t timer_ms value stopping the gesture timeout */
+#define KEY_FSM_TIMER_STOP (-2)
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+
+/** Gestures reported with EVENT_BUTTON_GESTURE */
+typedef enum button_gesture_e {
+  BUTTON_GESTURE_SHORT = 0, ///< Press released before the long press time
+  BUTTON_GESTURE_LONG,      ///< Held for the long press time
+  BUTTON_GESTURE_DOUBLE,    ///< Second press within the double click window
+  BUTTON_GESTURE_REPEAT,    ///< Still held after the repeat delay/interval
+  BUTTON_GESTURE_MAX
+} button_gesture_t;
+
+/** Gesture state of a key */
+typedef enum key_fsm_state_e {
+  KEY_IDLE = 0,       ///< Released, no gesture in progress
+  KEY_PRESSED,        ///< Pressed, waiting for the long press time
+  KEY_HELD,           ///< Held past the long press time, maybe repeating
+  KEY_WAIT_DOUBLE,    ///< Released after a short press, waiting for another
+  KEY_PRESSED_DOUBLE, ///< Second press of a double click, waiting for release
+} key_fsm_state_t;
+
+/** Gesture timing of a key, 0 disables the double click and repeat */
+typedef struct key_fsm_timing_s {
+  uint16_t long_press_ms;
+  uint16_t double_click_ms;
+  uint16_t repeat_delay_ms;
+  uint16_t repeat_interval_ms;
+} key_fsm_timing_t;
+
+/** State of a key */
+typedef struct key_fsm_s {
+  key_fsm_state_t state;
+  bool pressed; ///< Debounced state
+} key_fsm_t;
+
+/**
+ * @brief Result of a step, post the events in field order
+ */
+typedef struct key_fsm_out_s {
+  bool press;               ///< Post EVENT_BUTTON_PRESSED
+  bool release;             ///< Post EVENT_BUTTON_RELEASED
+  bool hold;                ///< Post EVENT_BUTTON_1S
+  button_gesture_t gesture; ///< Gesture to post, BUTTON_GESTURE_MAX for none
+  int32_t timer_ms; ///< Gesture timeout to start, or KEY_FSM_TIMER_KEEP/STOP
+} key_fsm_out_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Reset a key to released and idle
+ *
+ * @param fsm Key to reset
+ */
+void key_fsm_init(key_fsm_t *fsm);
+
+/**
+ * @brief Feed a sample taken once the key was stable for its debounce time
+ *
+ * @param fsm Key
+ * @param timing Gesture timing of the key
+ * @param pressed Sampled state
+ * @param out Set to the events to post and the timeout to arm
+ * @return True if the sample changed the debounced state
+ * @return False if the key bounced back to the state already reported, out is
+ * left untouched
+ */
+bool key_fsm_sample(key_fsm_t *fsm, const key_fsm_timing_t *timing,
+                    bool pressed, key_fsm_out_t *out);
+
+/**
+ * @brief Advance a key when its gesture timeout expires
+ *
+ * @param fsm Key
+ * @param timing Gesture timing of the key
+ * @param out Set to the events to post and the timeout to arm
+ */
+void key_fsm_expired(key_fsm_t *fsm, const key_fsm_timing_t *timing,
+                     key_fsm_out_t *out);
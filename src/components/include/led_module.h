@@ -0,0 +1,111 @@
+/**
+ * @file led_module.h
+ * @brief LED pattern sequencer
+ *
+ * Every LED runs a background pattern (off, on, blink, blink code or
+ * breathing) with an optional one-shot flash drawn on top of it.  All LEDs
+ * are driven from a single one-shot k_timer set to the next change of any
+ * LED, which only ticks every LED_PWM_TICK_MS while an LED is breathing and
+ * stops when every LED is static, so signalling needs no thread or stack.
+ * Breathing is rendered with software PWM on the LED GPIO.  All functions may
+ * be called from any context, including ISRs.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/** Timer period while an LED is breathing, one software PWM step */
+#define LED_PWM_TICK_MS 1
+
+/** Brightness steps of the software PWM, one frame is this many PWM ticks */
+#define LED_PWM_LEVELS 10
+
+/** On and off time of a single pulse of a blink code */
+#define LED_CODE_PULSE_MS 200
+
+/** Pause after the last pulse of a blink code */
+#define LED_CODE_PAUSE_MS 1000
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+
+/** LEDs driven by the module, taken from the led0 and led2 aliases */
+typedef enum led_id_e {
+  LED_GREEN = 0,
+  LED_RED,
+  LED_MAX
+} led_id_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Configure the LED GPIOs, all LEDs start off
+ *
+ * @return 0 on success, -1 on failure
+ */
+int8_t led_module_init();
+
+/**
+ * @brief Switch an LED permanently on or off
+ *
+ * @param led LED to set
+ * @param on True to switch the LED on
+ *
+ * @return 0 on success, -EINVAL on an invalid LED
+ */
+int led_module_set(led_id_t led, bool on);
+
+/**
+ * @brief Blink an LED continuously
+ *
+ * @param led LED to blink
+ * @param on_ms Time on per period
+ * @param off_ms Time off per period
+ *
+ * @return 0 on success, -EINVAL on an invalid LED or a zero period
+ */
+int led_module_blink(led_id_t led, uint16_t on_ms, uint16_t off_ms);
+
+/**
+ * @brief Repeat a blink code: count pulses followed by a pause
+ *
+ * @param led LED to blink
+ * @param count Number of pulses, 1 or more
+ *
+ * @return 0 on success, -EINVAL on an invalid LED or count
+ */
+int led_module_blink_code(led_id_t led, uint8_t count);
+
+/**
+ * @brief Fade an LED up and down continuously
+ *
+ * @param led LED to breathe
+ * @param period_ms Time for one full fade up and down
+ *
+ * @return 0 on success, -EINVAL on an invalid LED or period
+ */
+int led_module_breathe(led_id_t led, uint16_t period_ms);
+
+/**
+ * @brief Switch an LED on once for a while, then resume its pattern
+ *
+ * A flash requested while another is showing restarts it.
+ *
+ * @param led LED to flash
+ * @param on_ms Time on
+ *
+ * @return 0 on success, -EINVAL on an invalid LED
+ */
+int led_module_flash(led_id_t led, uint16_t on_ms);
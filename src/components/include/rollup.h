@@ -0,0 +1,146 @@
+/**
+ * @file rollup.h
+ * @brief Multi-resolution min/max/average rollups of sensor samples
+ *
+ * A rollup keeps ROLLUP_TIERS tiers of fixed width buckets: by default the
+ * last hour in minutes, the last day in hours and the last month in days.
+ * Each bucket holds the sample count, minimum, maximum and sum of the
+ * humidity and the temperature.  Adding a sample updates one bucket per tier,
+ * so an update costs the same and the rollup the same RAM however long the
+ * device has been up.  Buckets are reused round robin: a bucket found holding
+ * an older period is cleared when the first sample of its new period arrives,
+ * so no work is done for the periods without samples.
+ *
+ * A query covers a time range with the coarsest buckets that fit inside it
+ * and finer ones at the edges, so it visits at most two partial hours of
+ * minute buckets, two partial days of hour buckets and the day buckets, about
+ * 200 buckets however many samples they hold.  Where
+ * the finer tiers no longer reach back far enough, the edges are rounded out
+ * to the buckets of the finest tier still holding them; the range actually
+ * covered is reported with the result.
+ *
+ * Updates and queries take a spinlock for one bucket at a time and may run
+ * in any context.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+#include <stdint.h>
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/** Number of tiers */
+#define ROLLUP_TIERS 3
+
+/** Width and number of the buckets of the minute tier */
+#define ROLLUP_MINUTE_S 60
+#define ROLLUP_MINUTES 60
+
+/** Width and number of the buckets of the hour tier */
+#define ROLLUP_HOUR_S 3600
+#define ROLLUP_HOURS 24
+
+/** Width and number of the buckets of the day tier */
+#define ROLLUP_DAY_S 86400
+#define ROLLUP_DAYS 30
+
+/** Buckets of every tier together */
+#define ROLLUP_BUCKETS (ROLLUP_MINUTES + ROLLUP_HOURS + ROLLUP_DAYS)
+
+/**
+ * @brief Statically define a rollup
+ *
+ * @param name Name of the rollup
+ */
+#define ROLLUP_DEFINE(name) rollup_t name
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+
+/** Aggregate of the samples of one period */
+typedef struct rollup_bucket_s {
+  uint32_t period; ///< Period number plus one, 0 if the bucket is unused
+  uint32_t count;  ///< Samples in the period
+  int32_t rh_sum;  ///< Sum of the humidities in 0.1 %
+  int32_t t_sum;   ///< Sum of the temperatures in 0.1 degrees Celsius
+  int16_t rh_min;
+  int16_t rh_max;
+  int16_t t_min;
+  int16_t t_max;
+} rollup_bucket_t;
+
+/** Rollup, see ROLLUP_DEFINE() */
+typedef struct rollup_s {
+  struct k_spinlock lock;
+  uint32_t count;                          ///< Samples added
+  uint32_t last_s;                         ///< Newest sample time
+  rollup_bucket_t buckets[ROLLUP_BUCKETS]; ///< Minutes, hours, then days
+} rollup_t;
+
+/** Statistics of a time range */
+typedef struct rollup_stats_s {
+  uint32_t from_s; ///< Start of the range covered, bucket aligned
+  uint32_t to_s;   ///< End of the range covered, exclusive
+  uint32_t count;  ///< Samples in the range
+  int16_t rh_min;  ///< Humidity in 0.1 %
+  int16_t rh_max;
+  int16_t rh_avg;
+  int16_t t_min; ///< Temperature in 0.1 degrees Celsius
+  int16_t t_max;
+  int16_t t_avg;
+} rollup_stats_t;
+
+/*******************************************************************************
+ * Variables Declarations
+ ******************************************************************************/
+
+/** Rollup of the DHT11 samples published by the application, in s of uptime */
+extern rollup_t sensor_rollup;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Add a sample
+ *
+ * Samples may arrive out of order.  A tier whose bucket for the sample time
+ * has already been reused for a later period ignores the sample.
+ *
+ * @param rollup Rollup to update
+ * @param time_s Sample time in s
+ * @param rh_x10 Relative humidity in 0.1 %
+ * @param t_x10 Temperature in 0.1 degrees Celsius
+ */
+void rollup_add(rollup_t *rollup, uint32_t time_s, int16_t rh_x10,
+                int16_t t_x10);
+
+/**
+ * @brief Statistics of the samples in a time range
+ *
+ * @param rollup Rollup to query
+ * @param from_s Start of the range in s
+ * @param to_s End of the range in s, exclusive
+ * @param stats Pointer to store the statistics
+ *
+ * @return 0 on success
+ * @return -EINVAL if the range is empty
+ * @return -ENOENT if no retained sample falls in the range
+ */
+int rollup_query(rollup_t *rollup, uint32_t from_s, uint32_t to_s,
+                 rollup_stats_t *stats);
+
+/**
+ * @brief Drop every sample
+ *
+ * @param rollup Rollup to clear
+ */
+void rollup_reset(rollup_t *rollup);
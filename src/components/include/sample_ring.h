@@ -0,0 +1,143 @@
+/**
+ * @file sample_ring.h
+ * @brief Lock-free single writer, multiple reader broadcast ring of samples
+ *
+ * The ring holds the last SAMPLE_RING_CAPACITY samples in statically
+ * allocated memory.  One producer pushes samples and any number of readers
+ * consume them independently, each through its own cursor.  Every slot is
+ * protected by a sequence counter (seqlock) so neither side takes a lock:
+ * the producer never waits for readers, and a reader that falls more than
+ * SAMPLE_RING_CAPACITY samples behind detects the overrun, skips to the
+ * oldest sample still available and counts what it lost.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+#include <stdint.h>
+
+#include <dht11.h>
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/** Number of samples held by a ring.  Must be a power of two. */
+#define SAMPLE_RING_CAPACITY 32
+
+/**
+ * @brief Statically define a sample ring
+ *
+ * @param name Name of the ring
+ */
+#define SAMPLE_RING_DEFINE(name) sample_ring_t name = {.head = ATOMIC_INIT(0)}
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+
+/** A sensor sample as published to the ring */
+typedef struct sample_ring_sample_s {
+  int64_t timestamp_ms; ///< Uptime in ms when the sample was taken
+  dht11_sample_t data;  ///< Sensor reading
+  uint8_t inst;         ///< Sensor instance that produced the sample
+  uint32_t seq;         ///< Sequence number, set by sample_ring_push()
+} sample_ring_sample_t;
+
+/** A slot of the ring and its sequence counter */
+typedef struct sample_ring_slot_s {
+  /** Sequence number of the sample in the slot shifted left by one.  The low
+   * bit is set while the producer is writing the slot. */
+  atomic_t seq;
+  sample_ring_sample_t sample;
+} sample_ring_slot_t;
+
+/** Broadcast ring, see SAMPLE_RING_DEFINE() */
+typedef struct sample_ring_s {
+  /** Sequence number of the next sample to be pushed */
+  atomic_t head;
+  sample_ring_slot_t slots[SAMPLE_RING_CAPACITY];
+} sample_ring_t;
+
+/** Independent read position in a ring */
+typedef struct sample_ring_reader_s {
+  uint32_t cursor;   ///< Sequence number of the next sample to read
+  uint32_t overruns; ///< Samples lost because the reader fell behind
+} sample_ring_reader_t;
+
+/*******************************************************************************
+ * Variables Declarations
+ ******************************************************************************/
+
+/** Ring of validated DHT11 samples published by the application */
+extern sample_ring_t sensor_sample_ring;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Publish a sample
+ *
+ * Must only be called from a single producer context.  Never blocks.  The
+ * copy in the ring is numbered in the order of the pushes, the seq of the
+ * sample passed in is ignored.
+ *
+ * @param ring Ring to publish to
+ * @param sample Sample to copy into the ring
+ */
+void sample_ring_push(sample_ring_t *ring, const sample_ring_sample_t *sample);
+
+/**
+ * @brief Attach a reader to a ring
+ *
+ * The reader starts with the next sample pushed.
+ *
+ * @param ring Ring to read from
+ * @param reader Reader to initialise
+ */
+void sample_ring_reader_init(sample_ring_t *ring, sample_ring_reader_t *reader);
+
+/**
+ * @brief Read the next sample for a reader
+ *
+ * Never blocks.  If the reader fell behind, the lost samples are added to
+ * reader->overruns and the oldest available sample is returned.
+ *
+ * @param ring Ring to read from
+ * @param reader Reader position
+ * @param sample Pointer to store the sample
+ *
+ * @return 0 on success
+ * @return -EAGAIN if no new sample is available
+ */
+int sample_ring_pop(sample_ring_t *ring, sample_ring_reader_t *reader,
+                    sample_ring_sample_t *sample);
+
+/**
+ * @brief Read the most recent sample without attaching a reader
+ *
+ * Never blocks.  If the producer overwrites the sample while it is copied,
+ * the newer sample is returned instead.
+ *
+ * @param ring Ring to read from
+ * @param sample Pointer to store the sample
+ *
+ * @return 0 on success
+ * @return -EAGAIN if nothing has been pushed yet
+ */
+int sample_ring_latest(sample_ring_t *ring, sample_ring_sample_t *sample);
+
+/**
+ * @brief Number of samples a reader has not consumed yet
+ *
+ * @param ring Ring to read from
+ * @param reader Reader position
+ * @return Pending samples, may exceed SAMPLE_RING_CAPACITY after an overrun
+ */
+uint32_t sample_ring_pending(sample_ring_t *ring,
+                             const sample_ring_reader_t *reader);
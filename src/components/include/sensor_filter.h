@@ -0,0 +1,127 @@
+/**
+ * @file sensor_filter.h
+ * @brief Fixed-point filter chain for sensor readings
+ *
+ * Each channel of a reading runs through up to three stages, in order:
+ *
+ * 1. Spike rejection: a sample further than CONFIG_APP_FILTER_SPIKE_X10 from
+ *    the last accepted one is rejected, unless CONFIG_APP_FILTER_SPIKE_CONFIRM
+ *    samples in a row agree on the new level, which is then taken as a real
+ *    step.
+ * 2. Median of the last CONFIG_APP_FILTER_MEDIAN accepted samples.
+ * 3. Exponential moving average with a weight of 2^-CONFIG_APP_FILTER_EMA_SHIFT
+ *    for the new sample, kept with SENSOR_FILTER_EMA_FRAC_BITS fractional bits.
+ *
+ * A stage set to 0 in Kconfig is compiled out together with its state, so
+ * with every stage disabled a channel is a pass-through of no size.  Values
+ * are integers in 0.1 units, as the rest of the application keeps them;
+ * nothing is allocated and no floating point is used.
+ *
+ * A channel is not locked, each must be updated from a single context.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <dht11.h>
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/** Spike rejection compiled in */
+#define SENSOR_FILTER_SPIKE (CONFIG_APP_FILTER_SPIKE_X10 > 0)
+
+/** Median compiled in, a window of 1 would be a pass-through */
+#define SENSOR_FILTER_MEDIAN (CONFIG_APP_FILTER_MEDIAN > 1)
+
+/** Moving average compiled in */
+#define SENSOR_FILTER_EMA (CONFIG_APP_FILTER_EMA_SHIFT > 0)
+
+/** Fractional bits of the moving average */
+#define SENSOR_FILTER_EMA_FRAC_BITS 8
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+
+/** State of one channel */
+typedef struct sensor_filter_s {
+#if SENSOR_FILTER_SPIKE
+  int16_t accepted;  ///< Last sample accepted
+  int16_t candidate; ///< Level of the samples rejected in a row
+  uint8_t rejected;  ///< Samples rejected in a row
+#endif
+#if SENSOR_FILTER_MEDIAN
+  int16_t window[CONFIG_APP_FILTER_MEDIAN]; ///< Last samples, round robin
+  uint8_t next;                             ///< Slot of the next sample
+  uint8_t count;                            ///< Valid slots
+#endif
+#if SENSOR_FILTER_EMA
+  int32_t ema; ///< Average with SENSOR_FILTER_EMA_FRAC_BITS fractional bits
+#endif
+#if SENSOR_FILTER_SPIKE || SENSOR_FILTER_EMA
+  bool primed; ///< False until the first sample
+#endif
+} sensor_filter_t;
+
+/** Humidity and temperature channels of a DHT11 */
+typedef struct sensor_filter_dht11_s {
+  sensor_filter_t rh;
+  sensor_filter_t t;
+  uint32_t rejected; ///< Readings dropped as spikes
+} sensor_filter_dht11_t;
+
+/*******************************************************************************
+ * Variables Declarations
+ ******************************************************************************/
+
+/** Filter of the DHT11 readings published by the application, per instance */
+extern sensor_filter_dht11_t sensor_dht11_filter[DHT11_NUM_INSTANCES];
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Drop the history of a channel
+ *
+ * A zeroed channel is reset as well.
+ *
+ * @param filter Channel to reset
+ */
+void sensor_filter_reset(sensor_filter_t *filter);
+
+/**
+ * @brief Run a sample through the chain
+ *
+ * @param filter Channel of the sample
+ * @param in Sample in 0.1 units
+ * @param out Pointer to store the filtered sample, untouched if rejected
+ *
+ * @return 0 on success
+ * @return -EAGAIN if the sample was rejected as a spike
+ */
+int sensor_filter_apply(sensor_filter_t *filter, int16_t in, int16_t *out);
+
+/**
+ * @brief Filter a DHT11 reading
+ *
+ * Both channels are filtered.  If either channel rejects its sample, the
+ * reading is dropped as a whole and a channel that accepted its sample is left
+ * as it was.
+ *
+ * @param filter Filter of the instance
+ * @param sample Reading, replaced by the filtered one
+ *
+ * @return 0 on success
+ * @return -EAGAIN if the reading was rejected, sample is left as it was
+ */
+int sensor_filter_dht11(sensor_filter_dht11_t *filter, dht11_sample_t *sample);
@@ -0,0 +1,24 @@
+/**
+ * @file storage_workq.h
+ * @brief Low priority work queue of the flash writes
+ *
+ * Writing flash may erase a sector first, which takes up to seconds on the
+ * STM32F7.  Work that writes flash, the history store and the persisted DHT11
+ * calibration, is submitted to this queue instead of the system work queue.
+ * It runs at the lowest application priority, is started at boot and
+ * serialises the writes of its users.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+/*******************************************************************************
+ * Variables Declarations
+ ******************************************************************************/
+
+/** Work queue of the flash writes, CONFIG_APP_STORAGE_WORKQ_STACK_SIZE */
+extern struct k_work_q storage_workq;
@@ -0,0 +1,124 @@
+/**
+ * @file telemetry.h
+ * @brief Binary telemetry stream over an asynchronous UART
+ *
+ * Producers add typed records to an open frame.  A frame is closed when the
+ * next record does not fit or on telemetry_flush(), then protected with a
+ * CRC16, COBS encoded (cobs.h) and terminated by a zero byte into one of two
+ * transmit buffers.  While the UART sends one buffer with uart_tx(), by DMA
+ * where the driver supports it, frames collect in the other, and the TX done
+ * interrupt starts the next buffer.  A producer never waits for the UART:
+ * a frame that finds both buffers full is dropped and counted.
+ *
+ * A frame is laid out before encoding as
+ *
+ * | Bytes | Content                                           |
+ * | ----- | ------------------------------------------------- |
+ * | 1     | Format version, TELEMETRY_VERSION                 |
+ * | 2     | Frame sequence number, a gap counts lost frames   |
+ * | 4     | Uptime in ms when the frame was closed            |
+ * | ...   | Records: type, payload length, payload            |
+ * | 2     | CRC16-CCITT of everything above, seed 0xFFFF      |
+ *
+ * all little endian.  The records are decoded on the host by
+ * scripts/telemetry_decode.py.
+ *
+ * Adding a record holds a spinlock for the copy, closing a frame for its
+ * encoding, a single pass over at most TELEMETRY_FRAME_SIZE bytes.  Every
+ * function may be called from any context.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <zephyr/device.h>
+#include <zephyr/kernel.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/** Format version of a frame */
+#define TELEMETRY_VERSION 1
+
+/** Largest frame before encoding, CRC included */
+#define TELEMETRY_FRAME_SIZE 254
+
+/** Version, sequence number and timestamp */
+#define TELEMETRY_HEADER_SIZE 7
+
+#define TELEMETRY_CRC_SIZE 2
+
+/** Type and length preceding each record payload */
+#define TELEMETRY_RECORD_HEADER_SIZE 2
+
+/** Largest record payload */
+#define TELEMETRY_RECORD_MAX                                                   \
+  (TELEMETRY_FRAME_SIZE - TELEMETRY_HEADER_SIZE - TELEMETRY_CRC_SIZE -         \
+   TELEMETRY_RECORD_HEADER_SIZE)
+
+/** Size of each of the two transmit buffers, at least three full frames */
+#define TELEMETRY_TX_BUF_SIZE 1024
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+
+/** Stream statistics */
+typedef struct telemetry_stats_s {
+  uint32_t records;        ///< Records added
+  uint32_t frames;         ///< Frames closed
+  uint32_t frames_sent;    ///< Frames the UART completed
+  uint32_t frames_dropped; ///< Frames dropped, buffers full or UART error
+  uint32_t bytes_sent;     ///< Encoded bytes the UART completed
+  uint32_t tx_errors;      ///< uart_tx() failures and aborted transfers
+} telemetry_stats_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Attach the stream to a UART
+ *
+ * @param uart UART supporting the asynchronous API
+ *
+ * @return 0 on success
+ * @return -ENODEV if the UART is not ready
+ * @return Negative errno if its callback cannot be set
+ */
+int telemetry_init(const struct device *uart);
+
+/**
+ * @brief Add a record to the open frame
+ *
+ * Closes the frame first if the record does not fit in it.  Never blocks.
+ *
+ * @param type Record type, meaning defined by the producer
+ * @param payload Record payload, may be NULL if len is 0
+ * @param len Payload length, at most TELEMETRY_RECORD_MAX
+ *
+ * @return 0 on success
+ * @return -EINVAL if the record is too large
+ * @return -ENODEV if the stream is not initialised
+ */
+int telemetry_put(uint8_t type, const void *payload, size_t len);
+
+/**
+ * @brief Close the open frame and start sending it
+ *
+ * Does nothing if the frame holds no record.  Never blocks.
+ */
+void telemetry_flush(void);
+
+/**
+ * @brief Retrieve the stream statistics
+ *
+ * @param stats Pointer to struct to store the statistics
+ */
+void telemetry_get_stats(telemetry_stats_t *stats);
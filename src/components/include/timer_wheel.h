@@ -0,0 +1,87 @@
+/**
+ * @file timer_wheel.h
+ * @brief Hashed timer wheel sharing a single k_timer between many timeouts
+ *
+ * Timeouts are placed in one of TIMER_WHEEL_SLOTS slots according to their
+ * expiry tick.  A single k_timer advances the wheel every TIMER_WHEEL_TICK_MS
+ * and only runs while at least one timeout is armed, so the cost of a tick
+ * depends on the timeouts due in that slot rather than on how many exist.
+ * Callbacks run in the k_timer expiry (ISR) context.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/dlist.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/** Resolution of the wheel in ms */
+#define TIMER_WHEEL_TICK_MS 5
+
+/** Number of slots, must be a power of two */
+#define TIMER_WHEEL_SLOTS 64
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+
+typedef struct timer_wheel_entry_s timer_wheel_entry_t;
+
+/** Expiry callback, called from ISR context */
+typedef void (*timer_wheel_fn_t)(timer_wheel_entry_t *entry);
+
+/** A timeout, embed in the owning structure */
+struct timer_wheel_entry_s {
+  sys_dnode_t node;    ///< Link in a slot or the expired list
+  uint32_t rounds;     ///< Full wheel turns left before expiry
+  timer_wheel_fn_t fn; ///< Expiry callback
+  bool armed;          ///< True while the entry sits in a slot
+};
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Initialise a timeout
+ *
+ * @param entry Timeout to initialise
+ * @param fn Expiry callback
+ */
+void timer_wheel_init_entry(timer_wheel_entry_t *entry, timer_wheel_fn_t fn);
+
+/**
+ * @brief Arm or re-arm a timeout
+ *
+ * Expires no earlier than timeout_ms from now and at most two ticks later.
+ * Callable from ISRs.
+ *
+ * @param entry Timeout to arm
+ * @param timeout_ms Delay in ms
+ */
+void timer_wheel_start(timer_wheel_entry_t *entry, uint32_t timeout_ms);
+
+/**
+ * @brief Disarm a timeout, its callback will not be called
+ *
+ * Callable from ISRs.
+ *
+ * @param entry Timeout to disarm
+ */
+void timer_wheel_stop(timer_wheel_entry_t *entry);
+
+/**
+ * @brief Number of ticks the wheel has processed since boot
+ *
+ * @return Tick count
+ */
+uint32_t timer_wheel_ticks(void);
@@ -0,0 +1,175 @@
+/**
+ * @file ts_store.h
+ * @brief Flash backed time series of sensor samples
+ *
+ * Samples are collected in a RAM batch of TS_STORE_BATCH_SIZE bytes and
+ * written to a flash circular buffer (FCB) as one entry once the batch is
+ * full, so flash is programmed in large chunks and a sector is only erased
+ * when the buffer wraps.  Within a batch the first sample is stored whole and
+ * every following one as the varint encoded difference to its predecessor,
+ * which brings a slowly changing reading down to about three bytes.
+ *
+ * Each batch carries a CRC16 on top of the FCB entry CRC.  ts_store_init()
+ * walks the buffer, validates and decodes every batch and rebuilds the seek
+ * index from the valid ones, so a batch torn by a reset is dropped rather than
+ * returned.  The index holds the first timestamp of up to
+ * TS_STORE_INDEX_SIZE batches.  When it fills up, every other entry is
+ * dropped and only every second batch is indexed from then on, so a seek
+ * decodes a bounded number of batches however long the history grows.
+ *
+ * Samples still in the RAM batch are readable but lost on a reset, call
+ * ts_store_flush() to write them early.  All functions must be called from
+ * threads.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <zephyr/fs/fcb.h>
+#include <zephyr/kernel.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/** Size of a batch in bytes, the unit written to flash */
+#define TS_STORE_BATCH_SIZE 512
+
+/** Batches in the seek index before it is thinned out */
+#define TS_STORE_INDEX_SIZE 256
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+
+/** A stored sample */
+typedef struct ts_sample_s {
+  uint32_t time_s; ///< Timestamp in s, must not decrease
+  int16_t rh_x10;  ///< Relative humidity in 0.1 %
+  int16_t t_x10;   ///< Temperature in 0.1 degrees Celsius
+} ts_sample_t;
+
+/** Read position, see ts_store_seek() */
+typedef struct ts_store_cursor_s {
+  struct fcb_entry loc;             ///< Internal, entry of the batch
+  uint32_t generation;              ///< Internal, detects rotations
+  uint8_t buf[TS_STORE_BATCH_SIZE]; ///< Internal, copy of the batch
+  uint16_t len;                     ///< Internal, bytes in buf
+  uint16_t pos;                     ///< Internal, next record in buf
+  uint16_t left;                    ///< Internal, samples left in buf
+  uint8_t state;                    ///< Internal, where the next batch is
+  bool peeked;                      ///< Internal, prev not returned yet
+  ts_sample_t prev;                 ///< Internal, last decoded sample
+} ts_store_cursor_t;
+
+/** Store statistics */
+typedef struct ts_store_stats_s {
+  uint32_t samples;      ///< Samples appended since init
+  uint32_t batches;      ///< Batches written since init
+  uint32_t flash_bytes;  ///< Bytes programmed, FCB framing included
+  uint32_t erased_bytes; ///< Bytes erased by rotations
+  uint32_t rotations;    ///< Sectors erased to make room
+  uint32_t recovered;    ///< Valid batches found by the recovery scan
+  uint32_t discarded;    ///< Batches rejected by the recovery scan or a read
+  uint32_t index_stride; ///< Batches per index entry
+} ts_store_stats_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Mount the store and recover its contents
+ *
+ * Calling it again drops the RAM batch and mounts the store anew, as after a
+ * reset.
+ *
+ * @param area_id Flash area of the store, e.g.
+ * FIXED_PARTITION_ID(history_partition)
+ *
+ * @return 0 on success
+ * @return Negative errno if the flash area cannot be used
+ */
+int ts_store_init(uint8_t area_id);
+
+/**
+ * @brief Append a sample
+ *
+ * Writes the RAM batch to flash first if the sample does not fit, erasing the
+ * oldest sector if the buffer is full.
+ *
+ * @param sample Sample to store
+ *
+ * @return 0 on success
+ * @return -EINVAL if the sample is older than the last one
+ * @return Negative errno if the batch could not be written, the sample is
+ * dropped
+ */
+int ts_store_append(const ts_sample_t *sample);
+
+/**
+ * @brief Write the RAM batch to flash even if it is not full
+ *
+ * @return 0 on success or if the batch is empty
+ * @return Negative errno if the batch could not be written
+ */
+int ts_store_flush(void);
+
+/**
+ * @brief Position a cursor on the first sample at or after a time
+ *
+ * @param time_s Timestamp to seek to, 0 for the oldest sample
+ * @param cursor Cursor to position
+ *
+ * @return 0 on success, ts_store_next() returns -ENOENT if no sample is that
+ * recent
+ * @return -ENODEV if the store is not mounted
+ */
+int ts_store_seek(uint32_t time_s, ts_store_cursor_t *cursor);
+
+/**
+ * @brief Read the next sample of a cursor
+ *
+ * A cursor that reached the end does not see samples appended later, seek
+ * again from the last timestamp read.
+ *
+ * @param cursor Cursor positioned by ts_store_seek()
+ * @param sample Pointer to store the sample
+ *
+ * @return 0 on success
+ * @return -ENOENT at the end of the store
+ * @return -ESTALE if the batch under the cursor was erased, seek again
+ */
+int ts_store_next(ts_store_cursor_t *cursor, ts_sample_t *sample);
+
+/**
+ * @brief Timestamp of the newest sample
+ *
+ * @param time_s Pointer to store the timestamp
+ *
+ * @return 0 on success
+ * @return -ENOENT if the store is empty
+ */
+int ts_store_last_time(uint32_t *time_s);
+
+/**
+ * @brief Erase every sample
+ *
+ * @return 0 on success, negative errno otherwise
+ */
+int ts_store_clear(void);
+
+/**
+ * @brief Retrieve the store statistics
+ *
+ * Write amplification relative to storing every sample on its own is
+ * flash_bytes / (samples * sizeof(ts_sample_t)).
+ *
+ * @param stats Pointer to struct to store the statistics
+ */
+void ts_store_get_stats(ts_store_stats_t *stats);
@@ -0,0 +1,123 @@
+/**
+ * @file key_fsm.c
+ * @brief
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <key_fsm.h>
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/** Gesture state machine input for a debounced press */
+static void key_pressed(key_fsm_t *fsm, const key_fsm_timing_t *timing,
+                        key_fsm_out_t *out);
+
+/** Gesture state machine input for a debounced release */
+static void key_released(key_fsm_t *fsm, const key_fsm_timing_t *timing,
+                         key_fsm_out_t *out);
+
+/*******************************************************************************
+ * Function Definitions
+ ******************************************************************************/
+
+// Described in .h
+void key_fsm_init(key_fsm_t *fsm) {
+  fsm->state = KEY_IDLE;
+  fsm->pressed = false;
+}
+
+// Described in .h
+bool key_fsm_sample(key_fsm_t *fsm, const key_fsm_timing_t *timing,
+                    bool pressed, key_fsm_out_t *out) {
+  // Bounced back to the state we already reported
+  if (pressed == fsm->pressed) {
+    return false;
+  }
+
+  fsm->pressed = pressed;
+
+  *out = (key_fsm_out_t){
+      .gesture = BUTTON_GESTURE_MAX,
+      .timer_ms = KEY_FSM_TIMER_KEEP,
+  };
+
+  if (pressed) {
+    key_pressed(fsm, timing, out);
+  } else {
+    key_released(fsm, timing, out);
+  }
+
+  return true;
+}
+
+// Described above
+static void key_pressed(key_fsm_t *fsm, const key_fsm_timing_t *timing,
+                        key_fsm_out_t *out) {
+  out->press = true;
+
+  if (fsm->state == KEY_WAIT_DOUBLE) {
+    fsm->state = KEY_PRESSED_DOUBLE;
+    out->gesture = BUTTON_GESTURE_DOUBLE;
+    out->timer_ms = KEY_FSM_TIMER_STOP;
+    return;
+  }
+
+  fsm->state = KEY_PRESSED;
+  out->timer_ms = timing->long_press_ms;
+}
+
+// Described above
+static void key_released(key_fsm_t *fsm, const key_fsm_timing_t *timing,
+                         key_fsm_out_t *out) {
+  out->release = true;
+
+  // Released before the long press, this is a short press unless a second
+  // press follows within the double click window
+  if (fsm->state == KEY_PRESSED && timing->double_click_ms) {
+    fsm->state = KEY_WAIT_DOUBLE;
+    out->timer_ms = timing->double_click_ms;
+    return;
+  }
+
+  out->timer_ms = KEY_FSM_TIMER_STOP;
+
+  if (fsm->state == KEY_PRESSED) {
+    out->gesture = BUTTON_GESTURE_SHORT;
+  }
+
+  fsm->state = KEY_IDLE;
+}
+
+// Described in .h
+void key_fsm_expired(key_fsm_t *fsm, const key_fsm_timing_t *timing,
+                     key_fsm_out_t *out) {
+  *out = (key_fsm_out_t){
+      .gesture = BUTTON_GESTURE_MAX,
+      .timer_ms = KEY_FSM_TIMER_KEEP,
+  };
+
+  switch (fsm->state) {
+  case KEY_PRESSED:
+    fsm->state = KEY_HELD;
+    out->hold = true;
+    out->gesture = BUTTON_GESTURE_LONG;
+    if (timing->repeat_delay_ms) {
+      out->timer_ms = timing->repeat_delay_ms;
+    }
+    break;
+  case KEY_HELD:
+    out->gesture = BUTTON_GESTURE_REPEAT;
+    out->timer_ms = timing->repeat_interval_ms;
+    break;
+  case KEY_WAIT_DOUBLE:
+    fsm->state = KEY_IDLE;
+    out->gesture = BUTTON_GESTURE_SHORT;
+    break;
+  default:
+    break;
+  }
+}
@@ -0,0 +1,336 @@
+/**
+ * @file led_module.c
+ * @brief LED pattern sequencer
+ *
+ * Patterns are not stepped through a script.  Each timer expiry evaluates the
+ * brightness of every LED as a function of the time since its pattern was
+ * started, so a late expiry never shifts a pattern, and sets the timer to the
+ * next time any LED changes.  The GPIO is only written when the LED changes
+ * state.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "include/led_module.h"
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include <errno.h>
+
+LOG_MODULE_REGISTER(led_mod, 3);
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/* The devicetree node identifier for the "led0" alias. */
+#define LED0_NODE DT_ALIAS(led0)
+
+/* The devicetree node identifier for the "led2" alias. */
+#define LED2_NODE DT_ALIAS(led2)
+
+/** pattern_next_ms() of a pattern that never changes */
+#define LED_NO_CHANGE UINT32_MAX
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+
+/** Background patterns */
+enum led_pattern {
+  LED_PATTERN_OFF = 0,
+  LED_PATTERN_ON,
+  LED_PATTERN_BLINK,
+  LED_PATTERN_CODE,
+  LED_PATTERN_BREATHE,
+};
+
+/** State of one LED */
+typedef struct led_state_s {
+  enum led_pattern pattern;
+  uint32_t start_ms;     ///< Uptime the pattern started at
+  uint16_t on_ms;        ///< Blink on time
+  uint16_t off_ms;       ///< Blink off time
+  uint16_t period_ms;    ///< Breathing period
+  uint8_t count;         ///< Blink code pulse count
+  bool flashing;         ///< True while a one-shot flash is showing
+  uint32_t flash_end_ms; ///< Uptime the flash ends at
+  bool lit;              ///< Last state written to the GPIO
+} led_state_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/** Timer expiry, refreshes every LED */
+static void led_timer_handler(struct k_timer *timer);
+
+/**
+ * @brief Brightness of the background pattern of an LED
+ *
+ * @param led LED to evaluate
+ * @param now_ms Current uptime
+ *
+ * @return Brightness from 0 to LED_PWM_LEVELS
+ */
+static uint8_t pattern_level(const led_state_t *led, uint32_t now_ms);
+
+/**
+ * @brief Time until the background pattern of an LED next changes
+ *
+ * @param led LED to evaluate
+ * @param now_ms Current uptime
+ *
+ * @return Milliseconds to the change, LED_NO_CHANGE for a static pattern
+ */
+static uint32_t pattern_next_ms(const led_state_t *led, uint32_t now_ms);
+
+/** Write every LED and set the timer to the next change.  Called with the
+ * lock held */
+static void refresh(void);
+
+/** Replace the background pattern of an LED and refresh */
+static int set_pattern(led_id_t led, const led_state_t *pattern);
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+/** LED specs based on the DT description, indexed by led_id_t */
+static const struct gpio_dt_spec led_gpios[LED_MAX] = {
+    [LED_GREEN] = GPIO_DT_SPEC_GET(LED0_NODE, gpios),
+    [LED_RED] = GPIO_DT_SPEC_GET(LED2_NODE, gpios),
+};
+
+static led_state_t leds[LED_MAX];
+
+static K_TIMER_DEFINE(led_timer, led_timer_handler, NULL);
+
+static struct k_spinlock led_lock;
+
+/** Software PWM step, advanced on every expiry */
+static uint8_t pwm_step;
+
+static bool initialised;
+
+/*******************************************************************************
+ * Function Definitions
+ ******************************************************************************/
+
+// Described in .h
+int8_t led_module_init() {
+  for (uint8_t idx = 0; idx < LED_MAX; idx++) {
+    if (!gpio_is_ready_dt(&led_gpios[idx])) {
+      LOG_ERR("LED %d is not ready", idx);
+      return -1;
+    }
+
+    if (gpio_pin_configure_dt(&led_gpios[idx], GPIO_OUTPUT_INACTIVE)) {
+      LOG_ERR("Unable to configure LED %d", idx);
+      return -1;
+    }
+  }
+
+  initialised = true;
+
+  return 0;
+}
+
+// Described in .h
+int led_module_set(led_id_t led, bool on) {
+  led_state_t pattern = {
+      .pattern = on ? LED_PATTERN_ON : LED_PATTERN_OFF,
+  };
+
+  return set_pattern(led, &pattern);
+}
+
+// Described in .h
+int led_module_blink(led_id_t led, uint16_t on_ms, uint16_t off_ms) {
+  led_state_t pattern = {
+      .pattern = LED_PATTERN_BLINK,
+      .on_ms = on_ms,
+      .off_ms = off_ms,
+  };
+
+  if (on_ms + off_ms == 0) {
+    return -EINVAL;
+  }
+
+  return set_pattern(led, &pattern);
+}
+
+// Described in .h
+int led_module_blink_code(led_id_t led, uint8_t count) {
+  led_state_t pattern = {
+      .pattern = LED_PATTERN_CODE,
+      .count = count,
+  };
+
+  if (count == 0) {
+    return -EINVAL;
+  }
+
+  return set_pattern(led, &pattern);
+}
+
+// Described in .h
+int led_module_breathe(led_id_t led, uint16_t period_ms) {
+  led_state_t pattern = {
+      .pattern = LED_PATTERN_BREATHE,
+      .period_ms = period_ms,
+  };
+
+  // Needs at least one PWM frame up and one down
+  if (period_ms < 2 * LED_PWM_LEVELS * LED_PWM_TICK_MS) {
+    return -EINVAL;
+  }
+
+  return set_pattern(led, &pattern);
+}
+
+// Described in .h
+int led_module_flash(led_id_t led, uint16_t on_ms) {
+  if (led >= LED_MAX || !initialised) {
+    return -EINVAL;
+  }
+
+  K_SPINLOCK(&led_lock) {
+    leds[led].flashing = true;
+    leds[led].flash_end_ms = k_uptime_get_32() + on_ms;
+    refresh();
+  }
+
+  return 0;
+}
+
+// Described above
+static int set_pattern(led_id_t led, const led_state_t *pattern) {
+  if (led >= LED_MAX || !initialised) {
+    return -EINVAL;
+  }
+
+  K_SPINLOCK(&led_lock) {
+    led_state_t *state = &leds[led];
+
+    state->pattern = pattern->pattern;
+    state->start_ms = k_uptime_get_32();
+    state->on_ms = pattern->on_ms;
+    state->off_ms = pattern->off_ms;
+    state->period_ms = pattern->period_ms;
+    state->count = pattern->count;
+    refresh();
+  }
+
+  return 0;
+}
+
+// Described above
+static uint8_t pattern_level(const led_state_t *led, uint32_t now_ms) {
+  uint32_t elapsed = now_ms - led->start_ms;
+  uint32_t phase;
+
+  switch (led->pattern) {
+  case LED_PATTERN_ON:
+    return LED_PWM_LEVELS;
+  case LED_PATTERN_BLINK:
+    phase = elapsed % (led->on_ms + led->off_ms);
+    return phase < led->on_ms ? LED_PWM_LEVELS : 0;
+  case LED_PATTERN_CODE: {
+    uint32_t pulses_ms = 2 * LED_CODE_PULSE_MS * led->count;
+
+    phase = elapsed % (pulses_ms + LED_CODE_PAUSE_MS);
+    if (phase >= pulses_ms) {
+      return 0;
+    }
+    return (phase / LED_CODE_PULSE_MS) % 2 ? 0 : LED_PWM_LEVELS;
+  }
+  case LED_PATTERN_BREATHE: {
+    uint32_t half = led->period_ms / 2;
+
+    // Triangle wave, up for the first half and down for the second
+    phase = elapsed % led->period_ms;
+    if (phase > half) {
+      phase = led->period_ms - phase;
+    }
+    return MIN(phase * LED_PWM_LEVELS / half, LED_PWM_LEVELS);
+  }
+  default:
+    return 0;
+  }
+}
+
+// Described above
+static uint32_t pattern_next_ms(const led_state_t *led, uint32_t now_ms) {
+  uint32_t elapsed = now_ms - led->start_ms;
+  uint32_t phase;
+
+  switch (led->pattern) {
+  case LED_PATTERN_BLINK:
+    if (!led->on_ms || !led->off_ms) {
+      return LED_NO_CHANGE;
+    }
+    phase = elapsed % (led->on_ms + led->off_ms);
+    return phase < led->on_ms ? led->on_ms - phase
+                              : led->on_ms + led->off_ms - phase;
+  case LED_PATTERN_CODE: {
+    uint32_t pulses_ms = 2 * LED_CODE_PULSE_MS * led->count;
+    uint32_t cycle_ms = pulses_ms + LED_CODE_PAUSE_MS;
+
+    // The last off pulse runs on into the pause
+    phase = elapsed % cycle_ms;
+    if (phase >= pulses_ms - LED_CODE_PULSE_MS) {
+      return cycle_ms - phase;
+    }
+    return LED_CODE_PULSE_MS - phase % LED_CODE_PULSE_MS;
+  }
+  case LED_PATTERN_BREATHE:
+    return LED_PWM_TICK_MS;
+  default:
+    return LED_NO_CHANGE;
+  }
+}
+
+// Described above
+static void refresh(void) {
+  uint32_t now_ms = k_uptime_get_32();
+  uint32_t next_ms = LED_NO_CHANGE;
+
+  for (uint8_t idx = 0; idx < LED_MAX; idx++) {
+    led_state_t *led = &leds[idx];
+    uint8_t level;
+    bool lit;
+
+    if (led->flashing && (int32_t)(now_ms - led->flash_end_ms) >= 0) {
+      led->flashing = false;
+    }
+
+    level = led->flashing ? LED_PWM_LEVELS : pattern_level(led, now_ms);
+    lit = level > pwm_step;
+
+    if (lit != led->lit) {
+      gpio_pin_set_dt(&led_gpios[idx], lit);
+      led->lit = lit;
+    }
+
+    // A flash hides the pattern until it ends
+    next_ms = MIN(next_ms, led->flashing ? led->flash_end_ms - now_ms
+                                         : pattern_next_ms(led, now_ms));
+  }
+
+  if (next_ms == LED_NO_CHANGE) {
+    k_timer_stop(&led_timer);
+  } else {
+    k_timer_start(&led_timer, K_MSEC(next_ms), K_NO_WAIT);
+  }
+}
+
+// Described above
+static void led_timer_handler(struct k_timer *timer) {
+  K_SPINLOCK(&led_lock) {
+    pwm_step = (pwm_step + 1) % LED_PWM_LEVELS;
+    refresh();
+  }
+}
@@ -0,0 +1,208 @@
+/**
+ * @file rollup.c
+ * @brief Multi-resolution min/max/average rollups of sensor samples
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <zephyr/kernel.h>
+
+#include <errno.h>
+#include <string.h>
+
+#include <rollup.h>
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+
+/** Layout of a tier in rollup_t::buckets */
+typedef struct rollup_tier_s {
+  uint32_t width_s; ///< Period of a bucket
+  uint16_t count;   ///< Buckets of the tier
+  uint16_t first;   ///< Index of its first bucket
+} rollup_tier_t;
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+/** Tiers from the finest to the coarsest */
+static const rollup_tier_t tiers[ROLLUP_TIERS] = {
+    {ROLLUP_MINUTE_S, ROLLUP_MINUTES, 0},
+    {ROLLUP_HOUR_S, ROLLUP_HOURS, ROLLUP_MINUTES},
+    {ROLLUP_DAY_S, ROLLUP_DAYS, ROLLUP_MINUTES + ROLLUP_HOURS},
+};
+
+// Described in .h
+ROLLUP_DEFINE(sensor_rollup);
+
+/*******************************************************************************
+ * Function Definitions
+ ******************************************************************************/
+
+/** Average rounded to the nearest, count must not be 0 */
+static int16_t average(int64_t sum, uint32_t count) {
+  int64_t half = sum < 0 ? -(int64_t)(count / 2) : (int64_t)(count / 2);
+
+  return (int16_t)((sum + half) / (int64_t)count);
+}
+
+/** Bucket of a tier that holds a period */
+static rollup_bucket_t *tier_bucket(rollup_t *rollup, const rollup_tier_t *tier,
+                                    uint32_t period) {
+  return &rollup->buckets[tier->first + period % tier->count];
+}
+
+/**
+ * @brief Whether the bucket of a period is still in a tier, with or without
+ * samples
+ *
+ * Called with the rollup locked.  Periods after the newest sample count as
+ * retained, their buckets are just empty.
+ */
+static bool tier_retains(const rollup_t *rollup, const rollup_tier_t *tier,
+                         uint32_t period) {
+  uint32_t newest = rollup->last_s / tier->width_s;
+
+  return period > newest || newest - period < tier->count;
+}
+
+// Described in .h
+void rollup_add(rollup_t *rollup, uint32_t time_s, int16_t rh_x10,
+                int16_t t_x10) {
+  k_spinlock_key_t key = k_spin_lock(&rollup->lock);
+
+  for (uint8_t idx = 0; idx < ROLLUP_TIERS; idx++) {
+    uint32_t period = time_s / tiers[idx].width_s;
+    rollup_bucket_t *bucket = tier_bucket(rollup, &tiers[idx], period);
+
+    if (bucket->period > period + 1) {
+      continue;
+    }
+
+    if (bucket->period != period + 1) {
+      *bucket = (rollup_bucket_t){
+          .period = period + 1,
+          .rh_min = rh_x10,
+          .rh_max = rh_x10,
+          .t_min = t_x10,
+          .t_max = t_x10,
+      };
+    }
+
+    bucket->count++;
+    bucket->rh_sum += rh_x10;
+    bucket->t_sum += t_x10;
+    bucket->rh_min = MIN(bucket->rh_min, rh_x10);
+    bucket->rh_max = MAX(bucket->rh_max, rh_x10);
+    bucket->t_min = MIN(bucket->t_min, t_x10);
+    bucket->t_max = MAX(bucket->t_max, t_x10);
+  }
+
+  if (!rollup->count || time_s > rollup->last_s) {
+    rollup->last_s = time_s;
+  }
+  rollup->count++;
+
+  k_spin_unlock(&rollup->lock, key);
+}
+
+// Described in .h
+int rollup_query(rollup_t *rollup, uint32_t from_s, uint32_t to_s,
+                 rollup_stats_t *stats) {
+  int64_t rh_sum = 0;
+  int64_t t_sum = 0;
+  uint32_t time_s = from_s;
+
+  if (from_s >= to_s) {
+    return -EINVAL;
+  }
+
+  *stats = (rollup_stats_t){
+      .from_s = UINT32_MAX,
+      .rh_min = INT16_MAX,
+      .rh_max = INT16_MIN,
+      .t_min = INT16_MAX,
+      .t_max = INT16_MIN,
+  };
+
+  while (time_s < to_s) {
+    const rollup_tier_t *tier = NULL;
+    k_spinlock_key_t key = k_spin_lock(&rollup->lock);
+
+    if (!rollup->count || time_s > rollup->last_s) {
+      k_spin_unlock(&rollup->lock, key);
+      break;
+    }
+
+    // Coarsest bucket starting here and ending inside the range, else the
+    // finest retained bucket holding this time.  Retention only shrinks
+    // towards older periods, so a bucket rounded out here never overlaps
+    // finer ones already counted.
+    for (int8_t idx = ROLLUP_TIERS - 1; idx >= 0; idx--) {
+      uint32_t width_s = tiers[idx].width_s;
+
+      if (!tier_retains(rollup, &tiers[idx], time_s / width_s)) {
+        break;
+      }
+
+      tier = &tiers[idx];
+      if (time_s % width_s == 0 && to_s - time_s >= width_s) {
+        break;
+      }
+    }
+
+    // Older than every tier reaches back, skip to the oldest day retained
+    if (!tier) {
+      const rollup_tier_t *days = &tiers[ROLLUP_TIERS - 1];
+
+      time_s = (rollup->last_s / days->width_s - days->count + 1) *
+               days->width_s;
+      k_spin_unlock(&rollup->lock, key);
+      continue;
+    }
+
+    uint32_t period = time_s / tier->width_s;
+    const rollup_bucket_t *bucket = tier_bucket(rollup, tier, period);
+
+    if (bucket->period == period + 1) {
+      stats->from_s = MIN(stats->from_s, period * tier->width_s);
+      stats->to_s = MAX(stats->to_s, (period + 1) * tier->width_s);
+      stats->count += bucket->count;
+      rh_sum += bucket->rh_sum;
+      t_sum += bucket->t_sum;
+      stats->rh_min = MIN(stats->rh_min, bucket->rh_min);
+      stats->rh_max = MAX(stats->rh_max, bucket->rh_max);
+      stats->t_min = MIN(stats->t_min, bucket->t_min);
+      stats->t_max = MAX(stats->t_max, bucket->t_max);
+    }
+
+    k_spin_unlock(&rollup->lock, key);
+
+    uint32_t next_s = (period + 1) * tier->width_s;
+
+    time_s = next_s > time_s ? next_s : to_s;
+  }
+
+  if (!stats->count) {
+    return -ENOENT;
+  }
+
+  stats->rh_avg = average(rh_sum, stats->count);
+  stats->t_avg = average(t_sum, stats->count);
+
+  return 0;
+}
+
+// Described in .h
+void rollup_reset(rollup_t *rollup) {
+  k_spinlock_key_t key = k_spin_lock(&rollup->lock);
+
+  rollup->count = 0;
+  rollup->last_s = 0;
+  memset(rollup->buckets, 0, sizeof(rollup->buckets));
+
+  k_spin_unlock(&rollup->lock, key);
+}
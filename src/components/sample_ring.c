@@ -0,0 +1,123 @@
+/**
+ * @file sample_ring.c
+ * @brief Lock-free single writer, multiple reader broadcast ring of samples
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/barrier.h>
+
+#include <sample_ring.h>
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/** Mask applied to a sequence number to find its slot */
+#define SAMPLE_RING_MASK (SAMPLE_RING_CAPACITY - 1)
+
+BUILD_ASSERT((SAMPLE_RING_CAPACITY & SAMPLE_RING_MASK) == 0,
+             "SAMPLE_RING_CAPACITY must be a power of two");
+
+/** Slot sequence value for a sample being written */
+#define SLOT_SEQ_WRITING(seq) ((atomic_val_t)(((seq) << 1) | 1))
+
+/** Slot sequence value for a complete sample */
+#define SLOT_SEQ_VALID(seq) ((atomic_val_t)((seq) << 1))
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+// Described in .h
+SAMPLE_RING_DEFINE(sensor_sample_ring);
+
+/*******************************************************************************
+ * Function Definitions
+ ******************************************************************************/
+
+// Described in .h
+void sample_ring_push(sample_ring_t *ring, const sample_ring_sample_t *sample) {
+  uint32_t seq = (uint32_t)atomic_get(&ring->head);
+  sample_ring_slot_t *slot = &ring->slots[seq & SAMPLE_RING_MASK];
+
+  // Readers that see the odd value, or see it change, discard their copy
+  atomic_set(&slot->seq, SLOT_SEQ_WRITING(seq));
+  barrier_dmem_fence_full();
+
+  slot->sample = *sample;
+  slot->sample.seq = seq;
+
+  barrier_dmem_fence_full();
+  atomic_set(&slot->seq, SLOT_SEQ_VALID(seq));
+
+  atomic_set(&ring->head, (atomic_val_t)(seq + 1));
+}
+
+// Described in .h
+void sample_ring_reader_init(sample_ring_t *ring,
+                             sample_ring_reader_t *reader) {
+  reader->cursor = (uint32_t)atomic_get(&ring->head);
+  reader->overruns = 0;
+}
+
+// Described in .h
+int sample_ring_pop(sample_ring_t *ring, sample_ring_reader_t *reader,
+                    sample_ring_sample_t *sample) {
+  while (1) {
+    uint32_t head = (uint32_t)atomic_get(&ring->head);
+    uint32_t behind = head - reader->cursor;
+
+    if (behind == 0) {
+      return -EAGAIN;
+    }
+
+    // Samples older than the ring capacity have been overwritten
+    if (behind > SAMPLE_RING_CAPACITY) {
+      reader->overruns += behind - SAMPLE_RING_CAPACITY;
+      reader->cursor = head - SAMPLE_RING_CAPACITY;
+    }
+
+    const sample_ring_slot_t *slot =
+        &ring->slots[reader->cursor & SAMPLE_RING_MASK];
+    atomic_val_t seq = atomic_get(&slot->seq);
+
+    barrier_dmem_fence_full();
+    *sample = slot->sample;
+    barrier_dmem_fence_full();
+
+    if (seq == SLOT_SEQ_VALID(reader->cursor) &&
+        seq == atomic_get(&slot->seq)) {
+      reader->cursor++;
+      return 0;
+    }
+
+    // The producer lapped this reader while it was copying and the slot now
+    // belongs to a newer sample.  Skip it rather than waiting for the
+    // producer, which this reader may have preempted.
+    if (head - reader->cursor <= SAMPLE_RING_CAPACITY) {
+      reader->overruns++;
+      reader->cursor++;
+    }
+  }
+}
+
+// Described in .h
+int sample_ring_latest(sample_ring_t *ring, sample_ring_sample_t *sample) {
+  uint32_t head = (uint32_t)atomic_get(&ring->head);
+  sample_ring_reader_t reader = {.cursor = head - 1};
+
+  if (head == 0) {
+    return -EAGAIN;
+  }
+
+  return sample_ring_pop(ring, &reader, sample);
+}
+
+// Described in .h
+uint32_t sample_ring_pending(sample_ring_t *ring,
+                             const sample_ring_reader_t *reader) {
+  return (uint32_t)atomic_get(&ring->head) - reader->cursor;
+}
@@ -0,0 +1,173 @@
+/**
+ * @file sensor_filter.c
+ * @brief Fixed-point filter chain for sensor readings
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <zephyr/kernel.h>
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sensor_filter.h>
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+#if SENSOR_FILTER_MEDIAN
+BUILD_ASSERT(CONFIG_APP_FILTER_MEDIAN % 2 == 1,
+             "CONFIG_APP_FILTER_MEDIAN must be odd");
+#endif
+
+#if SENSOR_FILTER_EMA
+BUILD_ASSERT(CONFIG_APP_FILTER_EMA_SHIFT < SENSOR_FILTER_EMA_FRAC_BITS,
+             "The EMA would not settle within 0.5 of its input");
+#endif
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+// Described in .h
+sensor_filter_dht11_t sensor_dht11_filter[DHT11_NUM_INSTANCES];
+
+/*******************************************************************************
+ * Function Definitions
+ ******************************************************************************/
+
+/** Spike rejection stage, false if the sample is rejected.  The channel is
+ * left as it is, the state after the sample is stored in next. */
+static bool spike_check(const sensor_filter_t *filter, int16_t in,
+                        sensor_filter_t *next) {
+  *next = *filter;
+
+#if SENSOR_FILTER_SPIKE
+  if (next->primed && abs(in - next->accepted) > CONFIG_APP_FILTER_SPIKE_X10) {
+    // Rejected samples close to each other build up to a step
+    if (next->rejected &&
+        abs(in - next->candidate) <= CONFIG_APP_FILTER_SPIKE_X10) {
+      next->rejected++;
+    } else {
+      next->rejected = 1;
+      next->candidate = in;
+    }
+
+    if (next->rejected < CONFIG_APP_FILTER_SPIKE_CONFIRM) {
+      return false;
+    }
+  }
+
+  next->rejected = 0;
+  next->accepted = in;
+#endif
+
+  return true;
+}
+
+/** Median and moving average stages of an accepted sample */
+static int16_t smooth(sensor_filter_t *filter, int16_t in) {
+  int16_t out = in;
+
+#if SENSOR_FILTER_MEDIAN
+  int16_t sorted[CONFIG_APP_FILTER_MEDIAN];
+
+  filter->window[filter->next] = in;
+  filter->next = (filter->next + 1) % CONFIG_APP_FILTER_MEDIAN;
+  filter->count = MIN(filter->count + 1, CONFIG_APP_FILTER_MEDIAN);
+
+  // Insertion sort, a handful of elements
+  for (uint8_t idx = 0; idx < filter->count; idx++) {
+    int16_t val = filter->window[idx];
+    uint8_t pos = idx;
+
+    for (; pos > 0 && sorted[pos - 1] > val; pos--) {
+      sorted[pos] = sorted[pos - 1];
+    }
+    sorted[pos] = val;
+  }
+
+  // Lower middle while the window fills with an even count
+  out = sorted[(filter->count - 1) / 2];
+#endif
+
+#if SENSOR_FILTER_EMA
+  int32_t scaled = (int32_t)out * (1 << SENSOR_FILTER_EMA_FRAC_BITS);
+
+  if (!filter->primed) {
+    filter->ema = scaled;
+  } else {
+    filter->ema += (scaled - filter->ema) / (1 << CONFIG_APP_FILTER_EMA_SHIFT);
+  }
+
+  // Round to the nearest, half away from zero
+  int32_t half = 1 << (SENSOR_FILTER_EMA_FRAC_BITS - 1);
+
+  out = (int16_t)((filter->ema + (filter->ema < 0 ? -half : half)) /
+                  (1 << SENSOR_FILTER_EMA_FRAC_BITS));
+#endif
+
+#if SENSOR_FILTER_SPIKE || SENSOR_FILTER_EMA
+  filter->primed = true;
+#endif
+
+  return out;
+}
+
+// Described in .h
+void sensor_filter_reset(sensor_filter_t *filter) {
+  memset(filter, 0, sizeof(*filter));
+}
+
+// Described in .h
+int sensor_filter_apply(sensor_filter_t *filter, int16_t in, int16_t *out) {
+  sensor_filter_t next;
+  bool ok = spike_check(filter, in, &next);
+
+  *filter = next;
+  if (!ok) {
+    return -EAGAIN;
+  }
+
+  *out = smooth(filter, in);
+
+  return 0;
+}
+
+// Described in .h
+int sensor_filter_dht11(sensor_filter_dht11_t *filter,
+                        dht11_sample_t *sample) {
+  int16_t rh = sample->rh_x10;
+  int16_t t = sample->t_x10;
+
+  sensor_filter_t rh_next;
+  sensor_filter_t t_next;
+
+  // Both spike checks before either channel changes, so a dropped reading
+  // leaves no trace in a channel that accepted its sample.  A channel that
+  // rejected its sample still counts it towards a step.
+  bool rh_ok = spike_check(&filter->rh, rh, &rh_next);
+  bool t_ok = spike_check(&filter->t, t, &t_next);
+
+  if (!rh_ok || !t_ok) {
+    if (!rh_ok) {
+      filter->rh = rh_next;
+    }
+    if (!t_ok) {
+      filter->t = t_next;
+    }
+    filter->rejected++;
+    return -EAGAIN;
+  }
+
+  filter->rh = rh_next;
+  filter->t = t_next;
+
+  sample->rh_x10 = smooth(&filter->rh, rh);
+  sample->t_x10 = smooth(&filter->t, t);
+
+  return 0;
+}
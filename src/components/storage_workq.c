@@ -0,0 +1,49 @@
+/**
+ * @file storage_workq.c
+ * @brief Low priority work queue of the flash writes
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+
+#include <storage_workq.h>
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Start storage_workq
+ *
+ * @return 0
+ */
+static int storage_workq_init(void);
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+static K_THREAD_STACK_DEFINE(storage_stack,
+                             CONFIG_APP_STORAGE_WORKQ_STACK_SIZE);
+
+struct k_work_q storage_workq;
+
+SYS_INIT(storage_workq_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+/*******************************************************************************
+ * Function Definitions
+ ******************************************************************************/
+
+// Described above
+static int storage_workq_init(void) {
+  const struct k_work_queue_config cfg = {.name = "storage"};
+
+  k_work_queue_start(&storage_workq, storage_stack,
+                     K_THREAD_STACK_SIZEOF(storage_stack),
+                     K_LOWEST_APPLICATION_THREAD_PRIO, &cfg);
+
+  return 0;
+}
@@ -0,0 +1,257 @@
+/**
+ * @file telemetry.c
+ * @brief Binary telemetry stream over an asynchronous UART
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <zephyr/drivers/uart.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/crc.h>
+
+#include <errno.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <cobs.h>
+#include <telemetry.h>
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+#define TELEMETRY_CRC_SEED 0xFFFF
+
+/** Encoded frame with its zero delimiter */
+#define TELEMETRY_ENCODED_MAX (COBS_MAX_ENCODED_SIZE(TELEMETRY_FRAME_SIZE) + 1)
+
+BUILD_ASSERT(TELEMETRY_TX_BUF_SIZE >= TELEMETRY_ENCODED_MAX,
+             "A transmit buffer must hold a full frame");
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+
+/** A transmit buffer of encoded frames */
+typedef struct tx_buf_s {
+  uint8_t data[TELEMETRY_TX_BUF_SIZE];
+  size_t len;      ///< Encoded bytes
+  uint32_t frames; ///< Frames in data
+} tx_buf_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Handle the UART transfer events
+ *
+ * @param dev UNUSED
+ * @param evt Event of the transfer
+ * @param user_data UNUSED
+ */
+static void telemetry_uart_cb(const struct device *dev, struct uart_event *evt,
+                              void *user_data);
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+static struct k_spinlock lock;
+
+static const struct device *tx_uart;
+
+/** Frame being filled, its header is written when it is closed */
+static uint8_t frame[TELEMETRY_FRAME_SIZE];
+static size_t frame_len;
+static uint16_t frame_seq;
+
+static tx_buf_t tx_bufs[2];
+
+/** Buffer collecting frames, the other one may be in flight */
+static uint8_t tx_fill;
+
+/** True while the UART sends tx_bufs[tx_fill ^ 1] */
+static bool tx_busy;
+
+static telemetry_stats_t stats;
+
+/*******************************************************************************
+ * Function Definitions
+ ******************************************************************************/
+
+/** Hand the filling buffer to the UART if it is idle, lock held */
+static tx_buf_t *tx_claim(void) {
+  tx_buf_t *buf = &tx_bufs[tx_fill];
+
+  if (tx_busy || buf->len == 0) {
+    return NULL;
+  }
+
+  tx_busy = true;
+  tx_fill ^= 1;
+
+  return buf;
+}
+
+/**
+ * @brief Send a buffer returned by tx_claim()
+ *
+ * Called without the lock, a driver may complete the transfer from within
+ * uart_tx().
+ */
+static void tx_send(tx_buf_t *buf) {
+  if (buf == NULL) {
+    return;
+  }
+
+  if (uart_tx(tx_uart, buf->data, buf->len, SYS_FOREVER_US)) {
+    K_SPINLOCK(&lock) {
+      stats.tx_errors++;
+      stats.frames_dropped += buf->frames;
+      buf->len = 0;
+      buf->frames = 0;
+      tx_busy = false;
+    }
+  }
+}
+
+/** Encode the open frame into the filling buffer, lock held */
+static tx_buf_t *frame_close(void) {
+  tx_buf_t *buf = &tx_bufs[tx_fill];
+
+  if (frame_len == TELEMETRY_HEADER_SIZE) {
+    return NULL;
+  }
+
+  frame[0] = TELEMETRY_VERSION;
+  sys_put_le16(frame_seq++, &frame[1]);
+  sys_put_le32(k_uptime_get_32(), &frame[3]);
+  sys_put_le16(crc16_ccitt(TELEMETRY_CRC_SEED, frame, frame_len),
+               &frame[frame_len]);
+  frame_len += TELEMETRY_CRC_SIZE;
+  stats.frames++;
+
+  // The delimiter needs one byte past the encoding
+  int ret = cobs_encode(frame, frame_len, &buf->data[buf->len],
+                        sizeof(buf->data) - buf->len - 1);
+
+  if (ret < 0) {
+    stats.frames_dropped++;
+  } else {
+    buf->len += ret;
+    buf->data[buf->len++] = 0;
+    buf->frames++;
+  }
+
+  frame_len = TELEMETRY_HEADER_SIZE;
+
+  return tx_claim();
+}
+
+// Described in .h
+int telemetry_init(const struct device *uart) {
+  if (!device_is_ready(uart)) {
+    return -ENODEV;
+  }
+
+  int ret = uart_callback_set(uart, telemetry_uart_cb, NULL);
+
+  if (ret) {
+    return ret;
+  }
+
+  K_SPINLOCK(&lock) {
+    tx_uart = uart;
+    frame_len = TELEMETRY_HEADER_SIZE;
+  }
+
+  return 0;
+}
+
+// Described in .h
+int telemetry_put(uint8_t type, const void *payload, size_t len) {
+  tx_buf_t *send = NULL;
+  int ret = 0;
+
+  if (len > TELEMETRY_RECORD_MAX) {
+    return -EINVAL;
+  }
+
+  K_SPINLOCK(&lock) {
+    if (tx_uart == NULL) {
+      ret = -ENODEV;
+      K_SPINLOCK_BREAK;
+    }
+
+    if (frame_len + TELEMETRY_RECORD_HEADER_SIZE + len >
+        sizeof(frame) - TELEMETRY_CRC_SIZE) {
+      send = frame_close();
+    }
+
+    frame[frame_len++] = type;
+    frame[frame_len++] = (uint8_t)len;
+    if (len) {
+      memcpy(&frame[frame_len], payload, len);
+      frame_len += len;
+    }
+    stats.records++;
+  }
+
+  tx_send(send);
+
+  return ret;
+}
+
+// Described in .h
+void telemetry_flush(void) {
+  tx_buf_t *send = NULL;
+
+  K_SPINLOCK(&lock) {
+    if (tx_uart != NULL) {
+      send = frame_close();
+    }
+  }
+
+  tx_send(send);
+}
+
+// Described in .h
+void telemetry_get_stats(telemetry_stats_t *out) {
+  K_SPINLOCK(&lock) {
+    *out = stats;
+  }
+}
+
+// Described above
+static void telemetry_uart_cb(const struct device *dev, struct uart_event *evt,
+                              void *user_data) {
+  tx_buf_t *send = NULL;
+
+  if (evt->type != UART_TX_DONE && evt->type != UART_TX_ABORTED) {
+    return;
+  }
+
+  K_SPINLOCK(&lock) {
+    tx_buf_t *buf = &tx_bufs[tx_fill ^ 1];
+
+    if (evt->type == UART_TX_DONE) {
+      stats.frames_sent += buf->frames;
+    } else {
+      stats.tx_errors++;
+      stats.frames_dropped += buf->frames;
+    }
+    stats.bytes_sent += evt->data.tx.len;
+
+    buf->len = 0;
+    buf->frames = 0;
+    tx_busy = false;
+
+    // Frames collected meanwhile go out at once
+    send = tx_claim();
+  }
+
+  tx_send(send);
+}
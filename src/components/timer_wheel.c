@@ -0,0 +1,168 @@
+/**
+ * @file timer_wheel.c
+ * @brief Hashed timer wheel sharing a single k_timer between many timeouts
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/dlist.h>
+
+#include <timer_wheel.h>
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/** Mask applied to a tick to find its slot */
+#define TIMER_WHEEL_MASK (TIMER_WHEEL_SLOTS - 1)
+
+BUILD_ASSERT((TIMER_WHEEL_SLOTS & TIMER_WHEEL_MASK) == 0,
+             "TIMER_WHEEL_SLOTS must be a power of two");
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/** Advance the wheel by one slot and run the expired callbacks */
+static void wheel_tick(struct k_timer *timer);
+
+/** Remove an entry from whichever list holds it.  Called with the lock held */
+static void wheel_unlink(timer_wheel_entry_t *entry);
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+static K_TIMER_DEFINE(wheel_timer, wheel_tick, NULL);
+
+static struct k_spinlock wheel_lock;
+
+static sys_dlist_t slots[TIMER_WHEEL_SLOTS];
+
+/** Entries due in the current tick whose callbacks have not run yet */
+static sys_dlist_t expired;
+
+/** Slot processed by the last tick */
+static uint32_t wheel_pos;
+
+/** Number of armed entries, the k_timer runs while this is non-zero */
+static uint32_t armed_count;
+
+static uint32_t tick_count;
+
+static bool initialised;
+
+/*******************************************************************************
+ * Function Definitions
+ ******************************************************************************/
+
+// Described in .h
+void timer_wheel_init_entry(timer_wheel_entry_t *entry, timer_wheel_fn_t fn) {
+  sys_dnode_init(&entry->node);
+  entry->rounds = 0;
+  entry->fn = fn;
+  entry->armed = false;
+
+  K_SPINLOCK(&wheel_lock) {
+    if (!initialised) {
+      for (uint32_t slot = 0; slot < TIMER_WHEEL_SLOTS; slot++) {
+        sys_dlist_init(&slots[slot]);
+      }
+      sys_dlist_init(&expired);
+      initialised = true;
+    }
+  }
+}
+
+// Described above
+static void wheel_unlink(timer_wheel_entry_t *entry) {
+  if (sys_dnode_is_linked(&entry->node)) {
+    sys_dlist_remove(&entry->node);
+  }
+
+  if (entry->armed) {
+    entry->armed = false;
+    armed_count--;
+  }
+}
+
+// Described in .h
+void timer_wheel_start(timer_wheel_entry_t *entry, uint32_t timeout_ms) {
+  K_SPINLOCK(&wheel_lock) {
+    bool running = armed_count > 0;
+
+    wheel_unlink(entry);
+
+    // While running, the next tick is less than a full tick away so one more
+    // is needed to guarantee the minimum delay
+    uint32_t ticks = DIV_ROUND_UP(timeout_ms, TIMER_WHEEL_TICK_MS) +
+                     (running ? 1 : 0);
+    ticks = MAX(ticks, 1);
+
+    entry->rounds = (ticks - 1) / TIMER_WHEEL_SLOTS;
+    entry->armed = true;
+    sys_dlist_append(&slots[(wheel_pos + ticks) & TIMER_WHEEL_MASK],
+                     &entry->node);
+
+    if (armed_count++ == 0) {
+      k_timer_start(&wheel_timer, K_MSEC(TIMER_WHEEL_TICK_MS),
+                    K_MSEC(TIMER_WHEEL_TICK_MS));
+    }
+  }
+}
+
+// Described in .h
+void timer_wheel_stop(timer_wheel_entry_t *entry) {
+  K_SPINLOCK(&wheel_lock) {
+    wheel_unlink(entry);
+
+    if (armed_count == 0) {
+      k_timer_stop(&wheel_timer);
+    }
+  }
+}
+
+// Described in .h
+uint32_t timer_wheel_ticks(void) { return tick_count; }
+
+// Described above
+static void wheel_tick(struct k_timer *timer) {
+  timer_wheel_entry_t *entry;
+  timer_wheel_entry_t *next;
+
+  K_SPINLOCK(&wheel_lock) {
+    tick_count++;
+    wheel_pos = (wheel_pos + 1) & TIMER_WHEEL_MASK;
+
+    SYS_DLIST_FOR_EACH_CONTAINER_SAFE(&slots[wheel_pos], entry, next, node) {
+      if (entry->rounds) {
+        entry->rounds--;
+        continue;
+      }
+
+      wheel_unlink(entry);
+      sys_dlist_append(&expired, &entry->node);
+    }
+
+    if (armed_count == 0) {
+      k_timer_stop(&wheel_timer);
+    }
+  }
+
+  // Callbacks run unlocked so they can re-arm.  An entry stopped before its
+  // callback ran is unlinked from the expired list and skipped.
+  while (1) {
+    sys_dnode_t *node = NULL;
+
+    K_SPINLOCK(&wheel_lock) { node = sys_dlist_get(&expired); }
+
+    if (!node) {
+      break;
+    }
+
+    entry = CONTAINER_OF(node, timer_wheel_entry_t, node);
+    entry->fn(entry);
+  }
+}
@@ -0,0 +1,751 @@
+/**
+ * @file ts_store.c
+ * @brief Flash backed time series of sensor samples
+ *
+ * A batch is laid out as
+ *
+ * | Bytes | Content                                          |
+ * | ----- | ------------------------------------------------ |
+ * | 1     | Format version                                   |
+ * | 2     | Sample count                                     |
+ * | 4     | Timestamp of the first sample                    |
+ * | 2 + 2 | Humidity and temperature of the first sample     |
+ * | ...   | Per sample: varint time delta, zigzag varint     |
+ * |       | humidity and temperature deltas                  |
+ * | 2     | CRC16 of everything above                        |
+ *
+ * all little endian, padded with zeros to the flash write block size.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <zephyr/fs/fcb.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/crc.h>
+
+#include <string.h>
+
+#include <ts_store.h>
+
+LOG_MODULE_REGISTER(ts_store, 3);
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/** Identifies the FCB sectors of a store */
+#define STORE_MAGIC 0x54535331
+
+/** Format version of a batch */
+#define BATCH_VERSION 1
+
+/** Version, count, timestamp, humidity and temperature */
+#define BATCH_HEADER_SIZE 11
+
+#define BATCH_CRC_SIZE 2
+
+#define BATCH_CRC_SEED 0xFFFF
+
+/** A 32 bit varint and two zigzag encoded 17 bit varints */
+#define RECORD_MAX_SIZE 11
+
+/** Most flash sectors a store may span */
+#define MAX_SECTORS 32
+
+/** Largest flash write block supported, its padding is reserved in a batch */
+#define MAX_ALIGN 32
+
+/** Where a cursor finds its next batch */
+enum cursor_state_e {
+  CURSOR_AT_LOC = 0, ///< The entry at loc, not read yet
+  CURSOR_AFTER_LOC,  ///< The entry following loc
+  CURSOR_RAM,        ///< The RAM batch
+  CURSOR_END,        ///< Nothing left
+};
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+
+/** Batch indexed for seeks */
+typedef struct index_entry_s {
+  uint32_t first_s;     ///< Timestamp of the first sample of the batch
+  struct fcb_entry loc; ///< Entry of the batch
+} index_entry_t;
+
+/** Batch being filled in RAM */
+typedef struct ram_batch_s {
+  uint8_t buf[TS_STORE_BATCH_SIZE];
+  uint16_t pos;     ///< Bytes used
+  uint16_t count;   ///< Samples in the batch
+  ts_sample_t last; ///< Base of the next delta
+} ram_batch_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Decode one sample of a batch
+ *
+ * @param buf Batch
+ * @param len Bytes in buf
+ * @param pos Offset of the sample, 0 for the header sample.  Advanced past it.
+ * @param sample Previous sample on entry, the decoded one on return
+ * @return True on success, false if the sample is malformed
+ */
+static bool batch_decode(const uint8_t *buf, uint16_t len, uint16_t *pos,
+                         ts_sample_t *sample);
+
+/**
+ * @brief Validate a batch read from flash
+ *
+ * @param buf Batch
+ * @param len Bytes in buf
+ * @param first Pointer to store the first sample
+ * @param last Pointer to store the last sample
+ * @return Sample count, 0 if the batch is invalid
+ */
+static uint16_t batch_check(const uint8_t *buf, uint16_t len,
+                            ts_sample_t *first, ts_sample_t *last);
+
+/**
+ * @brief Write the RAM batch as an FCB entry and index it
+ *
+ * Called with store_lock held.
+ *
+ * @return 0 on success or if the batch is empty, negative errno otherwise
+ */
+static int batch_write(void);
+
+/**
+ * @brief Erase the oldest sector and forget its batches
+ *
+ * Called with store_lock held.
+ *
+ * @return 0 on success, negative errno otherwise
+ */
+static int store_rotate(void);
+
+/**
+ * @brief Add a batch to the seek index, thinning it out when full
+ *
+ * @param first_s Timestamp of the first sample of the batch
+ * @param loc Entry of the batch
+ */
+static void index_add(uint32_t first_s, const struct fcb_entry *loc);
+
+/**
+ * @brief Read the next sample of a cursor
+ *
+ * Called with store_lock held.
+ *
+ * @param cursor Cursor to advance
+ * @param sample Pointer to store the sample
+ * @return 0 on success, -ENOENT at the end, -ESTALE after a rotation
+ */
+static int cursor_next(ts_store_cursor_t *cursor, ts_sample_t *sample);
+
+/**
+ * @brief Load the next batch of a cursor into its buffer
+ *
+ * Called with store_lock held.  An invalid batch is skipped and leaves the
+ * cursor empty.
+ *
+ * @param cursor Cursor to load
+ * @return 0 on success, -ENOENT if there is no further batch
+ */
+static int cursor_load(ts_store_cursor_t *cursor);
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+static K_MUTEX_DEFINE(store_lock);
+
+static struct fcb store_fcb;
+
+static struct flash_sector store_sectors[MAX_SECTORS];
+
+static bool mounted;
+
+/** Flash write block size */
+static uint32_t store_align;
+
+/** Bytes a batch may use for samples, leaving room for its CRC and padding */
+static uint16_t record_limit;
+
+/** Incremented whenever batches are erased, invalidates cursors */
+static uint32_t generation;
+
+static ram_batch_t batch;
+
+/** Newest sample in flash or the RAM batch */
+static ts_sample_t last_sample;
+static bool have_last;
+
+/** Index of the batches in flash, oldest first */
+static index_entry_t index_entries[TS_STORE_INDEX_SIZE];
+static uint16_t index_len;
+static uint32_t index_skip;
+
+static ts_store_stats_t stats;
+
+/** Batch buffer of the recovery scan */
+static uint8_t scan_buf[TS_STORE_BATCH_SIZE];
+
+/*******************************************************************************
+ * Function Definitions
+ ******************************************************************************/
+
+/** Append an unsigned LEB128 varint */
+static uint8_t put_varint(uint8_t *out, uint32_t val) {
+  uint8_t len = 0;
+
+  while (val >= 0x80) {
+    out[len++] = (val & 0x7F) | 0x80;
+    val >>= 7;
+  }
+  out[len++] = val;
+
+  return len;
+}
+
+/** Read an unsigned LEB128 varint of at most 32 bits */
+static bool get_varint(const uint8_t *buf, uint16_t len, uint16_t *pos,
+                       uint32_t *val) {
+  uint32_t res = 0;
+
+  for (uint8_t shift = 0; shift < 35; shift += 7) {
+    if (*pos >= len) {
+      return false;
+    }
+
+    uint8_t byte = buf[(*pos)++];
+
+    res |= (uint32_t)(byte & 0x7F) << shift;
+    if (!(byte & 0x80)) {
+      *val = res;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/** Map a signed delta to an unsigned one, small magnitudes to small values */
+static uint32_t zigzag(int32_t val) {
+  return ((uint32_t)val << 1) ^ (uint32_t)(val >> 31);
+}
+
+static int32_t unzigzag(uint32_t val) {
+  return (int32_t)(val >> 1) ^ -(int32_t)(val & 1);
+}
+
+/** Encode a sample as deltas to its predecessor */
+static uint8_t encode_record(const ts_sample_t *prev, const ts_sample_t *sample,
+                             uint8_t *out) {
+  uint8_t len = put_varint(out, sample->time_s - prev->time_s);
+
+  len += put_varint(&out[len], zigzag(sample->rh_x10 - prev->rh_x10));
+  len += put_varint(&out[len], zigzag(sample->t_x10 - prev->t_x10));
+
+  return len;
+}
+
+/** Start the RAM batch with a sample */
+static void batch_start(const ts_sample_t *sample) {
+  batch.buf[0] = BATCH_VERSION;
+  sys_put_le16(0, &batch.buf[1]);
+  sys_put_le32(sample->time_s, &batch.buf[3]);
+  sys_put_le16((uint16_t)sample->rh_x10, &batch.buf[7]);
+  sys_put_le16((uint16_t)sample->t_x10, &batch.buf[9]);
+  batch.pos = BATCH_HEADER_SIZE;
+  batch.count = 1;
+}
+
+/** Bytes an FCB entry of len data bytes occupies in flash */
+static uint32_t entry_flash_size(uint16_t len) {
+  // Length of one or two bytes, data and CRC8, each padded to a write block
+  return ROUND_UP(len < 0x80 ? 1 : 2, store_align) +
+         ROUND_UP(len, store_align) + ROUND_UP(1, store_align);
+}
+
+// Described above
+static bool batch_decode(const uint8_t *buf, uint16_t len, uint16_t *pos,
+                         ts_sample_t *sample) {
+  uint32_t dt;
+  uint32_t drh;
+  uint32_t dtemp;
+
+  if (*pos == 0) {
+    if (len < BATCH_HEADER_SIZE) {
+      return false;
+    }
+
+    sample->time_s = sys_get_le32(&buf[3]);
+    sample->rh_x10 = (int16_t)sys_get_le16(&buf[7]);
+    sample->t_x10 = (int16_t)sys_get_le16(&buf[9]);
+    *pos = BATCH_HEADER_SIZE;
+    return true;
+  }
+
+  if (!get_varint(buf, len, pos, &dt) || !get_varint(buf, len, pos, &drh) ||
+      !get_varint(buf, len, pos, &dtemp)) {
+    return false;
+  }
+
+  int32_t rh = sample->rh_x10 + unzigzag(drh);
+  int32_t temp = sample->t_x10 + unzigzag(dtemp);
+
+  if (sample->time_s + dt < sample->time_s || rh < INT16_MIN ||
+      rh > INT16_MAX || temp < INT16_MIN || temp > INT16_MAX) {
+    return false;
+  }
+
+  sample->time_s += dt;
+  sample->rh_x10 = rh;
+  sample->t_x10 = temp;
+
+  return true;
+}
+
+// Described above
+static uint16_t batch_check(const uint8_t *buf, uint16_t len,
+                            ts_sample_t *first, ts_sample_t *last) {
+  ts_sample_t sample;
+  uint16_t pos = 0;
+
+  if (len < BATCH_HEADER_SIZE + BATCH_CRC_SIZE || buf[0] != BATCH_VERSION) {
+    return 0;
+  }
+
+  uint16_t count = sys_get_le16(&buf[1]);
+
+  for (uint16_t idx = 0; idx < count; idx++) {
+    if (!batch_decode(buf, len, &pos, &sample)) {
+      return 0;
+    }
+    if (idx == 0) {
+      *first = sample;
+    }
+  }
+
+  if (!count || pos + BATCH_CRC_SIZE > len ||
+      sys_get_le16(&buf[pos]) != crc16_ccitt(BATCH_CRC_SEED, buf, pos)) {
+    return 0;
+  }
+
+  *last = sample;
+
+  return count;
+}
+
+// Described above
+static void index_add(uint32_t first_s, const struct fcb_entry *loc) {
+  if (index_skip) {
+    index_skip--;
+    return;
+  }
+
+  // Keep every other entry and index half as many batches from now on
+  if (index_len == TS_STORE_INDEX_SIZE) {
+    for (uint16_t idx = 0; idx < TS_STORE_INDEX_SIZE / 2; idx++) {
+      index_entries[idx] = index_entries[2 * idx];
+    }
+    index_len = TS_STORE_INDEX_SIZE / 2;
+    stats.index_stride *= 2;
+  }
+
+  index_entries[index_len].first_s = first_s;
+  index_entries[index_len].loc = *loc;
+  index_len++;
+  index_skip = stats.index_stride - 1;
+}
+
+// Described above
+static int store_rotate(void) {
+  struct flash_sector *oldest = store_fcb.f_oldest;
+  uint16_t dropped = 0;
+
+  while (dropped < index_len &&
+         index_entries[dropped].loc.fe_sector == oldest) {
+    dropped++;
+  }
+
+  memmove(index_entries, &index_entries[dropped],
+          (index_len - dropped) * sizeof(index_entries[0]));
+  index_len -= dropped;
+
+  int ret = fcb_rotate(&store_fcb);
+
+  if (ret) {
+    return ret;
+  }
+
+  stats.rotations++;
+  stats.erased_bytes += oldest->fs_size;
+  generation++;
+
+  return 0;
+}
+
+// Described above
+static int batch_write(void) {
+  struct fcb_entry loc;
+  int ret;
+
+  if (!batch.count) {
+    return 0;
+  }
+
+  sys_put_le16(batch.count, &batch.buf[1]);
+  sys_put_le16(crc16_ccitt(BATCH_CRC_SEED, batch.buf, batch.pos),
+               &batch.buf[batch.pos]);
+
+  uint16_t len = ROUND_UP(batch.pos + BATCH_CRC_SIZE, store_align);
+
+  memset(&batch.buf[batch.pos + BATCH_CRC_SIZE], 0,
+         len - batch.pos - BATCH_CRC_SIZE);
+
+  while ((ret = fcb_append(&store_fcb, len, &loc)) == -ENOSPC) {
+    ret = store_rotate();
+    if (ret) {
+      return ret;
+    }
+  }
+
+  if (ret) {
+    return ret;
+  }
+
+  ret = flash_area_write(store_fcb.fap, FCB_ENTRY_FA_DATA_OFF(loc), batch.buf,
+                         len);
+  if (ret) {
+    return ret;
+  }
+
+  ret = fcb_append_finish(&store_fcb, &loc);
+  if (ret) {
+    return ret;
+  }
+
+  stats.batches++;
+  stats.flash_bytes += entry_flash_size(len);
+  index_add(sys_get_le32(&batch.buf[3]), &loc);
+
+  batch.count = 0;
+  batch.pos = 0;
+
+  return 0;
+}
+
+// Described in .h
+int ts_store_init(uint8_t area_id) {
+  uint32_t sector_cnt = MAX_SECTORS;
+  struct fcb_entry loc = {0};
+  ts_sample_t first;
+  ts_sample_t last;
+  int ret;
+
+  k_mutex_lock(&store_lock, K_FOREVER);
+
+  mounted = false;
+  have_last = false;
+  index_len = 0;
+  index_skip = 0;
+  generation++;
+  memset(&batch, 0, sizeof(batch));
+  memset(&stats, 0, sizeof(stats));
+  stats.index_stride = 1;
+
+  ret = flash_area_get_sectors(area_id, &sector_cnt, store_sectors);
+  if (ret) {
+    goto out;
+  }
+
+  memset(&store_fcb, 0, sizeof(store_fcb));
+  store_fcb.f_magic = STORE_MAGIC;
+  store_fcb.f_version = BATCH_VERSION;
+  store_fcb.f_sector_cnt = sector_cnt;
+  store_fcb.f_sectors = store_sectors;
+
+  ret = fcb_init(area_id, &store_fcb);
+  if (ret) {
+    goto out;
+  }
+
+  store_align = flash_area_align(store_fcb.fap);
+  if (store_align > MAX_ALIGN) {
+    ret = -ENOTSUP;
+    goto out;
+  }
+  record_limit = TS_STORE_BATCH_SIZE - BATCH_CRC_SIZE - (store_align - 1);
+
+  // Rebuild the index from every batch that decodes and continues the series
+  while (!fcb_getnext(&store_fcb, &loc)) {
+    if (loc.fe_data_len > sizeof(scan_buf) ||
+        flash_area_read(store_fcb.fap, FCB_ENTRY_FA_DATA_OFF(loc), scan_buf,
+                        loc.fe_data_len) ||
+        !batch_check(scan_buf, loc.fe_data_len, &first, &last) ||
+        (have_last && first.time_s < last_sample.time_s)) {
+      stats.discarded++;
+      continue;
+    }
+
+    stats.recovered++;
+    index_add(first.time_s, &loc);
+    last_sample = last;
+    have_last = true;
+  }
+
+  mounted = true;
+
+  LOG_INF("%u batches recovered, %u discarded", stats.recovered,
+          stats.discarded);
+
+out:
+  k_mutex_unlock(&store_lock);
+
+  return ret;
+}
+
+// Described in .h
+int ts_store_append(const ts_sample_t *sample) {
+  uint8_t record[RECORD_MAX_SIZE];
+  int ret = 0;
+
+  k_mutex_lock(&store_lock, K_FOREVER);
+
+  if (!mounted) {
+    ret = -ENODEV;
+    goto out;
+  }
+
+  if (have_last && sample->time_s < last_sample.time_s) {
+    ret = -EINVAL;
+    goto out;
+  }
+
+  if (!batch.count) {
+    batch_start(sample);
+  } else {
+    uint8_t len = encode_record(&batch.last, sample, record);
+
+    if (batch.pos + len <= record_limit) {
+      memcpy(&batch.buf[batch.pos], record, len);
+      batch.pos += len;
+      batch.count++;
+    } else {
+      ret = batch_write();
+      if (ret) {
+        goto out;
+      }
+      batch_start(sample);
+    }
+  }
+
+  batch.last = *sample;
+  last_sample = *sample;
+  have_last = true;
+  stats.samples++;
+
+out:
+  k_mutex_unlock(&store_lock);
+
+  return ret;
+}
+
+// Described in .h
+int ts_store_flush(void) {
+  k_mutex_lock(&store_lock, K_FOREVER);
+
+  int ret = mounted ? batch_write() : -ENODEV;
+
+  k_mutex_unlock(&store_lock);
+
+  return ret;
+}
+
+// Described above
+static int cursor_load(ts_store_cursor_t *cursor) {
+  ts_sample_t first;
+  ts_sample_t last;
+
+  switch (cursor->state) {
+  case CURSOR_AT_LOC:
+    cursor->state = CURSOR_AFTER_LOC;
+    break;
+  case CURSOR_AFTER_LOC:
+    if (fcb_getnext(&store_fcb, &cursor->loc)) {
+      cursor->state = CURSOR_RAM;
+      return 0;
+    }
+    break;
+  case CURSOR_RAM:
+    cursor->state = CURSOR_END;
+    memcpy(cursor->buf, batch.buf, batch.pos);
+    cursor->len = batch.pos;
+    cursor->pos = 0;
+    cursor->left = batch.count;
+    return 0;
+  default:
+    return -ENOENT;
+  }
+
+  uint16_t len = cursor->loc.fe_data_len;
+
+  if (len > sizeof(cursor->buf) ||
+      flash_area_read(store_fcb.fap, FCB_ENTRY_FA_DATA_OFF(cursor->loc),
+                      cursor->buf, len)) {
+    stats.discarded++;
+    return 0;
+  }
+
+  cursor->left = batch_check(cursor->buf, len, &first, &last);
+  cursor->len = len;
+  cursor->pos = 0;
+  if (!cursor->left) {
+    stats.discarded++;
+  }
+
+  return 0;
+}
+
+// Described above
+static int cursor_next(ts_store_cursor_t *cursor, ts_sample_t *sample) {
+  if (cursor->generation != generation) {
+    return -ESTALE;
+  }
+
+  if (cursor->peeked) {
+    cursor->peeked = false;
+    *sample = cursor->prev;
+    return 0;
+  }
+
+  while (!cursor->left) {
+    int ret = cursor_load(cursor);
+
+    if (ret) {
+      return ret;
+    }
+  }
+
+  // Validated when loaded, RAM batches are well formed by construction
+  batch_decode(cursor->buf, cursor->len, &cursor->pos, &cursor->prev);
+  cursor->left--;
+  *sample = cursor->prev;
+
+  return 0;
+}
+
+// Described in .h
+int ts_store_seek(uint32_t time_s, ts_store_cursor_t *cursor) {
+  ts_sample_t sample;
+  int ret = 0;
+
+  k_mutex_lock(&store_lock, K_FOREVER);
+
+  if (!mounted) {
+    ret = -ENODEV;
+    goto out;
+  }
+
+  memset(&cursor->loc, 0, sizeof(cursor->loc));
+  cursor->generation = generation;
+  cursor->left = 0;
+  cursor->peeked = false;
+  cursor->state = CURSOR_AFTER_LOC;
+
+  // Last indexed batch starting at or before time_s, from the oldest batch if
+  // there is none
+  uint16_t lo = 0;
+  uint16_t hi = index_len;
+
+  while (lo < hi) {
+    uint16_t mid = (lo + hi) / 2;
+
+    if (index_entries[mid].first_s <= time_s) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  if (lo) {
+    cursor->loc = index_entries[lo - 1].loc;
+    cursor->state = CURSOR_AT_LOC;
+  }
+
+  while (!cursor_next(cursor, &sample)) {
+    if (sample.time_s >= time_s) {
+      cursor->peeked = true;
+      break;
+    }
+  }
+
+out:
+  k_mutex_unlock(&store_lock);
+
+  return ret;
+}
+
+// Described in .h
+int ts_store_next(ts_store_cursor_t *cursor, ts_sample_t *sample) {
+  k_mutex_lock(&store_lock, K_FOREVER);
+
+  int ret = cursor_next(cursor, sample);
+
+  k_mutex_unlock(&store_lock);
+
+  return ret;
+}
+
+// Described in .h
+int ts_store_last_time(uint32_t *time_s) {
+  int ret = -ENOENT;
+
+  k_mutex_lock(&store_lock, K_FOREVER);
+
+  if (have_last) {
+    *time_s = last_sample.time_s;
+    ret = 0;
+  }
+
+  k_mutex_unlock(&store_lock);
+
+  return ret;
+}
+
+// Described in .h
+int ts_store_clear(void) {
+  k_mutex_lock(&store_lock, K_FOREVER);
+
+  int ret = mounted ? fcb_clear(&store_fcb) : -ENODEV;
+
+  if (!ret) {
+    have_last = false;
+    index_len = 0;
+    index_skip = 0;
+    generation++;
+    batch.count = 0;
+    batch.pos = 0;
+    stats.index_stride = 1;
+  }
+
+  k_mutex_unlock(&store_lock);
+
+  return ret;
+}
+
+// Described in .h
+void ts_store_get_stats(ts_store_stats_t *out) {
+  k_mutex_lock(&store_lock, K_FOREVER);
+  *out = stats;
+  k_mutex_unlock(&store_lock);
+}
@@ -0,0 +1,472 @@
+/**
+ * @file dht11_shell.c
+ * @brief `dht11` shell commands
+ *
+ * Every command except `dht11 read`, `dht11 stats` and `dht11 history` only
+ * copies counters that the drivers publish without a lock, so running them
+ * never masks the capture interrupt or delays the system work queue.
+ * `dht11 stats` holds the rollup lock for one bucket at a time.  `dht11 read`
+ * goes through the cache like any other consumer and `dht11 history` waits
+ * for the store while it writes or erases flash, both block the shell thread
+ * only.  `dht11 derived` computes the metrics of the newest sample under a
+ * spinlock unless another subscriber already did.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+
+#include <string.h>
+
+#include <app.h>
+#include <derived.h>
+#include <dht11.h>
+#include <dht11_cache.h>
+#include <dht11_calib.h>
+#include <dht11_reliable.h>
+#include <rollup.h>
+#include <sample_ring.h>
+#include <sensor_filter.h>
+#ifdef CONFIG_APP_HISTORY
+#include <history.h>
+#include <ts_store.h>
+#endif
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/** Width of the longest histogram bar in characters */
+#define HIST_BAR_WIDTH 40
+
+/** Samples printed by `dht11 history` without a count */
+#define HISTORY_DEFAULT_COUNT 20
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Parse the optional instance argument
+ *
+ * @param sh Shell to report errors to
+ * @param argc Argument count of the command
+ * @param argv Arguments of the command, the instance is argv[1]
+ * @param inst Pointer to store the instance, 0 if absent
+ *
+ * @return 0 on success, -EINVAL if the argument is not a valid instance
+ */
+static int parse_inst(const struct shell *sh, size_t argc, char **argv,
+                      uint8_t *inst);
+
+/**
+ * @brief Print the non empty bins of a histogram with a bar each
+ *
+ * @param sh Shell to print to
+ * @param bins Histogram counts
+ * @param count Number of bins
+ * @param bin_us Width of a bin in us, the last bin is open ended
+ */
+static void print_histogram(const struct shell *sh, const uint16_t *bins,
+                            uint16_t count, uint32_t bin_us);
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+/** Names of the reliable layer classes, also the `dht11 hist bus` argument */
+static const char *const class_names[DHT11_RELIABLE_CLASS_MAX] = {
+    [DHT11_RELIABLE_CLASS_OK] = "ok",
+    [DHT11_RELIABLE_CLASS_NO_RESPONSE] = "no_response",
+    [DHT11_RELIABLE_CLASS_SETUP] = "setup",
+    [DHT11_RELIABLE_CLASS_PARITY] = "parity",
+    [DHT11_RELIABLE_CLASS_RANGE] = "range",
+    [DHT11_RELIABLE_CLASS_OTHER] = "other",
+};
+
+static const char *const calib_state_names[] = {
+    [DHT11_CALIB_STATE_DEFAULT] = "default",
+    [DHT11_CALIB_STATE_RUNNING] = "running",
+    [DHT11_CALIB_STATE_DONE] = "done",
+};
+
+/*******************************************************************************
+ * Function Definitions
+ ******************************************************************************/
+
+// Described above
+static int parse_inst(const struct shell *sh, size_t argc, char **argv,
+                      uint8_t *inst) {
+  int err = 0;
+
+  *inst = 0;
+  if (argc < 2) {
+    return 0;
+  }
+
+  unsigned long val = shell_strtoul(argv[1], 10, &err);
+
+  if (err || val >= DHT11_NUM_INSTANCES) {
+    shell_error(sh, "Instance must be 0 to %d", DHT11_NUM_INSTANCES - 1);
+    return -EINVAL;
+  }
+
+  *inst = (uint8_t)val;
+
+  return 0;
+}
+
+// Described above
+static void print_histogram(const struct shell *sh, const uint16_t *bins,
+                            uint16_t count, uint32_t bin_us) {
+  char bar[HIST_BAR_WIDTH + 1];
+  uint16_t peak = 0;
+
+  for (uint16_t idx = 0; idx < count; idx++) {
+    peak = MAX(peak, bins[idx]);
+  }
+
+  if (!peak) {
+    shell_print(sh, "  (empty)");
+    return;
+  }
+
+  for (uint16_t idx = 0; idx < count; idx++) {
+    if (!bins[idx]) {
+      continue;
+    }
+
+    uint32_t len = DIV_ROUND_UP((uint32_t)bins[idx] * HIST_BAR_WIDTH, peak);
+
+    memset(bar, '#', len);
+    bar[len] = '\0';
+
+    if (idx == count - 1) {
+      shell_print(sh, "  %6u+      us %6u %s", idx * bin_us, bins[idx], bar);
+    } else {
+      shell_print(sh, "  %6u-%-6u us %6u %s", idx * bin_us,
+                  (idx + 1) * bin_us - 1, bins[idx], bar);
+    }
+  }
+}
+
+/** `dht11 read [inst]`, forces a physical read through the cache */
+static int cmd_dht11_read(const struct shell *sh, size_t argc, char **argv) {
+  dht11_reading_t reading;
+  uint8_t inst;
+
+  if (parse_inst(sh, argc, argv, &inst)) {
+    return -EINVAL;
+  }
+
+  dht11_error_t err = dht11_cache_get(inst, 0, &reading);
+
+  if (err) {
+    shell_error(sh, "Read failed, err=%d", err);
+    return -EIO;
+  }
+
+  shell_print(sh, "%s RH=" DHT11_X10_FMT " %% T=" DHT11_X10_FMT " C at %lld ms",
+              dht11_model_get(inst)->name,
+              DHT11_X10_ARGS(reading.sample.rh_x10),
+              DHT11_X10_ARGS(reading.sample.t_x10), reading.timestamp_ms);
+
+  return 0;
+}
+
+/** `dht11 last`, newest sample published by the application */
+static int cmd_dht11_last(const struct shell *sh, size_t argc, char **argv) {
+  sample_ring_sample_t sample;
+
+  if (sample_ring_latest(&sensor_sample_ring, &sample)) {
+    shell_print(sh, "No sample published yet");
+    return 0;
+  }
+
+  shell_print(sh,
+              "inst %u: RH=" DHT11_X10_FMT " %% T=" DHT11_X10_FMT
+              " C, %lld ms ago",
+              sample.inst, DHT11_X10_ARGS(sample.data.rh_x10),
+              DHT11_X10_ARGS(sample.data.t_x10),
+              k_uptime_get() - sample.timestamp_ms);
+
+  return 0;
+}
+
+/** `dht11 derived`, metrics derived from the newest sample */
+static int cmd_dht11_derived(const struct shell *sh, size_t argc,
+                             char **argv) {
+  derived_metrics_t metrics;
+  sample_ring_sample_t sample;
+
+  if (sample_ring_latest(&sensor_sample_ring, &sample)) {
+    shell_print(sh, "No sample published yet");
+    return 0;
+  }
+
+  int err = app_derived_get(&sample, &metrics);
+
+  if (err) {
+    shell_error(sh, "No metrics for RH=" DHT11_X10_FMT " %% T=" DHT11_X10_FMT
+                    " C, err=%d",
+                DHT11_X10_ARGS(sample.data.rh_x10),
+                DHT11_X10_ARGS(sample.data.t_x10), err);
+    return err;
+  }
+
+  shell_print(sh, "Dew point " DHT11_X10_FMT " C",
+              DHT11_X10_ARGS(metrics.dew_point_x10));
+  shell_print(sh, "Absolute humidity %u.%02u g/m3",
+              metrics.abs_humidity_x100 / 100,
+              metrics.abs_humidity_x100 % 100);
+  if (metrics.heat_index_x10 == DERIVED_NONE) {
+    shell_print(sh, "Heat index undefined above 50 C");
+  } else {
+    shell_print(sh, "Heat index " DHT11_X10_FMT " C",
+                DHT11_X10_ARGS(metrics.heat_index_x10));
+  }
+
+  return 0;
+}
+
+/** `dht11 errors`, outcome counters of every layer */
+static int cmd_dht11_errors(const struct shell *sh, size_t argc,
+                            char **argv) {
+  dht11_reliable_stats_t rel;
+  dht11_cache_stats_t cache;
+
+  dht11_reliable_get_stats(&rel);
+  dht11_cache_get_stats(&cache);
+
+  shell_print(sh, "requests %u published %u retries %u skipped %u",
+              rel.requests, rel.published, rel.retries, rel.skipped);
+  shell_print(sh, "bus time %u ms, %u.%03u samples per bus s", rel.bus_ms,
+              rel.samples_per_bus_s_mhz / 1000,
+              rel.samples_per_bus_s_mhz % 1000);
+
+  shell_print(sh, "%-12s %8s %8s %8s %8s %8s", "class", "count", "p50 us",
+              "p90 us", "p99 us", "max us");
+  for (uint8_t cls = 0; cls < DHT11_RELIABLE_CLASS_MAX; cls++) {
+    const dht11_reliable_class_stats_t *stats = &rel.classes[cls];
+
+    shell_print(sh, "%-12s %8u %8u %8u %8u %8u", class_names[cls],
+                stats->count, stats->p50_us, stats->p90_us, stats->p99_us,
+                stats->max_us);
+  }
+
+  shell_print(sh, "cache: hits %u coalesced %u reads %u failures %u",
+              cache.hits, cache.coalesced, cache.reads, cache.failures);
+  for (uint8_t inst = 0; inst < DHT11_NUM_INSTANCES; inst++) {
+    shell_print(sh, "filter %u: spikes rejected %u", inst,
+                sensor_dht11_filter[inst].rejected);
+  }
+
+  for (uint8_t inst = 0; inst < DHT11_NUM_INSTANCES; inst++) {
+    dht11_calib_stats_t calib;
+
+    dht11_calib_get_stats(inst, &calib);
+    shell_print(sh,
+                "calib %u: %s, threshold %u us, parity failures %u/%u "
+                "before, %u/%u after",
+                inst, calib_state_names[calib.state],
+                calib.params.threshold_us, calib.before.parity_failures,
+                calib.before.frames, calib.after.parity_failures,
+                calib.after.frames);
+  }
+
+  return 0;
+}
+
+/** `dht11 hist bus [class]`, bus time histogram of one or every class */
+static int cmd_dht11_hist_bus(const struct shell *sh, size_t argc,
+                              char **argv) {
+  uint16_t buckets[DHT11_RELIABLE_BUCKETS];
+  dht11_reliable_stats_t rel;
+
+  dht11_reliable_get_stats(&rel);
+
+  for (uint8_t cls = 0; cls < DHT11_RELIABLE_CLASS_MAX; cls++) {
+    if (argc > 1 ? strcmp(argv[1], class_names[cls])
+                 : !rel.classes[cls].count) {
+      continue;
+    }
+
+    dht11_reliable_get_histogram(cls, buckets);
+    shell_print(sh, "%s, %u attempts:", class_names[cls],
+                rel.classes[cls].count);
+    print_histogram(sh, buckets, DHT11_RELIABLE_BUCKETS,
+                    DHT11_RELIABLE_BUCKET_US);
+
+    if (argc > 1) {
+      return 0;
+    }
+  }
+
+  if (argc > 1) {
+    shell_error(sh, "Unknown class %s", argv[1]);
+    return -EINVAL;
+  }
+
+  return 0;
+}
+
+/** `dht11 hist pulse [inst]`, data pulse widths seen by the calibration */
+static int cmd_dht11_hist_pulse(const struct shell *sh, size_t argc,
+                                char **argv) {
+  uint16_t bins[DHT11_CALIB_BINS];
+  dht11_calib_stats_t calib;
+  uint8_t inst;
+
+  if (parse_inst(sh, argc, argv, &inst)) {
+    return -EINVAL;
+  }
+
+  dht11_calib_get_stats(inst, &calib);
+  dht11_calib_get_histogram(inst, bins);
+
+  shell_print(sh,
+              "inst %u, %u widths, 0 at %u us, 1 at %u us, threshold %u us:",
+              inst, calib.samples, calib.params.zero_us, calib.params.one_us,
+              calib.params.threshold_us);
+  print_histogram(sh, bins, DHT11_CALIB_BINS, DHT11_CALIB_BIN_US);
+
+  return 0;
+}
+
+/** `dht11 period [ms]`, show or change the acquisition period */
+static int cmd_dht11_period(const struct shell *sh, size_t argc, char **argv) {
+  int err = 0;
+
+  if (argc > 1) {
+    unsigned long period_ms = shell_strtoul(argv[1], 10, &err);
+
+    if (err || period_ms > UINT32_MAX ||
+        app_dht11_period_set((uint32_t)period_ms)) {
+      shell_error(sh, "Period must be at least %u ms",
+                  dht11_model_get(0)->min_interval_ms);
+      return -EINVAL;
+    }
+  }
+
+  shell_print(sh, "%u ms", app_dht11_period_get());
+
+  return 0;
+}
+
+/** `dht11 stats`, min/max/average over the last hour, day and month */
+static int cmd_dht11_stats(const struct shell *sh, size_t argc, char **argv) {
+  static const struct {
+    const char *name;
+    uint32_t span_s;
+  } ranges[] = {
+      {"hour", ROLLUP_HOUR_S},
+      {"day", ROLLUP_DAY_S},
+      {"month", ROLLUP_DAYS * ROLLUP_DAY_S},
+  };
+  uint32_t now_s = (uint32_t)(k_uptime_get() / MSEC_PER_SEC);
+  rollup_stats_t stats;
+
+  shell_print(sh, "%-6s %8s %17s %17s", "last", "samples", "RH min/avg/max %",
+              "T min/avg/max C");
+
+  for (uint8_t idx = 0; idx < ARRAY_SIZE(ranges); idx++) {
+    uint32_t from_s = now_s > ranges[idx].span_s ? now_s - ranges[idx].span_s
+                                                 : 0;
+
+    if (rollup_query(&sensor_rollup, from_s, now_s + 1, &stats)) {
+      shell_print(sh, "%-6s %8u", ranges[idx].name, 0);
+      continue;
+    }
+
+    shell_print(sh, "%-6s %8u %5d/%5d/%5d %5d/%5d/%5d", ranges[idx].name,
+                stats.count, stats.rh_min, stats.rh_avg, stats.rh_max,
+                stats.t_min, stats.t_avg, stats.t_max);
+  }
+
+  shell_print(sh, "values in 0.1 units, edges rounded to the retained buckets");
+
+  return 0;
+}
+
+/** `dht11 history [from_s [count]]`, samples recorded in flash */
+static int cmd_dht11_history(const struct shell *sh, size_t argc,
+                             char **argv) {
+#ifdef CONFIG_APP_HISTORY
+  // Too large for the shell stack, commands of one shell never overlap
+  static ts_store_cursor_t cursor;
+  unsigned long count = HISTORY_DEFAULT_COUNT;
+  unsigned long from_s = 0;
+  ts_store_stats_t stats;
+  ts_sample_t sample;
+  int err = 0;
+
+  if (argc > 1) {
+    from_s = shell_strtoul(argv[1], 10, &err);
+  }
+  if (argc > 2) {
+    count = shell_strtoul(argv[2], 10, &err);
+  }
+  if (err || from_s > UINT32_MAX) {
+    shell_error(sh, "Usage: dht11 history [from_s [count]]");
+    return -EINVAL;
+  }
+
+  ts_store_get_stats(&stats);
+  shell_print(sh,
+              "%u samples in %u batches, %u flash bytes, %u rotations, "
+              "now at %u s",
+              stats.samples, stats.batches, stats.flash_bytes,
+              stats.rotations, history_time_s(k_uptime_get()));
+
+  err = ts_store_seek((uint32_t)from_s, &cursor);
+  while (!err && count--) {
+    err = ts_store_next(&cursor, &sample);
+    if (!err) {
+      shell_print(sh,
+                  "%10u s RH=" DHT11_X10_FMT " %% T=" DHT11_X10_FMT " C",
+                  sample.time_s, DHT11_X10_ARGS(sample.rh_x10),
+                  DHT11_X10_ARGS(sample.t_x10));
+    }
+  }
+
+  if (err && err != -ENOENT) {
+    shell_error(sh, "History read failed, err=%d", err);
+    return err;
+  }
+
+  return 0;
+#else
+  shell_error(sh, "Needs CONFIG_APP_HISTORY, see settings.conf");
+
+  return -ENOTSUP;
+#endif
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(
+    sub_dht11_hist,
+    SHELL_CMD_ARG(bus, NULL, "Bus time per attempt [class]",
+                  cmd_dht11_hist_bus, 1, 1),
+    SHELL_CMD_ARG(pulse, NULL, "Data pulse widths [inst]",
+                  cmd_dht11_hist_pulse, 1, 1),
+    SHELL_SUBCMD_SET_END);
+
+SHELL_STATIC_SUBCMD_SET_CREATE(
+    sub_dht11,
+    SHELL_CMD_ARG(read, NULL, "Read now, bypassing the cache [inst]",
+                  cmd_dht11_read, 1, 1),
+    SHELL_CMD(last, NULL, "Last published sample", cmd_dht11_last),
+    SHELL_CMD(derived, NULL, "Dew point, absolute humidity and heat index",
+              cmd_dht11_derived),
+    SHELL_CMD(errors, NULL, "Outcome and error counters", cmd_dht11_errors),
+    SHELL_CMD(hist, &sub_dht11_hist, "Timing histograms", NULL),
+    SHELL_CMD_ARG(period, NULL, "Show or set the acquisition period [ms]",
+                  cmd_dht11_period, 1, 1),
+    SHELL_CMD(stats, NULL, "Min/avg/max over the last hour, day and month",
+              cmd_dht11_stats),
+    SHELL_CMD_ARG(history, NULL, "Recorded samples [from_s [count]]",
+                  cmd_dht11_history, 1, 2),
+    SHELL_SUBCMD_SET_END);
+
+SHELL_CMD_REGISTER(dht11, &sub_dht11, "DHT11 diagnostics", NULL);
@@ -8,12 +8,18 @@
  * @copyright Copyright (c) 2025
  *
  */
+#define DT_DRV_COMPAT custom_gpio_data
+
 #include <zephyr/drivers/gpio.h>
 #include <zephyr/kernel.h>
-#include <zephyr/kernel/thread_stack.h>
 
+#include <string.h>
+
+#include <app_trace.h>
 #include <common.h>
 #include <dht11.h>
+#include <dht11_calib.h>
+#include <hal_zephyr.h>
 
 LOG_MODULE_REGISTER(dht11, 3);
 
@@ -21,80 +27,163 @@ LOG_MODULE_REGISTER(dht11, 3);
  * Definitions
  ******************************************************************************/
 
-/** Time in ms to hold the line low by the MCU before communication starts */
-#define START_SIGNAL_MS 18
-
-/** Number of data bits to expect from the DHT11 after setup */
-#define NUM_DATA_BITS 40
+/** Longest pulse width in us that can be stored in the capture buffer */
+#define DHT11_MAX_PULSE_US UINT8_MAX
 
-/** Threshold in microseconds for a high data bit.
+/** Time in ms to wait for a full frame once the line has been released.
  *
- * This is set to 50 microseconds to avoid any issues, but
- * a high bit should be >70 us while the low bit is < 29 us.
+ * A full frame is at most 160 us of setup plus 40 * 120 us of data.
  */
-#define HIGH_BIT_THRESHOLD_US 50
-
-/** Device tree node based on label in DT */
-#define DHT11_NODE DT_NODELABEL(dht11_sensor)
-
-/** Setup time us to indicate transition to data transmission.
- *
- * The DHT11 will indicate that transmission is about to begin by
- * first toggling the line low for 80 us and then allowing it to remain
- * high for 80 us.
- */
-#define DHT11_DATA_SETUP_US 80
-
-/** Start index in bit array for the high RH byte */
-#define DHT11_RH_BYTE_MAJOR 0
-
-/** Start index in bit array for the low RH byte */
-#define DHT11_RH_BYTE_MINOR 8
-
-/** Start index in bit array for the high T byte */
-#define DHT11_T_BYTE_MAJOR 16
-
-/** Start index in bit array for the low T byte */
-#define DHT11_T_BYTE_MINOR 24
+#define DHT11_FRAME_TIMEOUT_MS 10
 
-/** Start index in bit array for the parity byte */
-#define DHT11_PARITY_BYTE 32
-
-/** Stack size for the dht11 thread */
-#define STACK_SIZE 128
+/** Per instance initialiser for dht11_insts */
+#define DHT11_INST_DEFINE(n)                                                   \
+  {                                                                            \
+      .line = {.spec = GPIO_DT_SPEC_INST_GET(n, gpios)},                       \
+      .model = DHT11_INST_MODEL(n),                                            \
+      .state = ATOMIC_INIT(CONVERSION_IDLE),                                   \
+  },
 
 /*******************************************************************************
  * Type Definitions
  ******************************************************************************/
 
-typedef struct pulse_data_s {
-  bool new_bit;
-  uint32_t start_time;
-  uint32_t end_time;
-} pulse_data_t;
+/** Stages of an interrupt driven conversion */
+enum conversion_state {
+  CONVERSION_IDLE = 0, ///< No conversion in flight
+  CONVERSION_START,    ///< MCU is driving the start signal
+  CONVERSION_CAPTURE,  ///< ISR is capturing the frame
+  CONVERSION_DECODE,   ///< Frame is complete or has timed out
+};
+
+/** State of a single DHT11 instance */
+typedef struct dht11_inst_s {
+  /** Data line retrieved using the device tree description */
+  const hal_line_t line;
+  /** Timing and conversion of the sensor, from its compatible */
+  const dht11_model_t *model;
+  /** Edge callback registered in interrupt mode */
+  struct gpio_callback cb_data;
+  /** High pulse widths in us recorded by the ISR */
+  uint8_t pulse_widths[DHT11_NUM_PULSES];
+  /** Number of valid entries in pulse_widths */
+  volatile uint8_t current_pulse;
+  /** Cycle count at the last rising edge */
+  uint32_t rise_time;
+  /** True when rise_time belongs to the pulse currently being captured */
+  bool rise_valid;
+  /** Current conversion_state, owned by whoever moves it out of IDLE */
+  atomic_t state;
+  /** Requester of the conversion in flight */
+  dht11_read_cb_t cb;
+  /** User data for cb */
+  void *user_data;
+  /** Releases the line once the start signal has been held long enough */
+  struct k_work_delayable release_work;
+  /** Aborts the conversion if the frame does not complete */
+  struct k_work_delayable timeout_work;
+  /** Result of the last decode, owned by the decode work until completed */
+  dht11_data_t data;
+} dht11_inst_t;
+
+/** Context for a blocking read on top of dht11_read_async() */
+typedef struct sync_read_s {
+  struct k_sem done;
+  dht11_error_t err;
+  dht11_data_t *data;
+} sync_read_t;
 
 /*******************************************************************************
  * Function Prototypes
  ******************************************************************************/
 
 /**
- * @brief Pack data bits retrieved from the DHT11.
- *
- * Data retrieved from the DHT11 contains 5 bytes of data.  Each byte represents
- * one of the data points in the dht11_data_t struct.  This packs the bits into
- * a byte in that struct.
+ * @brief Edge ISR for the DHT11 data line.
  *
- * @param bit_array Pointer to array containing retrieved bits
- * @param start_index Index of start of data to retrieve
- * @return Packed byte containing the data of interest.
+ * Records the width of each high pulse in us.  Once a full frame has been
+ * captured, the interrupt is disabled and the decode work is submitted.
+ * Shared by all instances, the instance is recovered from the callback.
  */
-static uint8_t pack_bits(uint8_t *bit_array, uint8_t start_index);
-
 static void gpio_cb(const struct device *dev, struct gpio_callback *cb,
                     uint32_t pins);
 
+/**
+ * @brief Record an edge of the DHT11 data line, the body of gpio_cb()
+ *
+ * @param inst Instance of the line
+ * @param now Cycle count taken on entry to the ISR
+ */
+static void capture_edge(dht11_inst_t *inst, uint32_t now);
+
+/**
+ * @brief Drive the start signal and schedule its release
+ *
+ * The line is released from the system work queue after the start signal of
+ * the model so no thread is blocked for the start pulse.
+ *
+ * @param inst Instance to start
+ * @return DHT11_ERROR_NONE on success
+ * @return DHT11_ERROR_CONFIG_FAILURE Failed to properly configure GPIO
+ */
+static dht11_error_t dht11_start_data_conversion(dht11_inst_t *inst);
+
+/**
+ * @brief Release the line at the end of the start signal and arm the ISR
+ *
+ * @param work Pointer to release_work
+ */
+static void release_work_handler(struct k_work *work);
+
+/**
+ * @brief Abort a conversion when the frame did not arrive in time
+ *
+ * @param work Pointer to timeout_work
+ */
+static void timeout_work_handler(struct k_work *work);
+
+/**
+ * @brief Complete the conversion in flight and notify the requester
+ *
+ * @param inst Instance that completed
+ * @param err Result of the conversion
+ */
+static void complete_conversion(dht11_inst_t *inst, dht11_error_t err);
+
+/**
+ * @brief Completion callback used by retrieve_data_int()
+ */
+static void sync_read_cb(dht11_error_t err, const dht11_data_t *data,
+                         void *user_data);
+
+/**
+ * @brief Retrieve a frame using the interrupt driven capture path
+ *
+ * @param inst Index of the instance to read
+ * @param data Pointer to struct to store the decoded frame
+ * @return DHT11_ERROR_NONE on success
+ * @return DHT11_ERROR_HARDWARE_UNAVAILABLE No response from the DHT11
+ * @return DHT11_ERROR_SETUP_FAILED Frame incomplete or setup pulse invalid
+ * @return DHT11_ERROR_PARITY_CHECK_FAILED Parity byte does not match
+ */
+static dht11_error_t retrieve_data_int(uint8_t inst, dht11_data_t *data);
+
 /** Function implementing hardware specific details for retrieving data off of
- * the DHT-11
+ * the DHT-11 by polling the line of an instance
+ *
+ * @param inst Instance to read
+ * @param bit_array Constant pointer to data to be retrieved from the DHT-11
+ *
+ * @returns DHT11_ERROR_NONE Success
+ * @returns DHT11_ERROR_SETUP_FAILED Failed to get correct response from DHT11
+ * at start of conversion
+ * @returns DHT11_ERROR_HARDWARE_UNAVAILABLE No response from the DHT11
+ * @returns DHT11_ERROR_CONFIG_FAILURE Failed to properly configure GPIO
+ */
+static dht11_error_t retrieve_data_inst(const dht11_inst_t *inst,
+                                        uint8_t *const bit_array);
+
+/** Polling retrieval from the first instance, the default for
+ * dht11_get_data()
  *
  * @param bit_array Constant pointer to data to be retrieved from the DHT-11
  *
@@ -106,36 +195,36 @@ static void gpio_cb(const struct device *dev, struct gpio_callback *cb,
 dht11_error_t retrieve_data(uint8_t *const bit_array);
 
 /**
- * @brief DHT11 polling thread
+ * @brief Decode captured frames
+ *
+ * Submitted to the system work queue by the ISR.  Decodes every frame waiting
+ * in decode_pending and calls the requesters' completion callbacks.  One work
+ * item serves every instance.
  *
- * @param arg1 UNUSED
- * @param arg2 UNUSED
- * @param arg3 UNUSED
+ * @param work UNUSED
  */
-static void conversion_thread(void *arg1, void *arg2, void *arg3);
+static void decode_work_handler(struct k_work *work);
 
 /*******************************************************************************
  * Variables
  ******************************************************************************/
 
-/** GPIO spec retrieved using the device tree description */
-static const struct gpio_dt_spec dht11_gpio =
-    GPIO_DT_SPEC_GET(DHT11_NODE, gpios);
-
-static struct gpio_callback dht11_cb_data;
-
-static pulse_data_t pulse_data[90];
+/** Instances generated from the device tree */
+static dht11_inst_t dht11_insts[] = {
+    DT_INST_FOREACH_STATUS_OKAY(DHT11_INST_DEFINE)};
 
-static uint8_t current_pulse = 0;
+BUILD_ASSERT(ARRAY_SIZE(dht11_insts) == DHT11_NUM_INSTANCES,
+             "DHT11 instance count mismatch");
+BUILD_ASSERT(DHT11_NUM_INSTANCES <= 32, "Too many DHT11 instances");
 
-static bool conversion_started = false;
+/** True when dht11_init() selected the interrupt driven capture path */
+static bool use_interrupts = false;
 
-/** Define a memory region for the DHT11 thread stack */
-K_THREAD_STACK_DEFINE(conversion_stack, STACK_SIZE);
+/** Submitted by the ISR each time an instance has captured a full frame */
+static K_WORK_DEFINE(decode_work, decode_work_handler);
 
-static struct k_thread conversion_thread_id;
-
-static struct k_sem conversion_sem;
+/** Bit per instance with a frame waiting to be decoded */
+static atomic_t decode_pending = ATOMIC_INIT(0);
 
 /*******************************************************************************
  * Function Definitions
@@ -143,213 +232,335 @@ static struct k_sem conversion_sem;
 
 // Described in .h
 dht11_error_t dht11_init(bool is_int) {
-  if (!gpio_is_ready_dt(&dht11_gpio)) {
-    return DHT11_ERROR_CONFIG_FAILURE;
+  for (uint8_t idx = 0; idx < DHT11_NUM_INSTANCES; idx++) {
+    if (!gpio_is_ready_dt(&dht11_insts[idx].line.spec)) {
+      return DHT11_ERROR_CONFIG_FAILURE;
+    }
   }
 
-  if (is_int) {
-    gpio_init_callback(&dht11_cb_data, gpio_cb, BIT(dht11_gpio.pin));
-    gpio_add_callback_dt(&dht11_gpio, &dht11_cb_data);
+  // Only the interrupt path is calibrated, but loading the parameters early
+  // keeps the first frames from being decoded with the defaults
+  dht11_calib_init();
+
+  if (is_int && !use_interrupts) {
+    for (uint8_t idx = 0; idx < DHT11_NUM_INSTANCES; idx++) {
+      dht11_inst_t *inst = &dht11_insts[idx];
+
+      k_work_init_delayable(&inst->release_work, release_work_handler);
+      k_work_init_delayable(&inst->timeout_work, timeout_work_handler);
 
-    // Binary semaphore to indicate when conversion has begun
-    k_sem_init(&conversion_sem, 0, 1);
+      gpio_init_callback(&inst->cb_data, gpio_cb, BIT(inst->line.spec.pin));
+      if (gpio_add_callback_dt(&inst->line.spec, &inst->cb_data) < 0) {
+        return DHT11_ERROR_CONFIG_FAILURE;
+      }
+    }
 
-    k_thread_create(&conversion_thread_id, conversion_stack,
-                    K_THREAD_STACK_SIZEOF(conversion_stack), conversion_thread,
-                    NULL, NULL, NULL, 7, 0, K_NO_WAIT);
+    use_interrupts = true;
   }
 
   return DHT11_ERROR_NONE;
 }
 
-dht11_error_t dht11_start_data_conversion() {
-  // MCU is master - toggle the line to indicate MCU is ready for transmission
-  if (gpio_pin_configure_dt(&dht11_gpio, GPIO_OUTPUT) < 0) {
+// Described in .h
+dht11_error_t dht11_read_async(uint8_t idx, dht11_read_cb_t cb,
+                               void *user_data) {
+  if (!use_interrupts || !cb || idx >= DHT11_NUM_INSTANCES) {
     return DHT11_ERROR_CONFIG_FAILURE;
   }
 
-  // Wait 100 ms for the semaphore
-  if (!k_sem_take(&conversion_sem, K_MSEC(100))) {
-    return DHT11_ERROR_HARDWARE_UNAVAILABLE;
+  dht11_inst_t *inst = &dht11_insts[idx];
+
+  if (!atomic_cas(&inst->state, CONVERSION_IDLE, CONVERSION_START)) {
+    return DHT11_ERROR_BUSY;
   }
 
-  gpio_pin_set_dt(&dht11_gpio, 0);
+  inst->cb = cb;
+  inst->user_data = user_data;
 
-  // Hold low for > 18 ms
-  k_msleep(START_SIGNAL_MS);
+  // Discard anything left over from a previous timed out conversion
+  atomic_clear_bit(&decode_pending, idx);
+  memset(&inst->data, 0, sizeof(inst->data));
+  inst->current_pulse = 0;
+  inst->rise_valid = false;
 
-  // Set the line for input to rececive data from the DHT11.  Since there should
-  // be a pullup on the line, this cause the line to go high.
-  if (gpio_pin_configure_dt(&dht11_gpio, GPIO_INPUT) < 0) {
+  dht11_error_t err = dht11_start_data_conversion(inst);
+  if (err) {
+    atomic_set(&inst->state, CONVERSION_IDLE);
+  }
+
+  return err;
+}
+
+// Described above
+static dht11_error_t dht11_start_data_conversion(dht11_inst_t *inst) {
+  // MCU is master - toggle the line to indicate MCU is ready for transmission
+  if (gpio_pin_configure_dt(&inst->line.spec, GPIO_OUTPUT) < 0) {
     return DHT11_ERROR_CONFIG_FAILURE;
   }
 
-  gpio_pin_interrupt_configure_dt(&dht11_gpio, GPIO_INT_EDGE_BOTH);
+  gpio_pin_set_dt(&inst->line.spec, 0);
+
+  // Hold low for the start signal of the model
+  k_work_schedule(&inst->release_work, K_MSEC(inst->model->start_ms));
 
   return DHT11_ERROR_NONE;
 }
 
-// Described in .h
-dht11_error_t dht11_get_data(dht11_retrieve_data_t hw_fp, dht11_data_t *data) {
+// Described above
+static void release_work_handler(struct k_work *work) {
+  struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+  dht11_inst_t *inst = CONTAINER_OF(dwork, dht11_inst_t, release_work);
+  const struct gpio_dt_spec *dht11_gpio = &inst->line.spec;
 
-  /* Storage for the bit data from the DHT11 */
-  uint8_t bit_array[40];
+  atomic_set(&inst->state, CONVERSION_CAPTURE);
 
-  // Make sure this value is 0'ed
-  data->rh_high = 0;
-  data->rh_low = 0;
-  data->t_high = 0;
-  data->t_low = 0;
-
-  if (!hw_fp) {
-    // Standard case - call the function defined in this module
-    retrieve_data(bit_array);
-  } else {
-    hw_fp(bit_array);
+  // Set the line for input to rececive data from the DHT11.  Since there should
+  // be a pullup on the line, this cause the line to go high.
+  if (gpio_pin_configure_dt(dht11_gpio, GPIO_INPUT) < 0) {
+    atomic_set(&inst->state, CONVERSION_DECODE);
+    complete_conversion(inst, DHT11_ERROR_CONFIG_FAILURE);
+    return;
   }
 
-  data->rh_high = pack_bits(bit_array, DHT11_RH_BYTE_MAJOR);
-  data->rh_low = pack_bits(bit_array, DHT11_RH_BYTE_MINOR);
-  data->t_high = pack_bits(bit_array, DHT11_T_BYTE_MAJOR);
-  data->t_low = pack_bits(bit_array, DHT11_T_BYTE_MINOR);
-  data->parity = pack_bits(bit_array, DHT11_PARITY_BYTE);
+  k_work_schedule(&inst->timeout_work, K_MSEC(DHT11_FRAME_TIMEOUT_MS));
 
-  uint8_t parity_byte =
-      data->rh_high + data->rh_low + data->t_high + data->t_low;
+  // Only arm the interrupt once the line has been released so the first edge
+  // seen is the DHT11 pulling the line low
+  if (gpio_pin_interrupt_configure_dt(dht11_gpio, GPIO_INT_EDGE_BOTH) < 0 &&
+      atomic_cas(&inst->state, CONVERSION_CAPTURE, CONVERSION_DECODE)) {
+    k_work_cancel_delayable(&inst->timeout_work);
+    complete_conversion(inst, DHT11_ERROR_CONFIG_FAILURE);
+  }
+}
 
-  // Check the parity byte
-  if (data->parity != parity_byte) {
-    return DHT11_ERROR_PARITY_CHECK_FAILED;
+// Described above
+static void timeout_work_handler(struct k_work *work) {
+  struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+  dht11_inst_t *inst = CONTAINER_OF(dwork, dht11_inst_t, timeout_work);
+
+  // The ISR may have completed the frame while this was pending
+  if (!atomic_cas(&inst->state, CONVERSION_CAPTURE, CONVERSION_DECODE)) {
+    return;
   }
 
-  return DHT11_ERROR_NONE;
+  gpio_pin_interrupt_configure_dt(&inst->line.spec, GPIO_INT_DISABLE);
+
+  complete_conversion(inst, inst->current_pulse
+                                ? DHT11_ERROR_SETUP_FAILED
+                                : DHT11_ERROR_HARDWARE_UNAVAILABLE);
 }
 
 // Described above
-uint8_t pack_bits(uint8_t *bit_array, uint8_t start_index) {
-  uint8_t packed_data = 0;
-  uint8_t upper_bound = start_index + 8;
+static void complete_conversion(dht11_inst_t *inst, dht11_error_t err) {
+  // Take copies so the callback is free to start the next conversion
+  dht11_data_t data = inst->data;
+  dht11_read_cb_t cb = inst->cb;
+  void *user_data = inst->user_data;
 
-  for (uint8_t idx = start_index; idx < upper_bound; idx++) {
-    packed_data |= (bit_array[idx] << ((upper_bound - 1) - idx));
-  }
-  return packed_data;
+  atomic_set(&inst->state, CONVERSION_IDLE);
+
+  cb(err, &data, user_data);
 }
 
 // Described above
-static void gpio_cb(const struct device *dev, struct gpio_callback *cb,
-                    uint32_t pins) {
-  conversion_started = true;
-  uint8_t level = gpio_pin_get_dt(&dht11_gpio);
-  if (level) {
-    pulse_data[current_pulse].start_time = k_cycle_get_32();
-  } else {
-    pulse_data[current_pulse++].new_bit = true;
-    pulse_data[current_pulse].end_time = k_cycle_get_32();
-  }
+static void sync_read_cb(dht11_error_t err, const dht11_data_t *data,
+                         void *user_data) {
+  sync_read_t *ctx = user_data;
+
+  *ctx->data = *data;
+  ctx->err = err;
+
+  k_sem_give(&ctx->done);
 }
 
 // Described above
-dht11_error_t retrieve_data(uint8_t *const bit_array) {
-  if (gpio_pin_configure_dt(&dht11_gpio, GPIO_OUTPUT) < 0) {
-    return DHT11_ERROR_CONFIG_FAILURE;
+static dht11_error_t retrieve_data_int(uint8_t inst, dht11_data_t *data) {
+  sync_read_t ctx = {.data = data};
+
+  // The conversion completes on the system work queue
+  __ASSERT(k_current_get() != &k_sys_work_q.thread,
+           "Blocking DHT11 read on the system work queue");
+
+  k_sem_init(&ctx.done, 0, 1);
+
+  dht11_error_t err = dht11_read_async(inst, sync_read_cb, &ctx);
+  if (err) {
+    return err;
   }
 
-  // Retrieve an IRQ lock so that we can decode without any interrupts thus
-  // creating an issue for determining the bit value
-  unsigned int key = irq_lock();
+  // The timeout work guarantees completion
+  k_sem_take(&ctx.done, K_FOREVER);
 
-  gpio_pin_set_dt(&dht11_gpio, 0);
+  return ctx.err;
+}
 
-  // Hold low for > 18 ms
-  k_msleep(START_SIGNAL_MS);
+// Described in .h
+uint8_t dht11_instance_count(void) { return DHT11_NUM_INSTANCES; }
 
-  // Set the line for input to rececive data from the DHT11.  Since there should
-  // be a pullup on the line, this cause the line to go high.
-  if (gpio_pin_configure_dt(&dht11_gpio, GPIO_INPUT) < 0) {
+// Described in .h
+const dht11_model_t *dht11_model_get(uint8_t inst) {
+  return inst < DHT11_NUM_INSTANCES ? dht11_insts[inst].model : NULL;
+}
+
+// Described in .h
+bool dht11_async_available(void) { return use_interrupts; }
+
+// Described in .h
+dht11_error_t dht11_get_data_inst(uint8_t inst, dht11_data_t *data) {
+
+  /* Storage for the bit data from the DHT11 */
+  uint8_t bit_array[DHT11_NUM_DATA_BITS];
+
+  if (inst >= DHT11_NUM_INSTANCES) {
     return DHT11_ERROR_CONFIG_FAILURE;
   }
 
-  /* After we have pulled the pin low for 18 ms, the data line will be
-   * setup for output from the DHT11.  Before data is transmitted, the
-   * line will be 1) set low for 80 us and then 2) high for 80 us.  If
-   * we do not see the line go high for 80 us, indicate that the setup
-   * has failed.
-   */
-
-  /* Use this to indicate the start time for our measurement */
-  uint32_t start = k_cycle_get_32();
-
-  /* Last good start time */
-  uint32_t pstart = start;
-
-  /* Pin will likely initially be high because it is pulled high when
-   * the MCU releases control due to pull up resistor.
-   */
-  while (gpio_pin_get_dt(&dht11_gpio))
-    ;
-
-  /* Pin will go low for 80 us but we don't care */
-  while (!gpio_pin_get_dt(&dht11_gpio)) {
-    // Capture the last valid time for measuring duration
-    pstart = start;
-    start = k_cycle_get_32();
+  // Make sure this value is 0'ed
+  memset(data, 0, sizeof(*data));
+
+  if (use_interrupts) {
+    // Interrupt driven path decodes in the decode work
+    return retrieve_data_int(inst, data);
+  }
+
+  dht11_error_t err = retrieve_data_inst(&dht11_insts[inst], bit_array);
+  if (err) {
+    // The bit array is only partly filled, do not decode it
+    return err;
+  }
+
+  return dht11_frame_decode_bits(bit_array, data);
+}
+
+// Described in .h
+dht11_error_t dht11_get_data(dht11_retrieve_data_t hw_fp, dht11_data_t *data) {
+
+  /* Storage for the bit data from the DHT11 */
+  uint8_t bit_array[DHT11_NUM_DATA_BITS];
+
+  if (!hw_fp) {
+    // Standard case - read the first instance
+    return dht11_get_data_inst(0, data);
+  }
+
+  // Make sure this value is 0'ed
+  memset(data, 0, sizeof(*data));
+
+  dht11_error_t err = hw_fp(bit_array);
+  if (err) {
+    return err;
   }
 
-  // Wait until the line goes low again
-  while (gpio_pin_get_dt(&dht11_gpio))
-    ;
+  return dht11_frame_decode_bits(bit_array, data);
+}
+
+// Described above
+static void gpio_cb(const struct device *dev, struct gpio_callback *cb,
+                    uint32_t pins) {
+  uint32_t now = k_cycle_get_32();
 
-  // Duration is the difference between the last low and the end of the high.
-  // This will add an extra 5 us or so, but we don't care as we are only
-  // interested in the duration greater than 80 us.
-  uint32_t duration = k_cyc_to_us_ceil32(k_cycle_get_32() - pstart);
+  capture_edge(CONTAINER_OF(cb, dht11_inst_t, cb_data), now);
 
-  if (duration < DHT11_DATA_SETUP_US) {
-    COMMON_LOG_ERR("Duration check failed: %d", duration);
-    return DHT11_ERROR_SETUP_FAILED;
+  APP_TRACE_END(DHT11_EDGE_ISR, now);
+}
+
+// Described above
+static void capture_edge(dht11_inst_t *inst, uint32_t now) {
+  if (gpio_pin_get_dt(&inst->line.spec)) {
+    inst->rise_time = now;
+    inst->rise_valid = true;
+    return;
+  }
+
+  // The first falling edge is the DHT11 acknowledging the start signal and has
+  // no matching rising edge
+  if (!inst->rise_valid || inst->current_pulse >= DHT11_NUM_PULSES) {
+    return;
   }
 
-  // Start retrieving data
-  for (uint8_t bit = 0; bit < NUM_DATA_BITS; bit++) {
-    start = k_cycle_get_32();
-    pstart = start;
+  inst->rise_valid = false;
+  inst->pulse_widths[inst->current_pulse++] =
+      MIN(k_cyc_to_us_floor32(now - inst->rise_time), DHT11_MAX_PULSE_US);
 
-    // Low doesn't matter
-    while (!gpio_pin_get_dt(&dht11_gpio)) {
-      pstart = start;
-      start = k_cycle_get_32();
+  if (inst->current_pulse == DHT11_NUM_PULSES) {
+    gpio_pin_interrupt_configure_dt(&inst->line.spec, GPIO_INT_DISABLE);
+    if (atomic_cas(&inst->state, CONVERSION_CAPTURE, CONVERSION_DECODE)) {
+      atomic_set_bit(&decode_pending, inst - dht11_insts);
+      k_work_submit(&decode_work);
     }
+  }
+}
+
+// Described above
+dht11_error_t retrieve_data(uint8_t *const bit_array) {
+  return retrieve_data_inst(&dht11_insts[0], bit_array);
+}
 
-    while (gpio_pin_get_dt(&dht11_gpio))
-      ;
+// Described above
+static dht11_error_t retrieve_data_inst(const dht11_inst_t *inst,
+                                        uint8_t *const bit_array) {
+  const struct gpio_dt_spec *dht11_gpio = &inst->line.spec;
 
-    // The value of the bit is determined by the high time
-    duration = k_cyc_to_us_ceil32(k_cycle_get_32() - pstart);
-    bit_array[bit] = duration > HIGH_BIT_THRESHOLD_US;
+  if (gpio_pin_configure_dt(dht11_gpio, GPIO_OUTPUT) < 0) {
+    return DHT11_ERROR_CONFIG_FAILURE;
   }
 
+  gpio_pin_set_dt(dht11_gpio, 0);
+
+  // Hold low for the start signal of the model
+  k_msleep(inst->model->start_ms);
+
+  // Retrieve an IRQ lock so that we can decode without any interrupts thus
+  // creating an issue for determining the bit value.  This is only taken once
+  // the start signal has been sent as sleeping with the lock held would
+  // release it.
+  unsigned int key = irq_lock();
+  uint32_t lock_start = APP_TRACE_START();
+
+  // Set the line for input to rececive data from the DHT11.  Since there should
+  // be a pullup on the line, this cause the line to go high.
+  dht11_error_t err =
+      gpio_pin_configure_dt(dht11_gpio, GPIO_INPUT) < 0
+          ? DHT11_ERROR_CONFIG_FAILURE
+          : dht11_frame_poll(&inst->line, bit_array);
+
   // Release the lock, we have finished probing the data line
   irq_unlock(key);
+  APP_TRACE_END(DHT11_IRQ_LOCK, lock_start);
 
-  return DHT11_ERROR_NONE;
+  if (err == DHT11_ERROR_SETUP_FAILED) {
+    COMMON_LOG_ERR("Frame setup failed");
+  }
+
+  return err;
 }
 
-static void conversion_thread(void *arg1, void *arg2, void *arg3) {
-  while (1) {
-    k_sem_take(&conversion_sem, K_FOREVER);
+// Described above
+static void decode_work_handler(struct k_work *work) {
+  // Frames captured while this runs set their bit and resubmit, so a single
+  // pass never misses one
+  for (uint8_t idx = 0; idx < DHT11_NUM_INSTANCES; idx++) {
+    if (!atomic_test_and_clear_bit(&decode_pending, idx)) {
+      continue;
+    }
+
+    dht11_inst_t *inst = &dht11_insts[idx];
+    dht11_calib_params_t params;
 
-    uint8_t current_bit = 0;
-    // uint8_t bit_array[40];
+    k_work_cancel_delayable(&inst->timeout_work);
 
-    while (conversion_started) {
-      if (pulse_data[current_bit].new_bit) {
-        if (0 == current_bit)
+    dht11_calib_get_params(idx, &params);
 
-          current_bit++;
-      }
+    uint32_t decode_start = APP_TRACE_START();
+    dht11_error_t err =
+        dht11_frame_decode_pulses(inst->pulse_widths, params.threshold_us,
+                                  params.setup_min_us, &inst->data);
 
-      conversion_started = false;
-    }
+    APP_TRACE_END(DHT11_DECODE, decode_start);
+
+    // The buffer is only reused once the conversion completes
+    dht11_calib_update(idx, &inst->pulse_widths[1], err);
+
+    complete_conversion(inst, err);
   }
 }
@@ -0,0 +1,304 @@
+/**
+ * @file dht11_cache.c
+ * @brief Reading cache in front of the DHT11 driver
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+
+#include <common.h>
+#include <dht11.h>
+#include <dht11_cache.h>
+#include <dht11_reliable.h>
+
+LOG_MODULE_REGISTER(dht11_cache, 3);
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+
+/** Cache state of a single instance */
+typedef struct cache_entry_s {
+  struct k_mutex lock;
+  /** Broadcast every time a physical read completes */
+  struct k_condvar updated;
+  /** Last good reading, valid when has_reading is set */
+  dht11_reading_t reading;
+  bool has_reading;
+  /** True from scheduling a physical read until it completes */
+  bool in_flight;
+  /** Incremented on every completed physical read */
+  uint32_t generation;
+  /** Result of the last physical read */
+  dht11_error_t last_err;
+  /** Uptime in ms at the start of the last physical read */
+  int64_t last_read_ms;
+  /** Non blocking requests waiting for the read in flight */
+  sys_slist_t waiters;
+  /** Starts the physical read once the minimum interval has elapsed */
+  struct k_work_delayable refresh_work;
+  /** Timing and conversion of the sensor */
+  const dht11_model_t *model;
+  uint8_t inst;
+} cache_entry_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Initialise the cache entries
+ *
+ * @return 0 always
+ */
+static int dht11_cache_init(void);
+
+/**
+ * @brief Schedule a physical read on behalf of all waiters
+ *
+ * Called with the entry locked and no read in flight.  The read starts as
+ * soon as the minimum read interval allows, but not before delay_ms.
+ *
+ * @param entry Cache entry of the instance
+ * @param delay_ms Least time in ms before the read
+ */
+static void cache_start_refresh(cache_entry_t *entry, uint32_t delay_ms);
+
+/**
+ * @brief Start the physical read, runs on the system work queue
+ *
+ * @param work Refresh work of the entry
+ */
+static void refresh_work_handler(struct k_work *work);
+
+/**
+ * @brief Store the result of a physical read and release its waiters
+ *
+ * @param err Result of the read
+ * @param data Decoded frame, only used when err is DHT11_ERROR_NONE
+ * @param user_data Cache entry of the instance
+ */
+static void cache_read_done(dht11_error_t err, const dht11_data_t *data,
+                            void *user_data);
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+static cache_entry_t cache_entries[DHT11_NUM_INSTANCES];
+
+static atomic_t stat_hits = ATOMIC_INIT(0);
+static atomic_t stat_coalesced = ATOMIC_INIT(0);
+static atomic_t stat_reads = ATOMIC_INIT(0);
+static atomic_t stat_failures = ATOMIC_INIT(0);
+
+SYS_INIT(dht11_cache_init, POST_KERNEL, 0);
+
+/*******************************************************************************
+ * Function Definitions
+ ******************************************************************************/
+
+// Described above
+static int dht11_cache_init(void) {
+  for (uint8_t idx = 0; idx < DHT11_NUM_INSTANCES; idx++) {
+    cache_entry_t *entry = &cache_entries[idx];
+
+    k_mutex_init(&entry->lock);
+    k_condvar_init(&entry->updated);
+    sys_slist_init(&entry->waiters);
+    k_work_init_delayable(&entry->refresh_work, refresh_work_handler);
+    entry->model = dht11_model_get(idx);
+    entry->last_read_ms = -entry->model->min_interval_ms;
+    entry->inst = idx;
+  }
+
+  return 0;
+}
+
+// Described above
+static void cache_start_refresh(cache_entry_t *entry, uint32_t delay_ms) {
+  int64_t wait_ms =
+      entry->last_read_ms + entry->model->min_interval_ms - k_uptime_get();
+
+  entry->in_flight = true;
+  k_work_schedule(&entry->refresh_work, K_MSEC(MAX(wait_ms, delay_ms)));
+}
+
+// Described above
+static void refresh_work_handler(struct k_work *work) {
+  struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+  cache_entry_t *entry = CONTAINER_OF(dwork, cache_entry_t, refresh_work);
+  dht11_data_t data = {0};
+
+  k_mutex_lock(&entry->lock, K_FOREVER);
+  entry->last_read_ms = k_uptime_get();
+  k_mutex_unlock(&entry->lock);
+
+  // Retries and validation happen below the cache, only validated samples
+  // are stored
+  dht11_error_t err = dht11_reliable_read(entry->inst, cache_read_done, entry);
+  if (err) {
+    cache_read_done(err, &data, entry);
+  }
+}
+
+// Described above
+static void cache_read_done(dht11_error_t err, const dht11_data_t *data,
+                            void *user_data) {
+  cache_entry_t *entry = user_data;
+  dht11_reading_t reading;
+  dht11_sample_t sample;
+  sys_slist_t waiters;
+  sys_snode_t *node;
+
+  // The frame has been validated against the same model, this cannot fail
+  if (!err) {
+    err = dht11_model_sample(entry->model, data, &sample);
+  }
+
+  atomic_inc(&stat_reads);
+  if (err) {
+    atomic_inc(&stat_failures);
+    COMMON_LOG_DBG("DHT11 %d read failed. Err=%d", entry->inst, err);
+  }
+
+  k_mutex_lock(&entry->lock, K_FOREVER);
+
+  if (!err) {
+    entry->reading.data = *data;
+    entry->reading.sample = sample;
+    entry->reading.timestamp_ms = k_uptime_get();
+    entry->has_reading = true;
+  }
+  entry->last_err = err;
+  entry->generation++;
+  entry->in_flight = false;
+  reading = entry->reading;
+
+  // Take the waiters so their callbacks run unlocked and may resubmit
+  waiters = entry->waiters;
+  sys_slist_init(&entry->waiters);
+
+  k_condvar_broadcast(&entry->updated);
+  k_mutex_unlock(&entry->lock);
+
+  while ((node = sys_slist_get(&waiters))) {
+    dht11_cache_request_t *req =
+        CONTAINER_OF(node, dht11_cache_request_t, node);
+
+    req->cb(err, &reading, req->user_data);
+  }
+}
+
+// Described in .h
+dht11_error_t dht11_cache_get(uint8_t inst, uint32_t max_age_ms,
+                              dht11_reading_t *reading) {
+  __ASSERT(k_current_get() != &k_sys_work_q.thread,
+           "Blocking DHT11 read on the system work queue");
+
+  if (inst >= DHT11_NUM_INSTANCES) {
+    return DHT11_ERROR_CONFIG_FAILURE;
+  }
+
+  cache_entry_t *entry = &cache_entries[inst];
+
+  k_mutex_lock(&entry->lock, K_FOREVER);
+
+  if (entry->has_reading &&
+      k_uptime_get() - entry->reading.timestamp_ms <= max_age_ms) {
+    *reading = entry->reading;
+    k_mutex_unlock(&entry->lock);
+    atomic_inc(&stat_hits);
+    return DHT11_ERROR_NONE;
+  }
+
+  uint32_t generation = entry->generation;
+
+  if (entry->in_flight) {
+    // Coalesce onto the read in flight, its result is as fresh as it gets
+    atomic_inc(&stat_coalesced);
+  } else {
+    cache_start_refresh(entry, 0);
+  }
+
+  while (generation == entry->generation) {
+    k_condvar_wait(&entry->updated, &entry->lock, K_FOREVER);
+  }
+
+  dht11_error_t err = entry->last_err;
+  if (!err) {
+    *reading = entry->reading;
+  }
+
+  k_mutex_unlock(&entry->lock);
+
+  return err;
+}
+
+// Described in .h
+dht11_error_t dht11_cache_get_async(uint8_t inst, uint32_t max_age_ms,
+                                    dht11_cache_request_t *req) {
+  if (inst >= DHT11_NUM_INSTANCES || !req->cb) {
+    return DHT11_ERROR_CONFIG_FAILURE;
+  }
+
+  cache_entry_t *entry = &cache_entries[inst];
+
+  k_mutex_lock(&entry->lock, K_FOREVER);
+
+  if (entry->has_reading &&
+      k_uptime_get() - entry->reading.timestamp_ms <= max_age_ms) {
+    dht11_reading_t reading = entry->reading;
+
+    k_mutex_unlock(&entry->lock);
+    atomic_inc(&stat_hits);
+    req->cb(DHT11_ERROR_NONE, &reading, req->user_data);
+    return DHT11_ERROR_NONE;
+  }
+
+  sys_slist_append(&entry->waiters, &req->node);
+
+  if (entry->in_flight) {
+    atomic_inc(&stat_coalesced);
+  } else {
+    cache_start_refresh(entry, req->delay_ms);
+  }
+
+  k_mutex_unlock(&entry->lock);
+
+  return DHT11_ERROR_NONE;
+}
+
+// Described in .h
+dht11_error_t dht11_cache_peek(uint8_t inst, dht11_reading_t *reading) {
+  dht11_error_t err = DHT11_ERROR_NONE;
+
+  if (inst >= DHT11_NUM_INSTANCES) {
+    return DHT11_ERROR_CONFIG_FAILURE;
+  }
+
+  cache_entry_t *entry = &cache_entries[inst];
+
+  k_mutex_lock(&entry->lock, K_FOREVER);
+
+  if (entry->has_reading) {
+    *reading = entry->reading;
+  } else {
+    err = DHT11_ERROR_HARDWARE_UNAVAILABLE;
+  }
+
+  k_mutex_unlock(&entry->lock);
+
+  return err;
+}
+
+// Described in .h
+void dht11_cache_get_stats(dht11_cache_stats_t *stats) {
+  stats->hits = atomic_get(&stat_hits);
+  stats->coalesced = atomic_get(&stat_coalesced);
+  stats->reads = atomic_get(&stat_reads);
+  stats->failures = atomic_get(&stat_failures);
+}
@@ -0,0 +1,581 @@
+/**
+ * @file dht11_calib.c
+ * @brief Adaptive 0/1 bit threshold for the interrupt driven DHT11 capture
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <zephyr/kernel.h>
+
+#ifdef CONFIG_APP_DHT11_CALIB_PERSIST
+#include <zephyr/settings/settings.h>
+
+#include <storage_workq.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <common.h>
+#include <dht11.h>
+#include <dht11_calib.h>
+
+LOG_MODULE_REGISTER(dht11_calib, 3);
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/** Upper bound on the threshold iterations of dht11_calib_derive() */
+#define CALIB_MAX_ITERATIONS 8
+
+/** Smallest distance in us between the two cluster means for a histogram to
+ * be accepted */
+#define CALIB_MIN_SEPARATION_US 20
+
+/** Fractional bits of the drift tracked cluster means */
+#define CALIB_MEAN_FRAC_BITS 4
+
+/** Settings subtree holding the persisted parameters */
+#define CALIB_SETTINGS_ROOT "dht11/calib"
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+
+/** Settings write waiting for calib_persist_handler() */
+typedef enum calib_persist_op_e {
+  CALIB_PERSIST_NONE = 0,
+  CALIB_PERSIST_STORE,
+  CALIB_PERSIST_DELETE,
+} calib_persist_op_t;
+
+/** Calibration of a single instance */
+typedef struct calib_entry_s {
+  dht11_calib_state_t state;
+  /** Parameters in use by the decoder */
+  dht11_calib_params_t params;
+  /** Cluster means in us with CALIB_MEAN_FRAC_BITS fractional bits */
+  uint16_t zero_mean;
+  uint16_t one_mean;
+  /** Threshold last handed to the settings subsystem */
+  uint8_t stored_threshold_us;
+  /** Settings write waiting for the storage work queue */
+  calib_persist_op_t persist_op;
+  dht11_calib_params_t persist_params;
+  /** Complete frames collected by the calibration in progress */
+  uint8_t frames_collected;
+  dht11_calib_counts_t before;
+  dht11_calib_counts_t after;
+  uint32_t samples;
+  uint16_t histogram[DHT11_CALIB_BINS];
+} calib_entry_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Return an entry to the defaults, statistics included
+ *
+ * @param entry Entry to clear
+ */
+static void calib_clear(calib_entry_t *entry);
+
+/**
+ * @brief Add the data pulse widths of a frame to the histogram
+ *
+ * Called with calib_lock held.
+ *
+ * @param entry Entry of the instance
+ * @param widths DHT11_NUM_DATA_BITS pulse widths in us
+ */
+static void histogram_add(calib_entry_t *entry, const uint8_t *widths);
+
+/**
+ * @brief Make params the parameters in use by an entry
+ *
+ * Called with calib_lock held.
+ *
+ * @param entry Entry of the instance
+ * @param params Parameters with zero_us and one_us set
+ */
+static void calib_apply(calib_entry_t *entry,
+                        const dht11_calib_params_t *params);
+
+/**
+ * @brief Move the cluster means towards the widths of a valid frame
+ *
+ * Called with calib_lock held.
+ *
+ * @param entry Entry of the instance
+ * @param widths DHT11_NUM_DATA_BITS pulse widths in us
+ */
+static void calib_track_drift(calib_entry_t *entry, const uint8_t *widths);
+
+/**
+ * @brief Derive the shortest accepted setup pulse from the mean 1 bit width
+ *
+ * Never stricter than the default and always longer than the threshold.
+ *
+ * @param params Parameters with threshold_us and one_us set
+ * @return Shortest accepted setup pulse in us
+ */
+static uint8_t setup_min_us(const dht11_calib_params_t *params);
+
+/**
+ * @brief Queue the store or deletion of the persisted parameters of an
+ * instance
+ *
+ * Called with calib_lock held.  Only the parameters are copied, the settings
+ * write runs from calib_persist_handler() on the storage work queue.
+ *
+ * @param inst Instance index
+ * @param params Parameters to store, NULL to delete them
+ */
+static void calib_persist(uint8_t inst, const dht11_calib_params_t *params);
+
+#ifdef CONFIG_APP_DHT11_CALIB_PERSIST
+/**
+ * @brief Write the queued parameters of every instance to the settings
+ *
+ * @param work UNUSED
+ */
+static void calib_persist_handler(struct k_work *work);
+
+/**
+ * @brief Settings handler restoring the parameters of an instance
+ *
+ * @param name Instance index below CALIB_SETTINGS_ROOT
+ * @param len Size of the stored value
+ * @param read_cb Reads the stored value
+ * @param cb_arg Passed to read_cb
+ * @return 0 on success, negative errno otherwise
+ */
+static int calib_settings_set(const char *name, size_t len,
+                              settings_read_cb read_cb, void *cb_arg);
+#endif
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+static calib_entry_t calib_entries[DHT11_NUM_INSTANCES];
+
+/** Protects calib_entries, taken from the decode work and callers */
+static struct k_spinlock calib_lock;
+
+/** Set by the first dht11_calib_init() */
+static atomic_t calib_initialized = ATOMIC_INIT(0);
+
+#ifdef CONFIG_APP_DHT11_CALIB_PERSIST
+SETTINGS_STATIC_HANDLER_DEFINE(dht11_calib, CALIB_SETTINGS_ROOT, NULL,
+                               calib_settings_set, NULL, NULL);
+
+static K_WORK_DEFINE(calib_persist_work, calib_persist_handler);
+#endif
+
+/*******************************************************************************
+ * Function Definitions
+ ******************************************************************************/
+
+// Described in .h
+int dht11_calib_init(void) {
+  if (atomic_set(&calib_initialized, 1)) {
+    return 0;
+  }
+
+  K_SPINLOCK(&calib_lock) {
+    for (uint8_t idx = 0; idx < DHT11_NUM_INSTANCES; idx++) {
+      calib_clear(&calib_entries[idx]);
+    }
+  }
+
+#ifdef CONFIG_APP_DHT11_CALIB_PERSIST
+  int ret = settings_subsys_init();
+  if (!ret) {
+    ret = settings_load_subtree(CALIB_SETTINGS_ROOT);
+  }
+
+  if (ret) {
+    COMMON_LOG_ERR("Failed to load DHT11 calibration: %d", ret);
+    return ret;
+  }
+#endif
+
+  return 0;
+}
+
+// Described in .h
+dht11_error_t dht11_calib_start(uint8_t inst) {
+  if (inst >= DHT11_NUM_INSTANCES) {
+    return DHT11_ERROR_CONFIG_FAILURE;
+  }
+
+  K_SPINLOCK(&calib_lock) {
+    calib_entry_t *entry = &calib_entries[inst];
+
+    // A calibrated instance keeps decoding with its parameters while it is
+    // recalibrated, frames_collected tracks the progress in both cases
+    if (entry->state != DHT11_CALIB_STATE_DONE) {
+      entry->state = DHT11_CALIB_STATE_RUNNING;
+    }
+
+    entry->frames_collected = 0;
+    entry->samples = 0;
+    memset(entry->histogram, 0, sizeof(entry->histogram));
+  }
+
+  return DHT11_ERROR_NONE;
+}
+
+// Described in .h
+dht11_error_t dht11_calib_reset(uint8_t inst) {
+  if (inst >= DHT11_NUM_INSTANCES) {
+    return DHT11_ERROR_CONFIG_FAILURE;
+  }
+
+  K_SPINLOCK(&calib_lock) {
+    calib_clear(&calib_entries[inst]);
+    calib_persist(inst, NULL);
+  }
+
+  return DHT11_ERROR_NONE;
+}
+
+// Described above
+static void calib_clear(calib_entry_t *entry) {
+  memset(entry, 0, sizeof(*entry));
+
+  entry->state = DHT11_CALIB_STATE_DEFAULT;
+  entry->params.threshold_us = DHT11_CALIB_DEFAULT_THRESHOLD_US;
+  entry->params.setup_min_us = DHT11_CALIB_DEFAULT_SETUP_MIN_US;
+  // Nothing to collect until dht11_calib_start()
+  entry->frames_collected = DHT11_CALIB_FRAMES;
+}
+
+// Described in .h
+void dht11_calib_get_params(uint8_t inst, dht11_calib_params_t *params) {
+  K_SPINLOCK(&calib_lock) { *params = calib_entries[inst].params; }
+}
+
+// Described in .h
+void dht11_calib_update(uint8_t inst, const uint8_t *widths,
+                        dht11_error_t err) {
+  dht11_calib_params_t derived;
+  dht11_calib_counts_t before;
+  bool calibrated = false;
+  bool failed = false;
+
+  if (inst >= DHT11_NUM_INSTANCES) {
+    return;
+  }
+
+  K_SPINLOCK(&calib_lock) {
+    calib_entry_t *entry = &calib_entries[inst];
+    dht11_calib_counts_t *counts = entry->state == DHT11_CALIB_STATE_DONE
+                                       ? &entry->after
+                                       : &entry->before;
+
+    counts->frames++;
+    if (err == DHT11_ERROR_PARITY_CHECK_FAILED) {
+      counts->parity_failures++;
+    }
+
+    // Frames with a bad setup pulse may not be a DHT11 frame at all
+    if (err == DHT11_ERROR_SETUP_FAILED) {
+      K_SPINLOCK_BREAK;
+    }
+
+    histogram_add(entry, widths);
+
+    if (entry->frames_collected < DHT11_CALIB_FRAMES &&
+        ++entry->frames_collected == DHT11_CALIB_FRAMES) {
+      calibrated = dht11_calib_derive(entry->histogram, &derived);
+      if (calibrated) {
+        entry->state = DHT11_CALIB_STATE_DONE;
+        entry->zero_mean = derived.zero_us << CALIB_MEAN_FRAC_BITS;
+        entry->one_mean = derived.one_us << CALIB_MEAN_FRAC_BITS;
+        calib_apply(entry, &derived);
+        derived = entry->params;
+      } else {
+        // A recalibration that fails keeps the parameters in use
+        if (entry->state == DHT11_CALIB_STATE_RUNNING) {
+          entry->state = DHT11_CALIB_STATE_DEFAULT;
+        }
+        failed = true;
+      }
+      before = entry->before;
+    } else if (entry->state == DHT11_CALIB_STATE_DONE && !err) {
+      calib_track_drift(entry, widths);
+    }
+
+    if (entry->state == DHT11_CALIB_STATE_DONE &&
+        (calibrated || abs(entry->params.threshold_us -
+                           entry->stored_threshold_us) >=
+                           DHT11_CALIB_PERSIST_DELTA_US)) {
+      entry->stored_threshold_us = entry->params.threshold_us;
+      calib_persist(inst, &entry->params);
+    }
+  }
+
+  if (calibrated) {
+    COMMON_LOG_INF("DHT11 %u calibrated: threshold %u us (0: %u us, 1: %u us)",
+                   inst, derived.threshold_us, derived.zero_us,
+                   derived.one_us);
+    COMMON_LOG_INF("DHT11 %u parity failures before calibration: %u of %u",
+                   inst, before.parity_failures, before.frames);
+  } else if (failed) {
+    COMMON_LOG_ERR("DHT11 %u calibration failed, no two pulse clusters", inst);
+  }
+}
+
+// Described above
+static void histogram_add(calib_entry_t *entry, const uint8_t *widths) {
+  for (uint8_t bit = 0; bit < DHT11_NUM_DATA_BITS; bit++) {
+    uint16_t *bin = &entry->histogram[widths[bit] / DHT11_CALIB_BIN_US];
+
+    // Halve every bin rather than saturate one so the shape is kept
+    if (*bin == UINT16_MAX) {
+      for (uint16_t idx = 0; idx < DHT11_CALIB_BINS; idx++) {
+        entry->histogram[idx] /= 2;
+      }
+    }
+
+    (*bin)++;
+  }
+
+  entry->samples += DHT11_NUM_DATA_BITS;
+}
+
+// Described in .h
+bool dht11_calib_derive(const uint16_t *bins, dht11_calib_params_t *params) {
+  uint32_t threshold = 0;
+  uint32_t mean[2] = {0};
+
+  // The iteration starts from the mean width so a clock that stretches or
+  // shrinks every pulse still finds a width on each side
+  for (uint8_t iter = 0; iter <= CALIB_MAX_ITERATIONS; iter++) {
+    uint32_t count[2] = {0};
+    uint32_t sum[2] = {0};
+
+    // The last bin holds the widths clamped by the capture, they are not
+    // measurements
+    for (uint16_t idx = 0; idx < DHT11_CALIB_BINS - 1; idx++) {
+      uint32_t width = idx * DHT11_CALIB_BIN_US + DHT11_CALIB_BIN_US / 2;
+      uint8_t cluster = width > threshold;
+
+      count[cluster] += bins[idx];
+      sum[cluster] += bins[idx] * width;
+    }
+
+    if (!iter) {
+      if (!count[1]) {
+        return false;
+      }
+      threshold = sum[1] / count[1];
+      continue;
+    }
+
+    if (!count[0] || !count[1]) {
+      return false;
+    }
+
+    mean[0] = sum[0] / count[0];
+    mean[1] = sum[1] / count[1];
+
+    uint32_t next = (mean[0] + mean[1]) / 2;
+    if (next == threshold) {
+      break;
+    }
+    threshold = next;
+  }
+
+  if (mean[1] - mean[0] < CALIB_MIN_SEPARATION_US) {
+    return false;
+  }
+
+  params->threshold_us = threshold;
+  params->zero_us = mean[0];
+  params->one_us = mean[1];
+  params->setup_min_us = setup_min_us(params);
+
+  return true;
+}
+
+// Described above
+static void calib_apply(calib_entry_t *entry,
+                        const dht11_calib_params_t *params) {
+  entry->params = *params;
+  entry->params.threshold_us = (params->zero_us + params->one_us) / 2;
+  entry->params.setup_min_us = setup_min_us(&entry->params);
+}
+
+// Described above
+static void calib_track_drift(calib_entry_t *entry, const uint8_t *widths) {
+  uint32_t count[2] = {0};
+  uint32_t sum[2] = {0};
+
+  for (uint8_t bit = 0; bit < DHT11_NUM_DATA_BITS; bit++) {
+    uint8_t cluster = widths[bit] > entry->params.threshold_us;
+
+    count[cluster]++;
+    sum[cluster] += widths[bit];
+  }
+
+  uint16_t *means[2] = {&entry->zero_mean, &entry->one_mean};
+
+  for (uint8_t cluster = 0; cluster < 2; cluster++) {
+    if (!count[cluster]) {
+      continue;
+    }
+
+    int32_t target = (sum[cluster] << CALIB_MEAN_FRAC_BITS) / count[cluster];
+    int32_t mean = *means[cluster];
+
+    *means[cluster] = mean + ((target - mean) >> DHT11_CALIB_DRIFT_SHIFT);
+  }
+
+  dht11_calib_params_t params = {
+      .zero_us = entry->zero_mean >> CALIB_MEAN_FRAC_BITS,
+      .one_us = entry->one_mean >> CALIB_MEAN_FRAC_BITS,
+  };
+
+  calib_apply(entry, &params);
+}
+
+// Described above
+static uint8_t setup_min_us(const dht11_calib_params_t *params) {
+  uint32_t setup_min = DHT11_CALIB_DEFAULT_SETUP_MIN_US * params->one_us /
+                       DHT11_CALIB_NOMINAL_ONE_US;
+
+  return CLAMP(setup_min, params->threshold_us + 1U,
+               DHT11_CALIB_DEFAULT_SETUP_MIN_US);
+}
+
+// Described in .h
+dht11_error_t dht11_calib_get_stats(uint8_t inst, dht11_calib_stats_t *stats) {
+  if (inst >= DHT11_NUM_INSTANCES) {
+    return DHT11_ERROR_CONFIG_FAILURE;
+  }
+
+  // No lock, the spinlock would mask the capture interrupt while copying
+  const calib_entry_t *entry = &calib_entries[inst];
+
+  stats->state = entry->state;
+  stats->params = entry->params;
+  stats->before = entry->before;
+  stats->after = entry->after;
+  stats->samples = entry->samples;
+
+  return DHT11_ERROR_NONE;
+}
+
+// Described in .h
+dht11_error_t dht11_calib_get_histogram(uint8_t inst, uint16_t *bins) {
+  if (inst >= DHT11_NUM_INSTANCES) {
+    return DHT11_ERROR_CONFIG_FAILURE;
+  }
+
+  memcpy(bins, calib_entries[inst].histogram,
+         sizeof(calib_entries[inst].histogram));
+
+  return DHT11_ERROR_NONE;
+}
+
+// Described above
+static void calib_persist(uint8_t inst, const dht11_calib_params_t *params) {
+#ifdef CONFIG_APP_DHT11_CALIB_PERSIST
+  calib_entry_t *entry = &calib_entries[inst];
+
+  // A write still queued is replaced, only the latest parameters matter
+  if (params) {
+    entry->persist_op = CALIB_PERSIST_STORE;
+    entry->persist_params = *params;
+  } else {
+    entry->persist_op = CALIB_PERSIST_DELETE;
+  }
+
+  k_work_submit_to_queue(&storage_workq, &calib_persist_work);
+#else
+  ARG_UNUSED(inst);
+  ARG_UNUSED(params);
+#endif
+}
+
+#ifdef CONFIG_APP_DHT11_CALIB_PERSIST
+// Described above
+static void calib_persist_handler(struct k_work *work) {
+  for (uint8_t inst = 0; inst < DHT11_NUM_INSTANCES; inst++) {
+    char key[sizeof(CALIB_SETTINGS_ROOT "/255")];
+    calib_persist_op_t op;
+    dht11_calib_params_t params;
+    int ret;
+
+    K_SPINLOCK(&calib_lock) {
+      calib_entry_t *entry = &calib_entries[inst];
+
+      op = entry->persist_op;
+      params = entry->persist_params;
+      entry->persist_op = CALIB_PERSIST_NONE;
+    }
+
+    if (op == CALIB_PERSIST_NONE) {
+      continue;
+    }
+
+    snprintf(key, sizeof(key), CALIB_SETTINGS_ROOT "/%u", inst);
+
+    // Settings writes may erase a flash sector, hence the storage work queue
+    if (op == CALIB_PERSIST_STORE) {
+      ret = settings_save_one(key, &params, sizeof(params));
+    } else {
+      ret = settings_delete(key);
+    }
+
+    if (ret) {
+      COMMON_LOG_ERR("Failed to store DHT11 %u calibration: %d", inst, ret);
+    }
+  }
+}
+#endif
+
+#ifdef CONFIG_APP_DHT11_CALIB_PERSIST
+// Described above
+static int calib_settings_set(const char *name, size_t len,
+                              settings_read_cb read_cb, void *cb_arg) {
+  dht11_calib_params_t params;
+  char *end;
+  unsigned long inst = strtoul(name, &end, 10);
+
+  if (end == name || (*end && *end != '/') || inst >= DHT11_NUM_INSTANCES) {
+    return -ENOENT;
+  }
+
+  if (len != sizeof(params) ||
+      read_cb(cb_arg, &params, sizeof(params)) != sizeof(params)) {
+    return -EINVAL;
+  }
+
+  // A record that could not have been derived would break every decode
+  if (!(params.zero_us < params.threshold_us &&
+        params.threshold_us < params.one_us &&
+        params.one_us - params.zero_us >= CALIB_MIN_SEPARATION_US)) {
+    return -EINVAL;
+  }
+
+  K_SPINLOCK(&calib_lock) {
+    calib_entry_t *entry = &calib_entries[inst];
+
+    entry->state = DHT11_CALIB_STATE_DONE;
+    entry->zero_mean = params.zero_us << CALIB_MEAN_FRAC_BITS;
+    entry->one_mean = params.one_us << CALIB_MEAN_FRAC_BITS;
+    entry->stored_threshold_us = params.threshold_us;
+    calib_apply(entry, &params);
+  }
+
+  return 0;
+}
+#endif
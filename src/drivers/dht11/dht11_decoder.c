@@ -0,0 +1,123 @@
+/**
+ * @file dht11_decoder.c
+ * @brief Decoder for DHT11 RTIO read buffers
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#define DT_DRV_COMPAT custom_gpio_data
+
+#include <zephyr/drivers/sensor.h>
+#include <zephyr/kernel.h>
+
+#include <dht11.h>
+
+#include "dht11_sensor.h"
+
+/*******************************************************************************
+ * Function Definitions
+ ******************************************************************************/
+
+/**
+ * @brief Convert a value of a sample to Q31
+ *
+ * @param x10 Value in 0.1 units
+ * @return Value in Q31 with DHT11_Q31_SHIFT
+ */
+static q31_t dht11_to_q31(int16_t x10) {
+  return (q31_t)(((int64_t)x10 * (1LL << (31 - DHT11_Q31_SHIFT))) / 10);
+}
+
+static int dht11_decoder_get_frame_count(const uint8_t *buffer,
+                                         struct sensor_chan_spec chan_spec,
+                                         uint16_t *frame_count) {
+  ARG_UNUSED(buffer);
+
+  if (chan_spec.chan_idx != 0) {
+    return -ENOTSUP;
+  }
+
+  switch (chan_spec.chan_type) {
+  case SENSOR_CHAN_AMBIENT_TEMP:
+  case SENSOR_CHAN_HUMIDITY:
+    *frame_count = 1;
+    return 0;
+  default:
+    return -ENOTSUP;
+  }
+}
+
+static int dht11_decoder_get_size_info(struct sensor_chan_spec chan_spec,
+                                       size_t *base_size, size_t *frame_size) {
+  switch (chan_spec.chan_type) {
+  case SENSOR_CHAN_AMBIENT_TEMP:
+  case SENSOR_CHAN_HUMIDITY:
+    *base_size = sizeof(struct sensor_q31_data);
+    *frame_size = sizeof(struct sensor_q31_sample_data);
+    return 0;
+  default:
+    return -ENOTSUP;
+  }
+}
+
+static int dht11_decoder_decode(const uint8_t *buffer,
+                                struct sensor_chan_spec chan_spec,
+                                uint32_t *fit, uint16_t max_count,
+                                void *data_out) {
+  const struct dht11_encoded_data *edata =
+      (const struct dht11_encoded_data *)buffer;
+  struct sensor_q31_data *out = data_out;
+  int16_t x10;
+
+  // Each buffer holds a single frame
+  if (*fit != 0 || max_count == 0) {
+    return 0;
+  }
+
+  switch (chan_spec.chan_type) {
+  case SENSOR_CHAN_AMBIENT_TEMP:
+    x10 = edata->sample.t_x10;
+    break;
+  case SENSOR_CHAN_HUMIDITY:
+    x10 = edata->sample.rh_x10;
+    break;
+  default:
+    return -ENOTSUP;
+  }
+
+  out->header.base_timestamp_ns = edata->timestamp_ns;
+  out->header.reading_count = 1;
+  out->shift = DHT11_Q31_SHIFT;
+  out->readings[0].timestamp_delta = 0;
+  out->readings[0].value = dht11_to_q31(x10);
+
+  *fit = 1;
+
+  return 1;
+}
+
+static bool dht11_decoder_has_trigger(const uint8_t *buffer,
+                                      enum sensor_trigger_type trigger) {
+  ARG_UNUSED(buffer);
+  ARG_UNUSED(trigger);
+
+  return false;
+}
+
+SENSOR_DECODER_API_DT_DEFINE() = {
+    .get_frame_count = dht11_decoder_get_frame_count,
+    .get_size_info = dht11_decoder_get_size_info,
+    .decode = dht11_decoder_decode,
+    .has_trigger = dht11_decoder_has_trigger,
+};
+
+// Described in dht11_sensor.h
+int dht11_get_decoder(const struct device *dev,
+                      const struct sensor_decoder_api **decoder) {
+  ARG_UNUSED(dev);
+
+  *decoder = &SENSOR_DECODER_NAME();
+
+  return 0;
+}
@@ -0,0 +1,399 @@
+/**
+ * @file dht11_emul.c
+ * @brief Emulated DHT11 on the native_sim GPIO emulator
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#define DT_DRV_COMPAT custom_gpio_data
+
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/gpio/gpio_emul.h>
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+
+#include <errno.h>
+
+#include <dht11.h>
+#include <dht11_emul.h>
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/** Interval in us at which a held line is sampled for its release once the
+ * start signal is long enough */
+#define DHT11_EMUL_HELD_US 10
+
+/** Levels of a response: the high before the preamble, the preamble, a low and
+ * a high per data bit and the final low */
+#define DHT11_EMUL_LEVELS (3 + 2 * DHT11_NUM_DATA_BITS + 1)
+
+/** Per instance initialiser for emuls */
+#define DHT11_EMUL_DEFINE(n)                                                   \
+  BUILD_ASSERT(DT_NODE_HAS_COMPAT(DT_INST_GPIO_CTLR(n, gpios),                 \
+                                  zephyr_gpio_emul),                           \
+               "DHT11 " #n " is not on a GPIO emulator");                      \
+  static dht11_emul_t emul_##n = {                                             \
+      .gpio = GPIO_DT_SPEC_INST_GET(n, gpios),                                 \
+      .model = DHT11_INST_MODEL(n),                                            \
+  };
+
+/** Entry of emuls */
+#define DHT11_EMUL_ENTRY(n) &emul_##n,
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+
+/** What the emulated sensor is doing */
+enum emul_state {
+  EMUL_IDLE = 0,   ///< Line released, waiting for the start signal
+  EMUL_HELD,       ///< MCU is holding the line low
+  EMUL_RESPONDING, ///< Driving the response
+};
+
+/** State of an emulated sensor */
+typedef struct dht11_emul_s {
+  /** Line of the sensor, the pin of a GPIO emulator */
+  const struct gpio_dt_spec gpio;
+  /** Model emulated, sets the shortest start signal answered */
+  const dht11_model_t *model;
+  /** Runs the state machine at the next point of interest */
+  struct k_timer timer;
+  /** Serialises the timer and dht11_emul_poll() */
+  struct k_spinlock lock;
+  enum emul_state state;
+  dht11_emul_config_t config;
+  /** Reading sent with the next start signal */
+  dht11_data_t data;
+  dht11_emul_stats_t stats;
+  /** Cycle count at which the line was first seen held low */
+  uint32_t held_since;
+  /** Cycle count at which the line was released, time 0 of the response */
+  uint32_t released_at;
+  /** End in us of each level of the response, levels alternate from high */
+  uint32_t ends[DHT11_EMUL_LEVELS];
+  /** Number of valid entries in ends */
+  uint8_t num_levels;
+  /** Level of the response driven at the moment */
+  uint8_t level;
+  /** Jitter generator state */
+  uint32_t rand_state;
+} dht11_emul_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Configure the lines as inputs pulled high and start the emulators
+ *
+ * @return 0 on success
+ * @return -ENODEV if a GPIO emulator is not ready
+ */
+static int dht11_emul_init(void);
+
+/**
+ * @brief Timer expiry, brings the instance up to date
+ *
+ * @param timer Timer of the instance
+ */
+static void emul_timer_handler(struct k_timer *timer);
+
+/**
+ * @brief Bring an instance up to date with the line and the time
+ *
+ * Called with the instance locked.
+ *
+ * @param emul Instance
+ * @param now Current cycle count
+ * @return Time in us until the state machine needs to run again
+ */
+static uint32_t emul_sync(dht11_emul_t *emul, uint32_t now);
+
+/**
+ * @brief Lay out the response to a start signal in ends
+ *
+ * @param emul Instance
+ */
+static void build_response(dht11_emul_t *emul);
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+DT_INST_FOREACH_STATUS_OKAY(DHT11_EMUL_DEFINE)
+
+/** Instances in the order of the driver */
+static dht11_emul_t *const emuls[] = {
+    DT_INST_FOREACH_STATUS_OKAY(DHT11_EMUL_ENTRY)};
+
+BUILD_ASSERT(ARRAY_SIZE(emuls) == DHT11_NUM_INSTANCES,
+             "DHT11 emulator count mismatch");
+
+SYS_INIT(dht11_emul_init, POST_KERNEL, CONFIG_APPLICATION_INIT_PRIORITY);
+
+/*******************************************************************************
+ * Function Definitions
+ ******************************************************************************/
+
+// Described in .h
+void dht11_emul_default_config(dht11_emul_config_t *config) {
+  *config = (dht11_emul_config_t){
+      .response_us = 30,
+      .ack_low_us = 80,
+      .ack_high_us = 80,
+      .bit_low_us = 50,
+      .zero_us = 27,
+      .one_us = 70,
+  };
+}
+
+// Described above
+static int dht11_emul_init(void) {
+  static const dht11_data_t initial = {.rh_high = 45, .t_high = 22};
+
+  for (uint8_t idx = 0; idx < ARRAY_SIZE(emuls); idx++) {
+    dht11_emul_t *emul = emuls[idx];
+
+    if (!gpio_is_ready_dt(&emul->gpio)) {
+      return -ENODEV;
+    }
+
+    dht11_emul_default_config(&emul->config);
+    emul->data = initial;
+    emul->level = 1;
+
+    // The input value is kept while the driver holds the line as an output
+    gpio_pin_configure(emul->gpio.port, emul->gpio.pin, GPIO_INPUT);
+    gpio_emul_input_set(emul->gpio.port, emul->gpio.pin, 1);
+
+    k_timer_init(&emul->timer, emul_timer_handler, NULL);
+    k_timer_start(&emul->timer, K_USEC(DHT11_EMUL_IDLE_US), K_NO_WAIT);
+  }
+
+  return 0;
+}
+
+// Described in .h
+int dht11_emul_configure(uint8_t inst, const dht11_emul_config_t *config) {
+  if (inst >= ARRAY_SIZE(emuls)) {
+    return -EINVAL;
+  }
+
+  dht11_emul_t *emul = emuls[inst];
+  k_spinlock_key_t key = k_spin_lock(&emul->lock);
+
+  emul->config = *config;
+  emul->rand_state = config->seed;
+
+  k_spin_unlock(&emul->lock, key);
+
+  return 0;
+}
+
+// Described in .h
+int dht11_emul_set_data(uint8_t inst, const dht11_data_t *data) {
+  if (inst >= ARRAY_SIZE(emuls)) {
+    return -EINVAL;
+  }
+
+  dht11_emul_t *emul = emuls[inst];
+  k_spinlock_key_t key = k_spin_lock(&emul->lock);
+
+  emul->data = *data;
+
+  k_spin_unlock(&emul->lock, key);
+
+  return 0;
+}
+
+// Described in .h
+int dht11_emul_get_stats(uint8_t inst, dht11_emul_stats_t *stats) {
+  if (inst >= ARRAY_SIZE(emuls)) {
+    return -EINVAL;
+  }
+
+  dht11_emul_t *emul = emuls[inst];
+  k_spinlock_key_t key = k_spin_lock(&emul->lock);
+
+  *stats = emul->stats;
+
+  k_spin_unlock(&emul->lock, key);
+
+  return 0;
+}
+
+// Described in .h
+void dht11_emul_poll(void) {
+  k_busy_wait(CONFIG_APP_DHT11_EMUL_POLL_US);
+
+  uint32_t now = k_cycle_get_32();
+
+  // The timers catch up once interrupts are unlocked, emul_sync() does not
+  // mind being run twice for the same time
+  for (uint8_t idx = 0; idx < ARRAY_SIZE(emuls); idx++) {
+    k_spinlock_key_t key = k_spin_lock(&emuls[idx]->lock);
+
+    emul_sync(emuls[idx], now);
+
+    k_spin_unlock(&emuls[idx]->lock, key);
+  }
+}
+
+// Described above
+static void emul_timer_handler(struct k_timer *timer) {
+  dht11_emul_t *emul = CONTAINER_OF(timer, dht11_emul_t, timer);
+  k_spinlock_key_t key = k_spin_lock(&emul->lock);
+
+  uint32_t next_us = emul_sync(emul, k_cycle_get_32());
+
+  k_timer_start(&emul->timer, K_USEC(next_us), K_NO_WAIT);
+
+  k_spin_unlock(&emul->lock, key);
+}
+
+/** Line level while the MCU drives it, -1 while it is an input */
+static int driven_level(const dht11_emul_t *emul) {
+  gpio_flags_t flags = 0;
+
+  gpio_emul_flags_get(emul->gpio.port, emul->gpio.pin, &flags);
+  if (!(flags & GPIO_OUTPUT)) {
+    return -1;
+  }
+
+  return gpio_emul_output_get(emul->gpio.port, emul->gpio.pin);
+}
+
+// Described above
+static uint32_t emul_sync(dht11_emul_t *emul, uint32_t now) {
+  int driven = driven_level(emul);
+
+  if (emul->state == EMUL_IDLE) {
+    if (driven != 0) {
+      return DHT11_EMUL_IDLE_US;
+    }
+
+    emul->state = EMUL_HELD;
+    emul->held_since = now;
+  }
+
+  if (emul->state == EMUL_HELD) {
+    uint32_t start_min_us = emul->model->start_ms * USEC_PER_MSEC;
+    // Seen low up to DHT11_EMUL_IDLE_US late
+    uint32_t held_us =
+        k_cyc_to_us_floor32(now - emul->held_since) + DHT11_EMUL_IDLE_US;
+
+    // Finer once the start signal is long enough, the release starts the
+    // response
+    if (driven == 0) {
+      return held_us < start_min_us
+                 ? MIN(start_min_us - held_us, DHT11_EMUL_IDLE_US)
+                 : DHT11_EMUL_HELD_US;
+    }
+
+    emul->state = EMUL_IDLE;
+
+    if (driven > 0 || emul->config.silent) {
+      return DHT11_EMUL_IDLE_US;
+    }
+
+    if (held_us < start_min_us) {
+      emul->stats.short_starts++;
+      return DHT11_EMUL_IDLE_US;
+    }
+
+    // Seen released up to DHT11_EMUL_HELD_US late, so held at least this long
+    if (held_us - DHT11_EMUL_IDLE_US - DHT11_EMUL_HELD_US >
+        emul->model->start_max_ms * USEC_PER_MSEC) {
+      emul->stats.long_starts++;
+      return DHT11_EMUL_IDLE_US;
+    }
+
+    build_response(emul);
+    emul->released_at = now;
+    emul->state = EMUL_RESPONDING;
+    emul->stats.starts++;
+  }
+
+  uint32_t elapsed_us = k_cyc_to_us_floor32(now - emul->released_at);
+  uint8_t idx = 0;
+
+  while (idx < emul->num_levels && elapsed_us >= emul->ends[idx]) {
+    idx++;
+  }
+
+  // Levels alternate from the high before the preamble, then the pull-up
+  uint8_t level = idx < emul->num_levels ? !(idx & 1) : 1;
+
+  if (level != emul->level) {
+    // Fires the edge interrupt of the driver from here
+    gpio_emul_input_set(emul->gpio.port, emul->gpio.pin, level);
+    emul->level = level;
+  }
+
+  if (idx == emul->num_levels) {
+    emul->state = EMUL_IDLE;
+    emul->stats.frames++;
+    return DHT11_EMUL_IDLE_US;
+  }
+
+  return emul->ends[idx] - elapsed_us;
+}
+
+/** Width moved by the jitter of the instance, never below 1 us */
+static uint32_t jittered(dht11_emul_t *emul, uint32_t width_us) {
+  uint32_t jitter = emul->config.jitter_us;
+
+  if (!jitter) {
+    return width_us;
+  }
+
+  emul->rand_state = emul->rand_state * 1103515245 + 12345;
+
+  int32_t offset = (int32_t)((emul->rand_state >> 8) % (2 * jitter + 1));
+
+  return MAX((int32_t)width_us + offset - (int32_t)jitter, 1);
+}
+
+// Described above
+static void build_response(dht11_emul_t *emul) {
+  const dht11_emul_config_t *config = &emul->config;
+  const dht11_data_t *data = &emul->data;
+  uint8_t parity = data->rh_high + data->rh_low + data->t_high + data->t_low;
+  const uint8_t bytes[] = {data->rh_high, data->rh_low, data->t_high,
+                           data->t_low,
+                           config->bad_parity ? (uint8_t)~parity : parity};
+  uint32_t widths[DHT11_EMUL_LEVELS];
+  uint8_t count = 0;
+
+  widths[count++] = config->response_us;
+  widths[count++] = config->ack_low_us;
+  widths[count++] = config->ack_high_us;
+
+  for (uint8_t bit = 0; bit < DHT11_NUM_DATA_BITS; bit++) {
+    bool one = (bytes[bit / 8] >> (7 - bit % 8)) & 1;
+    uint32_t high_us = one ? config->one_us : config->zero_us;
+
+    if (bit + 1 == config->drop_bit) {
+      // Without its falling edge the low merges with the highs around it
+      widths[count - 1] += config->bit_low_us + high_us;
+      continue;
+    }
+
+    widths[count++] = config->bit_low_us;
+    widths[count++] = high_us;
+  }
+
+  widths[count++] = config->bit_low_us;
+
+  uint32_t end = 0;
+
+  for (uint8_t idx = 0; idx < count; idx++) {
+    end += jittered(emul, widths[idx]);
+    emul->ends[idx] = end;
+  }
+
+  emul->num_levels = count;
+}
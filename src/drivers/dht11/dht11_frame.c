@@ -0,0 +1,215 @@
+/**
+ * @file dht11_frame.c
+ * @brief DHT11 frame layout, decoding and polling capture
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <stdbool.h>
+
+#include <dht11_frame.h>
+#include <hal.h>
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/** Setup time us to indicate transition to data transmission.
+ *
+ * The DHT11 will indicate that transmission is about to begin by
+ * first toggling the line low for 80 us and then allowing it to remain
+ * high for 80 us.
+ */
+#define DHT11_DATA_SETUP_US 80
+
+/** Longest time in us the line stays at one level once the DHT11 answers.
+ *
+ * The longest level of a frame is the 80 us preamble, a level lasting longer
+ * in the polling path means the sensor is absent or an edge was lost.
+ */
+#define DHT11_LEVEL_TIMEOUT_US 200
+
+/** Start index in bit array for the high RH byte */
+#define DHT11_RH_BYTE_MAJOR 0
+
+/** Start index in bit array for the low RH byte */
+#define DHT11_RH_BYTE_MINOR 8
+
+/** Start index in bit array for the high T byte */
+#define DHT11_T_BYTE_MAJOR 16
+
+/** Start index in bit array for the low T byte */
+#define DHT11_T_BYTE_MINOR 24
+
+/** Start index in bit array for the parity byte */
+#define DHT11_PARITY_BYTE 32
+
+/** Number of bytes in a DHT11 frame including the parity byte */
+#define DHT11_NUM_BYTES (DHT11_NUM_DATA_BITS / 8)
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Spin while the data line is at a level
+ *
+ * @param line Data line
+ * @param level Level to wait out
+ * @param timeout Longest wait in cycles
+ * @param last Set to the cycle count of the last read at level, left as it was
+ * if the line was not at level
+ * @return True once the line has left level
+ * @return False if it was still at level after timeout
+ */
+static bool wait_level(const hal_line_t *line, int level, uint32_t timeout,
+                       uint32_t *last);
+
+/*******************************************************************************
+ * Function Definitions
+ ******************************************************************************/
+
+// Described in .h
+uint8_t dht11_pack_bits(const uint8_t *bit_array, uint8_t start_index) {
+  uint8_t packed_data = 0;
+  uint8_t upper_bound = start_index + 8;
+
+  for (uint8_t idx = start_index; idx < upper_bound; idx++) {
+    packed_data |= (bit_array[idx] << ((upper_bound - 1) - idx));
+  }
+  return packed_data;
+}
+
+// Described in .h
+dht11_error_t dht11_frame_check_parity(const dht11_data_t *data) {
+  uint8_t parity_byte =
+      data->rh_high + data->rh_low + data->t_high + data->t_low;
+
+  // Check the parity byte
+  if (data->parity != parity_byte) {
+    return DHT11_ERROR_PARITY_CHECK_FAILED;
+  }
+
+  return DHT11_ERROR_NONE;
+}
+
+// Described in .h
+dht11_error_t dht11_frame_decode_bits(const uint8_t *bit_array,
+                                      dht11_data_t *data) {
+  data->rh_high = dht11_pack_bits(bit_array, DHT11_RH_BYTE_MAJOR);
+  data->rh_low = dht11_pack_bits(bit_array, DHT11_RH_BYTE_MINOR);
+  data->t_high = dht11_pack_bits(bit_array, DHT11_T_BYTE_MAJOR);
+  data->t_low = dht11_pack_bits(bit_array, DHT11_T_BYTE_MINOR);
+  data->parity = dht11_pack_bits(bit_array, DHT11_PARITY_BYTE);
+
+  return dht11_frame_check_parity(data);
+}
+
+// Described in .h
+dht11_error_t dht11_frame_decode_pulses(const uint8_t *widths,
+                                        uint8_t threshold_us,
+                                        uint8_t setup_min_us,
+                                        dht11_data_t *data) {
+  uint8_t bytes[DHT11_NUM_BYTES] = {0};
+
+  // The ISR may measure the 80 us setup pulse slightly short
+  if (widths[0] < setup_min_us) {
+    return DHT11_ERROR_SETUP_FAILED;
+  }
+
+  // Data bits follow the setup pulse, MSB first
+  for (uint8_t bit = 0; bit < DHT11_NUM_DATA_BITS; bit++) {
+    uint8_t *byte = &bytes[bit / 8];
+    *byte = (*byte << 1) | (widths[bit + 1] > threshold_us);
+  }
+
+  data->rh_high = bytes[DHT11_RH_BYTE_MAJOR / 8];
+  data->rh_low = bytes[DHT11_RH_BYTE_MINOR / 8];
+  data->t_high = bytes[DHT11_T_BYTE_MAJOR / 8];
+  data->t_low = bytes[DHT11_T_BYTE_MINOR / 8];
+  data->parity = bytes[DHT11_PARITY_BYTE / 8];
+
+  return dht11_frame_check_parity(data);
+}
+
+// Described above
+static bool wait_level(const hal_line_t *line, int level, uint32_t timeout,
+                       uint32_t *last) {
+  uint32_t begin = hal_cycles();
+  uint32_t now = begin;
+
+  while (hal_line_get(line) == level) {
+    *last = now;
+    now = hal_cycles();
+
+    if (now - begin > timeout) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// Described in .h
+dht11_error_t dht11_frame_poll(const hal_line_t *line,
+                               uint8_t *const bit_array) {
+  uint32_t timeout = hal_us_to_cycles(DHT11_LEVEL_TIMEOUT_US);
+
+  /* After we have pulled the pin low for 18 ms, the data line will be
+   * setup for output from the DHT11.  Before data is transmitted, the
+   * line will be 1) set low for 80 us and then 2) high for 80 us.  If
+   * we do not see the line go high for 80 us, indicate that the setup
+   * has failed.
+   */
+
+  /* Cycle count of the last read before the line went high, the start of a
+   * high pulse
+   */
+  uint32_t rise = hal_cycles();
+
+  /* Cycle count of the last read before the line went low, unused */
+  uint32_t fall = rise;
+
+  /* Pin will likely initially be high because it is pulled high when
+   * the MCU releases control due to pull up resistor.  Without a DHT11 it
+   * stays that way.
+   */
+  if (!wait_level(line, 1, timeout, &fall)) {
+    return DHT11_ERROR_HARDWARE_UNAVAILABLE;
+  }
+
+  /* Pin will go low for 80 us but we don't care, then wait until the line goes
+   * low again
+   */
+  if (!wait_level(line, 0, timeout, &rise) ||
+      !wait_level(line, 1, timeout, &fall)) {
+    return DHT11_ERROR_SETUP_FAILED;
+  }
+
+  // Duration is the difference between the last low and the end of the high.
+  // This will add an extra 5 us or so, but we don't care as we are only
+  // interested in the duration greater than 80 us.
+  uint32_t duration = hal_cycles_to_us(hal_cycles() - rise);
+
+  if (duration < DHT11_DATA_SETUP_US) {
+    return DHT11_ERROR_SETUP_FAILED;
+  }
+
+  // Start retrieving data
+  for (uint8_t bit = 0; bit < DHT11_NUM_DATA_BITS; bit++) {
+    rise = hal_cycles();
+
+    // Low doesn't matter, a level outlasting the timeout is a lost edge
+    if (!wait_level(line, 0, timeout, &rise) ||
+        !wait_level(line, 1, timeout, &fall)) {
+      return DHT11_ERROR_SETUP_FAILED;
+    }
+
+    // The value of the bit is determined by the high time
+    duration = hal_cycles_to_us(hal_cycles() - rise);
+    bit_array[bit] = duration > DHT11_FRAME_THRESHOLD_US;
+  }
+
+  return DHT11_ERROR_NONE;
+}
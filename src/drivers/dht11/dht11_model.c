@@ -0,0 +1,129 @@
+/**
+ * @file dht11_model.c
+ * @brief Sensors of the DHT11 family and the conversion of their frames
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <dht11_model.h>
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/** Largest valid tenths byte of the DHT11 */
+#define DHT11_TENTHS_MAX 9
+
+/** Sign bit of the DHT11 temperature tenths byte */
+#define DHT11_T_SIGN 0x80
+
+/** Sign bit of the DHT22 temperature high byte */
+#define DHT22_T_SIGN 0x80
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Conversion of a DHT11 frame, integer and tenths bytes
+ *
+ * @param data Frame that passed the parity check
+ * @param sample Pointer to store the converted sample
+ * @return As dht11_convert_t
+ */
+static dht11_error_t convert_dht11(const dht11_data_t *data,
+                                   dht11_sample_t *sample);
+
+/**
+ * @brief Conversion of a DHT22 frame, 16 bit values in 0.1 units
+ *
+ * @param data Frame that passed the parity check
+ * @param sample Pointer to store the converted sample
+ * @return As dht11_convert_t
+ */
+static dht11_error_t convert_dht22(const dht11_data_t *data,
+                                   dht11_sample_t *sample);
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+// Described in .h
+const dht11_model_t dht11_model_dht11 = {
+    .name = "DHT11",
+    .start_ms = 18,
+    .start_max_ms = 30,
+    .min_interval_ms = 1000,
+    .rh_max_x10 = 1000,
+    .t_min_x10 = -200,
+    .t_max_x10 = 600,
+    .convert = convert_dht11,
+};
+
+// Described in .h
+const dht11_model_t dht11_model_dht22 = {
+    .name = "DHT22",
+    // 1 ms typical, the margin covers the rounding of the sleep to ticks
+    .start_ms = 2,
+    .start_max_ms = 20,
+    .min_interval_ms = 2000,
+    .rh_max_x10 = 1000,
+    .t_min_x10 = -400,
+    .t_max_x10 = 800,
+    .convert = convert_dht22,
+};
+
+/*******************************************************************************
+ * Function Definitions
+ ******************************************************************************/
+
+// Described above
+static dht11_error_t convert_dht11(const dht11_data_t *data,
+                                   dht11_sample_t *sample) {
+  uint8_t t_tenths = data->t_low & ~DHT11_T_SIGN;
+
+  if (data->rh_low > DHT11_TENTHS_MAX || t_tenths > DHT11_TENTHS_MAX) {
+    return DHT11_ERROR_OUT_OF_RANGE;
+  }
+
+  sample->rh_x10 = data->rh_high * 10 + data->rh_low;
+  sample->t_x10 = data->t_high * 10 + t_tenths;
+  if (data->t_low & DHT11_T_SIGN) {
+    sample->t_x10 = -sample->t_x10;
+  }
+
+  return DHT11_ERROR_NONE;
+}
+
+// Described above
+static dht11_error_t convert_dht22(const dht11_data_t *data,
+                                   dht11_sample_t *sample) {
+  int16_t t_mag = ((data->t_high & ~DHT22_T_SIGN) << 8) | data->t_low;
+
+  sample->rh_x10 = (int16_t)((data->rh_high << 8) | data->rh_low);
+  sample->t_x10 = data->t_high & DHT22_T_SIGN ? -t_mag : t_mag;
+
+  return DHT11_ERROR_NONE;
+}
+
+// Described in .h
+dht11_error_t dht11_model_sample(const dht11_model_t *model,
+                                 const dht11_data_t *data,
+                                 dht11_sample_t *sample) {
+  if (!data->rh_high && !data->rh_low && !data->t_high && !data->t_low) {
+    return DHT11_ERROR_OUT_OF_RANGE;
+  }
+
+  dht11_error_t err = model->convert(data, sample);
+  if (err) {
+    return err;
+  }
+
+  if (sample->rh_x10 < 0 || sample->rh_x10 > model->rh_max_x10 ||
+      sample->t_x10 < model->t_min_x10 || sample->t_x10 > model->t_max_x10) {
+    return DHT11_ERROR_OUT_OF_RANGE;
+  }
+
+  return DHT11_ERROR_NONE;
+}
@@ -0,0 +1,468 @@
+/**
+ * @file dht11_reliable.c
+ * @brief Retrying, validating front end for DHT11 reads
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+
+#include <string.h>
+
+#include <common.h>
+#include <dht11.h>
+#include <dht11_reliable.h>
+
+LOG_MODULE_REGISTER(dht11_reliable, 3);
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+
+/** Request state of a single instance */
+typedef struct reliable_inst_s {
+  /** Runs the next attempt once the minimum read interval allows */
+  struct k_work_delayable attempt_work;
+  /** Requester of the request in flight */
+  dht11_read_cb_t cb;
+  void *user_data;
+  /** Timing and range of the sensor */
+  const dht11_model_t *model;
+  /** Non-zero while a request is in flight */
+  atomic_t busy;
+  uint8_t inst;
+  /** Attempts made for the request in flight */
+  uint8_t attempts;
+  /** Consecutive attempts that saw no response */
+  uint8_t unanswered;
+  /** Probe interval in ms while the sensor is absent, 0 while present */
+  uint32_t backoff_ms;
+  /** Uptime in ms at the start of the last attempt */
+  int64_t last_attempt_ms;
+  /** Uptime in ms before which an absent sensor is not probed */
+  int64_t probe_ms;
+  /** Cycle count at the start of the attempt in flight */
+  uint32_t start_cycles;
+  /** Frame of the last valid attempt */
+  dht11_data_t data;
+} reliable_inst_t;
+
+/** Bus time record of one class */
+typedef struct class_record_s {
+  atomic_t count;
+  atomic_t max_us;
+  uint16_t buckets[DHT11_RELIABLE_BUCKETS];
+} class_record_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Initialise the instances
+ *
+ * @return 0 always
+ */
+static int dht11_reliable_init(void);
+
+/**
+ * @brief Schedule the next attempt of a request
+ *
+ * The attempt runs once the minimum read interval of the model has elapsed
+ * since the start of the previous one.
+ *
+ * @param rel Instance of the request
+ */
+static void schedule_attempt(reliable_inst_t *rel);
+
+/**
+ * @brief Start an attempt, runs on the system work queue or, for the polling
+ * capture, on poll_workq
+ *
+ * @param work Attempt work of the instance
+ */
+static void attempt_work_handler(struct k_work *work);
+
+/**
+ * @brief Classify and record an attempt, then retry or complete the request
+ *
+ * @param err Result of the conversion
+ * @param data Decoded frame
+ * @param user_data Instance of the request
+ */
+static void attempt_done(dht11_error_t err, const dht11_data_t *data,
+                         void *user_data);
+
+/**
+ * @brief Whether a failed attempt is worth another conversion
+ *
+ * @param rel Instance of the request
+ * @param err Result of the attempt
+ * @return True if the request should be retried
+ */
+static bool should_retry(const reliable_inst_t *rel, dht11_error_t err);
+
+/**
+ * @brief Complete the request in flight and notify the requester
+ *
+ * @param rel Instance of the request
+ * @param err Result of the request
+ * @param skipped True if the request failed without an attempt
+ */
+static void complete_request(reliable_inst_t *rel, dht11_error_t err,
+                             bool skipped);
+
+/**
+ * @brief Record the outcome of an attempt
+ *
+ * @param rel Instance of the attempt
+ * @param cls Class of the attempt
+ * @param bus_us Bus time of the attempt
+ */
+static void record_attempt(const reliable_inst_t *rel,
+                           dht11_reliable_class_t cls, uint32_t bus_us);
+
+/**
+ * @brief Bus time at a percentile of a histogram
+ *
+ * @param buckets Copy of the histogram of a class
+ * @param max_us Longest bus time of the class
+ * @param pct Percentile, 1 to 100
+ * @return Upper edge of the bucket holding the percentile in us, the longest
+ * bus time if that is the last bucket
+ */
+static uint32_t bucket_percentile(const uint16_t *buckets, uint32_t max_us,
+                                  uint32_t pct);
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+static reliable_inst_t reliable_insts[DHT11_NUM_INSTANCES];
+
+#ifdef CONFIG_APP_DHT11_POLL_WORKQ
+static K_THREAD_STACK_DEFINE(poll_stack,
+                             CONFIG_APP_DHT11_POLL_WORKQ_STACK_SIZE);
+
+/** Runs the attempts of the polling capture, which block for the frame */
+static struct k_work_q poll_workq;
+#endif
+
+/** Written by the work queue of the attempts only, read without a lock */
+static class_record_t class_records[DHT11_RELIABLE_CLASS_MAX];
+
+static atomic_t stat_requests;
+static atomic_t stat_published;
+static atomic_t stat_retries;
+static atomic_t stat_skipped;
+static atomic_t stat_bus_ms;
+
+/** Bus time in us, published in ms through stat_bus_ms */
+static uint64_t bus_us_total;
+
+SYS_INIT(dht11_reliable_init, POST_KERNEL, 0);
+
+/*******************************************************************************
+ * Function Definitions
+ ******************************************************************************/
+
+// Described above
+static int dht11_reliable_init(void) {
+  for (uint8_t idx = 0; idx < DHT11_NUM_INSTANCES; idx++) {
+    reliable_inst_t *rel = &reliable_insts[idx];
+
+    k_work_init_delayable(&rel->attempt_work, attempt_work_handler);
+    rel->model = dht11_model_get(idx);
+    rel->last_attempt_ms = -rel->model->min_interval_ms;
+    rel->inst = idx;
+  }
+
+#ifdef CONFIG_APP_DHT11_POLL_WORKQ
+  const struct k_work_queue_config cfg = {.name = "dht11_poll"};
+
+  // High enough that the start signal is released on time
+  k_work_queue_start(&poll_workq, poll_stack, K_THREAD_STACK_SIZEOF(poll_stack),
+                     K_HIGHEST_APPLICATION_THREAD_PRIO, &cfg);
+#endif
+
+  return 0;
+}
+
+// Described in .h
+dht11_error_t dht11_reliable_read(uint8_t inst, dht11_read_cb_t cb,
+                                  void *user_data) {
+  if (inst >= DHT11_NUM_INSTANCES || !cb) {
+    return DHT11_ERROR_CONFIG_FAILURE;
+  }
+
+  // A polled attempt must not block the system work queue
+  if (!dht11_async_available() && !IS_ENABLED(CONFIG_APP_DHT11_POLL_WORKQ)) {
+    return DHT11_ERROR_CONFIG_FAILURE;
+  }
+
+  reliable_inst_t *rel = &reliable_insts[inst];
+
+  if (!atomic_cas(&rel->busy, 0, 1)) {
+    return DHT11_ERROR_BUSY;
+  }
+
+  rel->cb = cb;
+  rel->user_data = user_data;
+  rel->attempts = 0;
+
+  schedule_attempt(rel);
+
+  return DHT11_ERROR_NONE;
+}
+
+// Described above
+static void schedule_attempt(reliable_inst_t *rel) {
+  int64_t wait_ms =
+      rel->last_attempt_ms + rel->model->min_interval_ms - k_uptime_get();
+  struct k_work_q *queue = &k_sys_work_q;
+
+#ifdef CONFIG_APP_DHT11_POLL_WORKQ
+  if (!dht11_async_available()) {
+    queue = &poll_workq;
+  }
+#endif
+
+  k_work_schedule_for_queue(queue, &rel->attempt_work, K_MSEC(MAX(wait_ms, 0)));
+}
+
+// Described above
+static void attempt_work_handler(struct k_work *work) {
+  struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+  reliable_inst_t *rel = CONTAINER_OF(dwork, reliable_inst_t, attempt_work);
+  dht11_data_t data = {0};
+  int64_t now = k_uptime_get();
+
+  // An absent sensor is only put on the bus when its probe is due
+  if (rel->backoff_ms && now < rel->probe_ms) {
+    complete_request(rel, DHT11_ERROR_HARDWARE_UNAVAILABLE, true);
+    return;
+  }
+
+  rel->attempts++;
+  rel->last_attempt_ms = now;
+  rel->start_cycles = k_cycle_get_32();
+
+  if (!dht11_async_available()) {
+    // Polling capture, the attempt runs to completion on poll_workq
+    attempt_done(dht11_get_data_inst(rel->inst, &data), &data, rel);
+    return;
+  }
+
+  dht11_error_t err = dht11_read_async(rel->inst, attempt_done, rel);
+  if (err) {
+    attempt_done(err, &data, rel);
+  }
+}
+
+// Described above
+static void attempt_done(dht11_error_t err, const dht11_data_t *data,
+                         void *user_data) {
+  reliable_inst_t *rel = user_data;
+  uint32_t bus_us = k_cyc_to_us_floor32(k_cycle_get_32() - rel->start_cycles);
+
+  if (!err) {
+    err = dht11_reliable_validate(rel->inst, data);
+  }
+
+  dht11_reliable_class_t cls = dht11_reliable_classify(err);
+
+  record_attempt(rel, cls, bus_us);
+
+  if (cls == DHT11_RELIABLE_CLASS_NO_RESPONSE) {
+    rel->unanswered = MIN(rel->unanswered + 1, UINT8_MAX);
+    if (rel->unanswered >= DHT11_RELIABLE_DOWN_THRESHOLD) {
+      rel->backoff_ms = rel->backoff_ms
+                            ? MIN(rel->backoff_ms * 2,
+                                  DHT11_RELIABLE_BACKOFF_MAX_MS)
+                            : rel->model->min_interval_ms;
+      rel->probe_ms = rel->last_attempt_ms + rel->backoff_ms;
+    }
+  } else if (cls != DHT11_RELIABLE_CLASS_OTHER) {
+    // Any frame, even a corrupt one, shows the sensor is there
+    if (rel->backoff_ms) {
+      COMMON_LOG_INF("DHT11 %d responding again", rel->inst);
+    }
+    rel->unanswered = 0;
+    rel->backoff_ms = 0;
+  }
+
+  if (!err) {
+    rel->data = *data;
+    complete_request(rel, err, false);
+    return;
+  }
+
+  if (should_retry(rel, err)) {
+    schedule_attempt(rel);
+    return;
+  }
+
+  complete_request(rel, err, false);
+}
+
+// Described above
+static bool should_retry(const reliable_inst_t *rel, dht11_error_t err) {
+  if (rel->attempts >= DHT11_RELIABLE_MAX_ATTEMPTS || rel->backoff_ms) {
+    return false;
+  }
+
+  // A configuration failure will not go away by itself, everything else may
+  return err != DHT11_ERROR_CONFIG_FAILURE;
+}
+
+// Described above
+static void record_attempt(const reliable_inst_t *rel,
+                           dht11_reliable_class_t cls, uint32_t bus_us) {
+  class_record_t *record = &class_records[cls];
+  uint16_t *bucket = &record->buckets[MIN(bus_us / DHT11_RELIABLE_BUCKET_US,
+                                          DHT11_RELIABLE_BUCKETS - 1)];
+
+  // Halve every bucket rather than saturate one so the shape is kept
+  if (*bucket == UINT16_MAX) {
+    for (uint8_t idx = 0; idx < DHT11_RELIABLE_BUCKETS; idx++) {
+      record->buckets[idx] /= 2;
+    }
+  }
+
+  (*bucket)++;
+  atomic_inc(&record->count);
+  if (bus_us > (uint32_t)atomic_get(&record->max_us)) {
+    atomic_set(&record->max_us, bus_us);
+  }
+
+  bus_us_total += bus_us;
+  atomic_set(&stat_bus_ms, (atomic_val_t)(bus_us_total / 1000));
+
+  if (rel->attempts > 1) {
+    atomic_inc(&stat_retries);
+  }
+}
+
+// Described above
+static void complete_request(reliable_inst_t *rel, dht11_error_t err,
+                             bool skipped) {
+  // Take copies so the callback is free to start the next request
+  dht11_data_t data = rel->data;
+  dht11_read_cb_t cb = rel->cb;
+  void *user_data = rel->user_data;
+
+  atomic_inc(&stat_requests);
+  if (!err) {
+    atomic_inc(&stat_published);
+  }
+  if (skipped) {
+    atomic_inc(&stat_skipped);
+  }
+
+  if (err) {
+    memset(&data, 0, sizeof(data));
+  }
+
+  atomic_clear(&rel->busy);
+
+  cb(err, &data, user_data);
+}
+
+// Described in .h
+dht11_error_t dht11_reliable_validate(uint8_t inst, const dht11_data_t *data) {
+  const dht11_model_t *model = dht11_model_get(inst);
+  dht11_sample_t sample;
+
+  if (!model) {
+    return DHT11_ERROR_CONFIG_FAILURE;
+  }
+
+  return dht11_model_sample(model, data, &sample);
+}
+
+// Described in .h
+dht11_reliable_class_t dht11_reliable_classify(dht11_error_t err) {
+  switch (err) {
+  case DHT11_ERROR_NONE:
+    return DHT11_RELIABLE_CLASS_OK;
+  case DHT11_ERROR_HARDWARE_UNAVAILABLE:
+    return DHT11_RELIABLE_CLASS_NO_RESPONSE;
+  case DHT11_ERROR_SETUP_FAILED:
+    return DHT11_RELIABLE_CLASS_SETUP;
+  case DHT11_ERROR_PARITY_CHECK_FAILED:
+    return DHT11_RELIABLE_CLASS_PARITY;
+  case DHT11_ERROR_OUT_OF_RANGE:
+    return DHT11_RELIABLE_CLASS_RANGE;
+  default:
+    return DHT11_RELIABLE_CLASS_OTHER;
+  }
+}
+
+// Described above
+static uint32_t bucket_percentile(const uint16_t *buckets, uint32_t max_us,
+                                  uint32_t pct) {
+  uint32_t total = 0;
+  uint32_t seen = 0;
+
+  for (uint8_t idx = 0; idx < DHT11_RELIABLE_BUCKETS; idx++) {
+    total += buckets[idx];
+  }
+
+  if (!total) {
+    return 0;
+  }
+
+  uint32_t target = DIV_ROUND_UP(total * pct, 100);
+
+  for (uint8_t idx = 0; idx < DHT11_RELIABLE_BUCKETS - 1; idx++) {
+    seen += buckets[idx];
+    if (seen >= target) {
+      return MIN((idx + 1U) * DHT11_RELIABLE_BUCKET_US, max_us);
+    }
+  }
+
+  return max_us;
+}
+
+// Described in .h
+void dht11_reliable_get_stats(dht11_reliable_stats_t *stats) {
+  uint16_t buckets[DHT11_RELIABLE_BUCKETS];
+
+  for (uint8_t cls = 0; cls < DHT11_RELIABLE_CLASS_MAX; cls++) {
+    const class_record_t *record = &class_records[cls];
+    dht11_reliable_class_stats_t *out = &stats->classes[cls];
+
+    // Percentiles from one copy so they are at least ordered
+    memcpy(buckets, record->buckets, sizeof(buckets));
+
+    out->count = atomic_get(&record->count);
+    out->max_us = atomic_get(&record->max_us);
+    out->p50_us = bucket_percentile(buckets, out->max_us, 50);
+    out->p90_us = bucket_percentile(buckets, out->max_us, 90);
+    out->p99_us = bucket_percentile(buckets, out->max_us, 99);
+  }
+
+  stats->requests = atomic_get(&stat_requests);
+  stats->published = atomic_get(&stat_published);
+  stats->retries = atomic_get(&stat_retries);
+  stats->skipped = atomic_get(&stat_skipped);
+  stats->bus_ms = atomic_get(&stat_bus_ms);
+
+  stats->samples_per_bus_s_mhz =
+      stats->bus_ms ? (uint64_t)stats->published * 1000000 / stats->bus_ms : 0;
+}
+
+// Described in .h
+dht11_error_t dht11_reliable_get_histogram(dht11_reliable_class_t cls,
+                                           uint16_t *buckets) {
+  if (cls >= DHT11_RELIABLE_CLASS_MAX) {
+    return DHT11_ERROR_CONFIG_FAILURE;
+  }
+
+  memcpy(buckets, class_records[cls].buckets,
+         sizeof(class_records[cls].buckets));
+
+  return DHT11_ERROR_NONE;
+}
@@ -0,0 +1,215 @@
+/**
+ * @file dht11_sched.c
+ * @brief Acquisition scheduler for multiple DHT11 instances
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <zephyr/kernel.h>
+
+#include <common.h>
+#include <dht11.h>
+#include <dht11_cache.h>
+#include <dht11_sched.h>
+
+LOG_MODULE_REGISTER(dht11_sched, 3);
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+
+/** State of the round in flight */
+typedef struct sched_round_s {
+  dht11_sched_cb_t cb;
+  void *user_data;
+  atomic_t remaining;
+  atomic_t samples_ok;
+  uint32_t start_cycles;
+} sched_round_t;
+
+/** Context for dht11_sched_acquire_all() */
+typedef struct sched_sync_s {
+  struct k_sem done;
+  atomic_t remaining;
+  dht11_reading_t *readings;
+  dht11_error_t *errs;
+} sched_sync_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Cache request completion for every sensor of a round
+ *
+ * @param user_data Instance index
+ */
+static void sched_read_done(dht11_error_t err, const dht11_reading_t *reading,
+                            void *user_data);
+
+/**
+ * @brief Account for a finished round and allow the next one
+ */
+static void sched_finish_round(void);
+
+/**
+ * @brief Per sensor callback used by dht11_sched_acquire_all()
+ */
+static void sched_sync_cb(uint8_t inst, dht11_error_t err,
+                          const dht11_reading_t *reading, void *user_data);
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+/** Round in flight, valid while round_active is set */
+static sched_round_t sched_round;
+
+/** Cache request of every instance, owned by the cache during a round */
+static dht11_cache_request_t sched_requests[DHT11_NUM_INSTANCES];
+
+/** Non-zero while a round is in flight */
+static atomic_t round_active = ATOMIC_INIT(0);
+
+/** Protects stats and the totals */
+static struct k_spinlock stats_lock;
+
+static dht11_sched_stats_t stats;
+
+/** Sum of round durations used for the aggregate sample rate */
+static uint64_t total_round_us;
+
+/*******************************************************************************
+ * Function Definitions
+ ******************************************************************************/
+
+// Described in .h
+dht11_error_t dht11_sched_acquire(uint32_t max_age_ms, dht11_sched_cb_t cb,
+                                  void *user_data) {
+  uint8_t count = dht11_instance_count();
+
+  if (!cb || !count) {
+    return DHT11_ERROR_CONFIG_FAILURE;
+  }
+
+  if (!atomic_cas(&round_active, 0, 1)) {
+    return DHT11_ERROR_BUSY;
+  }
+
+  sched_round.cb = cb;
+  sched_round.user_data = user_data;
+  atomic_set(&sched_round.remaining, count);
+  atomic_set(&sched_round.samples_ok, 0);
+  sched_round.start_cycles = k_cycle_get_32();
+
+  // Each line is held for exactly the start signal of its model and released
+  // at least DHT11_SCHED_STAGGER_MS after the previous one
+  uint32_t release_ms = 0;
+
+  for (uint8_t inst = 0; inst < count; inst++) {
+    dht11_cache_request_t *req = &sched_requests[inst];
+    uint32_t start_ms = dht11_model_get(inst)->start_ms;
+
+    release_ms = inst ? MAX(release_ms + DHT11_SCHED_STAGGER_MS, start_ms)
+                      : start_ms;
+
+    req->cb = sched_read_done;
+    req->user_data = (void *)(uintptr_t)inst;
+    req->delay_ms = release_ms - start_ms;
+
+    dht11_error_t err = dht11_cache_get_async(inst, max_age_ms, req);
+    if (err) {
+      dht11_reading_t empty = {0};
+      sched_read_done(err, &empty, req->user_data);
+    }
+  }
+
+  return DHT11_ERROR_NONE;
+}
+
+// Described above
+static void sched_read_done(dht11_error_t err, const dht11_reading_t *reading,
+                            void *user_data) {
+  uint8_t inst = (uint8_t)(uintptr_t)user_data;
+
+  if (!err) {
+    atomic_inc(&sched_round.samples_ok);
+  }
+
+  sched_round.cb(inst, err, reading, sched_round.user_data);
+
+  if (atomic_dec(&sched_round.remaining) == 1) {
+    sched_finish_round();
+  }
+}
+
+// Described above
+static void sched_finish_round(void) {
+  uint32_t round_us =
+      k_cyc_to_us_ceil32(k_cycle_get_32() - sched_round.start_cycles);
+  uint32_t samples_ok = atomic_get(&sched_round.samples_ok);
+  k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+  stats.rounds++;
+  stats.samples_ok += samples_ok;
+  stats.samples_failed += dht11_instance_count() - samples_ok;
+  stats.last_round_us = round_us;
+  total_round_us += round_us;
+  stats.sample_rate_mhz =
+      total_round_us ? (uint32_t)(((uint64_t)stats.samples_ok * 1000000000ULL) /
+                                  total_round_us)
+                     : 0;
+
+  k_spin_unlock(&stats_lock, key);
+
+  COMMON_LOG_DBG("Round of %d sensors took %d us", dht11_instance_count(),
+                 round_us);
+
+  atomic_clear(&round_active);
+}
+
+// Described above
+static void sched_sync_cb(uint8_t inst, dht11_error_t err,
+                          const dht11_reading_t *reading, void *user_data) {
+  sched_sync_t *ctx = user_data;
+
+  ctx->readings[inst] = *reading;
+  ctx->errs[inst] = err;
+
+  if (atomic_dec(&ctx->remaining) == 1) {
+    k_sem_give(&ctx->done);
+  }
+}
+
+// Described in .h
+dht11_error_t dht11_sched_acquire_all(uint32_t max_age_ms,
+                                      dht11_reading_t *readings,
+                                      dht11_error_t *errs) {
+  sched_sync_t ctx = {.readings = readings, .errs = errs};
+
+  __ASSERT(k_current_get() != &k_sys_work_q.thread,
+           "Blocking DHT11 round on the system work queue");
+
+  k_sem_init(&ctx.done, 0, 1);
+  atomic_set(&ctx.remaining, dht11_instance_count());
+
+  dht11_error_t err = dht11_sched_acquire(max_age_ms, sched_sync_cb, &ctx);
+  if (err) {
+    return err;
+  }
+
+  // Every request completes, through the reliable layer if not from the cache
+  k_sem_take(&ctx.done, K_FOREVER);
+
+  return DHT11_ERROR_NONE;
+}
+
+// Described in .h
+void dht11_sched_get_stats(dht11_sched_stats_t *out) {
+  k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+  *out = stats;
+
+  k_spin_unlock(&stats_lock, key);
+}
@@ -0,0 +1,270 @@
+/**
+ * @file dht11_sensor.c
+ * @brief Zephyr sensor API for the DHT11
+ *
+ * Exposes the DHT11 as a sensor device providing SENSOR_CHAN_AMBIENT_TEMP and
+ * SENSOR_CHAN_HUMIDITY through sample_fetch/channel_get and, when
+ * CONFIG_SENSOR_ASYNC_API is enabled, through RTIO reads.  Both go through
+ * dht11_cache.h, so no read reaches the sensor sooner than the minimum
+ * interval of its model and a read joins the one in flight, whoever started
+ * it.  RTIO reads submitted while the device waits on the cache are completed
+ * with the same reading.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#define DT_DRV_COMPAT custom_gpio_data
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/sensor.h>
+#include <zephyr/kernel.h>
+#include <zephyr/rtio/rtio.h>
+#include <zephyr/sys/mpsc_lockfree.h>
+
+#include <common.h>
+#include <dht11.h>
+#include <dht11_cache.h>
+
+#include "dht11_sensor.h"
+
+LOG_MODULE_REGISTER(dht11_sensor, 3);
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/** Scale applied to the tenths of a sample to form sensor_value.val2 */
+#define DHT11_FRACTION_SCALE 100000
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+
+/**
+ * @brief Configuration of a DHT11 sensor device
+ */
+struct dht11_sensor_config {
+  uint8_t inst; ///< Index of the instance in the DHT11 core
+};
+
+/**
+ * @brief Run time data of the DHT11 sensor device
+ */
+struct dht11_sensor_data {
+  dht11_sample_t sample;         ///< Last sample retrieved by sample_fetch
+  struct mpsc pending;           ///< RTIO reads waiting on the cache request
+  atomic_t reading;              ///< Non-zero while a cache request is queued
+  dht11_cache_request_t request; ///< Cache request of the RTIO reads
+};
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Map a DHT11 error to a negative errno value
+ *
+ * @param err DHT11 error code
+ * @return 0 or negative errno
+ */
+static int dht11_error_to_errno(dht11_error_t err);
+
+/**
+ * @brief Convert a value of a sample to a sensor_value
+ *
+ * @param x10 Value in 0.1 units
+ * @param val Output value, both parts carry the sign
+ */
+static void dht11_to_sensor_value(int16_t x10, struct sensor_value *val);
+
+/*******************************************************************************
+ * Function Definitions
+ ******************************************************************************/
+
+// Described above
+static int dht11_error_to_errno(dht11_error_t err) {
+  switch (err) {
+  case DHT11_ERROR_NONE:
+    return 0;
+  case DHT11_ERROR_BUSY:
+    return -EBUSY;
+  case DHT11_ERROR_HARDWARE_UNAVAILABLE:
+    return -ENODEV;
+  default:
+    return -EIO;
+  }
+}
+
+// Described above
+static void dht11_to_sensor_value(int16_t x10, struct sensor_value *val) {
+  val->val1 = x10 / 10;
+  val->val2 = (x10 % 10) * DHT11_FRACTION_SCALE;
+}
+
+static int dht11_sample_fetch(const struct device *dev,
+                              enum sensor_channel chan) {
+  const struct dht11_sensor_config *cfg = dev->config;
+  struct dht11_sensor_data *data = dev->data;
+
+  if (chan != SENSOR_CHAN_ALL && chan != SENSOR_CHAN_AMBIENT_TEMP &&
+      chan != SENSOR_CHAN_HUMIDITY) {
+    return -ENOTSUP;
+  }
+
+  // Go through the cache so the shell and other fetchers cannot read the
+  // sensor faster than it allows
+  dht11_reading_t reading;
+  dht11_error_t err = dht11_cache_get(
+      cfg->inst, dht11_model_get(cfg->inst)->min_interval_ms, &reading);
+  if (err) {
+    COMMON_LOG_DBG("Fetch failed. Err=%d", err);
+  } else {
+    data->sample = reading.sample;
+  }
+
+  return dht11_error_to_errno(err);
+}
+
+static int dht11_channel_get(const struct device *dev, enum sensor_channel chan,
+                             struct sensor_value *val) {
+  const struct dht11_sensor_data *data = dev->data;
+
+  switch (chan) {
+  case SENSOR_CHAN_AMBIENT_TEMP:
+    dht11_to_sensor_value(data->sample.t_x10, val);
+    return 0;
+  case SENSOR_CHAN_HUMIDITY:
+    dht11_to_sensor_value(data->sample.rh_x10, val);
+    return 0;
+  default:
+    return -ENOTSUP;
+  }
+}
+
+#ifdef CONFIG_SENSOR_ASYNC_API
+
+/**
+ * @brief Complete every pending RTIO read with the result of a conversion
+ *
+ * @param dev DHT11 sensor device
+ * @param err Result of the request
+ * @param reading Reading, only used when err is DHT11_ERROR_NONE
+ */
+static void dht11_complete_pending(const struct device *dev, dht11_error_t err,
+                                   const dht11_reading_t *reading) {
+  struct dht11_sensor_data *data = dev->data;
+  struct mpsc_node *node;
+
+  while ((node = mpsc_pop(&data->pending)) != NULL) {
+    struct rtio_iodev_sqe *iodev_sqe =
+        CONTAINER_OF(node, struct rtio_iodev_sqe, q);
+    uint32_t min_buf_len = sizeof(struct dht11_encoded_data);
+    uint32_t buf_len;
+    uint8_t *buf;
+
+    if (err) {
+      rtio_iodev_sqe_err(iodev_sqe, dht11_error_to_errno(err));
+      continue;
+    }
+
+    int rc = rtio_sqe_rx_buf(iodev_sqe, min_buf_len, min_buf_len, &buf,
+                             &buf_len);
+    if (rc) {
+      rtio_iodev_sqe_err(iodev_sqe, rc);
+      continue;
+    }
+
+    struct dht11_encoded_data *edata = (struct dht11_encoded_data *)buf;
+    edata->timestamp_ns = (uint64_t)reading->timestamp_ms * NSEC_PER_MSEC;
+    edata->sample = reading->sample;
+
+    rtio_iodev_sqe_ok(iodev_sqe, 0);
+  }
+}
+
+/**
+ * @brief dht11_cache_get_async() completion for RTIO reads
+ */
+static void dht11_read_done(dht11_error_t err, const dht11_reading_t *reading,
+                            void *user_data) {
+  const struct device *dev = user_data;
+  struct dht11_sensor_data *data = dev->data;
+
+  // Clear before draining so a read pushed after the drain starts a new
+  // request instead of being stranded
+  atomic_clear(&data->reading);
+
+  dht11_complete_pending(dev, err, reading);
+}
+
+static void dht11_submit(const struct device *dev,
+                         struct rtio_iodev_sqe *iodev_sqe) {
+  const struct sensor_read_config *read_cfg = iodev_sqe->sqe.iodev->data;
+  const struct dht11_sensor_config *cfg = dev->config;
+  struct dht11_sensor_data *data = dev->data;
+
+  if (read_cfg->is_streaming) {
+    rtio_iodev_sqe_err(iodev_sqe, -ENOTSUP);
+    return;
+  }
+
+  mpsc_push(&data->pending, &iodev_sqe->q);
+
+  // Join the request pending if there is one
+  if (!atomic_cas(&data->reading, 0, 1)) {
+    return;
+  }
+
+  data->request.cb = dht11_read_done;
+  data->request.user_data = (void *)dev;
+
+  // A reading as old as the minimum interval would be the next one anyway
+  uint32_t max_age_ms = dht11_model_get(cfg->inst)->min_interval_ms;
+  dht11_error_t err =
+      dht11_cache_get_async(cfg->inst, max_age_ms, &data->request);
+  if (err) {
+    atomic_clear(&data->reading);
+    dht11_complete_pending(dev, err, NULL);
+  }
+}
+
+#endif /* CONFIG_SENSOR_ASYNC_API */
+
+static int dht11_sensor_init(const struct device *dev) {
+  struct dht11_sensor_data *data = dev->data;
+
+  mpsc_init(&data->pending);
+
+  if (dht11_init(true)) {
+    COMMON_LOG_ERR("DHT11 initialization failed.");
+    return -ENODEV;
+  }
+
+  return 0;
+}
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+static const struct sensor_driver_api dht11_sensor_api = {
+    .sample_fetch = dht11_sample_fetch,
+    .channel_get = dht11_channel_get,
+#ifdef CONFIG_SENSOR_ASYNC_API
+    .submit = dht11_submit,
+    .get_decoder = dht11_get_decoder,
+#endif
+};
+
+#define DHT11_SENSOR_DEFINE(n)                                                 \
+  static struct dht11_sensor_data dht11_sensor_data_##n;                       \
+  static const struct dht11_sensor_config dht11_sensor_config_##n = {          \
+      .inst = n,                                                               \
+  };                                                                           \
+  SENSOR_DEVICE_DT_INST_DEFINE(n, dht11_sensor_init, NULL,                     \
+                               &dht11_sensor_data_##n,                         \
+                               &dht11_sensor_config_##n, POST_KERNEL,          \
+                               CONFIG_SENSOR_INIT_PRIORITY, &dht11_sensor_api);
+
+DT_INST_FOREACH_STATUS_OKAY(DHT11_SENSOR_DEFINE)
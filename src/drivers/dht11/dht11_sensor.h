@@ -0,0 +1,47 @@
+/**
+ * @file dht11_sensor.h
+ * @brief Private definitions shared by the DHT11 sensor API implementation
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <zephyr/drivers/sensor.h>
+
+#include <dht11.h>
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/** Q31 shift used for decoded values.  Readings of every model are within
+ * +/-256. */
+#define DHT11_Q31_SHIFT 8
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+
+/**
+ * @brief Layout of an RTIO read buffer filled by the DHT11 driver
+ */
+struct dht11_encoded_data {
+  uint64_t timestamp_ns; ///< Time the conversion completed
+  dht11_sample_t sample; ///< Frame converted by the model of the sensor
+};
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Retrieve the decoder for DHT11 RTIO buffers
+ *
+ * @param dev DHT11 sensor device
+ * @param decoder Set to the DHT11 decoder API
+ * @return 0 always
+ */
+int dht11_get_decoder(const struct device *dev,
+                      const struct sensor_decoder_api **decoder);
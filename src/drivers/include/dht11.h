@@ -13,6 +13,12 @@
  * the pulse length for the high time will be between 26 and 70 us with the
  * longer pulse length representing a 1.
  *
+ * The frame layout, its decoding and the polling capture are in dht11_frame.h,
+ * which builds for the host as well.  The DHT22 and AM2302 speak the same
+ * protocol with a shorter start signal and 16 bit values.  A node selects its
+ * model by listing "custom,dht22" before "custom,gpio-data" in its
+ * compatible, see dht11_model.h.
+ *
  * @version 0.1
  *
  * @copyright Copyright (c) 2025
@@ -23,52 +29,55 @@
 
 #include <stdint.h>
 
+#include <zephyr/devicetree.h>
+
+#include <dht11_frame.h>
+#include <dht11_model.h>
+
 /*******************************************************************************
  * Definitions
  ******************************************************************************/
 
-/*******************************************************************************
- * Type Definitions
- ******************************************************************************/
+/** Number of DHT11 instances enabled in the device tree */
+#define DHT11_NUM_INSTANCES DT_NUM_INST_STATUS_OKAY(custom_gpio_data)
 
 /**
- * @brief Data will be returned from the sensor as 4 bytes.
- *
- * Data is returned from the DHT11 sensor as 4 bytes.  The bytes and
- * order are:
+ * @brief Model of instance n, chosen at build time from its compatible
  *
- * * High byte for relative humidity.  This will be the value to the left of the
- * decimal.
- * * Low byte for relative humidity.  This is the value to the right of the
- * decimal.
- * * High byte for temperature.  Defined as for the relative humidity.
- * * Low byte for temperature.  Defined as for the relative humidity.
+ * Expands to a pointer to a constant dht11_model_t.  Used where DT_DRV_COMPAT
+ * is custom_gpio_data.
  *
+ * @param n Instance number
  */
-typedef struct dht11_data_s {
-  uint8_t rh_high; ///< High byte returned for the RH
-  uint8_t rh_low;  ///< Low byte returned for the RH
-  uint8_t t_high;  ///< High byte returned for temperature
-  uint8_t t_low;   ///< Low byte returned for temperature
-  uint8_t parity;  ///< Parity byte
-} dht11_data_t;
-
-typedef enum dht11_error_e {
-  DHT11_ERROR_NONE = 0,
-  DHT11_ERROR_CONFIG_FAILURE,
-  DHT11_ERROR_SETUP_FAILED,
-  DHT11_ERROR_PARITY_CHECK_FAILED,
-  DHT11_ERROR_HARDWARE_UNAVAILABLE,
-  DHT11_ERROR_MAX
-} dht11_error_t;
+#define DHT11_INST_MODEL(n)                                                    \
+  COND_CODE_1(DT_INST_NODE_HAS_COMPAT(n, custom_dht22), (&dht11_model_dht22), \
+              (&dht11_model_dht11))
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
 
 /** Typedef for a function that encapsulates the non-ISR based hardware
  * data-capture logic.
  *
- * This function pointer is provided for mocking purposes.
+ * This function pointer is provided for mocking purposes.  It fills bit_array
+ * with DHT11_NUM_DATA_BITS entries of 0 or 1, first bit first.
  */
 typedef dht11_error_t (*dht11_retrieve_data_t)(uint8_t *const bit_array);
 
+/** Completion callback for dht11_read_async().
+ *
+ * Called from the system work queue once the conversion has finished.  The
+ * data pointer is only valid for the duration of the call and the callback
+ * may start the next conversion, but must not block.
+ *
+ * @param err Result of the conversion
+ * @param data Decoded frame
+ * @param user_data User data passed to dht11_read_async()
+ */
+typedef void (*dht11_read_cb_t)(dht11_error_t err, const dht11_data_t *data,
+                                void *user_data);
+
 /*******************************************************************************
  * Variables Declarations
  ******************************************************************************/
@@ -81,16 +90,53 @@ typedef dht11_error_t (*dht11_retrieve_data_t)(uint8_t *const bit_array);
  * @brief Initialize the DHT11 for operation
  *
  * @param is_int Boolean indicating this will use an interrupt to decode the
- * GPIO
+ * GPIO.  In interrupt mode the ISR timestamps each edge of the frame, the
+ * pulse widths are decoded on the system work queue and dht11_get_data()
+ * blocks on a semaphore rather than polling the line with interrupts locked.
  *
  * @return DHT11_ERROR_NONE on success
  * @return DHT11_ERROR_CONFIG_FAILURE when fail to get ready value
  */
 dht11_error_t dht11_init(bool is_int);
 
+/**
+ * @brief Number of DHT11 instances managed by the driver
+ *
+ * @return DHT11_NUM_INSTANCES
+ */
+uint8_t dht11_instance_count(void);
+
+/**
+ * @brief Model of an instance
+ *
+ * @param inst Instance index, 0 to DHT11_NUM_INSTANCES - 1
+ * @return Model of the instance, NULL if it does not exist
+ */
+const dht11_model_t *dht11_model_get(uint8_t inst);
+
+/**
+ * @brief Whether the interrupt driven capture used by dht11_read_async() is
+ * enabled
+ *
+ * @return True once dht11_init() has been called with is_int set
+ */
+bool dht11_async_available(void);
+
+/**
+ * @brief Retrieve the DHT11 serial data from a given instance
+ *
+ * @param inst Instance index, 0 to DHT11_NUM_INSTANCES - 1
+ * @param data Pointer to struct to store DHT11 data
+ *
+ * @return As dht11_get_data()
+ */
+dht11_error_t dht11_get_data_inst(uint8_t inst, dht11_data_t *data);
+
 /**
  * @brief Retrieve the DHT11 serial data
  *
+ * Reads the first instance unless hw_fp is provided.
+ *
  * @param hw_fp Function pointer to function to be used for retrieving data from
  * the DHT-11.  Set to NULL for the standard case.
  * @param data Pointer to struct to store DHT11 data
@@ -100,5 +146,27 @@ dht11_error_t dht11_init(bool is_int);
  * @return DHT11_ERROR_SETUP_FAILED Peripheral did not respond as expected
  * @return DHT11_ERROR_PARITY_CHECK_FAILED if parity byte indicates data
  * corruption.
+ * @return DHT11_ERROR_HARDWARE_UNAVAILABLE No edges were seen on the data line
+ * @return Error of hw_fp if it failed, data is then left zeroed
  */
 dht11_error_t dht11_get_data(dht11_retrieve_data_t hw_fp, dht11_data_t *data);
+
+/**
+ * @brief Start an interrupt driven conversion without blocking
+ *
+ * Requires dht11_init(true).  The start signal is released from the system
+ * work queue and the frame is captured by the ISR, so the caller returns
+ * immediately and is notified through cb.  Each instance can have one
+ * conversion in flight.
+ *
+ * @param inst Instance index, 0 to DHT11_NUM_INSTANCES - 1
+ * @param cb Completion callback
+ * @param user_data Passed to cb
+ *
+ * @return DHT11_ERROR_NONE if the conversion was started
+ * @return DHT11_ERROR_CONFIG_FAILURE if not in interrupt mode, the instance
+ * does not exist or the GPIO could not be configured
+ * @return DHT11_ERROR_BUSY if a conversion is already in flight
+ */
+dht11_error_t dht11_read_async(uint8_t inst, dht11_read_cb_t cb,
+                               void *user_data);
@@ -0,0 +1,133 @@
+/**
+ * @file dht11_cache.h
+ * @brief Reading cache in front of the DHT11 driver
+ *
+ * A sensor cannot be read more often than the minimum read interval of its
+ * model and a DHT11 read occupies the bus for more than 20 ms.  The cache
+ * keeps the last good reading of each instance, raw and converted, with its
+ * timestamp.  Callers state the oldest reading they accept and only go to the
+ * bus when the cached one is too old.  Requests arriving while a read is in
+ * flight wait for that read instead of starting another one, and reads are
+ * delayed until the minimum interval has elapsed rather than failing.  The
+ * physical reads run on a work queue, so requests can also be made without
+ * blocking.  They go through dht11_reliable.h, so a read is retried before it
+ * fails and only validated samples are cached.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <zephyr/sys/slist.h>
+
+#include <stdint.h>
+
+#include <dht11.h>
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+
+/** A validated reading and the time it was taken */
+typedef struct dht11_reading_s {
+  dht11_data_t data;     ///< Decoded frame as sent by the sensor
+  dht11_sample_t sample; ///< Frame converted by the model of the instance
+  int64_t timestamp_ms;  ///< Uptime in ms when the conversion completed
+} dht11_reading_t;
+
+/** Cache statistics, summed over all instances */
+typedef struct dht11_cache_stats_s {
+  uint32_t hits;      ///< Requests answered from the cache
+  uint32_t coalesced; ///< Requests that waited on a read already in flight
+  uint32_t reads;     ///< Physical reads performed
+  uint32_t failures;  ///< Physical reads that failed
+} dht11_cache_stats_t;
+
+/** Completion callback for dht11_cache_get_async().
+ *
+ * Called from the calling context on a cache hit, otherwise from the work
+ * queue of the reads, see dht11_reliable.h.  The reading is only valid for
+ * the duration of the call and only when err is DHT11_ERROR_NONE.  The
+ * callback may resubmit its request.
+ *
+ * @param err Result of the request
+ * @param reading Reading that satisfied the request
+ * @param user_data User data passed with the request
+ */
+typedef void (*dht11_cache_cb_t)(dht11_error_t err,
+                                 const dht11_reading_t *reading,
+                                 void *user_data);
+
+/** Non blocking request, owned by the caller until its callback runs */
+typedef struct dht11_cache_request_s {
+  sys_snode_t node;    ///< Internal, links the request to its instance
+  dht11_cache_cb_t cb; ///< Completion callback
+  void *user_data;     ///< Passed to cb
+  /** Least time in ms before the read, if the request starts one.  Lets a
+   * caller stagger the reads of several instances, see dht11_sched.h. */
+  uint32_t delay_ms;
+} dht11_cache_request_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Retrieve a reading no older than max_age_ms
+ *
+ * Blocks while a physical read is needed, including any wait for the minimum
+ * read interval.  Must not be called from the system work queue, which
+ * performs the read, use dht11_cache_get_async() there instead.
+ *
+ * @param inst Instance index, 0 to DHT11_NUM_INSTANCES - 1
+ * @param max_age_ms Oldest acceptable reading in ms
+ * @param reading Pointer to struct to store the reading
+ *
+ * @return DHT11_ERROR_NONE on success
+ * @return DHT11_ERROR_CONFIG_FAILURE if the instance does not exist
+ * @return Error of the physical read otherwise.  Requests coalesced onto a
+ * failed read receive its error.
+ */
+dht11_error_t dht11_cache_get(uint8_t inst, uint32_t max_age_ms,
+                              dht11_reading_t *reading);
+
+/**
+ * @brief Request a reading no older than max_age_ms without blocking
+ *
+ * The callback runs immediately on a cache hit.  Otherwise the request joins
+ * the read in flight or starts a new one, no sooner than its delay_ms, and the
+ * callback runs when it completes.
+ *
+ * @param inst Instance index, 0 to DHT11_NUM_INSTANCES - 1
+ * @param max_age_ms Oldest acceptable reading in ms
+ * @param req Request with its callback set, must stay valid until the
+ * callback runs
+ *
+ * @return DHT11_ERROR_NONE if the request was accepted
+ * @return DHT11_ERROR_CONFIG_FAILURE if the instance does not exist or the
+ * request has no callback
+ */
+dht11_error_t dht11_cache_get_async(uint8_t inst, uint32_t max_age_ms,
+                                    dht11_cache_request_t *req);
+
+/**
+ * @brief Retrieve the last good reading regardless of its age
+ *
+ * Never touches the bus.
+ *
+ * @param inst Instance index, 0 to DHT11_NUM_INSTANCES - 1
+ * @param reading Pointer to struct to store the reading
+ *
+ * @return DHT11_ERROR_NONE on success
+ * @return DHT11_ERROR_HARDWARE_UNAVAILABLE if no good reading exists yet
+ * @return DHT11_ERROR_CONFIG_FAILURE if the instance does not exist
+ */
+dht11_error_t dht11_cache_peek(uint8_t inst, dht11_reading_t *reading);
+
+/**
+ * @brief Retrieve the cache statistics
+ *
+ * @param stats Pointer to struct to store the statistics
+ */
+void dht11_cache_get_stats(dht11_cache_stats_t *stats);
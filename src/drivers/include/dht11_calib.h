@@ -0,0 +1,206 @@
+/**
+ * @file dht11_calib.h
+ * @brief Adaptive 0/1 bit threshold for the interrupt driven DHT11 capture
+ *
+ * The DHT11 encodes a 0 as a ~27 us high pulse and a 1 as a ~70 us high pulse,
+ * but sensors, wiring and the MCU clock all shift the widths the ISR measures.
+ * The calibration collects a histogram of the measured data pulse widths over
+ * DHT11_CALIB_FRAMES frames and places the decision boundary between the two
+ * clusters found in it.  Once calibrated, every frame that passes its parity
+ * check moves the cluster means towards the widths it contained, so the
+ * threshold follows slow drift such as temperature.  Until an instance has
+ * been calibrated the fixed defaults are used.
+ *
+ * With CONFIG_APP_DHT11_CALIB_PERSIST the parameters of each instance are
+ * stored with the settings subsystem under "dht11/calib/<inst>" and restored by
+ * dht11_calib_init().
+ *
+ * The polling capture path measures the low and high time together and keeps
+ * its fixed threshold.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <dht11.h>
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/** Threshold in us used until an instance has been calibrated */
+#define DHT11_CALIB_DEFAULT_THRESHOLD_US DHT11_FRAME_THRESHOLD_US
+
+/** Shortest setup pulse in us accepted until an instance has been calibrated.
+ *
+ * The setup pulse is nominally 80 us, the ISR may measure it slightly short.
+ */
+#define DHT11_CALIB_DEFAULT_SETUP_MIN_US 70
+
+/** Nominal width in us of a 1 bit, the setup minimum scales with its ratio to
+ * the measured one */
+#define DHT11_CALIB_NOMINAL_ONE_US 70
+
+/** Width in us of a histogram bin */
+#define DHT11_CALIB_BIN_US 2
+
+/** Number of histogram bins, covering every width the capture can store */
+#define DHT11_CALIB_BINS ((UINT8_MAX + 1) / DHT11_CALIB_BIN_US)
+
+/** Complete frames collected before the threshold is derived */
+#define DHT11_CALIB_FRAMES 16
+
+/** Drift tracking weight, each valid frame moves the cluster means by
+ * 1 / 2^DHT11_CALIB_DRIFT_SHIFT of the difference */
+#define DHT11_CALIB_DRIFT_SHIFT 4
+
+/** Change of the threshold in us since it was last stored that causes it to be
+ * stored again.  Limits flash writes while tracking drift. */
+#define DHT11_CALIB_PERSIST_DELTA_US 2
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+
+/** Calibration state of an instance */
+typedef enum dht11_calib_state_e {
+  DHT11_CALIB_STATE_DEFAULT = 0, ///< Using the fixed defaults
+  DHT11_CALIB_STATE_RUNNING,     ///< Collecting the histogram
+  DHT11_CALIB_STATE_DONE,        ///< Using a derived threshold
+} dht11_calib_state_t;
+
+/** Decode parameters of an instance, also the persisted record */
+typedef struct dht11_calib_params_s {
+  uint8_t threshold_us; ///< High pulses longer than this are a 1
+  uint8_t zero_us;      ///< Mean width of a 0 bit, 0 if not calibrated
+  uint8_t one_us;       ///< Mean width of a 1 bit, 0 if not calibrated
+  uint8_t setup_min_us; ///< Shortest accepted setup pulse
+} dht11_calib_params_t;
+
+/** Decode results counted while one set of parameters was in use */
+typedef struct dht11_calib_counts_s {
+  uint32_t frames;          ///< Complete frames decoded
+  uint32_t parity_failures; ///< Frames rejected by the parity check
+} dht11_calib_counts_t;
+
+/** Calibration statistics of an instance */
+typedef struct dht11_calib_stats_s {
+  dht11_calib_state_t state;   ///< Current state
+  dht11_calib_params_t params; ///< Parameters in use
+  dht11_calib_counts_t before; ///< Frames decoded with the defaults
+  dht11_calib_counts_t after;  ///< Frames decoded once calibrated
+  uint32_t samples;            ///< Pulse widths in the histogram
+} dht11_calib_stats_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Initialize the calibration and restore persisted parameters
+ *
+ * Called by dht11_init(), calling it again has no effect.
+ *
+ * @return 0 on success
+ * @return Negative errno if the settings could not be loaded, the instances
+ * then use the defaults
+ */
+int dht11_calib_init(void);
+
+/**
+ * @brief Start a calibration of an instance
+ *
+ * Clears the histogram and derives new parameters from the next
+ * DHT11_CALIB_FRAMES complete frames.  The current parameters stay in use
+ * until then.
+ *
+ * @param inst Instance index, 0 to DHT11_NUM_INSTANCES - 1
+ *
+ * @return DHT11_ERROR_NONE on success
+ * @return DHT11_ERROR_CONFIG_FAILURE if the instance does not exist
+ */
+dht11_error_t dht11_calib_start(uint8_t inst);
+
+/**
+ * @brief Return an instance to the default parameters
+ *
+ * Also removes its persisted parameters and clears its statistics.
+ *
+ * @param inst Instance index, 0 to DHT11_NUM_INSTANCES - 1
+ *
+ * @return DHT11_ERROR_NONE on success
+ * @return DHT11_ERROR_CONFIG_FAILURE if the instance does not exist
+ */
+dht11_error_t dht11_calib_reset(uint8_t inst);
+
+/**
+ * @brief Retrieve the decode parameters of an instance
+ *
+ * @param inst Instance index, 0 to DHT11_NUM_INSTANCES - 1
+ * @param params Pointer to struct to store the parameters
+ */
+void dht11_calib_get_params(uint8_t inst, dht11_calib_params_t *params);
+
+/**
+ * @brief Feed a captured frame to the calibration
+ *
+ * Called by the driver with the pulse widths of every complete frame and the
+ * result of decoding them.
+ *
+ * @param inst Instance index, 0 to DHT11_NUM_INSTANCES - 1
+ * @param widths DHT11_NUM_DATA_BITS data pulse widths in us, setup pulse
+ * excluded
+ * @param err Result of the decode
+ */
+void dht11_calib_update(uint8_t inst, const uint8_t *widths,
+                        dht11_error_t err);
+
+/**
+ * @brief Retrieve the calibration statistics of an instance
+ *
+ * The parity failure rate before and after calibration is
+ * parity_failures / frames of before and after.  Lock free, a frame decoded
+ * meanwhile may be counted in some fields and not yet in others.
+ *
+ * @param inst Instance index, 0 to DHT11_NUM_INSTANCES - 1
+ * @param stats Pointer to struct to store the statistics
+ *
+ * @return DHT11_ERROR_NONE on success
+ * @return DHT11_ERROR_CONFIG_FAILURE if the instance does not exist
+ */
+dht11_error_t dht11_calib_get_stats(uint8_t inst, dht11_calib_stats_t *stats);
+
+/**
+ * @brief Retrieve the pulse width histogram of an instance
+ *
+ * Bin n counts the widths from n * DHT11_CALIB_BIN_US up to the next bin.
+ * The counts are halved whenever one of them would overflow, so only their
+ * ratios are meaningful.  Lock free.
+ *
+ * @param inst Instance index, 0 to DHT11_NUM_INSTANCES - 1
+ * @param bins Array of DHT11_CALIB_BINS entries to store the histogram
+ *
+ * @return DHT11_ERROR_NONE on success
+ * @return DHT11_ERROR_CONFIG_FAILURE if the instance does not exist
+ */
+dht11_error_t dht11_calib_get_histogram(uint8_t inst, uint16_t *bins);
+
+/**
+ * @brief Derive the decode parameters from a pulse width histogram
+ *
+ * Splits the histogram in two clusters by iterating the threshold to the
+ * midpoint of the cluster means, starting from the mean width.  The last bin
+ * holds the widths clamped by the capture and is ignored.
+ *
+ * @param bins Array of DHT11_CALIB_BINS counts
+ * @param params Pointer to struct to store the parameters
+ *
+ * @return True on success
+ * @return False if the histogram does not contain two clusters
+ */
+bool dht11_calib_derive(const uint16_t *bins, dht11_calib_params_t *params);
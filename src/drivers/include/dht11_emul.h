@@ -0,0 +1,125 @@
+/**
+ * @file dht11_emul.h
+ * @brief Emulated DHT11 on the native_sim GPIO emulator
+ *
+ * Every custom,gpio-data node whose line is on a zephyr,gpio-emul controller
+ * gets an emulated sensor.  Like the real one it listens to the line, and when
+ * the MCU has held it low for the start signal of its model, but no longer
+ * than its start_max_ms, and released it, it drives the response through
+ * gpio_emul_input_set(): the line stays high for response_us, then the 80 us
+ * low and 80 us high preamble, 40 data bits of a 50 us low and a short or long
+ * high, and a final 50 us low before the line is released to the pull-up.
+ * The frame is sent as set, whatever the model.  Edge interrupts fire from the
+ * emulator timer at the exact simulated times, so the interrupt capture path
+ * runs unchanged.  The timer runs on kernel ticks, with
+ * CONFIG_SYS_CLOCK_TICKS_PER_SEC=1000000 the edges land on the us.  The
+ * emulator stands in for the pull-up by configuring the pin as an input driven
+ * high at boot.
+ *
+ * The polling capture path spins on the line with interrupts locked, and time
+ * does not pass in a busy loop on native_sim.  With CONFIG_APP_DHT11_EMUL the
+ * line read of hal_zephyr.c calls dht11_emul_poll() first, which waits
+ * CONFIG_APP_DHT11_EMUL_POLL_US and brings the emulated lines up to date.
+ *
+ * Pulse widths, jitter, a dropped edge, a bad parity byte and no response at
+ * all are set per instance with dht11_emul_configure().
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <dht11.h>
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/** Interval in us at which an idle emulator samples the line for the start
+ * signal.  The start signal is measured at most this much short. */
+#define DHT11_EMUL_IDLE_US 500
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+
+/** Waveform of an emulated sensor, all times in us */
+typedef struct dht11_emul_config_s {
+  uint16_t response_us; ///< Line left high after the release, 20 to 40
+  uint16_t ack_low_us;  ///< Low half of the preamble
+  uint16_t ack_high_us; ///< High half of the preamble
+  uint16_t bit_low_us;  ///< Low before each data bit and after the last
+  uint16_t zero_us;     ///< High time of a 0 bit
+  uint16_t one_us;      ///< High time of a 1 bit
+  uint16_t jitter_us;   ///< Each level is moved by up to +/- this much
+  uint32_t seed;        ///< Seed of the jitter, the same seed repeats a run
+  uint8_t drop_bit;     ///< Data bit from 1 whose leading low is lost, 0 none
+  bool bad_parity;      ///< Send the complement of the parity byte
+  bool silent;          ///< Ignore the start signal
+} dht11_emul_config_t;
+
+/** Counters of an emulated sensor */
+typedef struct dht11_emul_stats_s {
+  uint32_t starts;       ///< Start signals answered
+  uint32_t short_starts; ///< Start signals too short to be answered
+  uint32_t long_starts;  ///< Start signals too long to be answered
+  uint32_t frames;       ///< Responses driven to the end
+} dht11_emul_stats_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Nominal waveform of the datasheet
+ *
+ * @param config Pointer to store the waveform
+ */
+void dht11_emul_default_config(dht11_emul_config_t *config);
+
+/**
+ * @brief Set the waveform of an instance
+ *
+ * Takes effect with the next start signal.
+ *
+ * @param inst Instance index, 0 to DHT11_NUM_INSTANCES - 1
+ * @param config Waveform
+ * @return 0 on success
+ * @return -EINVAL if the instance does not exist
+ */
+int dht11_emul_configure(uint8_t inst, const dht11_emul_config_t *config);
+
+/**
+ * @brief Set the reading sent by an instance
+ *
+ * The parity byte of data is ignored, the emulator sends the sum of the data
+ * bytes unless bad_parity is set.  Takes effect with the next start signal.
+ *
+ * @param inst Instance index, 0 to DHT11_NUM_INSTANCES - 1
+ * @param data Reading
+ * @return 0 on success
+ * @return -EINVAL if the instance does not exist
+ */
+int dht11_emul_set_data(uint8_t inst, const dht11_data_t *data);
+
+/**
+ * @brief Retrieve the counters of an instance
+ *
+ * @param inst Instance index, 0 to DHT11_NUM_INSTANCES - 1
+ * @param stats Pointer to store the counters
+ * @return 0 on success
+ * @return -EINVAL if the instance does not exist
+ */
+int dht11_emul_get_stats(uint8_t inst, dht11_emul_stats_t *stats);
+
+/**
+ * @brief Let time pass for a polling read of the line
+ *
+ * Waits CONFIG_APP_DHT11_EMUL_POLL_US and drives every emulated line to its
+ * level at the new time.  Called by the driver with interrupts locked.
+ */
+void dht11_emul_poll(void);
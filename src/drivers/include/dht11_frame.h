@@ -0,0 +1,146 @@
+/**
+ * @file dht11_frame.h
+ * @brief DHT11 frame layout, decoding and polling capture
+ *
+ * A frame is 40 bits sent MSB first: the integer and tenths bytes of the
+ * relative humidity, the integer and tenths bytes of the temperature and a
+ * parity byte holding the sum of the four.  Each bit is a 50 us low followed by
+ * a high whose width sets its value.
+ *
+ * Nothing in here depends on Zephyr.  The line and the cycle counter are read
+ * through hal.h, so the same code runs in the driver and in the host build.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <hal.h>
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/** Number of data bits in a frame, including the parity byte */
+#define DHT11_NUM_DATA_BITS 40
+
+/** Number of high pulses captured in interrupt mode.
+ *
+ * The first pulse is the 80 us setup high followed by one pulse per data bit.
+ */
+#define DHT11_NUM_PULSES (DHT11_NUM_DATA_BITS + 1)
+
+/** Threshold in microseconds for a high data bit of the polling path.
+ *
+ * This is set to 50 microseconds to avoid any issues, but
+ * a high bit should be >70 us while the low bit is < 29 us.  The interrupt
+ * path uses the per instance threshold from dht11_calib.h.
+ */
+#define DHT11_FRAME_THRESHOLD_US 50
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+
+/**
+ * @brief Data will be returned from the sensor as 4 bytes.
+ *
+ * Data is returned from the DHT11 sensor as 4 bytes.  The bytes and
+ * order are:
+ *
+ * * High byte for relative humidity.  This will be the value to the left of the
+ * decimal.
+ * * Low byte for relative humidity.  This is the value to the right of the
+ * decimal.
+ * * High byte for temperature.  Defined as for the relative humidity.
+ * * Low byte for temperature.  Defined as for the relative humidity.
+ *
+ */
+typedef struct dht11_data_s {
+  uint8_t rh_high; ///< High byte returned for the RH
+  uint8_t rh_low;  ///< Low byte returned for the RH
+  uint8_t t_high;  ///< High byte returned for temperature
+  uint8_t t_low;   ///< Low byte returned for temperature
+  uint8_t parity;  ///< Parity byte
+} dht11_data_t;
+
+typedef enum dht11_error_e {
+  DHT11_ERROR_NONE = 0,
+  DHT11_ERROR_CONFIG_FAILURE,
+  DHT11_ERROR_SETUP_FAILED,
+  DHT11_ERROR_PARITY_CHECK_FAILED,
+  DHT11_ERROR_HARDWARE_UNAVAILABLE,
+  DHT11_ERROR_BUSY,
+  DHT11_ERROR_OUT_OF_RANGE,
+  DHT11_ERROR_MAX
+} dht11_error_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Pack data bits retrieved from the DHT11.
+ *
+ * Data retrieved from the DHT11 contains 5 bytes of data.  Each byte represents
+ * one of the data points in the dht11_data_t struct.  This packs the bits into
+ * a byte in that struct.
+ *
+ * @param bit_array Pointer to array containing retrieved bits
+ * @param start_index Index of start of data to retrieve
+ * @return Packed byte containing the data of interest.
+ */
+uint8_t dht11_pack_bits(const uint8_t *bit_array, uint8_t start_index);
+
+/**
+ * @brief Check the parity byte of a decoded frame
+ *
+ * @param data Decoded frame
+ * @return DHT11_ERROR_NONE if the parity byte matches the data bytes
+ * @return DHT11_ERROR_PARITY_CHECK_FAILED otherwise
+ */
+dht11_error_t dht11_frame_check_parity(const dht11_data_t *data);
+
+/**
+ * @brief Decode a frame of individual bits into a frame
+ *
+ * @param bit_array Array of DHT11_NUM_DATA_BITS bits
+ * @param data Pointer to struct to store the decoded frame
+ * @return DHT11_ERROR_NONE on success
+ * @return DHT11_ERROR_PARITY_CHECK_FAILED if the parity byte does not match
+ */
+dht11_error_t dht11_frame_decode_bits(const uint8_t *bit_array,
+                                      dht11_data_t *data);
+
+/**
+ * @brief Decode the high pulse widths captured by the ISR into a frame
+ *
+ * @param widths Array of DHT11_NUM_PULSES high times in us
+ * @param threshold_us High pulses longer than this are a 1
+ * @param setup_min_us Shortest setup pulse accepted
+ * @param data Pointer to struct to store the decoded frame
+ * @return DHT11_ERROR_NONE on success
+ * @return DHT11_ERROR_SETUP_FAILED if the setup pulse was too short
+ * @return DHT11_ERROR_PARITY_CHECK_FAILED if the parity byte does not match
+ */
+dht11_error_t dht11_frame_decode_pulses(const uint8_t *widths,
+                                        uint8_t threshold_us,
+                                        uint8_t setup_min_us,
+                                        dht11_data_t *data);
+
+/**
+ * @brief Capture a frame by polling the released line
+ *
+ * Called with interrupts locked once the start signal has been released.
+ *
+ * @param line Data line, configured as an input
+ * @param bit_array Constant pointer to data to be retrieved from the DHT-11
+ * @return DHT11_ERROR_NONE Success
+ * @return DHT11_ERROR_HARDWARE_UNAVAILABLE The line was never pulled low
+ * @return DHT11_ERROR_SETUP_FAILED Preamble too short or an edge was missing
+ */
+dht11_error_t dht11_frame_poll(const hal_line_t *line,
+                               uint8_t *const bit_array);
@@ -0,0 +1,106 @@
+/**
+ * @file dht11_model.h
+ * @brief Sensors of the DHT11 family and the conversion of their frames
+ *
+ * The DHT11, DHT22 and AM2302 share the wire protocol and the frame of
+ * dht11_frame.h but not the meaning of its bytes nor the timing around it:
+ *
+ * * DHT11: integer and tenths bytes of each value.  Newer parts report
+ *   temperatures below 0 C by setting bit 7 of the tenths byte.  A start
+ *   signal of 18 ms and one conversion per second.
+ * * DHT22 and AM2302, the same part: each value is a 16 bit big endian number
+ *   of 0.1 units, the temperature in sign and magnitude.  A start signal of
+ *   1 ms and one conversion every 2 s.
+ *
+ * Each instance is bound to one model at build time from its devicetree
+ * compatible, see DHT11_INST_MODEL(), so the bit loop is shared and the
+ * conversion is picked without a branch on the model.  Every model converts to
+ * the same dht11_sample_t.
+ *
+ * Nothing in here depends on Zephyr, it builds for the host as well.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <dht11_frame.h>
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/** printf() format of a value in 0.1 units, with DHT11_X10_ARGS() */
+#define DHT11_X10_FMT "%s%d.%d"
+
+/** printf() arguments of a value in 0.1 units, evaluates val three times */
+#define DHT11_X10_ARGS(val)                                                    \
+  ((val) < 0 ? "-" : ""), abs(val) / 10, abs(val) % 10
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+
+/** A converted reading, the same for every model */
+typedef struct dht11_sample_s {
+  int16_t rh_x10; ///< Relative humidity in 0.1 %
+  int16_t t_x10;  ///< Temperature in 0.1 C
+} dht11_sample_t;
+
+/**
+ * @brief Conversion of the data bytes of a frame to a sample
+ *
+ * @param data Frame that passed the parity check
+ * @param sample Pointer to store the converted sample
+ * @return DHT11_ERROR_NONE on success
+ * @return DHT11_ERROR_OUT_OF_RANGE if a byte holds a value the model cannot
+ * send
+ */
+typedef dht11_error_t (*dht11_convert_t)(const dht11_data_t *data,
+                                         dht11_sample_t *sample);
+
+/** Timing, range and conversion of a model */
+typedef struct dht11_model_s {
+  const char *name;         ///< Name of the model
+  uint16_t start_ms;        ///< Start signal, the line is held low this long
+  uint16_t start_max_ms;    ///< Longest start signal the sensor answers
+  uint16_t min_interval_ms; ///< Shortest time between two conversions
+  int16_t rh_max_x10;       ///< Highest plausible relative humidity
+  int16_t t_min_x10;        ///< Lowest plausible temperature
+  int16_t t_max_x10;        ///< Highest plausible temperature
+  dht11_convert_t convert;  ///< Conversion of the data bytes
+} dht11_model_t;
+
+/*******************************************************************************
+ * Variables Declarations
+ ******************************************************************************/
+
+/** DHT11 */
+extern const dht11_model_t dht11_model_dht11;
+
+/** DHT22 and AM2302 */
+extern const dht11_model_t dht11_model_dht22;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Convert a frame that passed the parity check and check its range
+ *
+ * An all zero frame passes the parity check but is what a line held low
+ * decodes to, so it is rejected whatever the model.
+ *
+ * @param model Model of the sensor that sent the frame
+ * @param data Decoded frame
+ * @param sample Pointer to store the sample, only valid on success
+ * @return DHT11_ERROR_NONE if the values are plausible
+ * @return DHT11_ERROR_OUT_OF_RANGE otherwise
+ */
+dht11_error_t dht11_model_sample(const dht11_model_t *model,
+                                 const dht11_data_t *data,
+                                 dht11_sample_t *sample);
@@ -0,0 +1,166 @@
+/**
+ * @file dht11_reliable.h
+ * @brief Retrying, validating front end for DHT11 reads
+ *
+ * A request is served by up to DHT11_RELIABLE_MAX_ATTEMPTS conversions.  The
+ * sensor ignores a start signal sent less than the minimum read interval of
+ * its model after the previous one, so every attempt, first ones included, is
+ * delayed until the interval since the last attempt on the instance has
+ * elapsed rather than wasting bus time on a read that cannot succeed.  Frames
+ * that pass the parity check are also converted and checked against the range
+ * of the model, see dht11_model.h, and only then completed as valid.
+ *
+ * A sensor that does not respond at all is treated as absent.  After
+ * DHT11_RELIABLE_DOWN_THRESHOLD consecutive unanswered attempts, requests fail
+ * without touching the bus until a probe is due.  The probe interval starts at
+ * the minimum read interval and doubles with every unanswered probe up to
+ * DHT11_RELIABLE_BACKOFF_MAX_MS.
+ *
+ * The attempts run on the system work queue with the interrupt driven
+ * capture.  The polling capture blocks for the whole frame, so its attempts
+ * run on a work queue of their own, CONFIG_APP_DHT11_POLL_WORKQ, without which
+ * it is not supported.
+ *
+ * Every attempt is classified and its bus time, from the start signal to the
+ * result, is recorded per class so percentiles can be reported.  The
+ * statistics are only written from the work queue running the attempts and
+ * read without a lock, so reading them never delays the capture.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <dht11.h>
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/** Conversions attempted per request */
+#define DHT11_RELIABLE_MAX_ATTEMPTS 3
+
+/** Consecutive unanswered attempts after which a sensor is considered absent */
+#define DHT11_RELIABLE_DOWN_THRESHOLD 3
+
+/** Longest interval in ms between two probes of an absent sensor */
+#define DHT11_RELIABLE_BACKOFF_MAX_MS 32000
+
+/** Width in us of a bus time histogram bucket */
+#define DHT11_RELIABLE_BUCKET_US 500
+
+/** Bus time histogram buckets per class, the last one collects the rest */
+#define DHT11_RELIABLE_BUCKETS 64
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+
+/** Outcome of a single conversion */
+typedef enum dht11_reliable_class_e {
+  DHT11_RELIABLE_CLASS_OK = 0,      ///< Valid sample
+  DHT11_RELIABLE_CLASS_NO_RESPONSE, ///< No edge on the line
+  DHT11_RELIABLE_CLASS_SETUP,       ///< Bad setup pulse or incomplete frame
+  DHT11_RELIABLE_CLASS_PARITY,      ///< Parity byte does not match
+  DHT11_RELIABLE_CLASS_RANGE,       ///< Parity good, values implausible
+  DHT11_RELIABLE_CLASS_OTHER,       ///< Configuration failure or busy
+  DHT11_RELIABLE_CLASS_MAX
+} dht11_reliable_class_t;
+
+/** Statistics of one class */
+typedef struct dht11_reliable_class_stats_s {
+  uint32_t count;  ///< Attempts with this outcome
+  uint32_t p50_us; ///< Median bus time, upper edge of its bucket
+  uint32_t p90_us; ///< 90th percentile bus time
+  uint32_t p99_us; ///< 99th percentile bus time
+  uint32_t max_us; ///< Longest bus time
+} dht11_reliable_class_stats_t;
+
+/** Statistics summed over all instances */
+typedef struct dht11_reliable_stats_s {
+  dht11_reliable_class_stats_t classes[DHT11_RELIABLE_CLASS_MAX];
+  uint32_t requests;  ///< Requests completed
+  uint32_t published; ///< Requests completed with a valid sample
+  uint32_t retries;   ///< Attempts beyond the first of a request
+  uint32_t skipped;   ///< Requests failed without an attempt, sensor absent
+  uint32_t bus_ms;    ///< Bus time over all attempts
+  /** Valid samples per second of bus time in mHz */
+  uint32_t samples_per_bus_s_mhz;
+} dht11_reliable_stats_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Read an instance with retries without blocking
+ *
+ * Uses the interrupt driven capture when available, the polling one
+ * otherwise.  Each instance serves one request at a time.
+ *
+ * @param inst Instance index, 0 to DHT11_NUM_INSTANCES - 1
+ * @param cb Called once from the work queue running the attempts with the
+ * result of the last one.  The frame is only valid when err is
+ * DHT11_ERROR_NONE.
+ * @param user_data Passed to cb
+ *
+ * @return DHT11_ERROR_NONE if the request was accepted
+ * @return DHT11_ERROR_CONFIG_FAILURE if the instance does not exist, cb is
+ * NULL or the driver polls without CONFIG_APP_DHT11_POLL_WORKQ
+ * @return DHT11_ERROR_BUSY if a request is already in flight
+ */
+dht11_error_t dht11_reliable_read(uint8_t inst, dht11_read_cb_t cb,
+                                  void *user_data);
+
+/**
+ * @brief Check a frame that passed the parity check against the sensor range
+ *
+ * The frame is converted with the model of the instance, see
+ * dht11_model_sample().
+ *
+ * @param inst Instance that sent the frame
+ * @param data Decoded frame
+ *
+ * @return DHT11_ERROR_NONE if the values are plausible
+ * @return DHT11_ERROR_OUT_OF_RANGE otherwise
+ * @return DHT11_ERROR_CONFIG_FAILURE if the instance does not exist
+ */
+dht11_error_t dht11_reliable_validate(uint8_t inst, const dht11_data_t *data);
+
+/**
+ * @brief Map a DHT11 error to its class
+ *
+ * @param err Result of a conversion
+ * @return Class of err
+ */
+dht11_reliable_class_t dht11_reliable_classify(dht11_error_t err);
+
+/**
+ * @brief Retrieve the statistics
+ *
+ * Lock free.  An attempt completing meanwhile may be counted in some fields
+ * and not yet in others.
+ *
+ * @param stats Pointer to struct to store the statistics
+ */
+void dht11_reliable_get_stats(dht11_reliable_stats_t *stats);
+
+/**
+ * @brief Retrieve the bus time histogram of a class
+ *
+ * Bucket n counts the attempts that took from n * DHT11_RELIABLE_BUCKET_US up
+ * to the next bucket, the last bucket every longer one.  The counts are halved
+ * whenever one of them would overflow, so only their ratios are meaningful.
+ * Lock free.
+ *
+ * @param cls Class of the histogram
+ * @param buckets Array of DHT11_RELIABLE_BUCKETS entries to store it
+ *
+ * @return DHT11_ERROR_NONE on success
+ * @return DHT11_ERROR_CONFIG_FAILURE if the class does not exist
+ */
+dht11_error_t dht11_reliable_get_histogram(dht11_reliable_class_t cls,
+                                           uint16_t *buckets);
@@ -0,0 +1,106 @@
+/**
+ * @file dht11_sched.h
+ * @brief Acquisition scheduler for multiple DHT11 instances
+ *
+ * Reads every DHT11 instance in one round.  Each sensor is released
+ * DHT11_SCHED_STAGGER_MS after the previous one so their frames do not
+ * overlap on the CPU, and its start signal begins so that the line is held
+ * low for exactly the start signal of its model, which a sensor stops
+ * answering past dht11_model_t start_max_ms.  The start signals overlap, so a
+ * round of N DHT11 takes roughly 18 ms + N * DHT11_SCHED_STAGGER_MS rather
+ * than N times a single read.
+ *
+ * The reads go through the reading cache, see dht11_cache.h, so an instance
+ * is never read sooner than the minimum read interval of its model, and each
+ * read is retried and validated by dht11_reliable.h.  An instance read outside
+ * the round, or retried, is released later than its slot.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <dht11.h>
+#include <dht11_cache.h>
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/** Offset in ms between the release of consecutive sensors in a round.
+ *
+ * A DHT11 frame lasts at most ~5 ms after the line is released.
+ */
+#define DHT11_SCHED_STAGGER_MS 6
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+
+/** Per sensor completion callback for a scheduled round.
+ *
+ * Called from the system work queue, or from dht11_sched_acquire() when the
+ * cache holds a reading young enough.
+ *
+ * @param inst Instance index
+ * @param err Result of the request
+ * @param reading Reading of the instance, only valid for the duration of the
+ * call and only when err is DHT11_ERROR_NONE
+ * @param user_data User data passed to dht11_sched_acquire()
+ */
+typedef void (*dht11_sched_cb_t)(uint8_t inst, dht11_error_t err,
+                                 const dht11_reading_t *reading,
+                                 void *user_data);
+
+/** Scheduler statistics */
+typedef struct dht11_sched_stats_s {
+  uint32_t rounds;          ///< Completed rounds
+  uint32_t samples_ok;      ///< Valid samples over all rounds
+  uint32_t samples_failed;  ///< Failed samples over all rounds
+  uint32_t last_round_us;   ///< Wall-clock duration of the last round
+  uint32_t sample_rate_mhz; ///< Valid samples per second of round time in mHz
+} dht11_sched_stats_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Start a round reading every instance without blocking
+ *
+ * @param max_age_ms Oldest acceptable reading in ms, younger cached readings
+ * are returned without a read
+ * @param cb Called once per instance
+ * @param user_data Passed to cb
+ *
+ * @return DHT11_ERROR_NONE if the round was started
+ * @return DHT11_ERROR_BUSY if a round is already in flight
+ */
+dht11_error_t dht11_sched_acquire(uint32_t max_age_ms, dht11_sched_cb_t cb,
+                                  void *user_data);
+
+/**
+ * @brief Read every instance and block until the round completes
+ *
+ * Must not be called from the system work queue, which performs the reads.
+ *
+ * @param max_age_ms Oldest acceptable reading in ms
+ * @param readings Array of DHT11_NUM_INSTANCES readings
+ * @param errs Array of DHT11_NUM_INSTANCES results
+ *
+ * @return DHT11_ERROR_NONE if the round ran, individual results are in errs
+ * @return DHT11_ERROR_BUSY if a round is already in flight
+ */
+dht11_error_t dht11_sched_acquire_all(uint32_t max_age_ms,
+                                      dht11_reading_t *readings,
+                                      dht11_error_t *errs);
+
+/**
+ * @brief Retrieve the scheduler statistics
+ *
+ * @param stats Pointer to struct to store the statistics
+ */
+void dht11_sched_get_stats(dht11_sched_stats_t *stats);
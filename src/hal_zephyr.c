@@ -0,0 +1,39 @@
+/**
+ * @file hal_zephyr.c
+ * @brief Hardware access of the portable cores on Zephyr
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/kernel.h>
+
+#include <hal_zephyr.h>
+#ifdef CONFIG_APP_DHT11_EMUL
+#include <dht11_emul.h>
+#endif
+
+/*******************************************************************************
+ * Function Definitions
+ ******************************************************************************/
+
+// Described in .h
+uint32_t hal_cycles(void) { return k_cycle_get_32(); }
+
+// Described in .h
+uint32_t hal_us_to_cycles(uint32_t us) { return k_us_to_cyc_ceil32(us); }
+
+// Described in .h
+uint32_t hal_cycles_to_us(uint32_t cycles) {
+  return k_cyc_to_us_ceil32(cycles);
+}
+
+// Described in .h
+int hal_line_get(const hal_line_t *line) {
+#ifdef CONFIG_APP_DHT11_EMUL
+  // Time only passes in a busy wait on native_sim, see dht11_emul.h
+  dht11_emul_poll();
+#endif
+  return gpio_pin_get_dt(&line->spec);
+}
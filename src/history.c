@@ -0,0 +1,149 @@
+/**
+ * @file history.c
+ * @brief Flash history of the published DHT11 samples
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/storage/flash_map.h>
+
+#include <common.h>
+#include <history.h>
+#include <sample_ring.h>
+#include <storage_workq.h>
+#include <ts_store.h>
+
+LOG_MODULE_REGISTER(history, 3);
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/** Period of the ring drain, well below SAMPLE_RING_CAPACITY readings */
+#define HISTORY_DRAIN_MS 10000
+
+/** Age of the oldest sample in the RAM batch at which it is flushed */
+#define HISTORY_FLUSH_MS (CONFIG_APP_HISTORY_FLUSH_MIN * 60 * MSEC_PER_SEC)
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Append the samples published since the last drain to the store
+ *
+ * @param work UNUSED
+ */
+static void history_drain_handler(struct k_work *work);
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+static K_WORK_DELAYABLE_DEFINE(history_drain_work, history_drain_handler);
+
+static sample_ring_reader_t history_reader;
+
+/** Store timestamp of uptime 0 */
+static uint32_t boot_base_s;
+
+/** ts_store_stats_t batches at the last append, a change means the RAM batch
+ * was written */
+static uint32_t written_batches;
+
+/** True while the RAM batch holds samples */
+static bool unflushed;
+
+/** Uptime of the oldest sample in the RAM batch, valid while unflushed */
+static int64_t unflushed_since_ms;
+
+/*******************************************************************************
+ * Function Definitions
+ ******************************************************************************/
+
+// Described in .h
+int history_init(void) {
+  uint32_t last_s;
+
+  int ret = ts_store_init(FIXED_PARTITION_ID(history_partition));
+
+  if (ret) {
+    COMMON_LOG_ERR("History store unavailable. Err=%d", ret);
+    return ret;
+  }
+
+  if (!ts_store_last_time(&last_s)) {
+    boot_base_s = last_s + 1;
+  }
+
+  sample_ring_reader_init(&sensor_sample_ring, &history_reader);
+
+  k_work_schedule_for_queue(&storage_workq, &history_drain_work,
+                            K_MSEC(HISTORY_DRAIN_MS));
+
+  return 0;
+}
+
+// Described in .h
+uint32_t history_time_s(int64_t uptime_ms) {
+  return boot_base_s + (uint32_t)(uptime_ms / MSEC_PER_SEC);
+}
+
+// Described above
+static void history_drain_handler(struct k_work *work) {
+  sample_ring_sample_t sample;
+  ts_store_stats_t stats;
+  uint32_t overruns = history_reader.overruns;
+
+  while (!sample_ring_pop(&sensor_sample_ring, &history_reader, &sample)) {
+    // The store has no instance, it records the first sensor
+    if (sample.inst) {
+      continue;
+    }
+
+    const ts_sample_t entry = {
+        .time_s = history_time_s(sample.timestamp_ms),
+        .rh_x10 = sample.data.rh_x10,
+        .t_x10 = sample.data.t_x10,
+    };
+
+    int ret = ts_store_append(&entry);
+
+    if (ret) {
+      COMMON_LOG_ERR_RATELIMIT("History append failed. Err=%d", ret);
+      continue;
+    }
+
+    // First sample of the RAM batch, or one that did not fit and started it
+    ts_store_get_stats(&stats);
+    if (!unflushed || stats.batches != written_batches) {
+      unflushed = true;
+      unflushed_since_ms = sample.timestamp_ms;
+      written_batches = stats.batches;
+    }
+  }
+
+  // Bounds the samples a reset can lose to those of the last flush period
+  if (HISTORY_FLUSH_MS && unflushed &&
+      k_uptime_get() - unflushed_since_ms >= HISTORY_FLUSH_MS) {
+    int ret = ts_store_flush();
+
+    if (ret) {
+      COMMON_LOG_ERR_RATELIMIT("History flush failed. Err=%d", ret);
+    } else {
+      ts_store_get_stats(&stats);
+      written_batches = stats.batches;
+      unflushed = false;
+    }
+  }
+
+  if (history_reader.overruns != overruns) {
+    COMMON_LOG_WRN("History lost %u samples",
+                   history_reader.overruns - overruns);
+  }
+
+  k_work_schedule_for_queue(&storage_workq, &history_drain_work,
+                            K_MSEC(HISTORY_DRAIN_MS));
+}
@@ -4,15 +4,26 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
-#include <zephyr/drivers/gpio.h>
 #include <zephyr/kernel.h>
-#include <zephyr/kernel/thread_stack.h>
 
+#include <errno.h>
 #include <stdbool.h>
 
+#include <app.h>
 #include <common.h>
+#include <derived.h>
 #include <dht11.h>
+#include <dht11_cache.h>
+#include <dht11_calib.h>
+#include <dht11_sched.h>
 #include <event_module.h>
+#include <history.h>
+#include <led_module.h>
+#include <resource_monitor.h>
+#include <rollup.h>
+#include <sample_ring.h>
+#include <sensor_filter.h>
+#include <telemetry_feed.h>
 
 #include <button_module.h>
 
@@ -22,17 +33,17 @@ LOG_MODULE_REGISTER(main_app, 3);
  * Definitions
  ******************************************************************************/
 
-/** DHT11 stack size (1 kB) */
-#define STACK_SIZE 1024
+/** Delay before the first DHT11 read, lets the sensor settle after power up */
+#define DHT11_STARTUP_MS 1000
 
-/* Time to sleep in ms before toggling the green LED */
-#define SLEEP_TIME_MS 500
+/** Default period of the DHT11 acquisition, see app_dht11_period_set() */
+#define DHT11_PERIOD_MS 3000
 
-/* The devicetree node identifier for the "led0" alias. */
-#define LED0_NODE DT_ALIAS(led0)
+/* Heartbeat on and off time of the green LED */
+#define HEARTBEAT_MS 500
 
-/* The devicetree node identifier for the "led0" alias. */
-#define LED2_NODE DT_ALIAS(led2)
+/* Length of the red flash acknowledging a key press */
+#define KEY_FLASH_MS 50
 
 /*******************************************************************************
  * Type Definitions
@@ -43,29 +54,73 @@ LOG_MODULE_REGISTER(main_app, 3);
  ******************************************************************************/
 
 /**
- * @brief DHT11 polling thread
+ * @brief Periodic DHT11 acquisition, starts a round of the scheduler over
+ * every instance
  *
- * @param arg1 UNUSED
- * @param arg2 UNUSED
- * @param arg3 UNUSED
+ * @param work UNUSED
  */
-static void dht11_thread_start(void *arg1, void *arg2, void *arg3);
+static void dht11_poll_handler(struct k_work *work);
+
+/**
+ * @brief Publish the reading of one instance and signal its errors
+ *
+ * @param inst Instance index
+ * @param err Result of the request
+ * @param reading Reading that satisfied the request
+ * @param user_data UNUSED
+ */
+static void dht11_reading_done(uint8_t inst, dht11_error_t err,
+                               const dht11_reading_t *reading,
+                               void *user_data);
+
+/**
+ * @brief Filter a valid DHT11 reading and publish it to the sample ring and
+ * the rollup
+ *
+ * @param inst Instance that took the reading
+ * @param reading Reading to publish
+ */
+static void dht11_publish(uint8_t inst, const dht11_reading_t *reading);
+
+/**
+ * @brief Handler for EVENT_BUTTON_PRESSED, acknowledges the press on the red
+ * LED
+ *
+ * @param evt Event delivered by the event module
+ */
+static void button_press_handler(const event_t *evt);
+
+/**
+ * @brief Handler for EVENT_BUTTON_1S
+ *
+ * @param evt Event delivered by the event module
+ */
+static void button_hold_handler(const event_t *evt);
 
 /*******************************************************************************
  * Variables
  ******************************************************************************/
 
-/** LED spec based on the DT description */
-static const struct gpio_dt_spec green_led = GPIO_DT_SPEC_GET(LED0_NODE, gpios);
+/** DHT11 acquisition, runs on the system work queue */
+static K_WORK_DELAYABLE_DEFINE(dht11_poll_work, dht11_poll_handler);
+
+/** Period of the DHT11 acquisition in ms, changed from the shell */
+static atomic_t dht11_period_ms = ATOMIC_INIT(DHT11_PERIOD_MS);
 
-/**  Red LED spec based on the DT description */
-static const struct gpio_dt_spec red_led = GPIO_DT_SPEC_GET(LED2_NODE, gpios);
+/** Last error of every DHT11 instance, only used on the system work queue */
+static dht11_error_t dht11_errs[DHT11_NUM_INSTANCES];
 
-/** Define a memory region for the DHT11 thread stack */
-K_THREAD_STACK_DEFINE(thread_stack, STACK_SIZE);
+/** DHT11 error signalled on the red LED */
+static dht11_error_t dht11_last_err = DHT11_ERROR_NONE;
 
-/**  DHT11 thread structure */
-static struct k_thread dht11_thread;
+/** Derived metrics of the last sample asked for, shared by the subscribers */
+static derived_cache_t derived_cache;
+static struct k_spinlock derived_lock;
+
+EVENT_HANDLER_DEFINE(main_button_press, EVENT_BUTTON_PRESSED,
+                     button_press_handler);
+
+EVENT_HANDLER_DEFINE(main_button_hold, EVENT_BUTTON_1S, button_hold_handler);
 
 /*******************************************************************************
  * Function Definitions
@@ -77,68 +132,172 @@ static struct k_thread dht11_thread;
  * @return int
  */
 int main(void) {
-  bool led_state = true;
-
   event_module_init();
   button_module_init();
 
-  if (!gpio_is_ready_dt(&red_led)) {
+  if (led_module_init()) {
     COMMON_LOG_ERR("LED GPIO is not ready");
     return -1;
   }
 
-  if (!gpio_is_ready_dt(&green_led)) {
-    COMMON_LOG_ERR("LED GPIO is not ready");
-    return -1;
-  }
+  // Heartbeat, the LED module keeps it running without this thread
+  led_module_blink(LED_GREEN, HEARTBEAT_MS, HEARTBEAT_MS);
 
-  if (gpio_pin_configure_dt(&red_led, GPIO_OUTPUT_ACTIVE)) {
-    COMMON_LOG_ERR("Unable to configure pin");
-    return -1;
+  if (dht11_init(true)) {
+    COMMON_LOG_ERR("DHT11 initialization failed.");
   }
 
-  if (gpio_pin_configure_dt(&green_led, GPIO_OUTPUT_ACTIVE)) {
-    COMMON_LOG_ERR("Unable to configure pin");
-    return -1;
+  // Calibrate the bit thresholds from the first readings unless a
+  // calibration was restored from the settings
+  for (uint8_t inst = 0; inst < DHT11_NUM_INSTANCES; inst++) {
+    dht11_calib_stats_t calib;
+    if (!dht11_calib_get_stats(inst, &calib) &&
+        calib.state != DHT11_CALIB_STATE_DONE) {
+      dht11_calib_start(inst);
+    }
   }
 
-  gpio_pin_set_dt(&red_led, 0);
+#ifdef CONFIG_APP_HISTORY
+  history_init();
+#endif
 
-  // Create and start the DHT11 acquisition thread
-  k_tid_t dht11_tid = k_thread_create(
-      &dht11_thread, thread_stack, K_THREAD_STACK_SIZEOF(thread_stack),
-      dht11_thread_start, NULL, NULL, NULL, 7, 0, K_NO_WAIT);
+#ifdef CONFIG_APP_TELEMETRY
+  telemetry_feed_init();
+#endif
 
-  while (1) {
-    if (gpio_pin_toggle_dt(&green_led)) {
-      return -1;
-    }
+#ifdef CONFIG_APP_RESOURCE_MONITOR
+  resource_monitor_init();
+#endif
+
+  // Everything else runs from interrupts, timers, the system work queue and
+  // the history work queue so the main thread is free to exit
+  k_work_schedule(&dht11_poll_work, K_MSEC(DHT11_STARTUP_MS));
+
+  return 0;
+}
+
+// Described above
+static void button_press_handler(const event_t *evt) {
+  led_module_flash(LED_RED, KEY_FLASH_MS);
+}
 
-    led_state = !led_state;
-    uint32_t events = event_module_wait_on_event(SLEEP_TIME_MS);
+// Described above
+static void button_hold_handler(const event_t *evt) {
+  const button_event_t *btn = (const button_event_t *)evt->payload;
+
+  COMMON_LOG_INF("Key %d held for %d ms", btn->key, btn->hold_ms);
+}
 
-    if (events & EVENT_BUTTON_1S) {
+// Described in .h
+uint32_t app_dht11_period_get(void) {
+  return (uint32_t)atomic_get(&dht11_period_ms);
+}
+
+// Described in .h
+int app_dht11_period_set(uint32_t period_ms) {
+  for (uint8_t inst = 0; inst < DHT11_NUM_INSTANCES; inst++) {
+    if (period_ms < dht11_model_get(inst)->min_interval_ms) {
+      return -EINVAL;
     }
   }
+
+  // Not rescheduled here, the round in flight may still be waiting
+  atomic_set(&dht11_period_ms, (atomic_val_t)period_ms);
+
   return 0;
 }
 
+// Described in .h
+int app_derived_get(const sample_ring_sample_t *sample,
+                    derived_metrics_t *metrics) {
+  int err = 0;
+
+  K_SPINLOCK(&derived_lock) {
+    err = derived_cache_get(&derived_cache, sample->seq, &sample->data,
+                            metrics);
+  }
+
+  return err;
+}
+
 // Described above
-static void dht11_thread_start(void *arg1, void *arg2, void *arg3) {
-  COMMON_LOG_INF("Starting DHT11 thread.");
+static void dht11_poll_handler(struct k_work *work) {
+  uint32_t max_age_ms = 0;
 
-  if (dht11_init(false)) {
-    COMMON_LOG_ERR("DHT11 initialization failed.");
+  k_work_schedule(&dht11_poll_work, K_MSEC(app_dht11_period_get()));
+
+  // No read can be fresher than one taken within the minimum read interval
+  for (uint8_t inst = 0; inst < DHT11_NUM_INSTANCES; inst++) {
+    max_age_ms = MAX(max_age_ms, dht11_model_get(inst)->min_interval_ms);
   }
-  k_msleep(1000);
 
-  while (1) {
-    dht11_data_t data;
-    dht11_error_t err = dht11_get_data(NULL, &data);
-    if (err) {
-      COMMON_LOG_ERR("Error retrieving DHT11 data. Err=%d", err);
+  // Busy while retries of the previous round are still waiting
+  dht11_error_t err = dht11_sched_acquire(max_age_ms, dht11_reading_done, NULL);
+  if (err) {
+    COMMON_LOG_DBG("DHT11 round skipped. Err=%d", err);
+  }
+}
+
+// Described above
+static void dht11_reading_done(uint8_t inst, dht11_error_t err,
+                               const dht11_reading_t *reading,
+                               void *user_data) {
+  dht11_error_t led_err = DHT11_ERROR_NONE;
+
+  if (err) {
+    COMMON_LOG_ERR_RATELIMIT("Error retrieving DHT11 %d data. Err=%d", inst,
+                             err);
+  } else {
+    dht11_publish(inst, reading);
+  }
+
+  dht11_errs[inst] = err;
+  for (uint8_t idx = 0; idx < DHT11_NUM_INSTANCES && !led_err; idx++) {
+    led_err = dht11_errs[idx];
+  }
+
+  // Signal a persistent error of any instance as a blink code of its number
+  // on the red LED
+  if (led_err != dht11_last_err) {
+    if (led_err) {
+      led_module_blink_code(LED_RED, led_err);
+    } else {
+      led_module_set(LED_RED, false);
     }
-    COMMON_LOG_INF("RH=%d, T=%d, parity=%d", data.rh_high, data.t_high, data.parity);
-    k_msleep(3000);
+    dht11_last_err = led_err;
+  }
+}
+
+// Described above
+static void dht11_publish(uint8_t inst, const dht11_reading_t *reading) {
+  sample_ring_sample_t sample = {
+      .timestamp_ms = reading->timestamp_ms,
+      .data = reading->sample,
+      .inst = inst,
+  };
+
+  if (sensor_filter_dht11(&sensor_dht11_filter[inst], &sample.data)) {
+    COMMON_LOG_WRN("DHT11 %d spike dropped, RH=" DHT11_X10_FMT
+                   ", T=" DHT11_X10_FMT,
+                   inst, DHT11_X10_ARGS(reading->sample.rh_x10),
+                   DHT11_X10_ARGS(reading->sample.t_x10));
+    return;
+  }
+
+  COMMON_LOG_INF("DHT11 %d RH=" DHT11_X10_FMT ", T=" DHT11_X10_FMT
+                 ", raw RH=" DHT11_X10_FMT ", T=" DHT11_X10_FMT,
+                 inst, DHT11_X10_ARGS(sample.data.rh_x10),
+                 DHT11_X10_ARGS(sample.data.t_x10),
+                 DHT11_X10_ARGS(reading->sample.rh_x10),
+                 DHT11_X10_ARGS(reading->sample.t_x10));
+
+  sample_ring_push(&sensor_sample_ring, &sample);
+
+  // The rollup has no instance, it follows the first sensor
+  if (inst) {
+    return;
   }
+
+  rollup_add(&sensor_rollup, (uint32_t)(reading->timestamp_ms / MSEC_PER_SEC),
+             sample.data.rh_x10, sample.data.t_x10);
 }
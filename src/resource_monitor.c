@@ -0,0 +1,226 @@
+/**
+ * @file resource_monitor.c
+ * @brief Periodic stack and CPU usage of every thread
+ *
+ * A sample is built in a scratch table while walking the thread list
+ * unlocked, then swapped in under monitor_lock so readers never see half a
+ * sample.  Each entry keeps the execution cycles of its thread so the next
+ * sample can compute the share of the period in between.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include <string.h>
+
+#include <resource_monitor.h>
+
+LOG_MODULE_REGISTER(resource_monitor, 3);
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+#define NUM_ENTRIES CONFIG_APP_RESOURCE_MONITOR_THREADS
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+
+/** A monitored thread */
+typedef struct monitor_entry_s {
+  const struct k_thread *thread;
+  uint64_t cycles; ///< Execution cycles of the thread at the sample
+  resource_monitor_thread_t usage;
+} monitor_entry_t;
+
+/** Context of a sample */
+typedef struct sample_walk_s {
+  monitor_entry_t *entries; ///< Table being built
+  size_t count;
+  uint32_t untracked;
+  uint32_t stack_warnings;
+  uint32_t cpu_warnings;
+  uint64_t period_cycles; ///< Execution cycles of all threads since the last
+} sample_walk_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Sample one thread into the table being built
+ *
+ * @param thread Thread to sample
+ * @param user_data sample_walk_t of the sample
+ */
+static void sample_thread(const struct k_thread *thread, void *user_data);
+
+/**
+ * @brief Entry of a thread in the last sample
+ *
+ * @param thread Thread to look up
+ * @return Entry or NULL if the thread is new
+ */
+static const monitor_entry_t *find_entry(const struct k_thread *thread);
+
+/**
+ * @brief Periodic sample
+ *
+ * @param work UNUSED
+ */
+static void monitor_work_handler(struct k_work *work);
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+static K_WORK_DELAYABLE_DEFINE(monitor_work, monitor_work_handler);
+
+/** Protects entries and count for the readers */
+static struct k_spinlock monitor_lock;
+
+/** Last sample */
+static monitor_entry_t entries[NUM_ENTRIES];
+static size_t num_entries;
+
+/** Sample being built */
+static monitor_entry_t scratch[NUM_ENTRIES];
+
+/** Execution cycles of all threads at the last sample */
+static uint64_t last_total_cycles;
+
+static resource_monitor_stats_t stats;
+
+/*******************************************************************************
+ * Function Definitions
+ ******************************************************************************/
+
+// Described in .h
+void resource_monitor_init(void) {
+  resource_monitor_sample();
+  k_work_schedule(&monitor_work,
+                  K_SECONDS(CONFIG_APP_RESOURCE_MONITOR_PERIOD_S));
+}
+
+// Described above
+static void monitor_work_handler(struct k_work *work) {
+  resource_monitor_sample();
+  k_work_schedule(&monitor_work,
+                  K_SECONDS(CONFIG_APP_RESOURCE_MONITOR_PERIOD_S));
+}
+
+// Described in .h
+void resource_monitor_sample(void) {
+  k_thread_runtime_stats_t all;
+  sample_walk_t walk = {.entries = scratch};
+
+  k_thread_runtime_stats_all_get(&all);
+  walk.period_cycles = all.execution_cycles - last_total_cycles;
+  last_total_cycles = all.execution_cycles;
+
+  k_thread_foreach_unlocked(sample_thread, &walk);
+
+  K_SPINLOCK(&monitor_lock) {
+    memcpy(entries, scratch, walk.count * sizeof(scratch[0]));
+    num_entries = walk.count;
+    stats.samples++;
+    stats.untracked = walk.untracked;
+    stats.stack_warnings += walk.stack_warnings;
+    stats.cpu_warnings += walk.cpu_warnings;
+  }
+
+  if (walk.untracked) {
+    LOG_WRN("%u threads beyond CONFIG_APP_RESOURCE_MONITOR_THREADS",
+            walk.untracked);
+  }
+}
+
+// Described above
+static const monitor_entry_t *find_entry(const struct k_thread *thread) {
+  // Only the sampler writes the table, no lock needed to read it here
+  for (size_t idx = 0; idx < num_entries; idx++) {
+    if (entries[idx].thread == thread) {
+      return &entries[idx];
+    }
+  }
+
+  return NULL;
+}
+
+// Described above
+static void sample_thread(const struct k_thread *thread, void *user_data) {
+  sample_walk_t *walk = user_data;
+  const monitor_entry_t *prev = find_entry(thread);
+  const char *name = k_thread_name_get((k_tid_t)thread);
+  k_thread_runtime_stats_t rt;
+  size_t unused;
+
+  if (walk->count >= NUM_ENTRIES) {
+    walk->untracked++;
+    return;
+  }
+
+  if (k_thread_runtime_stats_get((k_tid_t)thread, &rt) ||
+      k_thread_stack_space_get(thread, &unused)) {
+    return;
+  }
+
+  monitor_entry_t *entry = &walk->entries[walk->count++];
+  resource_monitor_thread_t *usage = &entry->usage;
+  uint64_t cycles = rt.execution_cycles - (prev ? prev->cycles : 0);
+
+  entry->thread = thread;
+  entry->cycles = rt.execution_cycles;
+
+  strncpy(usage->name, name && name[0] ? name : "?", sizeof(usage->name) - 1);
+  usage->name[sizeof(usage->name) - 1] = '\0';
+  usage->stack_size = thread->stack_info.size;
+  usage->stack_peak = usage->stack_size - unused;
+
+  // A thread first seen reports its cycles since it was created
+  usage->cpu_permille =
+      walk->period_cycles ? MIN(cycles * 1000 / walk->period_cycles, 1000) : 0;
+
+  // The peak never drops, so a thread is only reported once
+  usage->stack_warn = (uint64_t)usage->stack_peak * 100 >=
+                      (uint64_t)usage->stack_size *
+                          CONFIG_APP_RESOURCE_MONITOR_STACK_PCT;
+  if (usage->stack_warn && !(prev && prev->usage.stack_warn)) {
+    walk->stack_warnings++;
+    LOG_WRN("%s stack peak %u of %u B", usage->name, usage->stack_peak,
+            usage->stack_size);
+  }
+
+  // The idle thread takes whatever is left
+  usage->cpu_warn =
+      k_thread_priority_get((k_tid_t)thread) != K_IDLE_PRIO &&
+      usage->cpu_permille > CONFIG_APP_RESOURCE_MONITOR_CPU_PCT * 10;
+  if (usage->cpu_warn && !(prev && prev->usage.cpu_warn)) {
+    walk->cpu_warnings++;
+    LOG_WRN("%s used %u.%u %% of the CPU", usage->name,
+            usage->cpu_permille / 10, usage->cpu_permille % 10);
+  }
+}
+
+// Described in .h
+size_t resource_monitor_get(resource_monitor_thread_t *threads, size_t max) {
+  size_t count = 0;
+
+  K_SPINLOCK(&monitor_lock) {
+    count = MIN(max, num_entries);
+    for (size_t idx = 0; idx < count; idx++) {
+      threads[idx] = entries[idx].usage;
+    }
+  }
+
+  return count;
+}
+
+// Described in .h
+void resource_monitor_get_stats(resource_monitor_stats_t *out) {
+  K_SPINLOCK(&monitor_lock) { *out = stats; }
+}
@@ -0,0 +1,216 @@
+/**
+ * @file telemetry_feed.c
+ * @brief Feed of the application data into the telemetry stream
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <zephyr/device.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+
+#include <string.h>
+
+#include <app.h>
+#include <common.h>
+#include <dht11_reliable.h>
+#include <event_module.h>
+#include <resource_monitor.h>
+#include <sample_ring.h>
+#include <telemetry.h>
+#include <telemetry_feed.h>
+
+LOG_MODULE_REGISTER(telemetry_feed, 3);
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+#define TELEMETRY_UART DEVICE_DT_GET(DT_CHOSEN(app_telemetry_uart))
+
+/** Size of a SAMPLE record */
+#define SAMPLE_RECORD_SIZE 9
+
+/** Size of a DERIVED record */
+#define DERIVED_RECORD_SIZE 11
+
+/** Size of a thread in a RESOURCES record */
+#define RESOURCES_THREAD_SIZE (6 + RESOURCE_MONITOR_NAME_LEN)
+
+/** Threads fitting in a RESOURCES record */
+#define RESOURCES_MAX_THREADS (TELEMETRY_RECORD_MAX / RESOURCES_THREAD_SIZE)
+
+/** Flush periods between two COUNTERS records */
+#define COUNTERS_EVERY                                                         \
+  MAX(1, CONFIG_APP_TELEMETRY_COUNTERS_S * MSEC_PER_SEC /                      \
+             CONFIG_APP_TELEMETRY_FLUSH_MS)
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Send the new samples, the counters when due, and flush the frame
+ *
+ * @param work UNUSED
+ */
+static void telemetry_flush_handler(struct k_work *work);
+
+/**
+ * @brief Send a dispatched event
+ *
+ * @param evt Event delivered by the event module
+ */
+static void telemetry_event_handler(const event_t *evt);
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+static K_WORK_DELAYABLE_DEFINE(telemetry_flush_work, telemetry_flush_handler);
+
+static sample_ring_reader_t telemetry_reader;
+
+/** Flushes since the last COUNTERS record */
+static uint32_t flushes;
+
+EVENT_HANDLER_DEFINE(telemetry_button_1s, EVENT_BUTTON_1S,
+                     telemetry_event_handler);
+EVENT_HANDLER_DEFINE(telemetry_button_pressed, EVENT_BUTTON_PRESSED,
+                     telemetry_event_handler);
+EVENT_HANDLER_DEFINE(telemetry_button_released, EVENT_BUTTON_RELEASED,
+                     telemetry_event_handler);
+EVENT_HANDLER_DEFINE(telemetry_button_gesture, EVENT_BUTTON_GESTURE,
+                     telemetry_event_handler);
+
+/*******************************************************************************
+ * Function Definitions
+ ******************************************************************************/
+
+// Described in .h
+int telemetry_feed_init(void) {
+  int ret = telemetry_init(TELEMETRY_UART);
+
+  if (ret) {
+    COMMON_LOG_ERR("Telemetry UART unavailable. Err=%d", ret);
+    return ret;
+  }
+
+  sample_ring_reader_init(&sensor_sample_ring, &telemetry_reader);
+  k_work_schedule(&telemetry_flush_work,
+                  K_MSEC(CONFIG_APP_TELEMETRY_FLUSH_MS));
+
+  return 0;
+}
+
+/** Send a COUNTERS record */
+static void telemetry_put_counters(void) {
+  uint8_t payload[TELEMETRY_FEED_COUNTER_MAX * sizeof(uint32_t)];
+  uint32_t counters[TELEMETRY_FEED_COUNTER_MAX];
+  dht11_reliable_stats_t dht11;
+  telemetry_stats_t stream;
+  event_stats_t events;
+
+  telemetry_get_stats(&stream);
+  event_module_get_stats(&events);
+  dht11_reliable_get_stats(&dht11);
+
+  counters[TELEMETRY_FEED_FRAMES] = stream.frames;
+  counters[TELEMETRY_FEED_FRAMES_DROPPED] = stream.frames_dropped;
+  counters[TELEMETRY_FEED_EVENTS_POSTED] = events.posted;
+  counters[TELEMETRY_FEED_EVENTS_DROPPED] = events.dropped;
+  counters[TELEMETRY_FEED_DHT11_REQUESTS] = dht11.requests;
+  counters[TELEMETRY_FEED_DHT11_PUBLISHED] = dht11.published;
+  counters[TELEMETRY_FEED_DHT11_RETRIES] = dht11.retries;
+  counters[TELEMETRY_FEED_SAMPLES_OVERRUN] = telemetry_reader.overruns;
+  counters[TELEMETRY_FEED_EVENT_POOL_PEAK] = events.pool_peak;
+
+  for (uint8_t idx = 0; idx < TELEMETRY_FEED_COUNTER_MAX; idx++) {
+    sys_put_le32(counters[idx], &payload[idx * sizeof(uint32_t)]);
+  }
+
+  telemetry_put(TELEMETRY_FEED_COUNTERS, payload, sizeof(payload));
+}
+
+#ifdef CONFIG_APP_RESOURCE_MONITOR
+/** Send a RESOURCES record */
+static void telemetry_put_resources(void) {
+  static resource_monitor_thread_t threads[RESOURCES_MAX_THREADS];
+  static uint8_t payload[RESOURCES_MAX_THREADS * RESOURCES_THREAD_SIZE];
+  size_t count = resource_monitor_get(threads, ARRAY_SIZE(threads));
+
+  for (size_t idx = 0; idx < count; idx++) {
+    uint8_t *out = &payload[idx * RESOURCES_THREAD_SIZE];
+
+    sys_put_le16(MIN(threads[idx].stack_size, UINT16_MAX), &out[0]);
+    sys_put_le16(MIN(threads[idx].stack_peak, UINT16_MAX), &out[2]);
+    sys_put_le16(threads[idx].cpu_permille, &out[4]);
+    strncpy((char *)&out[6], threads[idx].name, RESOURCE_MONITOR_NAME_LEN);
+  }
+
+  telemetry_put(TELEMETRY_FEED_RESOURCES, payload,
+                count * RESOURCES_THREAD_SIZE);
+}
+#endif
+
+#ifdef CONFIG_APP_TELEMETRY_DERIVED
+/** Send the DERIVED record of a sample, nothing if it has no metrics */
+static void telemetry_put_derived(const sample_ring_sample_t *sample) {
+  uint8_t payload[DERIVED_RECORD_SIZE];
+  derived_metrics_t metrics;
+
+  if (app_derived_get(sample, &metrics)) {
+    return;
+  }
+
+  sys_put_le32((uint32_t)sample->timestamp_ms, &payload[0]);
+  payload[4] = sample->inst;
+  sys_put_le16(metrics.dew_point_x10, &payload[5]);
+  sys_put_le16(metrics.abs_humidity_x100, &payload[7]);
+  sys_put_le16(metrics.heat_index_x10, &payload[9]);
+
+  telemetry_put(TELEMETRY_FEED_DERIVED, payload, sizeof(payload));
+}
+#endif
+
+// Described above
+static void telemetry_flush_handler(struct k_work *work) {
+  uint8_t payload[SAMPLE_RECORD_SIZE];
+  sample_ring_sample_t sample;
+
+  while (!sample_ring_pop(&sensor_sample_ring, &telemetry_reader, &sample)) {
+    sys_put_le32((uint32_t)sample.timestamp_ms, &payload[0]);
+    payload[4] = sample.inst;
+    sys_put_le16(sample.data.rh_x10, &payload[5]);
+    sys_put_le16(sample.data.t_x10, &payload[7]);
+
+    telemetry_put(TELEMETRY_FEED_SAMPLE, payload, sizeof(payload));
+#ifdef CONFIG_APP_TELEMETRY_DERIVED
+    telemetry_put_derived(&sample);
+#endif
+  }
+
+  if (++flushes >= COUNTERS_EVERY) {
+    flushes = 0;
+    telemetry_put_counters();
+#ifdef CONFIG_APP_RESOURCE_MONITOR
+    telemetry_put_resources();
+#endif
+  }
+
+  telemetry_flush();
+
+  k_work_schedule(&telemetry_flush_work,
+                  K_MSEC(CONFIG_APP_TELEMETRY_FLUSH_MS));
+}
+
+// Described above
+static void telemetry_event_handler(const event_t *evt) {
+  uint8_t payload[1 + EVENT_PAYLOAD_SIZE];
+
+  payload[0] = (uint8_t)evt->type;
+  memcpy(&payload[1], evt->payload, evt->len);
+
+  telemetry_put(TELEMETRY_FEED_EVENT, payload, 1 + evt->len);
+}
@@ -0,0 +1,93 @@
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include <app_trace.h>
+
+/** Length of the traced busy wait with interrupts locked */
+#define LOCK_US 50
+
+/** Spans recorded by the benchmark */
+#define BENCH_SPANS 10000
+
+static void app_trace_before(void *fixture) { app_trace_reset(); }
+
+ZTEST(app_trace_suite, test_log2_buckets) {
+  const uint32_t lengths[] = {0, 1, 2, 3, 1000, UINT32_MAX};
+  app_trace_stats_t stats;
+
+  for (uint8_t idx = 0; idx < ARRAY_SIZE(lengths); idx++) {
+    app_trace_record(APP_TRACE_DHT11_DECODE, lengths[idx]);
+  }
+
+  zassert_ok(app_trace_get(APP_TRACE_DHT11_DECODE, &stats));
+  zassert_equal(stats.count, ARRAY_SIZE(lengths));
+  zassert_equal(stats.max_cycles, UINT32_MAX);
+  zassert_equal(stats.buckets[0], 1);
+  zassert_equal(stats.buckets[1], 1);
+  zassert_equal(stats.buckets[2], 2, "2 and 3 share [2, 4)");
+  zassert_equal(stats.buckets[10], 1, "1000 is in [512, 1024)");
+  zassert_equal(stats.buckets[APP_TRACE_BUCKETS - 1], 1);
+
+  // Other spans are untouched
+  zassert_ok(app_trace_get(APP_TRACE_BUTTON_ISR, &stats));
+  zassert_equal(stats.count, 0);
+}
+
+ZTEST(app_trace_suite, test_blackout) {
+  app_trace_span_t span;
+
+  zassert_equal(app_trace_blackout(&span), 0);
+
+  // Latency is not a blackout, interrupts stay enabled meanwhile
+  app_trace_record(APP_TRACE_BUTTON_LATENCY, 100000);
+  app_trace_record(APP_TRACE_DHT11_IRQ_LOCK, 500);
+  app_trace_record(APP_TRACE_DHT11_EDGE_ISR, 800);
+  app_trace_record(APP_TRACE_DHT11_EDGE_ISR, 20);
+
+  zassert_equal(app_trace_blackout(&span), 800);
+  zassert_equal(span, APP_TRACE_DHT11_EDGE_ISR);
+  zassert_equal(app_trace_blackout(NULL), 800);
+}
+
+ZTEST(app_trace_suite, test_irq_lock_span) {
+  app_trace_stats_t stats;
+
+  unsigned int key = irq_lock();
+  uint32_t start = APP_TRACE_START();
+
+  k_busy_wait(LOCK_US);
+
+  irq_unlock(key);
+  APP_TRACE_END(DHT11_IRQ_LOCK, start);
+
+  zassert_ok(app_trace_get(APP_TRACE_DHT11_IRQ_LOCK, &stats));
+  zassert_equal(stats.count, 1);
+  zassert_true(k_cyc_to_us_ceil32(stats.max_cycles) >= LOCK_US, "%u cycles",
+               stats.max_cycles);
+  zassert_equal(app_trace_blackout(NULL), stats.max_cycles);
+}
+
+ZTEST(app_trace_suite, test_invalid_span) {
+  app_trace_stats_t stats;
+
+  zassert_equal(app_trace_get(APP_TRACE_SPAN_MAX, &stats), -EINVAL);
+  zassert_str_equal(app_trace_name(APP_TRACE_SPAN_MAX), "?");
+  zassert_str_equal(app_trace_name(APP_TRACE_DHT11_DECODE), "dht11_decode");
+}
+
+ZTEST(app_trace_suite, test_bench_record) {
+  uint32_t start = k_cycle_get_32();
+
+  for (uint32_t idx = 0; idx < BENCH_SPANS; idx++) {
+    uint32_t span_start = APP_TRACE_START();
+
+    APP_TRACE_END(DHT11_DECODE, span_start);
+  }
+
+  uint32_t cycles = k_cycle_get_32() - start;
+
+  TC_PRINT("record: %u spans in %u cycles, %u cycles/span\n", BENCH_SPANS,
+           cycles, cycles / BENCH_SPANS);
+}
+
+ZTEST_SUITE(app_trace_suite, NULL, NULL, app_trace_before, NULL, NULL);
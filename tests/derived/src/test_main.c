@@ -0,0 +1,176 @@
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include <math.h>
+
+#include <derived.h>
+#include <sample_ring.h>
+
+/** Largest errors against the double reference */
+#define DEW_POINT_TOL 0.1
+#define ABS_HUMIDITY_TOL 0.05
+#define HEAT_INDEX_TOL 0.2
+
+/** Grid steps of the accuracy sweep in 0.1 units, coprime with the tables */
+#define SWEEP_T_STEP 3
+#define SWEEP_RH_STEP 7
+
+/** Samples timed by the benchmark */
+#define BENCH_SAMPLES 1000
+
+static SAMPLE_RING_DEFINE(ring);
+
+/** Metrics of the formulas the tables are generated from, in double */
+static void reference(double t, double rh, double *dew_point,
+                      double *abs_humidity, double *heat_index) {
+  double magnus = 17.62 * t / (243.12 + t);
+  double gamma = log(rh / 100) + magnus;
+  double t_f = t * 9 / 5 + 32;
+  double hi = 0.5 * (t_f + 61.0 + (t_f - 68.0) * 1.2 + rh * 0.094);
+
+  *dew_point = 243.12 * gamma / (17.62 - gamma);
+  *abs_humidity = 216.7 * rh / 100 * 6.112 * exp(magnus) / (273.15 + t);
+
+  if ((hi + t_f) / 2 >= 80) {
+    hi = -42.379 + 2.04901523 * t_f + 10.14333127 * rh -
+         0.22475541 * t_f * rh - 6.83783e-3 * t_f * t_f -
+         5.481717e-2 * rh * rh + 1.22874e-3 * t_f * t_f * rh +
+         8.5282e-4 * t_f * rh * rh - 1.99e-6 * t_f * t_f * rh * rh;
+    if (rh < 13 && t_f >= 80 && t_f <= 112) {
+      hi -= (13 - rh) / 4 * sqrt((17 - fabs(t_f - 95)) / 17);
+    } else if (rh > 85 && t_f >= 80 && t_f <= 87) {
+      hi += (rh - 85) / 10 * (87 - t_f) / 5;
+    }
+  }
+  *heat_index = (hi - 32) * 5 / 9;
+}
+
+static void derived_before(void *fixture) { memset(&ring, 0, sizeof(ring)); }
+
+ZTEST(derived_suite, test_accuracy) {
+  derived_metrics_t metrics;
+  double dew_point;
+  double abs_humidity;
+  double heat_index;
+
+  for (int16_t t_x10 = -400; t_x10 <= 800; t_x10 += SWEEP_T_STEP) {
+    for (int16_t rh_x10 = 1; rh_x10 <= 1000; rh_x10 += SWEEP_RH_STEP) {
+      dht11_sample_t sample = {.rh_x10 = rh_x10, .t_x10 = t_x10};
+
+      zassert_ok(derived_compute(&sample, &metrics));
+      reference(t_x10 / 10.0, rh_x10 / 10.0, &dew_point, &abs_humidity,
+                &heat_index);
+
+      zassert_true(fabs(metrics.dew_point_x10 / 10.0 - dew_point) <=
+                       DEW_POINT_TOL,
+                   "dew point %d at %d, %d", metrics.dew_point_x10, t_x10,
+                   rh_x10);
+      zassert_true(fabs(metrics.abs_humidity_x100 / 100.0 - abs_humidity) <=
+                       ABS_HUMIDITY_TOL,
+                   "absolute humidity %u at %d, %d",
+                   metrics.abs_humidity_x100, t_x10, rh_x10);
+      if (t_x10 <= 500) {
+        zassert_true(fabs(metrics.heat_index_x10 / 10.0 - heat_index) <=
+                         HEAT_INDEX_TOL,
+                     "heat index %d at %d, %d", metrics.heat_index_x10,
+                     t_x10, rh_x10);
+      }
+    }
+  }
+}
+
+ZTEST(derived_suite, test_domain) {
+  derived_metrics_t metrics;
+  dht11_sample_t sample = {.rh_x10 = 0, .t_x10 = 250};
+
+  zassert_equal(derived_compute(&sample, &metrics), -EDOM);
+
+  sample.rh_x10 = 1001;
+  zassert_equal(derived_compute(&sample, &metrics), -ERANGE);
+
+  sample.rh_x10 = 500;
+  sample.t_x10 = 801;
+  zassert_equal(derived_compute(&sample, &metrics), -ERANGE);
+
+  // The ends of the DHT22 range
+  sample.t_x10 = 800;
+  zassert_ok(derived_compute(&sample, &metrics));
+  zassert_equal(metrics.heat_index_x10, DERIVED_NONE);
+
+  sample.rh_x10 = 1000;
+  sample.t_x10 = -400;
+  zassert_ok(derived_compute(&sample, &metrics));
+  zassert_equal(metrics.dew_point_x10, -400);
+}
+
+ZTEST(derived_suite, test_cache_per_seq) {
+  derived_cache_t cache = {0};
+  derived_metrics_t first;
+  derived_metrics_t again;
+  sample_ring_reader_t reader;
+  sample_ring_sample_t sample = {.data = {.rh_x10 = 600, .t_x10 = 300}};
+
+  sample_ring_reader_init(&ring, &reader);
+  sample_ring_push(&ring, &sample);
+
+  // Nothing is computed until a subscriber asks
+  zassert_equal(cache.computed, 0);
+
+  zassert_ok(sample_ring_latest(&ring, &sample));
+  zassert_ok(derived_cache_get(&cache, sample.seq, &sample.data, &first));
+  zassert_equal(cache.computed, 1);
+
+  // A second subscriber reading the same sample gets the cached metrics
+  zassert_ok(sample_ring_pop(&ring, &reader, &sample));
+  zassert_ok(derived_cache_get(&cache, sample.seq, &sample.data, &again));
+  zassert_equal(cache.computed, 1);
+  zassert_equal(cache.hits, 1);
+  zassert_mem_equal(&first, &again, sizeof(first));
+
+  // The next sample is computed again, even with the same values
+  sample_ring_push(&ring, &sample);
+  zassert_ok(sample_ring_pop(&ring, &reader, &sample));
+  zassert_ok(derived_cache_get(&cache, sample.seq, &sample.data, &again));
+  zassert_equal(cache.computed, 2);
+
+  // So is an error, once
+  sample.data.rh_x10 = 0;
+  sample_ring_push(&ring, &sample);
+  zassert_ok(sample_ring_pop(&ring, &reader, &sample));
+  zassert_equal(derived_cache_get(&cache, sample.seq, &sample.data, &again),
+                -EDOM);
+  zassert_equal(derived_cache_get(&cache, sample.seq, &sample.data, &again),
+                -EDOM);
+  zassert_equal(cache.computed, 3);
+}
+
+ZTEST(derived_suite, test_bench) {
+  derived_metrics_t metrics;
+  double dew_point;
+  double abs_humidity;
+  double heat_index;
+  double sink = 0;
+
+  uint32_t start = k_cycle_get_32();
+  for (uint32_t idx = 0; idx < BENCH_SAMPLES; idx++) {
+    dht11_sample_t sample = {.rh_x10 = 200 + idx % 700,
+                             .t_x10 = 150 + idx % 250};
+
+    derived_compute(&sample, &metrics);
+  }
+  uint32_t fixed_cycles = k_cycle_get_32() - start;
+
+  start = k_cycle_get_32();
+  for (uint32_t idx = 0; idx < BENCH_SAMPLES; idx++) {
+    reference((150 + idx % 250) / 10.0, (200 + idx % 700) / 10.0, &dew_point,
+              &abs_humidity, &heat_index);
+    sink += dew_point + abs_humidity + heat_index;
+  }
+  uint32_t double_cycles = k_cycle_get_32() - start;
+
+  TC_PRINT("fixed point: %u cycles/sample, double: %u cycles/sample (%d)\n",
+           fixed_cycles / BENCH_SAMPLES, double_cycles / BENCH_SAMPLES,
+           (int)sink);
+}
+
+ZTEST_SUITE(derived_suite, NULL, NULL, derived_before, NULL, NULL);
@@ -0,0 +1,209 @@
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include <string.h>
+
+#include <dht11.h>
+#include <dht11_calib.h>
+
+/** Widths in us measured by a capture whose clock runs fast, a 1 bit is
+ * shorter than the default threshold */
+#define FAST_ZERO_US 18
+#define FAST_ONE_US 45
+
+/** Nominal widths in us */
+#define NOMINAL_ZERO_US 27
+#define NOMINAL_ONE_US 70
+
+/** Frames fed to the drift test */
+#define DRIFT_FRAMES 64
+
+/** Data bit pattern of the generated frames, 14 ones and 26 zeros */
+static bool frame_bit(uint8_t bit) { return bit % 3 == 0; }
+
+static void make_widths(uint8_t *widths, uint8_t zero_us, uint8_t one_us) {
+  for (uint8_t bit = 0; bit < DHT11_NUM_DATA_BITS; bit++) {
+    widths[bit] = frame_bit(bit) ? one_us : zero_us;
+  }
+}
+
+static void feed_frames(uint32_t count, uint8_t zero_us, uint8_t one_us,
+                        dht11_error_t err) {
+  uint8_t widths[DHT11_NUM_DATA_BITS];
+
+  make_widths(widths, zero_us, one_us);
+  for (uint32_t idx = 0; idx < count; idx++) {
+    dht11_calib_update(0, widths, err);
+  }
+}
+
+static void *dht11_calib_setup(void) {
+  zassert_ok(dht11_calib_init());
+  return NULL;
+}
+
+static void dht11_calib_before(void *fixture) {
+  zassert_ok(dht11_calib_reset(0));
+}
+
+ZTEST(dht11_calib_suite, test_defaults) {
+  dht11_calib_stats_t stats;
+
+  zassert_ok(dht11_calib_get_stats(0, &stats));
+  zassert_equal(stats.state, DHT11_CALIB_STATE_DEFAULT);
+  zassert_equal(stats.params.threshold_us, DHT11_CALIB_DEFAULT_THRESHOLD_US);
+  zassert_equal(stats.params.setup_min_us, DHT11_CALIB_DEFAULT_SETUP_MIN_US);
+
+  // Nothing is derived without a calibration in progress
+  feed_frames(2 * DHT11_CALIB_FRAMES, FAST_ZERO_US, FAST_ONE_US,
+              DHT11_ERROR_PARITY_CHECK_FAILED);
+  zassert_ok(dht11_calib_get_stats(0, &stats));
+  zassert_equal(stats.state, DHT11_CALIB_STATE_DEFAULT);
+  zassert_equal(stats.before.frames, 2 * DHT11_CALIB_FRAMES);
+
+  zassert_equal(dht11_calib_start(DHT11_NUM_INSTANCES),
+                DHT11_ERROR_CONFIG_FAILURE);
+}
+
+ZTEST(dht11_calib_suite, test_derive_nominal) {
+  uint16_t bins[DHT11_CALIB_BINS] = {0};
+  dht11_calib_params_t params;
+
+  bins[NOMINAL_ZERO_US / DHT11_CALIB_BIN_US] = 26;
+  bins[NOMINAL_ONE_US / DHT11_CALIB_BIN_US] = 14;
+
+  zassert_true(dht11_calib_derive(bins, &params));
+  zassert_within(params.zero_us, NOMINAL_ZERO_US, DHT11_CALIB_BIN_US);
+  zassert_within(params.one_us, NOMINAL_ONE_US, DHT11_CALIB_BIN_US);
+  zassert_within(params.threshold_us, (NOMINAL_ZERO_US + NOMINAL_ONE_US) / 2,
+                 DHT11_CALIB_BIN_US);
+  zassert_equal(params.setup_min_us, DHT11_CALIB_DEFAULT_SETUP_MIN_US);
+}
+
+ZTEST(dht11_calib_suite, test_derive_rejects_single_cluster) {
+  uint16_t bins[DHT11_CALIB_BINS] = {0};
+  dht11_calib_params_t params;
+
+  zassert_false(dht11_calib_derive(bins, &params), "empty histogram");
+
+  bins[NOMINAL_ZERO_US / DHT11_CALIB_BIN_US] = 40;
+  zassert_false(dht11_calib_derive(bins, &params), "single width");
+
+  // Two widths too close to be a 0 and a 1
+  bins[(NOMINAL_ZERO_US + 10) / DHT11_CALIB_BIN_US] = 40;
+  zassert_false(dht11_calib_derive(bins, &params), "clusters too close");
+
+  // Clamped widths are not a cluster
+  memset(bins, 0, sizeof(bins));
+  bins[NOMINAL_ZERO_US / DHT11_CALIB_BIN_US] = 40;
+  bins[DHT11_CALIB_BINS - 1] = 40;
+  zassert_false(dht11_calib_derive(bins, &params), "clamped widths");
+}
+
+ZTEST(dht11_calib_suite, test_calibration_fixes_parity) {
+  dht11_calib_stats_t stats;
+  uint16_t bins[DHT11_CALIB_BINS];
+
+  zassert_ok(dht11_calib_start(0));
+
+  // With the default threshold every 1 decodes as a 0
+  feed_frames(DHT11_CALIB_FRAMES - 1, FAST_ZERO_US, FAST_ONE_US,
+              DHT11_ERROR_PARITY_CHECK_FAILED);
+  zassert_ok(dht11_calib_get_stats(0, &stats));
+  zassert_equal(stats.state, DHT11_CALIB_STATE_RUNNING);
+  zassert_equal(stats.params.threshold_us, DHT11_CALIB_DEFAULT_THRESHOLD_US);
+
+  feed_frames(1, FAST_ZERO_US, FAST_ONE_US, DHT11_ERROR_PARITY_CHECK_FAILED);
+  zassert_ok(dht11_calib_get_stats(0, &stats));
+  zassert_equal(stats.state, DHT11_CALIB_STATE_DONE);
+  zassert_true(stats.params.threshold_us > FAST_ZERO_US);
+  zassert_true(stats.params.threshold_us < FAST_ONE_US);
+  // The setup pulse is measured short by the same ratio
+  zassert_within(stats.params.setup_min_us,
+                 DHT11_CALIB_DEFAULT_SETUP_MIN_US * FAST_ONE_US /
+                     DHT11_CALIB_NOMINAL_ONE_US,
+                 DHT11_CALIB_BIN_US);
+
+  zassert_equal(stats.before.frames, DHT11_CALIB_FRAMES);
+  zassert_equal(stats.before.parity_failures, DHT11_CALIB_FRAMES);
+  zassert_equal(stats.samples, DHT11_CALIB_FRAMES * DHT11_NUM_DATA_BITS);
+
+  zassert_ok(dht11_calib_get_histogram(0, bins));
+  zassert_equal(bins[FAST_ONE_US / DHT11_CALIB_BIN_US],
+                DHT11_CALIB_FRAMES * 14);
+
+  // Frames decoded with the derived threshold are counted separately
+  feed_frames(4, FAST_ZERO_US, FAST_ONE_US, DHT11_ERROR_NONE);
+  feed_frames(1, FAST_ZERO_US, FAST_ONE_US, DHT11_ERROR_PARITY_CHECK_FAILED);
+  zassert_ok(dht11_calib_get_stats(0, &stats));
+  zassert_equal(stats.before.frames, DHT11_CALIB_FRAMES);
+  zassert_equal(stats.after.frames, 5);
+  zassert_equal(stats.after.parity_failures, 1);
+}
+
+ZTEST(dht11_calib_suite, test_setup_failures_not_collected) {
+  dht11_calib_stats_t stats;
+
+  zassert_ok(dht11_calib_start(0));
+  feed_frames(DHT11_CALIB_FRAMES, FAST_ZERO_US, FAST_ONE_US,
+              DHT11_ERROR_SETUP_FAILED);
+
+  zassert_ok(dht11_calib_get_stats(0, &stats));
+  zassert_equal(stats.state, DHT11_CALIB_STATE_RUNNING);
+  zassert_equal(stats.samples, 0);
+  zassert_equal(stats.before.frames, DHT11_CALIB_FRAMES);
+}
+
+ZTEST(dht11_calib_suite, test_failed_calibration_keeps_defaults) {
+  dht11_calib_stats_t stats;
+
+  zassert_ok(dht11_calib_start(0));
+  feed_frames(DHT11_CALIB_FRAMES, NOMINAL_ZERO_US, NOMINAL_ZERO_US,
+              DHT11_ERROR_NONE);
+
+  zassert_ok(dht11_calib_get_stats(0, &stats));
+  zassert_equal(stats.state, DHT11_CALIB_STATE_DEFAULT);
+  zassert_equal(stats.params.threshold_us, DHT11_CALIB_DEFAULT_THRESHOLD_US);
+}
+
+ZTEST(dht11_calib_suite, test_drift_tracking) {
+  dht11_calib_params_t params;
+  uint8_t drift_one_us = FAST_ONE_US + 8;
+
+  zassert_ok(dht11_calib_start(0));
+  feed_frames(DHT11_CALIB_FRAMES, FAST_ZERO_US, FAST_ONE_US,
+              DHT11_ERROR_NONE);
+  dht11_calib_get_params(0, &params);
+  uint8_t calibrated_us = params.threshold_us;
+
+  // Frames that fail parity must not move the threshold
+  feed_frames(DRIFT_FRAMES, FAST_ZERO_US, drift_one_us,
+              DHT11_ERROR_PARITY_CHECK_FAILED);
+  dht11_calib_get_params(0, &params);
+  zassert_equal(params.threshold_us, calibrated_us);
+
+  feed_frames(DRIFT_FRAMES, FAST_ZERO_US, drift_one_us, DHT11_ERROR_NONE);
+  dht11_calib_get_params(0, &params);
+  zassert_within(params.zero_us, FAST_ZERO_US, 1);
+  zassert_within(params.one_us, drift_one_us, 1);
+  zassert_within(params.threshold_us, (FAST_ZERO_US + drift_one_us) / 2, 1);
+  zassert_true(params.threshold_us > calibrated_us);
+}
+
+ZTEST(dht11_calib_suite, test_reset) {
+  dht11_calib_stats_t stats;
+
+  zassert_ok(dht11_calib_start(0));
+  feed_frames(DHT11_CALIB_FRAMES, FAST_ZERO_US, FAST_ONE_US,
+              DHT11_ERROR_NONE);
+  zassert_ok(dht11_calib_reset(0));
+
+  zassert_ok(dht11_calib_get_stats(0, &stats));
+  zassert_equal(stats.state, DHT11_CALIB_STATE_DEFAULT);
+  zassert_equal(stats.params.threshold_us, DHT11_CALIB_DEFAULT_THRESHOLD_US);
+  zassert_equal(stats.before.frames, 0);
+  zassert_equal(stats.samples, 0);
+}
+
+ZTEST_SUITE(dht11_calib_suite, NULL, dht11_calib_setup, dht11_calib_before,
+            NULL, NULL);
@@ -0,0 +1,250 @@
+#include <zephyr/kernel.h>
+#include <zephyr/sys/sys_heap.h>
+#include <zephyr/ztest.h>
+
+#include <string.h>
+
+#include <dht11.h>
+
+/** Generated frames, the benchmarks cycle through them */
+#define NUM_FRAMES 64
+
+/** Decodes timed per benchmark */
+#define BENCH_ITERATIONS 10000
+
+/** Stack of the benchmark thread, the decode path must fit well inside */
+#define BENCH_STACK_SIZE 1024
+
+/** Index of the first bit of each byte of a frame */
+#define BYTE_START(byte) ((byte) * 8)
+
+/** Result of a benchmark run */
+typedef struct bench_result_s {
+  uint32_t decode_cycles;      ///< Per valid frame
+  uint32_t parity_fail_cycles; ///< Per frame rejected on parity
+  uint32_t pack_cycles;        ///< Per dht11_pack_bits() call
+  uint32_t errors;             ///< Frames decoded to the wrong result
+  size_t stack_bytes;          ///< Stack high-water mark of the thread
+} bench_result_t;
+
+extern struct k_heap _system_heap;
+
+static uint8_t valid_frames[NUM_FRAMES][DHT11_NUM_DATA_BITS];
+static uint8_t corrupt_frames[NUM_FRAMES][DHT11_NUM_DATA_BITS];
+static dht11_data_t expected[NUM_FRAMES];
+
+/** Frame handed to dht11_get_data() by the mock */
+static const uint8_t *mock_frame;
+
+static bench_result_t result;
+
+K_THREAD_STACK_DEFINE(bench_stack, BENCH_STACK_SIZE);
+static struct k_thread bench_thread;
+
+/** Fixed seed xorshift so every run decodes the same frames */
+static uint32_t next_random(void) {
+  static uint32_t state = 0x2545F491;
+
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+static void unpack_byte(uint8_t *bits, uint8_t value) {
+  for (uint8_t bit = 0; bit < 8; bit++) {
+    bits[bit] = (value >> (7 - bit)) & 1;
+  }
+}
+
+static void make_frame(uint8_t *bits, const dht11_data_t *data) {
+  unpack_byte(&bits[BYTE_START(0)], data->rh_high);
+  unpack_byte(&bits[BYTE_START(1)], data->rh_low);
+  unpack_byte(&bits[BYTE_START(2)], data->t_high);
+  unpack_byte(&bits[BYTE_START(3)], data->t_low);
+  unpack_byte(&bits[BYTE_START(4)], data->parity);
+}
+
+/** dht11_retrieve_data_t mock returning mock_frame */
+static dht11_error_t mock_retrieve(uint8_t *const bit_array) {
+  memcpy(bit_array, mock_frame, DHT11_NUM_DATA_BITS);
+  return DHT11_ERROR_NONE;
+}
+
+static void *dht11_decode_setup(void) {
+  for (uint32_t idx = 0; idx < NUM_FRAMES; idx++) {
+    uint32_t rnd = next_random();
+    dht11_data_t *data = &expected[idx];
+
+    data->rh_high = 20 + rnd % 70;
+    data->rh_low = 0;
+    data->t_high = (rnd >> 8) % 50;
+    data->t_low = (rnd >> 16) % 10;
+    data->parity = data->rh_high + data->rh_low + data->t_high + data->t_low;
+    make_frame(valid_frames[idx], data);
+
+    // Flip one data bit so only the parity check can catch it
+    memcpy(corrupt_frames[idx], valid_frames[idx], DHT11_NUM_DATA_BITS);
+    corrupt_frames[idx][(rnd >> 24) % BYTE_START(4)] ^= 1;
+  }
+
+  return NULL;
+}
+
+static uint32_t bench_decode(uint8_t frames[][DHT11_NUM_DATA_BITS],
+                             dht11_error_t expect_err) {
+  dht11_data_t data;
+  uint32_t start = k_cycle_get_32();
+
+  for (uint32_t iter = 0; iter < BENCH_ITERATIONS; iter++) {
+    uint32_t idx = iter % NUM_FRAMES;
+
+    mock_frame = frames[idx];
+    if (dht11_get_data(mock_retrieve, &data) != expect_err ||
+        (!expect_err && memcmp(&data, &expected[idx], sizeof(data)))) {
+      result.errors++;
+    }
+  }
+
+  return (k_cycle_get_32() - start) / BENCH_ITERATIONS;
+}
+
+static void bench_entry(void *arg1, void *arg2, void *arg3) {
+  volatile uint8_t sink = 0;
+
+  result.decode_cycles = bench_decode(valid_frames, DHT11_ERROR_NONE);
+  result.parity_fail_cycles =
+      bench_decode(corrupt_frames, DHT11_ERROR_PARITY_CHECK_FAILED);
+
+  uint32_t start = k_cycle_get_32();
+
+  for (uint32_t iter = 0; iter < BENCH_ITERATIONS; iter++) {
+    sink += dht11_pack_bits(valid_frames[iter % NUM_FRAMES],
+                            BYTE_START(iter % 5));
+  }
+
+  result.pack_cycles = (k_cycle_get_32() - start) / BENCH_ITERATIONS;
+}
+
+/** Fail if value exceeds a recorded baseline by more than the tolerance,
+ * print the line to record it in boards/<board>.conf if there is none */
+static void check_baseline(const char *name, const char *option,
+                           uint32_t value, uint32_t baseline) {
+  if (!baseline) {
+    TC_PRINT("%s: %u, no baseline, record CONFIG_%s=%u\n", name, value,
+             option, value);
+    return;
+  }
+
+  uint32_t limit = baseline + baseline * CONFIG_BENCH_TOLERANCE_PCT / 100;
+
+  TC_PRINT("%s: %u, baseline %u, limit %u\n", name, value, baseline, limit);
+  zassert_true(value <= limit, "%s regressed: %u > %u", name, value, limit);
+}
+
+ZTEST(dht11_decode_suite, test_pack_bits_exhaustive) {
+  uint8_t bits[DHT11_NUM_DATA_BITS] = {0};
+
+  for (uint8_t byte = 0; byte < 5; byte++) {
+    for (uint32_t value = 0; value <= UINT8_MAX; value++) {
+      unpack_byte(&bits[BYTE_START(byte)], value);
+      zassert_equal(dht11_pack_bits(bits, BYTE_START(byte)), value);
+    }
+  }
+}
+
+ZTEST(dht11_decode_suite, test_decode_valid) {
+  dht11_data_t data;
+
+  for (uint32_t idx = 0; idx < NUM_FRAMES; idx++) {
+    mock_frame = valid_frames[idx];
+    zassert_ok(dht11_get_data(mock_retrieve, &data));
+    zassert_mem_equal(&data, &expected[idx], sizeof(data));
+  }
+}
+
+ZTEST(dht11_decode_suite, test_decode_parity_failure) {
+  dht11_data_t data;
+
+  for (uint32_t idx = 0; idx < NUM_FRAMES; idx++) {
+    mock_frame = corrupt_frames[idx];
+    zassert_equal(dht11_get_data(mock_retrieve, &data),
+                  DHT11_ERROR_PARITY_CHECK_FAILED);
+  }
+}
+
+/** dht11_retrieve_data_t mock failing after filling part of the frame */
+static dht11_error_t mock_retrieve_fail(uint8_t *const bit_array) {
+  memset(bit_array, 1, DHT11_NUM_DATA_BITS / 2);
+  return DHT11_ERROR_SETUP_FAILED;
+}
+
+ZTEST(dht11_decode_suite, test_retrieve_failure) {
+  dht11_data_t data;
+  dht11_data_t zero = {0};
+
+  // The partial frame must not be decoded
+  zassert_equal(dht11_get_data(mock_retrieve_fail, &data),
+                DHT11_ERROR_SETUP_FAILED);
+  zassert_mem_equal(&data, &zero, sizeof(data));
+}
+
+ZTEST(dht11_decode_suite, test_model_from_compatible) {
+  uint8_t dht11s = 0;
+  uint8_t dht22s = 0;
+
+  // One node of each model in the overlay, the DHT22 one lists custom,dht22
+  zassert_equal(dht11_instance_count(), 2);
+  for (uint8_t inst = 0; inst < dht11_instance_count(); inst++) {
+    dht11s += dht11_model_get(inst) == &dht11_model_dht11;
+    dht22s += dht11_model_get(inst) == &dht11_model_dht22;
+  }
+  zassert_equal(dht11s, 1);
+  zassert_equal(dht22s, 1);
+  zassert_is_null(dht11_model_get(dht11_instance_count()));
+}
+
+ZTEST(dht11_decode_suite, test_bench_decode) {
+  struct sys_memory_stats heap_before;
+  struct sys_memory_stats heap_after;
+  size_t unused = 0;
+
+  memset(&result, 0, sizeof(result));
+
+  sys_heap_runtime_stats_reset_max(&_system_heap.heap);
+  sys_heap_runtime_stats_get(&_system_heap.heap, &heap_before);
+
+  k_thread_create(&bench_thread, bench_stack,
+                  K_THREAD_STACK_SIZEOF(bench_stack), bench_entry, NULL, NULL,
+                  NULL, K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+  zassert_ok(k_thread_join(&bench_thread, K_FOREVER));
+
+  sys_heap_runtime_stats_get(&_system_heap.heap, &heap_after);
+  zassert_ok(k_thread_stack_space_get(&bench_thread, &unused));
+  result.stack_bytes = K_THREAD_STACK_SIZEOF(bench_stack) - unused;
+
+  zassert_equal(result.errors, 0, "%u frames decoded wrongly", result.errors);
+
+  // The decoder works on caller provided buffers only
+  TC_PRINT("heap: %u bytes peak during decode\n",
+           (uint32_t)(heap_after.max_allocated_bytes -
+                      heap_before.allocated_bytes));
+  zassert_equal(heap_after.max_allocated_bytes, heap_before.allocated_bytes,
+                "decode path allocated from the heap");
+
+  check_baseline("decode cycles/frame", "BENCH_BASELINE_DECODE_CYCLES",
+                 result.decode_cycles, CONFIG_BENCH_BASELINE_DECODE_CYCLES);
+  check_baseline("parity failure cycles/frame",
+                 "BENCH_BASELINE_PARITY_FAIL_CYCLES", result.parity_fail_cycles,
+                 CONFIG_BENCH_BASELINE_PARITY_FAIL_CYCLES);
+  check_baseline("pack_bits cycles/call", "BENCH_BASELINE_PACK_CYCLES",
+                 result.pack_cycles, CONFIG_BENCH_BASELINE_PACK_CYCLES);
+
+  // POSIX arch threads run on host stacks, the Zephyr one is barely touched
+  if (!IS_ENABLED(CONFIG_ARCH_POSIX)) {
+    check_baseline("stack bytes", "BENCH_BASELINE_STACK_BYTES",
+                   result.stack_bytes, CONFIG_BENCH_BASELINE_STACK_BYTES);
+  }
+}
+
+ZTEST_SUITE(dht11_decode_suite, NULL, dht11_decode_setup, NULL, NULL, NULL);
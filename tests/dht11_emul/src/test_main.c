@@ -0,0 +1,286 @@
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include <string.h>
+
+#include <dht11.h>
+#include <dht11_emul.h>
+#include <dht11_sched.h>
+
+/** Readings checked per waveform */
+#define NUM_READINGS 32
+
+/** Readings per jitter level of the benchmark */
+#define BENCH_READINGS 50
+
+/** Line of the emulated sensor, driven by hand for the short start */
+static const struct gpio_dt_spec dht11_gpio =
+    GPIO_DT_SPEC_GET(DT_NODELABEL(dht11_sensor), gpios);
+
+/** Jitter levels of the benchmark in us */
+static const uint16_t bench_jitter_us[] = {0, 5, 10, 15, 20, 25};
+
+static dht11_emul_config_t config;
+
+static uint32_t rand_state;
+
+static uint32_t next_rand(void) {
+  rand_state = rand_state * 1103515245 + 12345;
+  return rand_state >> 8;
+}
+
+static dht11_data_t random_reading(void) {
+  uint32_t rnd = next_rand();
+  dht11_data_t data = {
+      .rh_high = 20 + rnd % 70,
+      .t_high = (rnd >> 8) % 50,
+      .t_low = (rnd >> 16) % 10,
+  };
+
+  data.parity = data.rh_high + data.rh_low + data.t_high + data.t_low;
+
+  return data;
+}
+
+/** Read the emulated sensor while it sends reading */
+static dht11_error_t read_emulated(const dht11_data_t *reading,
+                                   dht11_data_t *data) {
+  zassert_ok(dht11_emul_set_data(0, reading));
+
+  return dht11_get_data_inst(0, data);
+}
+
+static void emul_apply(void) { zassert_ok(dht11_emul_configure(0, &config)); }
+
+static void *emul_setup(void) {
+  zassert_ok(dht11_init(IS_ENABLED(CONFIG_TEST_DHT11_EMUL_INTERRUPT)));
+  TC_PRINT("capture path: %s\n",
+           dht11_async_available() ? "interrupt" : "polling");
+
+  return NULL;
+}
+
+static void emul_before(void *fixture) {
+  dht11_emul_default_config(&config);
+  config.seed = 1;
+  emul_apply();
+  rand_state = 1;
+}
+
+ZTEST(dht11_emul_suite, test_nominal) {
+  dht11_emul_stats_t before;
+  dht11_emul_stats_t after;
+  dht11_data_t data;
+
+  zassert_ok(dht11_emul_get_stats(0, &before));
+
+  for (uint32_t idx = 0; idx < NUM_READINGS; idx++) {
+    dht11_data_t reading = random_reading();
+
+    zassert_ok(read_emulated(&reading, &data), "reading %u", idx);
+    zassert_mem_equal(&data, &reading, sizeof(data), "reading %u", idx);
+  }
+
+  // The final low outlasts the last edge the driver waits for
+  k_msleep(1);
+
+  zassert_ok(dht11_emul_get_stats(0, &after));
+  zassert_equal(after.starts - before.starts, NUM_READINGS);
+  zassert_equal(after.frames - before.frames, NUM_READINGS);
+  zassert_equal(after.short_starts, before.short_starts);
+  zassert_equal(after.long_starts, before.long_starts);
+}
+
+ZTEST(dht11_emul_suite, test_pulse_widths) {
+  // Short and long ends of what a sensor and its wiring produce
+  static const dht11_emul_config_t widths[] = {
+      {.response_us = 20, .ack_low_us = 75, .ack_high_us = 85,
+       .bit_low_us = 40, .zero_us = 20, .one_us = 75},
+      {.response_us = 40, .ack_low_us = 85, .ack_high_us = 90,
+       .bit_low_us = 60, .zero_us = 40, .one_us = 60},
+  };
+  dht11_data_t data;
+
+  for (size_t set = 0; set < ARRAY_SIZE(widths); set++) {
+    config = widths[set];
+    emul_apply();
+
+    for (uint32_t idx = 0; idx < NUM_READINGS; idx++) {
+      dht11_data_t reading = random_reading();
+
+      zassert_ok(read_emulated(&reading, &data), "set %zu reading %u", set,
+                 idx);
+      zassert_mem_equal(&data, &reading, sizeof(data), "set %zu reading %u",
+                        set, idx);
+    }
+  }
+}
+
+ZTEST(dht11_emul_suite, test_jitter) {
+  uint32_t rejected = 0;
+  dht11_data_t data;
+
+  config.jitter_us = 10;
+  emul_apply();
+
+  for (uint32_t idx = 0; idx < NUM_READINGS; idx++) {
+    dht11_data_t reading = random_reading();
+    dht11_error_t err = read_emulated(&reading, &data);
+
+    // Data bits stay clear of the threshold, only the preamble check of the
+    // polling path is tight enough to reject a frame
+    if (err == DHT11_ERROR_SETUP_FAILED && !dht11_async_available()) {
+      rejected++;
+      continue;
+    }
+
+    zassert_ok(err, "reading %u", idx);
+    zassert_mem_equal(&data, &reading, sizeof(data), "reading %u", idx);
+  }
+
+  TC_PRINT("+/-%u us: %u of %u preambles rejected\n", config.jitter_us,
+           rejected, NUM_READINGS);
+}
+
+ZTEST(dht11_emul_suite, test_bad_parity) {
+  dht11_data_t data;
+
+  config.bad_parity = true;
+  emul_apply();
+
+  for (uint32_t idx = 0; idx < NUM_READINGS; idx++) {
+    dht11_data_t reading = random_reading();
+
+    zassert_equal(read_emulated(&reading, &data),
+                  DHT11_ERROR_PARITY_CHECK_FAILED, "reading %u", idx);
+  }
+}
+
+ZTEST(dht11_emul_suite, test_dropped_edge) {
+  static const uint8_t drop_bits[] = {1, 9, 20, 33, 40};
+  dht11_data_t data;
+
+  for (size_t idx = 0; idx < ARRAY_SIZE(drop_bits); idx++) {
+    dht11_data_t reading = random_reading();
+
+    config.drop_bit = drop_bits[idx];
+    emul_apply();
+
+    // One high pulse short, the frame never completes
+    zassert_equal(read_emulated(&reading, &data), DHT11_ERROR_SETUP_FAILED,
+                  "bit %u", drop_bits[idx]);
+  }
+}
+
+ZTEST(dht11_emul_suite, test_silent) {
+  dht11_data_t data;
+
+  config.silent = true;
+  emul_apply();
+
+  zassert_equal(dht11_get_data_inst(0, &data),
+                DHT11_ERROR_HARDWARE_UNAVAILABLE);
+}
+
+ZTEST(dht11_emul_suite, test_short_start) {
+  dht11_emul_stats_t before;
+  dht11_emul_stats_t after;
+
+  zassert_ok(dht11_emul_get_stats(0, &before));
+
+  zassert_ok(gpio_pin_configure_dt(&dht11_gpio, GPIO_OUTPUT_INACTIVE));
+  k_msleep(5);
+  zassert_ok(gpio_pin_configure_dt(&dht11_gpio, GPIO_INPUT));
+  k_msleep(2);
+
+  zassert_ok(dht11_emul_get_stats(0, &after));
+  zassert_equal(after.short_starts - before.short_starts, 1);
+  zassert_equal(after.starts, before.starts);
+  zassert_equal(gpio_pin_get_dt(&dht11_gpio), 1, "line not released");
+}
+
+ZTEST(dht11_emul_suite, test_long_start) {
+  dht11_emul_stats_t before;
+  dht11_emul_stats_t after;
+
+  zassert_ok(dht11_emul_get_stats(0, &before));
+
+  zassert_ok(gpio_pin_configure_dt(&dht11_gpio, GPIO_OUTPUT_INACTIVE));
+  k_msleep(dht11_model_get(0)->start_max_ms + 2);
+  zassert_ok(gpio_pin_configure_dt(&dht11_gpio, GPIO_INPUT));
+  k_msleep(2);
+
+  zassert_ok(dht11_emul_get_stats(0, &after));
+  zassert_equal(after.long_starts - before.long_starts, 1);
+  zassert_equal(after.starts, before.starts);
+}
+
+ZTEST(dht11_emul_suite, test_sched_round) {
+  dht11_emul_stats_t before;
+  dht11_emul_stats_t after;
+  dht11_reading_t readings[DHT11_NUM_INSTANCES];
+  dht11_error_t errs[DHT11_NUM_INSTANCES];
+  dht11_data_t reading = random_reading();
+
+  if (!dht11_async_available()) {
+    ztest_test_skip();
+  }
+
+  zassert_ok(dht11_emul_set_data(0, &reading));
+  zassert_ok(dht11_emul_get_stats(0, &before));
+
+  // Every line must be held within the start signal its sensor answers
+  zassert_ok(dht11_sched_acquire_all(0, readings, errs));
+  zassert_ok(errs[0]);
+  zassert_mem_equal(&readings[0].data, &reading, sizeof(reading));
+
+  k_msleep(1);
+
+  zassert_ok(dht11_emul_get_stats(0, &after));
+  zassert_equal(after.starts - before.starts, 1);
+  zassert_equal(after.long_starts, before.long_starts);
+  zassert_equal(after.short_starts, before.short_starts);
+}
+
+ZTEST(dht11_emul_suite, test_bench_jitter) {
+  dht11_data_t data;
+
+  for (size_t level = 0; level < ARRAY_SIZE(bench_jitter_us); level++) {
+    uint32_t decoded = 0;
+    uint32_t wrong = 0;
+
+    config.jitter_us = bench_jitter_us[level];
+    config.seed = level + 1;
+    emul_apply();
+
+    uint32_t start = k_cycle_get_32();
+
+    for (uint32_t idx = 0; idx < BENCH_READINGS; idx++) {
+      dht11_data_t reading = random_reading();
+
+      if (read_emulated(&reading, &data) == DHT11_ERROR_NONE) {
+        decoded++;
+        wrong += memcmp(&data, &reading, sizeof(data)) != 0;
+      }
+    }
+
+    uint32_t us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+    TC_PRINT("+/-%2u us: %2u of %u decoded, %u us per reading\n",
+             config.jitter_us, decoded, BENCH_READINGS, us / BENCH_READINGS);
+
+    // A frame is rejected rather than decoded to the wrong reading.  Beyond
+    // +/-15 us a pulse can cross the 50 us threshold, and bits flipped in a
+    // way that still matches the parity byte go unnoticed.
+    if (config.jitter_us <= 15) {
+      zassert_equal(wrong, 0, "%u wrong readings at +/-%u us", wrong,
+                    config.jitter_us);
+    }
+    if (config.jitter_us == 0) {
+      zassert_equal(decoded, BENCH_READINGS);
+    }
+  }
+}
+
+ZTEST_SUITE(dht11_emul_suite, NULL, emul_setup, emul_before, NULL, NULL);
@@ -0,0 +1,58 @@
+#include <zephyr/kernel.h>
+
+#include <string.h>
+
+#include "mock_dht11.h"
+
+static const mock_attempt_t *script;
+static size_t script_len;
+static uint32_t calls;
+static int64_t call_ms[MOCK_MAX_CALLS];
+static k_tid_t last_thread;
+
+void mock_dht11_script(const mock_attempt_t *attempts, size_t count) {
+  script = attempts;
+  script_len = count;
+  calls = 0;
+}
+
+uint32_t mock_dht11_calls(void) { return calls; }
+
+int64_t mock_dht11_call_ms(uint32_t idx) { return call_ms[idx]; }
+
+k_tid_t mock_dht11_last_thread(void) { return last_thread; }
+
+// Every instance is a DHT11
+const dht11_model_t *dht11_model_get(uint8_t inst) {
+  return inst < DHT11_NUM_INSTANCES ? &dht11_model_dht11 : NULL;
+}
+
+// The reliability layer falls back to the polling path
+bool dht11_async_available(void) { return false; }
+
+dht11_error_t dht11_read_async(uint8_t inst, dht11_read_cb_t cb,
+                               void *user_data) {
+  return DHT11_ERROR_CONFIG_FAILURE;
+}
+
+dht11_error_t dht11_get_data_inst(uint8_t inst, dht11_data_t *data) {
+  uint32_t idx = calls++;
+
+  last_thread = k_current_get();
+
+  if (idx < MOCK_MAX_CALLS) {
+    call_ms[idx] = k_uptime_get();
+  }
+
+  memset(data, 0, sizeof(*data));
+
+  if (idx >= script_len) {
+    k_busy_wait(28000);
+    return DHT11_ERROR_HARDWARE_UNAVAILABLE;
+  }
+
+  k_busy_wait(script[idx].bus_us);
+  *data = script[idx].data;
+
+  return script[idx].err;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <zephyr/kernel.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <dht11.h>
+
+/** Most attempts recorded by the mock */
+#define MOCK_MAX_CALLS 16
+
+/** Scripted result of one conversion */
+typedef struct mock_attempt_s {
+  dht11_error_t err;
+  dht11_data_t data;
+  uint32_t bus_us; ///< Time the conversion occupies the bus
+} mock_attempt_t;
+
+/** Replace the script and clear the recorded calls.  Conversions beyond the
+ * script see no response. */
+void mock_dht11_script(const mock_attempt_t *attempts, size_t count);
+
+/** Conversions performed since the last mock_dht11_script() */
+uint32_t mock_dht11_calls(void);
+
+/** Uptime in ms at the start of a recorded conversion */
+int64_t mock_dht11_call_ms(uint32_t idx);
+
+/** Thread that performed the last conversion */
+k_tid_t mock_dht11_last_thread(void);
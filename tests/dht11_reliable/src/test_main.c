@@ -0,0 +1,287 @@
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include <string.h>
+
+#include <dht11.h>
+#include <dht11_reliable.h>
+
+#include "mock_dht11.h"
+
+/** Bus time of every scripted conversion in us */
+#define BUS_US 22000
+
+/** A plausible frame */
+#define VALID_DATA                                                             \
+  {.rh_high = 45, .t_high = 23, .t_low = 4, .parity = 45 + 23 + 4}
+
+typedef struct read_result_s {
+  struct k_sem done;
+  dht11_error_t err;
+  dht11_data_t data;
+} read_result_t;
+
+static read_result_t result;
+
+static void read_done(dht11_error_t err, const dht11_data_t *data,
+                      void *user_data) {
+  read_result_t *res = user_data;
+
+  res->err = err;
+  res->data = *data;
+  k_sem_give(&res->done);
+}
+
+/** Run a request against a script and return its result */
+static dht11_error_t scripted_read(const mock_attempt_t *attempts,
+                                   size_t count) {
+  mock_dht11_script(attempts, count);
+
+  zassert_ok(dht11_reliable_read(0, read_done, &result));
+  zassert_ok(k_sem_take(&result.done, K_SECONDS(10)));
+
+  return result.err;
+}
+
+static void *dht11_reliable_setup(void) {
+  k_sem_init(&result.done, 0, 1);
+  return NULL;
+}
+
+ZTEST(dht11_reliable_suite, test_first_attempt) {
+  const mock_attempt_t script[] = {{.data = VALID_DATA, .bus_us = BUS_US}};
+  const dht11_data_t expected = VALID_DATA;
+  dht11_reliable_stats_t before;
+  dht11_reliable_stats_t after;
+
+  dht11_reliable_get_stats(&before);
+
+  zassert_ok(scripted_read(script, ARRAY_SIZE(script)));
+  zassert_equal(mock_dht11_calls(), 1);
+  zassert_mem_equal(&result.data, &expected, sizeof(expected));
+
+  dht11_reliable_get_stats(&after);
+  zassert_equal(after.published - before.published, 1);
+  zassert_equal(after.requests - before.requests, 1);
+  zassert_equal(after.retries, before.retries);
+  zassert_equal(after.classes[DHT11_RELIABLE_CLASS_OK].count -
+                    before.classes[DHT11_RELIABLE_CLASS_OK].count,
+                1);
+}
+
+ZTEST(dht11_reliable_suite, test_polled_off_system_workq) {
+  const mock_attempt_t script[] = {{.data = VALID_DATA, .bus_us = BUS_US}};
+
+  // A polled conversion blocks for the frame
+  zassert_ok(scripted_read(script, ARRAY_SIZE(script)));
+  zassert_not_null(mock_dht11_last_thread());
+  zassert_not_equal(mock_dht11_last_thread(), &k_sys_work_q.thread);
+}
+
+ZTEST(dht11_reliable_suite, test_retries_respect_interval) {
+  const mock_attempt_t script[] = {
+      {.err = DHT11_ERROR_PARITY_CHECK_FAILED, .bus_us = BUS_US},
+      {.err = DHT11_ERROR_SETUP_FAILED, .bus_us = BUS_US},
+      {.data = VALID_DATA, .bus_us = BUS_US},
+  };
+  dht11_reliable_stats_t before;
+  dht11_reliable_stats_t after;
+
+  dht11_reliable_get_stats(&before);
+
+  zassert_ok(scripted_read(script, ARRAY_SIZE(script)));
+  zassert_equal(mock_dht11_calls(), 3);
+
+  for (uint32_t idx = 1; idx < 3; idx++) {
+    zassert_true(mock_dht11_call_ms(idx) - mock_dht11_call_ms(idx - 1) >=
+                     dht11_model_dht11.min_interval_ms,
+                 "attempt %u too early", idx);
+  }
+
+  dht11_reliable_get_stats(&after);
+  zassert_equal(after.retries - before.retries, 2);
+  zassert_equal(after.published - before.published, 1);
+  zassert_equal(after.classes[DHT11_RELIABLE_CLASS_PARITY].count -
+                    before.classes[DHT11_RELIABLE_CLASS_PARITY].count,
+                1);
+  zassert_equal(after.classes[DHT11_RELIABLE_CLASS_SETUP].count -
+                    before.classes[DHT11_RELIABLE_CLASS_SETUP].count,
+                1);
+}
+
+ZTEST(dht11_reliable_suite, test_gives_up) {
+  const mock_attempt_t script[] = {
+      {.err = DHT11_ERROR_PARITY_CHECK_FAILED, .bus_us = BUS_US},
+      {.err = DHT11_ERROR_PARITY_CHECK_FAILED, .bus_us = BUS_US},
+      {.err = DHT11_ERROR_PARITY_CHECK_FAILED, .bus_us = BUS_US},
+      {.data = VALID_DATA, .bus_us = BUS_US},
+  };
+  const dht11_data_t zero = {0};
+  dht11_reliable_stats_t before;
+  dht11_reliable_stats_t after;
+
+  dht11_reliable_get_stats(&before);
+
+  zassert_equal(scripted_read(script, ARRAY_SIZE(script)),
+                DHT11_ERROR_PARITY_CHECK_FAILED);
+  zassert_equal(mock_dht11_calls(), DHT11_RELIABLE_MAX_ATTEMPTS);
+  // Nothing of a failed request is published
+  zassert_mem_equal(&result.data, &zero, sizeof(zero));
+
+  dht11_reliable_get_stats(&after);
+  zassert_equal(after.published, before.published);
+  zassert_equal(after.requests - before.requests, 1);
+}
+
+ZTEST(dht11_reliable_suite, test_rejects_implausible) {
+  const mock_attempt_t script[] = {
+      {.data = {.rh_high = 120, .t_high = 20, .parity = 140},
+       .bus_us = BUS_US},
+      {.bus_us = BUS_US}, // All zero frame passes the parity check
+      {.data = VALID_DATA, .bus_us = BUS_US},
+  };
+  dht11_reliable_stats_t before;
+  dht11_reliable_stats_t after;
+
+  dht11_reliable_get_stats(&before);
+
+  zassert_ok(scripted_read(script, ARRAY_SIZE(script)));
+  zassert_equal(mock_dht11_calls(), 3);
+
+  dht11_reliable_get_stats(&after);
+  zassert_equal(after.classes[DHT11_RELIABLE_CLASS_RANGE].count -
+                    before.classes[DHT11_RELIABLE_CLASS_RANGE].count,
+                2);
+}
+
+ZTEST(dht11_reliable_suite, test_config_failure_not_retried) {
+  const mock_attempt_t script[] = {
+      {.err = DHT11_ERROR_CONFIG_FAILURE},
+      {.data = VALID_DATA, .bus_us = BUS_US},
+  };
+
+  zassert_equal(scripted_read(script, ARRAY_SIZE(script)),
+                DHT11_ERROR_CONFIG_FAILURE);
+  zassert_equal(mock_dht11_calls(), 1);
+}
+
+ZTEST(dht11_reliable_suite, test_one_request_per_instance) {
+  const mock_attempt_t script[] = {{.data = VALID_DATA, .bus_us = BUS_US}};
+  read_result_t other;
+
+  k_sem_init(&other.done, 0, 1);
+  mock_dht11_script(script, ARRAY_SIZE(script));
+
+  zassert_ok(dht11_reliable_read(0, read_done, &result));
+  zassert_equal(dht11_reliable_read(0, read_done, &other), DHT11_ERROR_BUSY);
+  zassert_equal(dht11_reliable_read(DHT11_NUM_INSTANCES, read_done, &other),
+                DHT11_ERROR_CONFIG_FAILURE);
+
+  zassert_ok(k_sem_take(&result.done, K_SECONDS(10)));
+  zassert_ok(result.err);
+}
+
+ZTEST(dht11_reliable_suite, test_validate) {
+  dht11_data_t data = VALID_DATA;
+
+  zassert_ok(dht11_reliable_validate(0, &data));
+
+  data.t_low = 10;
+  zassert_equal(dht11_reliable_validate(0, &data), DHT11_ERROR_OUT_OF_RANGE);
+
+  data = (dht11_data_t)VALID_DATA;
+  data.t_high = dht11_model_dht11.t_max_x10 / 10 + 1;
+  zassert_equal(dht11_reliable_validate(0, &data), DHT11_ERROR_OUT_OF_RANGE);
+
+  data = (dht11_data_t){0};
+  zassert_equal(dht11_reliable_validate(0, &data), DHT11_ERROR_OUT_OF_RANGE);
+  zassert_equal(dht11_reliable_validate(DHT11_NUM_INSTANCES, &data),
+                DHT11_ERROR_CONFIG_FAILURE);
+
+  zassert_equal(dht11_reliable_classify(DHT11_ERROR_BUSY),
+                DHT11_RELIABLE_CLASS_OTHER);
+  zassert_equal(dht11_reliable_classify(DHT11_ERROR_HARDWARE_UNAVAILABLE),
+                DHT11_RELIABLE_CLASS_NO_RESPONSE);
+}
+
+ZTEST(dht11_reliable_suite, test_models) {
+  // 23.4 C below zero, sign in bit 7 of the tenths byte
+  const dht11_data_t dht11_cold = {.rh_high = 45, .t_high = 23, .t_low = 0x84};
+  // 65.2 %, 35.1 C below zero, sign in bit 15 of the temperature
+  const dht11_data_t dht22_cold = {.rh_high = 0x02, .rh_low = 0x8C,
+                                   .t_high = 0x81, .t_low = 0x5F};
+  // 120.0 %
+  const dht11_data_t dht22_wet = {.rh_high = 0x04, .rh_low = 0xB0,
+                                  .t_high = 0x00, .t_low = 0xC8};
+  dht11_sample_t sample;
+
+  zassert_ok(dht11_model_sample(&dht11_model_dht11, &dht11_cold, &sample));
+  zassert_equal(sample.rh_x10, 450);
+  zassert_equal(sample.t_x10, -234);
+
+  zassert_ok(dht11_model_sample(&dht11_model_dht22, &dht22_cold, &sample));
+  zassert_equal(sample.rh_x10, 652);
+  zassert_equal(sample.t_x10, -351);
+
+  zassert_equal(dht11_model_sample(&dht11_model_dht22, &dht22_wet, &sample),
+                DHT11_ERROR_OUT_OF_RANGE);
+
+  // The same bytes mean different things to the two models
+  zassert_equal(dht11_model_sample(&dht11_model_dht11, &dht22_cold, &sample),
+                DHT11_ERROR_OUT_OF_RANGE);
+
+  zassert_true(dht11_model_dht22.start_ms < dht11_model_dht11.start_ms);
+  zassert_true(dht11_model_dht22.min_interval_ms >
+               dht11_model_dht11.min_interval_ms);
+}
+
+ZTEST(dht11_reliable_suite, test_percentiles) {
+  const mock_attempt_t script[] = {{.data = VALID_DATA, .bus_us = BUS_US}};
+  dht11_reliable_stats_t stats;
+
+  zassert_ok(scripted_read(script, ARRAY_SIZE(script)));
+
+  dht11_reliable_get_stats(&stats);
+
+  // Every valid conversion in this suite takes BUS_US
+  const dht11_reliable_class_stats_t *ok =
+      &stats.classes[DHT11_RELIABLE_CLASS_OK];
+
+  zassert_true(ok->p50_us >= BUS_US, "p50 %u", ok->p50_us);
+  zassert_true(ok->p50_us <= ok->p90_us && ok->p90_us <= ok->p99_us);
+  zassert_true(ok->p99_us <= ok->max_us);
+  zassert_true(ok->max_us < BUS_US + 2 * DHT11_RELIABLE_BUCKET_US,
+               "max %u", ok->max_us);
+  zassert_true(stats.samples_per_bus_s_mhz > 0);
+}
+
+// Runs last, ztest orders the tests by name
+ZTEST(dht11_reliable_suite, test_zz_absent_sensor) {
+  const mock_attempt_t script[] = {{.data = VALID_DATA, .bus_us = BUS_US}};
+  dht11_reliable_stats_t before;
+  dht11_reliable_stats_t after;
+
+  // No script, the sensor never answers
+  zassert_equal(scripted_read(NULL, 0), DHT11_ERROR_HARDWARE_UNAVAILABLE);
+  zassert_equal(mock_dht11_calls(), DHT11_RELIABLE_DOWN_THRESHOLD);
+
+  // Absent now, a request is a single probe
+  zassert_equal(scripted_read(NULL, 0), DHT11_ERROR_HARDWARE_UNAVAILABLE);
+  zassert_equal(mock_dht11_calls(), 1);
+
+  // The failed probe doubled the interval, the next request skips the bus
+  dht11_reliable_get_stats(&before);
+  zassert_equal(scripted_read(NULL, 0), DHT11_ERROR_HARDWARE_UNAVAILABLE);
+  zassert_equal(mock_dht11_calls(), 0);
+  dht11_reliable_get_stats(&after);
+  zassert_equal(after.skipped - before.skipped, 1);
+  zassert_equal(after.bus_ms, before.bus_ms);
+
+  // Once the probe is due the sensor is found again
+  k_msleep(2 * dht11_model_dht11.min_interval_ms);
+  zassert_ok(scripted_read(script, ARRAY_SIZE(script)));
+  zassert_equal(mock_dht11_calls(), 1);
+}
+
+ZTEST_SUITE(dht11_reliable_suite, NULL, dht11_reliable_setup, NULL, NULL,
+            NULL);
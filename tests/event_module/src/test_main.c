@@ -0,0 +1,96 @@
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include <event_module.h>
+
+/** Largest burst posted by the latency benchmark, below the pool size */
+#define BENCH_MAX_BURST 16
+
+/** Bursts posted per burst size */
+#define BENCH_ROUNDS 200
+
+static K_SEM_DEFINE(handled_sem, 0, BENCH_MAX_BURST);
+
+static uint32_t handled;
+static uint64_t latency_sum_cycles;
+static uint32_t latency_max_cycles;
+static uint32_t last_payload;
+
+static void bench_handler(const event_t *evt) {
+  uint32_t latency = k_cycle_get_32() - evt->post_cycles;
+
+  latency_sum_cycles += latency;
+  latency_max_cycles = MAX(latency_max_cycles, latency);
+  if (evt->len == sizeof(last_payload)) {
+    memcpy(&last_payload, evt->payload, sizeof(last_payload));
+  }
+  handled++;
+
+  k_sem_give(&handled_sem);
+}
+
+EVENT_HANDLER_DEFINE(test_bench_handler, EVENT_BUTTON_1S, bench_handler);
+
+static void *event_module_setup(void) {
+  event_module_init();
+  return NULL;
+}
+
+static void event_module_before(void *fixture) {
+  handled = 0;
+  latency_sum_cycles = 0;
+  latency_max_cycles = 0;
+  last_payload = 0;
+  k_sem_reset(&handled_sem);
+}
+
+ZTEST(event_module_suite, test_invalid_post) {
+  uint8_t big[EVENT_PAYLOAD_SIZE + 1] = {0};
+
+  zassert_equal(event_module_post(NO_EVENT, NULL, 0), -EINVAL);
+  zassert_equal(event_module_post(EVENT_MAX, NULL, 0), -EINVAL);
+  zassert_equal(event_module_post(EVENT_BUTTON_1S, big, sizeof(big)), -EINVAL);
+}
+
+ZTEST(event_module_suite, test_payload_delivered) {
+  uint32_t payload = 0xC0FFEE;
+
+  zassert_ok(event_module_post(EVENT_BUTTON_1S, &payload, sizeof(payload)));
+  zassert_ok(k_sem_take(&handled_sem, K_MSEC(100)));
+  zassert_equal(last_payload, payload);
+}
+
+ZTEST(event_module_suite, test_pool_peak) {
+  event_stats_t stats;
+  uint32_t payload = 1;
+
+  zassert_ok(event_module_post(EVENT_BUTTON_1S, &payload, sizeof(payload)));
+  zassert_ok(k_sem_take(&handled_sem, K_MSEC(100)));
+
+  event_module_get_stats(&stats);
+  zassert_between_inclusive(stats.pool_peak, 1, EVENT_POOL_SIZE);
+}
+
+ZTEST(event_module_suite, test_bench_latency) {
+  for (uint32_t burst = 1; burst <= BENCH_MAX_BURST; burst *= 2) {
+    event_module_before(NULL);
+
+    for (uint32_t round = 0; round < BENCH_ROUNDS; round++) {
+      for (uint32_t idx = 0; idx < burst; idx++) {
+        zassert_ok(event_module_post(EVENT_BUTTON_1S, &idx, sizeof(idx)));
+      }
+      for (uint32_t idx = 0; idx < burst; idx++) {
+        zassert_ok(k_sem_take(&handled_sem, K_MSEC(100)));
+      }
+    }
+
+    zassert_equal(handled, burst * BENCH_ROUNDS);
+
+    TC_PRINT("burst %2u: avg %u ns, max %u ns post to handler\n", burst,
+             (uint32_t)k_cyc_to_ns_floor64(latency_sum_cycles / handled),
+             (uint32_t)k_cyc_to_ns_floor64(latency_max_cycles));
+  }
+}
+
+ZTEST_SUITE(event_module_suite, NULL, event_module_setup, event_module_before,
+            NULL, NULL);
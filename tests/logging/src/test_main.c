@@ -0,0 +1,88 @@
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/logging/log_ctrl.h>
+#include <zephyr/ztest.h>
+
+#include <common.h>
+
+LOG_MODULE_REGISTER(logging_test, 3);
+
+/** Messages logged between two drains of the log buffer */
+#define BENCH_BATCH 16
+
+/** Batches per benchmark */
+#define BENCH_BATCHES 8
+
+/** Messages in a burst of identical errors */
+#define BURST_LEN 100
+
+static void drain(void) {
+  while (log_process()) {
+  }
+}
+
+static void logging_before(void *fixture) { drain(); }
+
+ZTEST(logging_suite, test_ratelimit_window) {
+  common_ratelimit_t rl = {0};
+  uint32_t suppressed = UINT32_MAX;
+
+  zassert_true(common_ratelimit(&rl, &suppressed));
+  zassert_equal(suppressed, 0);
+
+  for (uint32_t idx = 0; idx < 5; idx++) {
+    zassert_false(common_ratelimit(&rl, &suppressed));
+  }
+
+  k_msleep(CONFIG_APP_LOG_RATELIMIT_MS);
+
+  zassert_true(common_ratelimit(&rl, &suppressed));
+  zassert_equal(suppressed, 5);
+}
+
+static void log_burst(uint32_t len) {
+  for (uint32_t idx = 0; idx < len; idx++) {
+    COMMON_LOG_ERR_RATELIMIT("Error retrieving DHT11 data. Err=%d", 3);
+  }
+}
+
+ZTEST(logging_suite, test_ratelimit_burst) {
+  // One message gets through per window
+  log_burst(BURST_LEN);
+  zassert_equal(log_buffered_cnt(), 1);
+  drain();
+
+  // The next one reports the rest of the burst
+  k_msleep(CONFIG_APP_LOG_RATELIMIT_MS);
+  log_burst(1);
+  zassert_equal(log_buffered_cnt(), 2);
+  drain();
+}
+
+ZTEST(logging_suite, test_bench_log_cost) {
+  uint64_t front_cycles = 0;
+  uint64_t back_cycles = 0;
+
+  for (uint32_t batch = 0; batch < BENCH_BATCHES; batch++) {
+    uint32_t start = k_cycle_get_32();
+
+    for (uint32_t idx = 0; idx < BENCH_BATCH; idx++) {
+      COMMON_LOG_INF("RH=%d, T=%d, parity=%d", idx, batch, idx + batch);
+    }
+
+    uint32_t logged = k_cycle_get_32();
+
+    drain();
+
+    back_cycles += k_cycle_get_32() - logged;
+    front_cycles += logged - start;
+  }
+
+  // Front end is the cost to the caller, back end the deferred formatting and
+  // output done by the log thread
+  TC_PRINT("Per message: front end %u cycles, back end %u cycles\n",
+           (uint32_t)(front_cycles / (BENCH_BATCH * BENCH_BATCHES)),
+           (uint32_t)(back_cycles / (BENCH_BATCH * BENCH_BATCHES)));
+}
+
+ZTEST_SUITE(logging_suite, NULL, NULL, logging_before, NULL, NULL);
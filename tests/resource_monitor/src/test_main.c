@@ -0,0 +1,148 @@
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include <string.h>
+
+#include <resource_monitor.h>
+
+/** Stack of each test thread */
+#define TEST_STACK_SIZE 1024
+
+/** Stack depth marked for the deep thread, over the 80 % default threshold */
+#define DEEP_USE 900
+
+/** Busy time of the busy thread, most of the sampling period */
+#define BUSY_US 50000
+
+static K_THREAD_STACK_DEFINE(deep_stack, TEST_STACK_SIZE);
+static K_THREAD_STACK_DEFINE(shallow_stack, TEST_STACK_SIZE);
+static K_THREAD_STACK_DEFINE(busy_stack, TEST_STACK_SIZE);
+
+static struct k_thread deep_thread;
+static struct k_thread shallow_thread;
+static struct k_thread busy_thread;
+
+/** Never given, parks the test threads once they are done */
+static K_SEM_DEFINE(park_sem, 0, 1);
+
+static resource_monitor_thread_t threads[CONFIG_APP_RESOURCE_MONITOR_THREADS];
+
+static void park_entry(void *p1, void *p2, void *p3) {
+  k_sem_take(&park_sem, K_FOREVER);
+}
+
+static void busy_entry(void *p1, void *p2, void *p3) {
+  k_busy_wait(BUSY_US);
+  k_sem_take(&park_sem, K_FOREVER);
+}
+
+static k_tid_t start(struct k_thread *thread, k_thread_stack_t *stack,
+                     k_thread_entry_t entry, const char *name) {
+  k_tid_t tid = k_thread_create(thread, stack, TEST_STACK_SIZE, entry, NULL,
+                                NULL, NULL, K_PRIO_PREEMPT(1), 0, K_NO_WAIT);
+
+  k_thread_name_set(tid, name);
+
+  return tid;
+}
+
+/** Usage of a thread in the last sample, NULL if it is not in it */
+static const resource_monitor_thread_t *find(const char *name) {
+  size_t count = resource_monitor_get(threads, ARRAY_SIZE(threads));
+
+  for (size_t idx = 0; idx < count; idx++) {
+    if (!strcmp(threads[idx].name, name)) {
+      return &threads[idx];
+    }
+  }
+
+  return NULL;
+}
+
+ZTEST(resource_monitor_suite, test_stack_peak) {
+  const resource_monitor_thread_t *usage;
+  resource_monitor_stats_t before;
+  resource_monitor_stats_t after;
+
+  start(&deep_thread, deep_stack, park_entry, "deep");
+  start(&shallow_thread, shallow_stack, park_entry, "shallow");
+  k_msleep(1);
+
+  // native_sim runs threads on host stacks, so the depth is marked directly:
+  // the high-water mark is the first byte above the painted bottom that
+  // lost its paint
+  uint8_t *mark = (uint8_t *)deep_thread.stack_info.start +
+                  deep_thread.stack_info.size - DEEP_USE;
+  *mark = 0;
+
+  resource_monitor_get_stats(&before);
+  resource_monitor_sample();
+  resource_monitor_get_stats(&after);
+
+  usage = find("deep");
+  zassert_not_null(usage);
+  zassert_equal(usage->stack_size, deep_thread.stack_info.size);
+  zassert_equal(usage->stack_peak, DEEP_USE, "peak %u", usage->stack_peak);
+  zassert_true(usage->stack_warn);
+
+  usage = find("shallow");
+  zassert_not_null(usage);
+  zassert_true(usage->stack_peak < usage->stack_size / 2, "peak %u",
+               usage->stack_peak);
+  zassert_false(usage->stack_warn);
+
+  zassert_equal(after.samples, before.samples + 1);
+  zassert_equal(after.stack_warnings, before.stack_warnings + 1);
+
+  // The deep thread stays over the threshold but is only reported once
+  resource_monitor_sample();
+  resource_monitor_get_stats(&before);
+  zassert_equal(before.stack_warnings, after.stack_warnings);
+  zassert_true(find("deep")->stack_warn);
+
+  k_thread_abort(&deep_thread);
+  k_thread_abort(&shallow_thread);
+}
+
+ZTEST(resource_monitor_suite, test_cpu_share) {
+  const resource_monitor_thread_t *usage;
+  resource_monitor_stats_t before;
+  resource_monitor_stats_t after;
+  uint32_t total = 0;
+
+  resource_monitor_sample();
+  resource_monitor_get_stats(&before);
+
+  start(&busy_thread, busy_stack, busy_entry, "busy");
+  k_usleep(BUSY_US + BUSY_US / 10);
+
+  resource_monitor_sample();
+  resource_monitor_get_stats(&after);
+
+  usage = find("busy");
+  zassert_not_null(usage);
+  zassert_true(usage->cpu_permille >= 700, "busy %u", usage->cpu_permille);
+  zassert_true(usage->cpu_warn);
+  zassert_equal(after.cpu_warnings, before.cpu_warnings + 1);
+
+  // The shares of a period add up to the whole of it
+  size_t count = resource_monitor_get(threads, ARRAY_SIZE(threads));
+
+  for (size_t idx = 0; idx < count; idx++) {
+    total += threads[idx].cpu_permille;
+  }
+  zassert_between_inclusive(total, 1000 - count, 1000 + count);
+
+  k_thread_abort(&busy_thread);
+}
+
+ZTEST(resource_monitor_suite, test_get_truncated) {
+  resource_monitor_thread_t one;
+
+  resource_monitor_sample();
+
+  zassert_equal(resource_monitor_get(&one, 1), 1);
+  zassert_true(strlen(one.name) < RESOURCE_MONITOR_NAME_LEN);
+}
+
+ZTEST_SUITE(resource_monitor_suite, NULL, NULL, NULL, NULL, NULL);
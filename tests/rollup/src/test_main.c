@@ -0,0 +1,242 @@
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include <rollup.h>
+
+/** Interval of the generated samples, not a divisor of a minute */
+#define SAMPLE_S 7
+
+/** Samples over 25 hours, past the reach of the hour tier */
+#define SERIES_SAMPLES (25 * ROLLUP_HOUR_S / SAMPLE_S)
+
+/** Random ranges checked against a scan of the raw samples */
+#define RANDOM_QUERIES 500
+
+/** Queries timed by the benchmark */
+#define BENCH_QUERIES 1000
+
+typedef struct raw_sample_s {
+  uint32_t time_s;
+  int16_t rh_x10;
+  int16_t t_x10;
+} raw_sample_t;
+
+static ROLLUP_DEFINE(rollup);
+
+static raw_sample_t series[SERIES_SAMPLES];
+
+static uint32_t rand_state;
+
+static uint32_t next_rand(void) {
+  rand_state = rand_state * 1103515245 + 12345;
+  return rand_state >> 8;
+}
+
+/** Fill the series with a random walk and add it to the rollup */
+static void add_series(void) {
+  int16_t rh = 450;
+  int16_t temp = 200;
+
+  for (uint32_t idx = 0; idx < SERIES_SAMPLES; idx++) {
+    rh = CLAMP(rh + (int16_t)(next_rand() % 21) - 10, 200, 900);
+    temp = CLAMP(temp + (int16_t)(next_rand() % 11) - 5, -100, 400);
+
+    series[idx] = (raw_sample_t){idx * SAMPLE_S, rh, temp};
+    rollup_add(&rollup, series[idx].time_s, rh, temp);
+  }
+}
+
+/** Statistics of the raw samples in a range, for comparison */
+static uint32_t scan_series(uint32_t from_s, uint32_t to_s,
+                            rollup_stats_t *stats) {
+  int64_t rh_sum = 0;
+  int64_t t_sum = 0;
+
+  *stats = (rollup_stats_t){
+      .rh_min = INT16_MAX,
+      .rh_max = INT16_MIN,
+      .t_min = INT16_MAX,
+      .t_max = INT16_MIN,
+  };
+
+  for (uint32_t idx = 0; idx < SERIES_SAMPLES; idx++) {
+    const raw_sample_t *sample = &series[idx];
+
+    if (sample->time_s < from_s || sample->time_s >= to_s) {
+      continue;
+    }
+
+    stats->count++;
+    rh_sum += sample->rh_x10;
+    t_sum += sample->t_x10;
+    stats->rh_min = MIN(stats->rh_min, sample->rh_x10);
+    stats->rh_max = MAX(stats->rh_max, sample->rh_x10);
+    stats->t_min = MIN(stats->t_min, sample->t_x10);
+    stats->t_max = MAX(stats->t_max, sample->t_x10);
+  }
+
+  if (stats->count) {
+    // Positive in this series, so rounding half up is rounding to nearest
+    stats->rh_avg = (rh_sum + stats->count / 2) / stats->count;
+    stats->t_avg = t_sum >= 0 ? (t_sum + stats->count / 2) / stats->count
+                              : (t_sum - stats->count / 2) / stats->count;
+  }
+
+  return stats->count;
+}
+
+static void rollup_before(void *fixture) {
+  rollup_reset(&rollup);
+  rand_state = 1;
+}
+
+ZTEST(rollup_suite, test_empty) {
+  rollup_stats_t stats;
+
+  zassert_equal(rollup_query(&rollup, 0, UINT32_MAX, &stats), -ENOENT);
+  zassert_equal(rollup_query(&rollup, 10, 10, &stats), -EINVAL);
+}
+
+ZTEST(rollup_suite, test_one_minute) {
+  rollup_stats_t stats;
+
+  rollup_add(&rollup, 125, 400, 210);
+  rollup_add(&rollup, 130, 430, 190);
+  rollup_add(&rollup, 179, 420, 230);
+  rollup_add(&rollup, 180, 999, 999);
+
+  zassert_ok(rollup_query(&rollup, 120, 180, &stats));
+  zassert_equal(stats.from_s, 120);
+  zassert_equal(stats.to_s, 180);
+  zassert_equal(stats.count, 3);
+  zassert_equal(stats.rh_min, 400);
+  zassert_equal(stats.rh_max, 430);
+  zassert_equal(stats.rh_avg, 417);
+  zassert_equal(stats.t_min, 190);
+  zassert_equal(stats.t_max, 230);
+  zassert_equal(stats.t_avg, 210);
+
+  // Part of a retained minute is rounded out to the whole minute
+  zassert_ok(rollup_query(&rollup, 130, 131, &stats));
+  zassert_equal(stats.from_s, 120);
+  zassert_equal(stats.to_s, 180);
+  zassert_equal(stats.count, 3);
+}
+
+ZTEST(rollup_suite, test_out_of_order) {
+  rollup_stats_t stats;
+
+  rollup_add(&rollup, 1000, 500, 200);
+  rollup_add(&rollup, 10, 300, 100);
+
+  zassert_ok(rollup_query(&rollup, 0, 1060, &stats));
+  zassert_equal(stats.count, 2);
+  zassert_equal(stats.rh_min, 300);
+  zassert_equal(stats.t_max, 200);
+}
+
+ZTEST(rollup_suite, test_exact_ranges) {
+  rollup_stats_t stats;
+  rollup_stats_t expected;
+  uint32_t end_s = SERIES_SAMPLES * SAMPLE_S;
+
+  add_series();
+
+  // Last half hour in minutes, the last 20 whole hours, everything
+  const uint32_t ranges[][2] = {
+      {ROUND_DOWN(end_s, 60) - 1800, ROUND_DOWN(end_s, 60)},
+      {ROUND_DOWN(end_s, 3600) - 20 * 3600, ROUND_DOWN(end_s, 3600)},
+      {0, end_s},
+  };
+
+  for (uint8_t idx = 0; idx < ARRAY_SIZE(ranges); idx++) {
+    zassert_ok(rollup_query(&rollup, ranges[idx][0], ranges[idx][1], &stats));
+    zassert_equal(stats.from_s, ranges[idx][0], "range %u", idx);
+    zassert_true(stats.to_s >= ranges[idx][1], "range %u", idx);
+
+    zassert_equal(scan_series(ranges[idx][0], ranges[idx][1], &expected),
+                  stats.count, "range %u", idx);
+    zassert_equal(stats.rh_min, expected.rh_min, "range %u", idx);
+    zassert_equal(stats.rh_max, expected.rh_max, "range %u", idx);
+    zassert_equal(stats.rh_avg, expected.rh_avg, "range %u", idx);
+    zassert_equal(stats.t_min, expected.t_min, "range %u", idx);
+    zassert_equal(stats.t_max, expected.t_max, "range %u", idx);
+    zassert_equal(stats.t_avg, expected.t_avg, "range %u", idx);
+  }
+}
+
+ZTEST(rollup_suite, test_random_ranges) {
+  rollup_stats_t stats;
+  rollup_stats_t expected;
+  uint32_t end_s = SERIES_SAMPLES * SAMPLE_S;
+
+  add_series();
+
+  // Whatever the range, the result is that of the raw samples in the range
+  // reported as covered, and the covered range holds the requested one
+  for (uint32_t query = 0; query < RANDOM_QUERIES; query++) {
+    uint32_t from_s = next_rand() % end_s;
+    uint32_t to_s = from_s + 1 + next_rand() % (end_s - from_s);
+
+    if (rollup_query(&rollup, from_s, to_s, &stats)) {
+      zassert_equal(scan_series(from_s, to_s, &expected), 0);
+      continue;
+    }
+
+    zassert_true(stats.from_s <= from_s, "[%u, %u)", from_s, to_s);
+    zassert_true(stats.to_s >= to_s || stats.to_s >= end_s, "[%u, %u)",
+                 from_s, to_s);
+
+    scan_series(stats.from_s, stats.to_s, &expected);
+    zassert_equal(stats.count, expected.count, "[%u, %u)", from_s, to_s);
+    zassert_equal(stats.rh_min, expected.rh_min, "[%u, %u)", from_s, to_s);
+    zassert_equal(stats.rh_max, expected.rh_max, "[%u, %u)", from_s, to_s);
+    zassert_equal(stats.rh_avg, expected.rh_avg, "[%u, %u)", from_s, to_s);
+    zassert_equal(stats.t_min, expected.t_min, "[%u, %u)", from_s, to_s);
+    zassert_equal(stats.t_max, expected.t_max, "[%u, %u)", from_s, to_s);
+    zassert_equal(stats.t_avg, expected.t_avg, "[%u, %u)", from_s, to_s);
+  }
+}
+
+ZTEST(rollup_suite, test_rounds_out_past_retention) {
+  rollup_stats_t stats;
+  uint32_t end_s = SERIES_SAMPLES * SAMPLE_S;
+
+  add_series();
+
+  // Minutes of two hours ago are gone, their hour answers
+  uint32_t hour_s = ROUND_DOWN(end_s, 3600) - 2 * 3600;
+
+  zassert_ok(rollup_query(&rollup, hour_s + 1800, hour_s + 2700, &stats));
+  zassert_equal(stats.from_s, hour_s);
+  zassert_equal(stats.to_s, hour_s + 3600);
+
+  // The first hour is past the hour tier too, its day answers
+  zassert_ok(rollup_query(&rollup, 600, 1200, &stats));
+  zassert_equal(stats.from_s, 0);
+  zassert_equal(stats.to_s, ROLLUP_DAY_S);
+}
+
+ZTEST(rollup_suite, test_bench) {
+  rollup_stats_t stats;
+
+  uint32_t start = k_cycle_get_32();
+
+  add_series();
+
+  uint32_t add_cycles = k_cycle_get_32() - start;
+
+  start = k_cycle_get_32();
+  for (uint32_t query = 0; query < BENCH_QUERIES; query++) {
+    rollup_query(&rollup, 0, SERIES_SAMPLES * SAMPLE_S, &stats);
+  }
+
+  uint32_t query_cycles = k_cycle_get_32() - start;
+
+  TC_PRINT("add: %u cycles/sample (random walk included)\n",
+           add_cycles / SERIES_SAMPLES);
+  TC_PRINT("query of 25 h: %u cycles, %zu B of buckets\n",
+           query_cycles / BENCH_QUERIES, sizeof(rollup.buckets));
+}
+
+ZTEST_SUITE(rollup_suite, NULL, NULL, rollup_before, NULL, NULL);
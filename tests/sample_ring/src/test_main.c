@@ -0,0 +1,220 @@
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include <sample_ring.h>
+
+/** Samples pushed by each benchmark */
+#define BENCH_SAMPLES 100000
+
+/** Readers attached during the multi reader benchmark */
+#define BENCH_READERS 4
+
+/** Samples pushed from the timer in the concurrent test */
+#define CONCURRENT_SAMPLES 20000
+
+/** Every fourth burst of the timer overruns the ring */
+#define CONCURRENT_BURST 3
+#define CONCURRENT_OVERRUN_BURST (SAMPLE_RING_CAPACITY + 8)
+
+static SAMPLE_RING_DEFINE(ring);
+
+/** Samples pushed by writer_expiry() */
+static atomic_t writer_pushed;
+static uint32_t writer_bursts;
+
+static sample_ring_sample_t make_sample(uint32_t idx) {
+  sample_ring_sample_t sample = {
+      .timestamp_ms = idx,
+      .data = {.rh_x10 = idx & 0x7FFF, .t_x10 = (idx >> 15) & 0x7FFF},
+      .inst = 0,
+  };
+  return sample;
+}
+
+// Every field of a sample follows from its index, see make_sample()
+static bool sample_is_whole(const sample_ring_sample_t *sample) {
+  uint32_t idx = (uint32_t)sample->timestamp_ms;
+
+  return sample->seq == idx && sample->data.rh_x10 == (idx & 0x7FFF) &&
+         sample->data.t_x10 == ((idx >> 15) & 0x7FFF) && sample->inst == 0;
+}
+
+// Producer of the concurrent test, preempts the reader from the timer ISR
+static void writer_expiry(struct k_timer *timer) {
+  uint32_t burst = writer_bursts++ % 4 == 3 ? CONCURRENT_OVERRUN_BURST
+                                             : CONCURRENT_BURST;
+  uint32_t idx = (uint32_t)atomic_get(&writer_pushed);
+
+  for (uint32_t end = MIN(idx + burst, CONCURRENT_SAMPLES); idx < end; idx++) {
+    sample_ring_sample_t in = make_sample(idx);
+    sample_ring_push(&ring, &in);
+  }
+
+  atomic_set(&writer_pushed, idx);
+  if (idx == CONCURRENT_SAMPLES) {
+    k_timer_stop(timer);
+  }
+}
+
+static K_TIMER_DEFINE(writer_timer, writer_expiry, NULL);
+
+static void *sample_ring_setup(void) { return NULL; }
+
+static void sample_ring_before(void *fixture) {
+  memset(&ring, 0, sizeof(ring));
+}
+
+ZTEST(sample_ring_suite, test_empty) {
+  sample_ring_reader_t reader;
+  sample_ring_sample_t sample;
+
+  sample_ring_reader_init(&ring, &reader);
+  zassert_equal(sample_ring_pop(&ring, &reader, &sample), -EAGAIN);
+}
+
+ZTEST(sample_ring_suite, test_readers_are_independent) {
+  sample_ring_reader_t early;
+  sample_ring_reader_t late;
+  sample_ring_sample_t sample;
+
+  sample_ring_reader_init(&ring, &early);
+  for (uint32_t idx = 0; idx < 4; idx++) {
+    sample_ring_sample_t in = make_sample(idx);
+    sample_ring_push(&ring, &in);
+  }
+  sample_ring_reader_init(&ring, &late);
+
+  for (uint32_t idx = 0; idx < 4; idx++) {
+    zassert_ok(sample_ring_pop(&ring, &early, &sample));
+    zassert_equal(sample.timestamp_ms, idx);
+    zassert_equal(sample.seq, idx);
+  }
+  zassert_equal(sample_ring_pop(&ring, &late, &sample), -EAGAIN);
+  zassert_equal(early.overruns, 0);
+}
+
+ZTEST(sample_ring_suite, test_latest) {
+  sample_ring_reader_t reader;
+  sample_ring_sample_t sample;
+
+  zassert_equal(sample_ring_latest(&ring, &sample), -EAGAIN);
+
+  sample_ring_reader_init(&ring, &reader);
+  for (uint32_t idx = 0; idx < SAMPLE_RING_CAPACITY + 3; idx++) {
+    sample_ring_sample_t in = make_sample(idx);
+    sample_ring_push(&ring, &in);
+
+    zassert_ok(sample_ring_latest(&ring, &sample));
+    zassert_equal(sample.timestamp_ms, idx);
+  }
+
+  // Peeking does not consume anything
+  zassert_equal(sample_ring_pending(&ring, &reader), SAMPLE_RING_CAPACITY + 3);
+}
+
+ZTEST(sample_ring_suite, test_overrun_is_detected) {
+  sample_ring_reader_t reader;
+  sample_ring_sample_t sample;
+  uint32_t pushed = SAMPLE_RING_CAPACITY * 3 + 5;
+
+  sample_ring_reader_init(&ring, &reader);
+  for (uint32_t idx = 0; idx < pushed; idx++) {
+    sample_ring_sample_t in = make_sample(idx);
+    sample_ring_push(&ring, &in);
+  }
+
+  zassert_ok(sample_ring_pop(&ring, &reader, &sample));
+  zassert_equal(sample.timestamp_ms, pushed - SAMPLE_RING_CAPACITY);
+  zassert_equal(reader.overruns, pushed - SAMPLE_RING_CAPACITY);
+  zassert_equal(sample_ring_pending(&ring, &reader), SAMPLE_RING_CAPACITY - 1);
+}
+
+ZTEST(sample_ring_suite, test_preempting_writer) {
+  sample_ring_reader_t reader;
+  sample_ring_sample_t sample;
+  uint32_t next_seq = 0;
+  uint32_t received = 0;
+  uint32_t skipped = 0;
+  uint32_t torn = 0;
+
+  atomic_set(&writer_pushed, 0);
+  writer_bursts = 0;
+  sample_ring_reader_init(&ring, &reader);
+  k_timer_start(&writer_timer, K_MSEC(1), K_MSEC(1));
+
+  while (atomic_get(&writer_pushed) < CONCURRENT_SAMPLES ||
+         sample_ring_pending(&ring, &reader)) {
+    if (sample_ring_pop(&ring, &reader, &sample)) {
+      // Lets time pass on native_sim so the timer fires
+      k_busy_wait(10);
+      continue;
+    }
+
+    torn += !sample_is_whole(&sample);
+    zassert_true(sample.seq >= next_seq, "sample %u read after %u",
+                 sample.seq, next_seq - 1);
+    skipped += sample.seq - next_seq;
+    next_seq = sample.seq + 1;
+    received++;
+  }
+
+  TC_PRINT("concurrent: %u received, %u overruns\n", received,
+           reader.overruns);
+  zassert_equal(torn, 0, "%u torn samples returned", torn);
+  zassert_true(reader.overruns > 0, "no burst overran the reader");
+  zassert_equal(reader.overruns, skipped);
+  zassert_equal(received + reader.overruns, CONCURRENT_SAMPLES);
+}
+
+ZTEST(sample_ring_suite, test_bench_push) {
+  sample_ring_sample_t in = make_sample(0);
+  uint64_t start = k_cycle_get_64();
+
+  for (uint32_t idx = 0; idx < BENCH_SAMPLES; idx++) {
+    in.timestamp_ms = idx;
+    sample_ring_push(&ring, &in);
+  }
+
+  uint64_t cycles = k_cycle_get_64() - start;
+
+  TC_PRINT("push: %u samples in %llu ns, %llu ns/sample\n", BENCH_SAMPLES,
+           k_cyc_to_ns_floor64(cycles),
+           k_cyc_to_ns_floor64(cycles) / BENCH_SAMPLES);
+}
+
+ZTEST(sample_ring_suite, test_bench_push_pop) {
+  sample_ring_reader_t readers[BENCH_READERS];
+  sample_ring_sample_t in = make_sample(0);
+  sample_ring_sample_t out;
+  uint64_t pop_cycles = 0;
+
+  for (uint8_t idx = 0; idx < BENCH_READERS; idx++) {
+    sample_ring_reader_init(&ring, &readers[idx]);
+  }
+
+  uint64_t start = k_cycle_get_64();
+
+  for (uint32_t idx = 0; idx < BENCH_SAMPLES; idx++) {
+    in.timestamp_ms = idx;
+    sample_ring_push(&ring, &in);
+
+    uint64_t pop_start = k_cycle_get_64();
+    for (uint8_t reader = 0; reader < BENCH_READERS; reader++) {
+      zassert_ok(sample_ring_pop(&ring, &readers[reader], &out));
+    }
+    pop_cycles += k_cycle_get_64() - pop_start;
+  }
+
+  uint64_t cycles = k_cycle_get_64() - start;
+
+  for (uint8_t idx = 0; idx < BENCH_READERS; idx++) {
+    zassert_equal(readers[idx].overruns, 0);
+  }
+
+  TC_PRINT("push + %d pops: %u samples in %llu ns, %llu ns/pop\n",
+           BENCH_READERS, BENCH_SAMPLES, k_cyc_to_ns_floor64(cycles),
+           k_cyc_to_ns_floor64(pop_cycles) / (BENCH_SAMPLES * BENCH_READERS));
+}
+
+ZTEST_SUITE(sample_ring_suite, NULL, sample_ring_setup, sample_ring_before,
+            NULL, NULL);
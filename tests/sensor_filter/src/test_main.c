@@ -0,0 +1,232 @@
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <sensor_filter.h>
+
+/** Samples of the random series */
+#define SERIES_SAMPLES 1000
+
+/** Samples timed by the benchmark */
+#define BENCH_SAMPLES 10000
+
+/** Level of the steady input, 25.0 */
+#define LEVEL 250
+
+static sensor_filter_t filter;
+
+static int16_t series[SERIES_SAMPLES];
+
+static uint32_t rand_state;
+
+static uint32_t next_rand(void) {
+  rand_state = rand_state * 1103515245 + 12345;
+  return rand_state >> 8;
+}
+
+/** Random walk in whole units, as a DHT11 reports, with small steps */
+static void fill_series(void) {
+  int16_t val = 450;
+
+  for (uint32_t idx = 0; idx < SERIES_SAMPLES; idx++) {
+    val = CLAMP(val + 10 * ((int16_t)(next_rand() % 3) - 1), 200, 900);
+    series[idx] = val;
+  }
+}
+
+static void filter_before(void *fixture) {
+  sensor_filter_reset(&filter);
+  rand_state = 1;
+}
+
+ZTEST(sensor_filter_suite, test_steady) {
+  int16_t out;
+
+  for (uint32_t idx = 0; idx < 20; idx++) {
+    zassert_ok(sensor_filter_apply(&filter, LEVEL, &out));
+    zassert_equal(out, LEVEL, "sample %u", idx);
+  }
+}
+
+ZTEST(sensor_filter_suite, test_passthrough) {
+  int16_t out;
+
+  if (SENSOR_FILTER_SPIKE || SENSOR_FILTER_MEDIAN || SENSOR_FILTER_EMA) {
+    ztest_test_skip();
+  }
+
+  zassert_equal(sizeof(sensor_filter_t), 0, "disabled stages take RAM");
+
+  fill_series();
+  for (uint32_t idx = 0; idx < SERIES_SAMPLES; idx++) {
+    zassert_ok(sensor_filter_apply(&filter, series[idx], &out));
+    zassert_equal(out, series[idx], "sample %u", idx);
+  }
+}
+
+ZTEST(sensor_filter_suite, test_spike) {
+#if SENSOR_FILTER_SPIKE
+  const int16_t spike = LEVEL + CONFIG_APP_FILTER_SPIKE_X10 + 10;
+  int16_t out;
+
+  for (uint32_t idx = 0; idx < 5; idx++) {
+    zassert_ok(sensor_filter_apply(&filter, LEVEL, &out));
+  }
+
+  // Isolated spikes, up and down
+  zassert_equal(sensor_filter_apply(&filter, spike, &out), -EAGAIN);
+  zassert_ok(sensor_filter_apply(&filter, LEVEL, &out));
+  zassert_equal(sensor_filter_apply(&filter, LEVEL - (spike - LEVEL), &out),
+                -EAGAIN);
+  zassert_ok(sensor_filter_apply(&filter, LEVEL, &out));
+  zassert_equal(out, LEVEL);
+
+  // Spikes at different levels do not add up to a step
+  for (uint32_t idx = 0; idx < CONFIG_APP_FILTER_SPIKE_CONFIRM; idx++) {
+    int16_t level = idx % 2 ? spike : LEVEL - (spike - LEVEL);
+
+    zassert_equal(sensor_filter_apply(&filter, level, &out), -EAGAIN);
+  }
+
+  // A step is taken once confirmed
+  zassert_ok(sensor_filter_apply(&filter, LEVEL, &out));
+  for (uint32_t idx = 1; idx < CONFIG_APP_FILTER_SPIKE_CONFIRM; idx++) {
+    zassert_equal(sensor_filter_apply(&filter, spike, &out), -EAGAIN);
+  }
+  zassert_ok(sensor_filter_apply(&filter, spike, &out));
+  zassert_ok(sensor_filter_apply(&filter, spike, &out));
+#else
+  ztest_test_skip();
+#endif
+}
+
+ZTEST(sensor_filter_suite, test_outlier) {
+#if SENSOR_FILTER_MEDIAN
+  int16_t out;
+
+  // Outliers below the spike threshold, spaced wider than the window
+  for (uint32_t idx = 0; idx < 50; idx++) {
+    int16_t in = idx % CONFIG_APP_FILTER_MEDIAN == 1 ? LEVEL + 50 : LEVEL;
+
+    zassert_ok(sensor_filter_apply(&filter, in, &out));
+    zassert_equal(out, LEVEL, "sample %u", idx);
+  }
+#else
+  ztest_test_skip();
+#endif
+}
+
+#if SENSOR_FILTER_MEDIAN && !SENSOR_FILTER_SPIKE && !SENSOR_FILTER_EMA
+static int compare_int16(const void *a, const void *b) {
+  return *(const int16_t *)a - *(const int16_t *)b;
+}
+#endif
+
+ZTEST(sensor_filter_suite, test_median) {
+#if SENSOR_FILTER_MEDIAN && !SENSOR_FILTER_SPIKE && !SENSOR_FILTER_EMA
+  int16_t window[CONFIG_APP_FILTER_MEDIAN];
+  int16_t out;
+
+  fill_series();
+  for (uint32_t idx = 0; idx < SERIES_SAMPLES; idx++) {
+    uint32_t count = MIN(idx + 1, CONFIG_APP_FILTER_MEDIAN);
+
+    zassert_ok(sensor_filter_apply(&filter, series[idx], &out));
+
+    memcpy(window, &series[idx + 1 - count], count * sizeof(int16_t));
+    qsort(window, count, sizeof(int16_t), compare_int16);
+    zassert_equal(out, window[(count - 1) / 2], "sample %u", idx);
+  }
+#else
+  ztest_test_skip();
+#endif
+}
+
+ZTEST(sensor_filter_suite, test_ema) {
+#if SENSOR_FILTER_EMA && !SENSOR_FILTER_SPIKE && !SENSOR_FILTER_MEDIAN
+  const double alpha = 1.0 / (1 << CONFIG_APP_FILTER_EMA_SHIFT);
+  double ref = 0;
+  int16_t out;
+
+  // Step response, then the random series, against a double reference
+  zassert_ok(sensor_filter_apply(&filter, 0, &out));
+  for (uint32_t idx = 0; idx < 100; idx++) {
+    zassert_ok(sensor_filter_apply(&filter, 1000, &out));
+    ref += alpha * (1000 - ref);
+    zassert_within(out, ref, 1.0, "step sample %u: %d vs %f", idx, out, ref);
+  }
+  zassert_equal(out, 1000, "average does not settle on its input");
+
+  fill_series();
+  for (uint32_t idx = 0; idx < SERIES_SAMPLES; idx++) {
+    zassert_ok(sensor_filter_apply(&filter, series[idx], &out));
+    ref += alpha * (series[idx] - ref);
+    zassert_within(out, ref, 1.0, "sample %u: %d vs %f", idx, out, ref);
+  }
+#else
+  ztest_test_skip();
+#endif
+}
+
+ZTEST(sensor_filter_suite, test_dht11) {
+  sensor_filter_dht11_t dht11 = {0};
+  dht11_sample_t sample;
+
+  for (uint32_t idx = 0; idx < 10; idx++) {
+    sample = (dht11_sample_t){.rh_x10 = 450, .t_x10 = 220};
+    zassert_ok(sensor_filter_dht11(&dht11, &sample));
+  }
+  zassert_equal(sample.rh_x10, 450);
+  zassert_equal(sample.t_x10, 220);
+
+#if SENSOR_FILTER_SPIKE
+  // A spike on one channel drops the reading untouched and leaves the
+  // other channel as it was
+  const dht11_sample_t spike = {.rh_x10 = 455, .t_x10 = 600};
+  const sensor_filter_t rh_before = dht11.rh;
+
+  sample = spike;
+  zassert_equal(sensor_filter_dht11(&dht11, &sample), -EAGAIN);
+  zassert_mem_equal(&sample, &spike, sizeof(sample));
+  zassert_mem_equal(&dht11.rh, &rh_before, sizeof(rh_before));
+  zassert_equal(dht11.rejected, 1);
+#endif
+
+  // Tenths of a smoothed value are kept
+  sample = (dht11_sample_t){.rh_x10 = 460, .t_x10 = 220};
+  zassert_ok(sensor_filter_dht11(&dht11, &sample));
+  zassert_between_inclusive(sample.rh_x10, 450, 460);
+
+  // Readings below 0 C pass through unclamped
+  sensor_filter_dht11_t cold = {0};
+
+  sample = (dht11_sample_t){.rh_x10 = 652, .t_x10 = -351};
+  zassert_ok(sensor_filter_dht11(&cold, &sample));
+  zassert_equal(sample.t_x10, -351);
+}
+
+ZTEST(sensor_filter_suite, test_bench) {
+  uint32_t rejected = 0;
+  int16_t out;
+
+  fill_series();
+
+  uint32_t start = k_cycle_get_32();
+
+  for (uint32_t idx = 0; idx < BENCH_SAMPLES; idx++) {
+    rejected += sensor_filter_apply(&filter, series[idx % SERIES_SAMPLES],
+                                    &out) != 0;
+  }
+
+  uint32_t cycles = k_cycle_get_32() - start;
+
+  TC_PRINT("stages: spike %d, median %d, ema shift %d\n",
+           CONFIG_APP_FILTER_SPIKE_X10, CONFIG_APP_FILTER_MEDIAN,
+           CONFIG_APP_FILTER_EMA_SHIFT);
+  TC_PRINT("%u cycles/sample, %zu B per channel, %u rejected\n",
+           cycles / BENCH_SAMPLES, sizeof(sensor_filter_t), rejected);
+}
+
+ZTEST_SUITE(sensor_filter_suite, NULL, NULL, filter_before, NULL, NULL);
@@ -0,0 +1,215 @@
+#include <zephyr/device.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include <string.h>
+
+#include <cobs.h>
+#include <telemetry.h>
+
+#define TELEMETRY_UART DEVICE_DT_GET(DT_CHOSEN(app_telemetry_uart))
+
+/** Random blocks checked by the round trip */
+#define ROUNDTRIP_BLOCKS 2000
+
+/** Largest random block, spans a few full runs */
+#define ROUNDTRIP_MAX 700
+
+/** Frames sent by the benchmark */
+#define BENCH_FRAMES 5000
+
+/** A SAMPLE record of the application feed */
+#define BENCH_RECORD_SIZE 9
+
+/** Records filling one frame */
+#define BENCH_RECORDS                                                          \
+  ((TELEMETRY_FRAME_SIZE - TELEMETRY_HEADER_SIZE - TELEMETRY_CRC_SIZE) /       \
+   (TELEMETRY_RECORD_HEADER_SIZE + BENCH_RECORD_SIZE))
+
+/** Full frames fitting in a transmit buffer, delimiters included */
+#define FRAMES_PER_BUF                                                         \
+  (TELEMETRY_TX_BUF_SIZE / (COBS_MAX_ENCODED_SIZE(TELEMETRY_FRAME_SIZE) + 1))
+
+typedef struct cobs_vector_s {
+  uint8_t raw[4];
+  uint8_t raw_len;
+  uint8_t enc[5];
+  uint8_t enc_len;
+} cobs_vector_t;
+
+static uint8_t raw[ROUNDTRIP_MAX];
+static uint8_t enc[COBS_MAX_ENCODED_SIZE(ROUNDTRIP_MAX)];
+static uint8_t dec[ROUNDTRIP_MAX];
+
+static uint32_t rand_state = 1;
+
+static uint32_t next_rand(void) {
+  rand_state = rand_state * 1103515245 + 12345;
+  return rand_state >> 8;
+}
+
+static void *telemetry_setup(void) {
+  zassert_ok(telemetry_init(TELEMETRY_UART));
+
+  return NULL;
+}
+
+ZTEST(telemetry_suite, test_cobs_vectors) {
+  static const cobs_vector_t vectors[] = {
+      {{0x00}, 1, {0x01, 0x01}, 2},
+      {{0x00, 0x00}, 2, {0x01, 0x01, 0x01}, 3},
+      {{0x11, 0x22, 0x00, 0x33}, 4, {0x03, 0x11, 0x22, 0x02, 0x33}, 5},
+      {{0x11, 0x22, 0x33, 0x44}, 4, {0x05, 0x11, 0x22, 0x33, 0x44}, 5},
+      {{0x11, 0x00, 0x00, 0x00}, 4, {0x02, 0x11, 0x01, 0x01, 0x01}, 5},
+  };
+
+  for (size_t idx = 0; idx < ARRAY_SIZE(vectors); idx++) {
+    const cobs_vector_t *vec = &vectors[idx];
+    int len = cobs_encode(vec->raw, vec->raw_len, enc, sizeof(enc));
+
+    zassert_equal(len, vec->enc_len, "vector %zu", idx);
+    zassert_mem_equal(enc, vec->enc, len, "vector %zu", idx);
+
+    len = cobs_decode(vec->enc, vec->enc_len, dec, sizeof(dec));
+    zassert_equal(len, vec->raw_len, "vector %zu", idx);
+    zassert_mem_equal(dec, vec->raw, len, "vector %zu", idx);
+  }
+
+  // 254 non-zero bytes fill one run, the 255th opens the next
+  for (size_t idx = 0; idx < 255; idx++) {
+    raw[idx] = idx + 1;
+  }
+  zassert_equal(cobs_encode(raw, 254, enc, sizeof(enc)), 255);
+  zassert_equal(enc[0], 0xFF);
+  zassert_equal(cobs_encode(raw, 255, enc, sizeof(enc)), 257);
+  zassert_equal(enc[0], 0xFF);
+  zassert_equal(enc[255], 0x02);
+  zassert_equal(enc[256], 0xFF);
+}
+
+ZTEST(telemetry_suite, test_cobs_roundtrip) {
+  for (uint32_t block = 0; block < ROUNDTRIP_BLOCKS; block++) {
+    size_t len = next_rand() % ROUNDTRIP_MAX;
+
+    // All zeros, half, a third, or none for full runs
+    for (size_t idx = 0; idx < len; idx++) {
+      bool zero = block % 4 != 3 && next_rand() % (1 + block % 4) == 0;
+
+      raw[idx] = zero ? 0 : 1 + next_rand() % 255;
+    }
+
+    int enc_len = cobs_encode(raw, len, enc, COBS_MAX_ENCODED_SIZE(len));
+
+    zassert_true(enc_len > 0, "block %u", block);
+    zassert_is_null(memchr(enc, 0, enc_len), "block %u", block);
+
+    zassert_equal(cobs_decode(enc, enc_len, dec, sizeof(dec)), len,
+                  "block %u", block);
+    zassert_mem_equal(dec, raw, len, "block %u", block);
+
+    // In place, as a receiver would
+    zassert_equal(cobs_decode(enc, enc_len, enc, enc_len), len, "block %u",
+                  block);
+    zassert_mem_equal(enc, raw, len, "block %u", block);
+  }
+}
+
+ZTEST(telemetry_suite, test_cobs_invalid) {
+  static const uint8_t zero_inside[] = {0x03, 0x11, 0x00};
+  static const uint8_t past_end[] = {0x05, 0x11, 0x22};
+  static const uint8_t block[] = {0x11, 0x22, 0x00, 0x33};
+
+  zassert_equal(cobs_decode(zero_inside, sizeof(zero_inside), dec,
+                            sizeof(dec)),
+                -EINVAL);
+  zassert_equal(cobs_decode(past_end, sizeof(past_end), dec, sizeof(dec)),
+                -EINVAL);
+
+  zassert_equal(cobs_encode(block, sizeof(block), enc, 4), -ENOMEM);
+  zassert_equal(cobs_encode(block, sizeof(block), enc, 5), 5);
+  zassert_equal(cobs_decode(enc, 5, dec, 3), -ENOMEM);
+}
+
+ZTEST(telemetry_suite, test_record_too_large) {
+  static const uint8_t payload[TELEMETRY_RECORD_MAX + 1];
+
+  zassert_equal(telemetry_put(1, payload, sizeof(payload)), -EINVAL);
+}
+
+ZTEST(telemetry_suite, test_throughput) {
+  uint8_t payload[BENCH_RECORD_SIZE] = {0x10, 0x27, 0x00, 0x00, 0x00,
+                                        0xC2, 0x01, 0xDC, 0x00};
+  uint32_t put_cycles = 0;
+  uint32_t put_max = 0;
+  uint32_t flush_cycles = 0;
+  uint32_t flush_max = 0;
+  telemetry_stats_t before;
+  telemetry_stats_t stats;
+
+  telemetry_flush();
+  telemetry_get_stats(&before);
+
+  int64_t start_ms = k_uptime_get();
+
+  for (uint32_t frame = 0; frame < BENCH_FRAMES; frame++) {
+    // Pace to the UART so that the closed frames never overrun the buffers
+    do {
+      telemetry_get_stats(&stats);
+      if (stats.frames - stats.frames_sent - stats.frames_dropped <
+          FRAMES_PER_BUF) {
+        break;
+      }
+      k_sleep(K_TICKS(1));
+    } while (true);
+
+    for (uint32_t rec = 0; rec < BENCH_RECORDS; rec++) {
+      uint32_t start = k_cycle_get_32();
+
+      payload[0] = (uint8_t)rec;
+      zassert_ok(telemetry_put(1, payload, sizeof(payload)));
+
+      uint32_t cycles = k_cycle_get_32() - start;
+
+      put_cycles += cycles;
+      put_max = MAX(put_max, cycles);
+    }
+
+    uint32_t start = k_cycle_get_32();
+
+    telemetry_flush();
+
+    uint32_t cycles = k_cycle_get_32() - start;
+
+    flush_cycles += cycles;
+    flush_max = MAX(flush_max, cycles);
+  }
+
+  // Let the last buffers drain
+  for (int wait = 0; wait < 1000; wait++) {
+    telemetry_get_stats(&stats);
+    if (stats.frames == stats.frames_sent + stats.frames_dropped) {
+      break;
+    }
+    k_sleep(K_MSEC(1));
+  }
+
+  int64_t elapsed_ms = MAX(k_uptime_get() - start_ms, 1);
+  int64_t sent = stats.frames_sent - before.frames_sent;
+  int64_t bytes = stats.bytes_sent - before.bytes_sent;
+
+  zassert_equal(stats.frames - before.frames, BENCH_FRAMES);
+  zassert_equal(stats.frames_sent + stats.frames_dropped, stats.frames,
+                "frames left in flight");
+  zassert_equal(stats.frames_dropped, before.frames_dropped,
+                "paced producer lost frames");
+  zassert_equal(stats.tx_errors, 0);
+
+  TC_PRINT("%lld frames of %u records in %lld ms: %lld frames/s, %lld B/s\n",
+           sent, BENCH_RECORDS, elapsed_ms, sent * MSEC_PER_SEC / elapsed_ms,
+           bytes * MSEC_PER_SEC / elapsed_ms);
+  TC_PRINT("put: %u cycles avg, %u max; flush: %u cycles avg, %u max\n",
+           put_cycles / (BENCH_FRAMES * BENCH_RECORDS), put_max,
+           flush_cycles / BENCH_FRAMES, flush_max);
+}
+
+ZTEST_SUITE(telemetry_suite, NULL, telemetry_setup, NULL, NULL, NULL);
@@ -0,0 +1,119 @@
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include <timer_wheel.h>
+
+/** Number of timeouts armed at once by the fan out test */
+#define FANOUT_ENTRIES 32
+
+/** Expirations of the periodic test */
+#define PERIODIC_COUNT 5
+
+typedef struct test_timer_s {
+  timer_wheel_entry_t entry;
+  uint32_t fired;
+  int64_t fired_ms;
+  uint32_t period_ms; ///< Re-armed from the callback while non-zero
+} test_timer_t;
+
+static test_timer_t timers[FANOUT_ENTRIES];
+
+static void test_expired(timer_wheel_entry_t *entry) {
+  test_timer_t *timer = CONTAINER_OF(entry, test_timer_t, entry);
+
+  timer->fired++;
+  timer->fired_ms = k_uptime_get();
+
+  if (timer->period_ms && timer->fired < PERIODIC_COUNT) {
+    timer_wheel_start(entry, timer->period_ms);
+  }
+}
+
+static void timer_wheel_before(void *fixture) {
+  for (uint32_t idx = 0; idx < FANOUT_ENTRIES; idx++) {
+    timer_wheel_stop(&timers[idx].entry);
+    memset(&timers[idx], 0, sizeof(timers[idx]));
+    timer_wheel_init_entry(&timers[idx].entry, test_expired);
+  }
+}
+
+ZTEST(timer_wheel_suite, test_expires_after_timeout) {
+  int64_t start = k_uptime_get();
+
+  timer_wheel_start(&timers[0].entry, 50);
+
+  k_msleep(40);
+  zassert_equal(timers[0].fired, 0);
+
+  k_msleep(50);
+  zassert_equal(timers[0].fired, 1);
+  zassert_true(timers[0].fired_ms - start >= 50);
+  zassert_true(timers[0].fired_ms - start <= 50 + 2 * TIMER_WHEEL_TICK_MS);
+}
+
+ZTEST(timer_wheel_suite, test_stop_cancels) {
+  timer_wheel_start(&timers[0].entry, 20);
+  timer_wheel_stop(&timers[0].entry);
+
+  k_msleep(60);
+  zassert_equal(timers[0].fired, 0);
+}
+
+ZTEST(timer_wheel_suite, test_restart_pushes_out) {
+  int64_t start = k_uptime_get();
+
+  for (uint32_t idx = 0; idx < 5; idx++) {
+    timer_wheel_start(&timers[0].entry, 30);
+    k_msleep(10);
+  }
+  zassert_equal(timers[0].fired, 0);
+
+  k_msleep(60);
+  zassert_equal(timers[0].fired, 1);
+  zassert_true(timers[0].fired_ms - start >= 40 + 30);
+}
+
+ZTEST(timer_wheel_suite, test_longer_than_one_turn) {
+  uint32_t timeout_ms = TIMER_WHEEL_SLOTS * TIMER_WHEEL_TICK_MS * 2 + 7;
+  int64_t start = k_uptime_get();
+
+  timer_wheel_start(&timers[0].entry, timeout_ms);
+
+  k_msleep(timeout_ms - 20);
+  zassert_equal(timers[0].fired, 0);
+
+  k_msleep(20 + 2 * TIMER_WHEEL_TICK_MS);
+  zassert_equal(timers[0].fired, 1);
+  zassert_true(timers[0].fired_ms - start >= timeout_ms);
+}
+
+ZTEST(timer_wheel_suite, test_rearm_from_callback) {
+  timers[0].period_ms = 10;
+  timer_wheel_start(&timers[0].entry, 10);
+
+  k_msleep(PERIODIC_COUNT * (10 + 2 * TIMER_WHEEL_TICK_MS) + 20);
+  zassert_equal(timers[0].fired, PERIODIC_COUNT);
+}
+
+ZTEST(timer_wheel_suite, test_fanout) {
+  uint32_t ticks = timer_wheel_ticks();
+
+  for (uint32_t idx = 0; idx < FANOUT_ENTRIES; idx++) {
+    timer_wheel_start(&timers[idx].entry, 10 + idx * 3);
+  }
+
+  k_msleep(10 + FANOUT_ENTRIES * 3 + 4 * TIMER_WHEEL_TICK_MS);
+
+  for (uint32_t idx = 0; idx < FANOUT_ENTRIES; idx++) {
+    zassert_equal(timers[idx].fired, 1, "timer %d fired %d times", idx,
+                  timers[idx].fired);
+  }
+
+  // One k_timer serves every entry and stops once the wheel is empty
+  uint32_t used = timer_wheel_ticks() - ticks;
+  k_msleep(10 * TIMER_WHEEL_TICK_MS);
+  zassert_equal(timer_wheel_ticks() - ticks, used);
+  TC_PRINT("%d timeouts served by %d wheel ticks\n", FANOUT_ENTRIES, used);
+}
+
+ZTEST_SUITE(timer_wheel_suite, NULL, NULL, timer_wheel_before, NULL, NULL);
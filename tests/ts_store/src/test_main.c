@@ -0,0 +1,282 @@
+#include <zephyr/kernel.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/ztest.h>
+
+#include <ts_store.h>
+
+#define STORE_AREA FIXED_PARTITION_ID(history_partition)
+
+/** Acquisition period of the generated samples */
+#define PERIOD_S 3
+
+/** Version, sample count and first sample of a batch, see ts_store.c */
+#define BATCH_HEADER_SIZE 11
+
+/** Samples appended by the benchmark, about 8 hours of readings */
+#define BENCH_SAMPLES 10000
+
+/**
+ * @brief Deterministic sample series
+ *
+ * Slow integer steps of the humidity and temperature as a DHT11 reports them.
+ */
+static ts_sample_t sample_at(uint32_t idx) {
+  ts_sample_t sample = {
+      .time_s = idx * PERIOD_S,
+      .rh_x10 = 400 + 10 * ((idx / 37) % 7),
+      .t_x10 = 220 - 10 * ((idx / 53) % 5),
+  };
+  return sample;
+}
+
+static void append_range(uint32_t from, uint32_t to) {
+  for (uint32_t idx = from; idx < to; idx++) {
+    ts_sample_t sample = sample_at(idx);
+
+    zassert_ok(ts_store_append(&sample), "sample %u", idx);
+  }
+}
+
+/** Read from a cursor to the end, checking every sample against the series */
+static uint32_t check_range(ts_store_cursor_t *cursor, uint32_t from) {
+  ts_sample_t sample;
+  uint32_t idx = from;
+  int ret;
+
+  while (!(ret = ts_store_next(cursor, &sample))) {
+    ts_sample_t expected = sample_at(idx);
+
+    zassert_equal(sample.time_s, expected.time_s, "sample %u", idx);
+    zassert_equal(sample.rh_x10, expected.rh_x10, "sample %u", idx);
+    zassert_equal(sample.t_x10, expected.t_x10, "sample %u", idx);
+    idx++;
+  }
+  zassert_equal(ret, -ENOENT);
+
+  return idx - from;
+}
+
+static void ts_store_before(void *fixture) {
+  zassert_ok(ts_store_init(STORE_AREA));
+  zassert_ok(ts_store_clear());
+}
+
+ZTEST(ts_store_suite, test_empty) {
+  ts_store_cursor_t cursor;
+  ts_sample_t sample;
+  uint32_t time_s;
+
+  zassert_equal(ts_store_last_time(&time_s), -ENOENT);
+  zassert_ok(ts_store_seek(0, &cursor));
+  zassert_equal(ts_store_next(&cursor, &sample), -ENOENT);
+}
+
+ZTEST(ts_store_suite, test_roundtrip) {
+  ts_store_cursor_t cursor;
+  ts_store_stats_t stats;
+
+  append_range(0, 1000);
+  zassert_ok(ts_store_seek(0, &cursor));
+  zassert_equal(check_range(&cursor, 0), 1000);
+
+  // Same samples once the RAM batch is in flash
+  zassert_ok(ts_store_flush());
+  zassert_ok(ts_store_seek(0, &cursor));
+  zassert_equal(check_range(&cursor, 0), 1000);
+
+  ts_store_get_stats(&stats);
+  zassert_equal(stats.samples, 1000);
+  zassert_true(stats.batches > 1);
+}
+
+ZTEST(ts_store_suite, test_reject_older) {
+  ts_sample_t sample = sample_at(10);
+
+  zassert_ok(ts_store_append(&sample));
+  zassert_ok(ts_store_append(&sample), "Equal timestamps are allowed");
+
+  sample = sample_at(9);
+  zassert_equal(ts_store_append(&sample), -EINVAL);
+}
+
+ZTEST(ts_store_suite, test_seek) {
+  ts_store_cursor_t cursor;
+  ts_sample_t sample;
+
+  append_range(0, 3000);
+
+  // Exact timestamp, between two samples and in the RAM batch
+  zassert_ok(ts_store_seek(1500 * PERIOD_S, &cursor));
+  zassert_equal(check_range(&cursor, 1500), 1500);
+
+  zassert_ok(ts_store_seek(700 * PERIOD_S - 1, &cursor));
+  zassert_equal(check_range(&cursor, 700), 2300);
+
+  zassert_ok(ts_store_seek(2999 * PERIOD_S, &cursor));
+  zassert_equal(check_range(&cursor, 2999), 1);
+
+  zassert_ok(ts_store_seek(3000 * PERIOD_S, &cursor));
+  zassert_equal(ts_store_next(&cursor, &sample), -ENOENT);
+}
+
+ZTEST(ts_store_suite, test_recovery) {
+  ts_store_cursor_t cursor;
+  ts_store_stats_t before;
+  ts_store_stats_t after;
+  uint32_t time_s;
+
+  append_range(0, 2000);
+  zassert_ok(ts_store_flush());
+  ts_store_get_stats(&before);
+
+  // Lost with the RAM batch by the simulated reset
+  append_range(2000, 2010);
+
+  zassert_ok(ts_store_init(STORE_AREA));
+  ts_store_get_stats(&after);
+  zassert_equal(after.recovered, before.batches);
+  zassert_equal(after.discarded, 0);
+
+  zassert_ok(ts_store_last_time(&time_s));
+  zassert_equal(time_s, sample_at(1999).time_s);
+
+  zassert_ok(ts_store_seek(0, &cursor));
+  zassert_equal(check_range(&cursor, 0), 2000);
+
+  // The series continues after the recovered samples
+  append_range(2000, 2100);
+  zassert_ok(ts_store_seek(1990 * PERIOD_S, &cursor));
+  zassert_equal(check_range(&cursor, 1990), 110);
+}
+
+ZTEST(ts_store_suite, test_corrupt_batch) {
+  const struct flash_area *fa;
+  ts_store_cursor_t cursor;
+  ts_store_stats_t stats;
+  ts_sample_t sample;
+  uint8_t buf[256];
+  uint8_t header[7] = {1};
+  off_t batch_off = -1;
+  uint32_t second = 0;
+
+  append_range(0, 1000);
+  zassert_ok(ts_store_flush());
+  ts_store_get_stats(&stats);
+  zassert_true(stats.batches >= 3);
+
+  // First sample of the second batch, the cursor is just past a batch header
+  // after reading it
+  zassert_ok(ts_store_seek(0, &cursor));
+  zassert_ok(ts_store_next(&cursor, &sample));
+  do {
+    zassert_ok(ts_store_next(&cursor, &sample));
+    second++;
+  } while (cursor.pos != BATCH_HEADER_SIZE);
+
+  // Locate the batch in flash by its version and first timestamp
+  sys_put_le32(sample.time_s, &header[3]);
+
+  zassert_ok(flash_area_open(STORE_AREA, &fa));
+  for (off_t off = 0; off + sizeof(header) <= fa->fa_size && batch_off < 0;
+       off += sizeof(buf) - sizeof(header)) {
+    size_t len = MIN(sizeof(buf), fa->fa_size - off);
+
+    zassert_ok(flash_area_read(fa, off, buf, len));
+    for (size_t pos = 0; pos + sizeof(header) <= len; pos++) {
+      if (buf[pos] == header[0] &&
+          !memcmp(&buf[pos + 3], &header[3], sizeof(header) - 3)) {
+        batch_off = off + pos;
+        break;
+      }
+    }
+  }
+  zassert_true(batch_off > 0, "second batch not found");
+
+  // Clear the bits of a few delta records, as an interrupted write would
+  const uint8_t zeros[4] = {0};
+
+  zassert_ok(flash_area_write(fa, batch_off + BATCH_HEADER_SIZE + 1, zeros,
+                              sizeof(zeros)));
+  flash_area_close(fa);
+
+  zassert_ok(ts_store_init(STORE_AREA));
+  ts_store_get_stats(&stats);
+  zassert_true(stats.recovered >= 2);
+
+  // The samples of the damaged batch are gone, the others remain intact
+  zassert_ok(ts_store_seek(0, &cursor));
+  for (uint32_t idx = 0; idx < second; idx++) {
+    zassert_ok(ts_store_next(&cursor, &sample));
+    zassert_equal(sample.time_s, sample_at(idx).time_s);
+  }
+
+  zassert_ok(ts_store_next(&cursor, &sample));
+  zassert_true(sample.time_s > sample_at(second).time_s);
+
+  uint32_t next = sample.time_s / PERIOD_S + 1;
+
+  zassert_equal(check_range(&cursor, next), 1000 - next);
+}
+
+ZTEST(ts_store_suite, test_rotation) {
+  ts_store_cursor_t cursor;
+  ts_store_stats_t stats;
+  ts_sample_t first;
+  ts_sample_t sample;
+  uint32_t idx = 0;
+
+  // Fill the partition until the oldest sectors have been erased twice
+  do {
+    append_range(idx, idx + 1000);
+    idx += 1000;
+    ts_store_get_stats(&stats);
+  } while (stats.rotations < 2);
+
+  // The oldest samples are gone, the rest is contiguous
+  zassert_ok(ts_store_seek(0, &cursor));
+  zassert_ok(ts_store_next(&cursor, &first));
+  zassert_true(first.time_s > 0);
+  zassert_equal(first.time_s % PERIOD_S, 0);
+  zassert_equal(check_range(&cursor, first.time_s / PERIOD_S + 1),
+                idx - first.time_s / PERIOD_S - 1);
+
+  // A cursor whose batches are erased under it notices
+  zassert_ok(ts_store_seek(0, &cursor));
+  do {
+    append_range(idx, idx + 1000);
+    idx += 1000;
+    ts_store_get_stats(&stats);
+  } while (stats.rotations < 3);
+  zassert_equal(ts_store_next(&cursor, &sample), -ESTALE);
+}
+
+ZTEST(ts_store_suite, test_bench_write_amplification) {
+  ts_store_stats_t stats;
+
+  uint32_t start = k_cycle_get_32();
+
+  append_range(0, BENCH_SAMPLES);
+  zassert_ok(ts_store_flush());
+
+  uint32_t cycles = k_cycle_get_32() - start;
+
+  ts_store_get_stats(&stats);
+
+  uint32_t raw_bytes = stats.samples * sizeof(ts_sample_t);
+
+  TC_PRINT("append: %u samples in %u batches, %u cycles/sample\n",
+           stats.samples, stats.batches, cycles / stats.samples);
+  TC_PRINT("flash: %u bytes, %u.%02u bytes/sample, write amplification "
+           "%u.%02u, %u bytes erased\n",
+           stats.flash_bytes, stats.flash_bytes / stats.samples,
+           stats.flash_bytes * 100 / stats.samples % 100,
+           stats.flash_bytes / raw_bytes,
+           stats.flash_bytes * 100 / raw_bytes % 100, stats.erased_bytes);
+
+  // Deltas of slowly changing readings take one byte per field
+  zassert_true(stats.flash_bytes < stats.samples * 4,
+               "%u bytes for %u samples", stats.flash_bytes, stats.samples);
+}
+
+ZTEST_SUITE(ts_store_suite, NULL, NULL, ts_store_before, NULL, NULL);